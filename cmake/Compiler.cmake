@@ -137,6 +137,13 @@ macro(dune_probe_cxx)
         set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -pg")
       endif(PROFILE)
 
+      # Allow if-conversion of floating point selects in code written
+      # to be vectorized (see DUNE/Math/Vectorized.cpp).
+      check_cxx_compiler_flag(-fno-trapping-math has_fno_trapping_math)
+      if(has_fno_trapping_math)
+        set(DUNE_CXX_FLAGS_VECTORIZE "-fno-trapping-math")
+      endif(has_fno_trapping_math)
+
       set(DUNE_CXX_FLAGS_STRICT "-Wall -Wshadow -pedantic")
       set(DUNE_C_FLAGS_STRICT "-Wall -Wshadow -pedantic")
       set(DUNE_CXX_FLAGS_LOOSE  "")
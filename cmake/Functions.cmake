@@ -262,6 +262,18 @@ macro(dune_probe_functions)
     "direct.h"
     DUNE_SYS_HAS__GETCWD)
 
+  dune_test_function(realpath
+    "char*"
+    "char*;char*"
+    "cstdlib"
+    DUNE_SYS_HAS_REALPATH)
+
+  dune_test_function(_fullpath
+    "char*"
+    "char*;char*;size_t"
+    "cstdlib"
+    DUNE_SYS_HAS__FULLPATH)
+
   dune_test_function(FormatMessage
     "DWORD"
     "DWORD;void*;DWORD;DWORD;char*;DWORD;va_list*"
@@ -0,0 +1,236 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+
+#ifndef DUNE_PROGRAMS_BENCH_BENCH_HPP_INCLUDED_
+#define DUNE_PROGRAMS_BENCH_BENCH_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Time/Clock.hpp>
+
+//! Minimal micro-benchmark harness.
+//!
+//! Each benchmark is a functor whose operator() executes one
+//! operation. During warmup the number of operations per sample is
+//! calibrated so that a sample lasts at least c_min_sample_ns, then
+//! a fixed number of samples is timed and summarized as nanoseconds
+//! per operation.
+//!
+//! Command line options accepted by every benchmark program:
+//!   --reps N      number of timed samples (default 200).
+//!   --warmup N    number of warmup samples (default 20).
+//!   --filter STR  only run benchmarks whose name contains STR.
+//!   --json FILE   write results as JSON to FILE ('-' for stdout).
+class Bench
+{
+public:
+  //! Minimum duration of a sample, in nanoseconds.
+  static const uint64_t c_min_sample_ns = 20000;
+
+  struct Result
+  {
+    std::string name;
+    unsigned batch;
+    unsigned samples;
+    double mean;
+    double min;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+  };
+
+  Bench(const char* suite, int argc, char** argv):
+    m_suite(suite),
+    m_reps(200),
+    m_warmup(20)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      if (i + 1 >= argc)
+        usage(argv[0]);
+
+      if (std::strcmp(argv[i], "--reps") == 0)
+        m_reps = std::max(1, std::atoi(argv[++i]));
+      else if (std::strcmp(argv[i], "--warmup") == 0)
+        m_warmup = std::max(1, std::atoi(argv[++i]));
+      else if (std::strcmp(argv[i], "--filter") == 0)
+        m_filter = argv[++i];
+      else if (std::strcmp(argv[i], "--json") == 0)
+        m_json = argv[++i];
+      else
+        usage(argv[0]);
+    }
+
+    std::fprintf(stderr, "* %s\n", suite);
+    std::fprintf(stderr, "  %-40s %10s %10s %10s %10s\n", "(ns/op)", "p50", "p90", "p99", "max");
+  }
+
+  ~Bench(void)
+  {
+    if (!m_json.empty())
+      writeJSON();
+  }
+
+  //! Run benchmark.
+  //! @param name benchmark name.
+  //! @param op functor executing one operation.
+  template <typename Op>
+  void
+  run(const char* name, Op& op)
+  {
+    if (!m_filter.empty() && std::strstr(name, m_filter.c_str()) == NULL)
+      return;
+
+    // Warmup and calibration.
+    unsigned batch = 1;
+    for (unsigned i = 0; i < m_warmup; ++i)
+    {
+      uint64_t t = sample(op, batch);
+      while (t < c_min_sample_ns && batch < (1u << 30))
+      {
+        batch *= 2;
+        t = sample(op, batch);
+      }
+    }
+
+    std::vector<double> samples(m_reps);
+    double sum = 0;
+    for (unsigned i = 0; i < m_reps; ++i)
+    {
+      samples[i] = (double)sample(op, batch) / batch;
+      sum += samples[i];
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    Result r;
+    r.name = name;
+    r.batch = batch;
+    r.samples = m_reps;
+    r.mean = sum / m_reps;
+    r.min = samples.front();
+    r.p50 = percentile(samples, 50);
+    r.p90 = percentile(samples, 90);
+    r.p99 = percentile(samples, 99);
+    r.max = samples.back();
+    m_results.push_back(r);
+
+    std::fprintf(stderr, "  %-40s %10.1f %10.1f %10.1f %10.1f\n",
+                 name, r.p50, r.p90, r.p99, r.max);
+  }
+
+  //! Keep a value alive so that the compiler cannot discard the
+  //! computation that produced it.
+  template <typename T>
+  static void
+  consume(const T& value)
+  {
+    static volatile char sink;
+    const volatile char* p = reinterpret_cast<const volatile char*>(&value);
+    sink = p[0];
+    (void)sink;
+  }
+
+private:
+  //! Suite name.
+  std::string m_suite;
+  //! Timed samples per benchmark.
+  unsigned m_reps;
+  //! Warmup samples per benchmark.
+  unsigned m_warmup;
+  //! Benchmark name filter.
+  std::string m_filter;
+  //! JSON output file.
+  std::string m_json;
+  //! Results.
+  std::vector<Result> m_results;
+
+  template <typename Op>
+  static uint64_t
+  sample(Op& op, unsigned batch)
+  {
+    uint64_t start = DUNE::Time::Clock::getNsec();
+    for (unsigned i = 0; i < batch; ++i)
+      op();
+    return DUNE::Time::Clock::getNsec() - start;
+  }
+
+  static double
+  percentile(const std::vector<double>& sorted, unsigned p)
+  {
+    size_t idx = (sorted.size() - 1) * p / 100;
+    return sorted[idx];
+  }
+
+  static void
+  usage(const char* program)
+  {
+    std::fprintf(stderr, "Usage: %s [--reps N] [--warmup N] [--filter STR] [--json FILE]\n", program);
+    std::exit(1);
+  }
+
+  void
+  writeJSON(void)
+  {
+    bool out_std = (m_json == "-");
+    std::FILE* fd = out_std ? stdout : std::fopen(m_json.c_str(), "w");
+    if (fd == NULL)
+    {
+      std::fprintf(stderr, "failed to open '%s'\n", m_json.c_str());
+      return;
+    }
+
+    std::fprintf(fd, "{\n  \"suite\": \"%s\",\n  \"results\": [", m_suite.c_str());
+    for (size_t i = 0; i < m_results.size(); ++i)
+    {
+      const Result& r = m_results[i];
+      std::fprintf(fd, "%s\n    {\"name\": \"%s\", \"batch\": %u, \"samples\": %u, "
+                   "\"mean\": %.3f, \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, "
+                   "\"p99\": %.3f, \"max\": %.3f}",
+                   i ? "," : "", r.name.c_str(), r.batch, r.samples,
+                   r.mean, r.min, r.p50, r.p90, r.p99, r.max);
+    }
+    std::fprintf(fd, "\n  ]\n}\n");
+
+    if (!out_std)
+      std::fclose(fd);
+  }
+};
+
+#endif
@@ -0,0 +1,287 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+// Quad-tree formerly used by Simulators::Environment (benchmark baseline). *
+//***************************************************************************
+
+#ifndef DUNE_PROGRAMS_BENCH_QUAD_TREE_HPP_INCLUDED_
+#define DUNE_PROGRAMS_BENCH_QUAD_TREE_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+//! Point quad-tree that indexed INI bathymetry in the Environment
+//! simulator before Math::KDTree. Only insertion and area search are
+//! kept, which is what depth lookups used. It is here so that the
+//! KDTree benchmarks have the previous implementation as a baseline.
+namespace Legacy
+{
+  //! Directions for search/insertion.
+  enum
+  {
+    DIR_NW, DIR_NE, DIR_SW, DIR_SE
+  };
+
+  //! Point structure.
+  struct Point
+  {
+    double x, y;
+
+    Point(double x_, double y_):
+      x(x_), y(y_) { }
+
+    double
+    distance(const Point& other) const
+    {
+      double dx = x - other.x;
+      double dy = y - other.y;
+      return std::sqrt(dx * dx + dy * dy);
+    }
+
+    template <typename T>
+    int
+    direction(const T& other) const
+    {
+      double dx = other.x - x;
+      double dy = other.y - y;
+
+      int dir = dx >= 0 ? DIR_NW : DIR_SW;
+
+      if (dy > 0)
+        dir++;
+
+      return dir;
+    }
+  };
+
+  //! Axis aligned rectangle.
+  struct Bounds
+  {
+    double min_x, max_x, min_y, max_y;
+
+    Bounds(const Point& p, double r):
+      min_x(p.x - r), max_x(p.x + r), min_y(p.y - r), max_y(p.y + r)
+    { }
+
+    Bounds(const Bounds& parent, const Point& lim, int dir)
+    {
+      switch (dir)
+      {
+        case DIR_NW:
+          min_x = lim.x;
+          max_x = parent.max_x;
+          min_y = parent.min_y;
+          max_y = lim.y;
+          break;
+        case DIR_NE:
+          min_x = lim.x;
+          max_x = parent.max_x;
+          min_y = lim.y;
+          max_y = parent.max_y;
+          break;
+        case DIR_SW:
+          min_x = parent.min_x;
+          max_x = lim.x;
+          min_y = parent.min_y;
+          max_y = lim.y;
+          break;
+        case DIR_SE:
+        default:
+          min_x = parent.min_x;
+          max_x = lim.x;
+          min_y = lim.y;
+          max_y = parent.max_y;
+          break;
+      }
+    }
+
+    Bounds
+    quadrant(int dir) const
+    {
+      return Bounds(*this, midpoint(), dir);
+    }
+
+    template <typename T>
+    std::pair<int, Bounds>
+    quadrant(const T& p) const
+    {
+      Point lim = midpoint();
+      int q = lim.direction(p);
+      return std::pair<int, Bounds>(q, Bounds(*this, lim, q));
+    }
+
+    bool
+    intersects(const Bounds& other) const
+    {
+      if (min_x > other.max_x || other.min_x > max_x)
+        return false;
+      if (min_y > other.max_y || other.min_y > max_y)
+        return false;
+      return true;
+    }
+
+    template <typename T>
+    bool
+    contains(const T& p) const
+    {
+      return p.x >= min_x && p.x <= max_x && p.y >= min_y && p.y <= max_y;
+    }
+
+    Point
+    midpoint() const
+    {
+      return Point(0.5 * (min_x + max_x), 0.5 * (min_y + max_y));
+    }
+  };
+
+  class QuadTree
+  {
+  public:
+    //! Item datum.
+    struct Item
+    {
+      double x, y, value;
+    };
+
+    QuadTree(const Bounds& bounds):
+      m_bounds(bounds),
+      m_root(0)
+    { }
+
+    ~QuadTree(void)
+    {
+      delete m_root;
+    }
+
+    //! Insert an item.
+    //! Returns 'false' if item is out-of-bounds.
+    bool
+    insert(const Item& item)
+    {
+      if (!m_bounds.contains(item))
+        return false;
+
+      if (!m_root)
+        m_root = new Node(item);
+      else
+        m_root->insert(item, m_bounds);
+
+      return true;
+    }
+
+    //! Search for items in a given area.
+    //! If any are found returns 'true' and adds results to 'item' vector.
+    bool
+    search(const Bounds& area, std::vector<Item>& items) const
+    {
+      items.clear();
+
+      if (m_root)
+        m_root->search(items, area, m_bounds);
+
+      return items.size() != 0;
+    }
+
+  private:
+    struct Node
+    {
+      union
+      {
+        Item item;
+        Node* children[4];
+      } m_data;
+
+      bool m_leaf;
+
+      Node(const Item& item)
+      {
+        m_data.item = item;
+        m_leaf = true;
+      }
+
+      ~Node(void)
+      {
+        if (!m_leaf)
+        {
+          for (int i = 0; i < 4; ++i)
+            delete m_data.children[i];
+        }
+      }
+
+      void
+      insert(const Item& item, const Bounds& b)
+      {
+        if (m_leaf)
+        {
+          m_leaf = false;
+          Item prev_item = m_data.item;
+          std::memset(m_data.children, 0, sizeof(m_data.children));
+          insert(prev_item, b);
+        }
+
+        std::pair<int, Bounds> bq = b.quadrant(item);
+        Node** c = m_data.children + bq.first;
+        if (*c)
+          (*c)->insert(item, bq.second);
+        else
+          *c = new Node(item);
+      }
+
+      void
+      search(std::vector<Item>& items, const Bounds& area, const Bounds& b) const
+      {
+        if (m_leaf)
+        {
+          if (b.contains(m_data.item))
+            items.push_back(m_data.item);
+          return;
+        }
+
+        for (int i = 0; i < 4; ++i)
+        {
+          if (m_data.children[i])
+          {
+            Bounds cb = b.quadrant(i);
+            if (area.intersects(cb))
+              m_data.children[i]->search(items, area, cb);
+          }
+        }
+      }
+    };
+
+    //! Bounds.
+    Bounds m_bounds;
+    //! Root node.
+    Node* m_root;
+  };
+}
+
+#endif
@@ -0,0 +1,100 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+//***************************************************************************
+// Micro-benchmarks for DUNE::Algorithms checksums and hashes.              *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Algorithms/CRC16.hpp>
+#include <DUNE/Algorithms/CRC32.hpp>
+#include <DUNE/Algorithms/MD5.hpp>
+
+// Local headers.
+#include "Bench.hpp"
+
+using namespace DUNE::Algorithms;
+
+struct Buffer
+{
+  std::vector<uint8_t> data;
+
+  Buffer(size_t size):
+    data(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      data[i] = (uint8_t)(i * 31 + 7);
+  }
+};
+
+struct ComputeCRC16: Buffer
+{
+  ComputeCRC16(size_t size): Buffer(size) { }
+  void operator()(void) { Bench::consume(CRC16::compute(&data[0], data.size())); }
+};
+
+struct ComputeCRC32: Buffer
+{
+  ComputeCRC32(size_t size): Buffer(size) { }
+  void operator()(void) { Bench::consume(CRC32::compute(&data[0], data.size(), true)); }
+};
+
+struct ComputeMD5: Buffer
+{
+  uint8_t digest[16];
+  ComputeMD5(size_t size): Buffer(size) { }
+  void operator()(void) { MD5::compute(&data[0], data.size(), digest); Bench::consume(digest[0]); }
+};
+
+int
+main(int argc, char** argv)
+{
+  Bench bench("Algorithms", argc, argv);
+
+  // Typical IMC message and a full UDP datagram (CRC32 is limited to
+  // 255 bytes per call).
+  ComputeCRC16 crc16_small(64);
+  bench.run("CRC16 64 bytes", crc16_small);
+
+  ComputeCRC16 crc16_large(1500);
+  bench.run("CRC16 1500 bytes", crc16_large);
+
+  ComputeCRC32 crc32(255);
+  bench.run("CRC32 255 bytes", crc32);
+
+  ComputeMD5 md5_small(64);
+  bench.run("MD5 64 bytes", md5_small);
+
+  ComputeMD5 md5_large(65536);
+  bench.run("MD5 64 KiB", md5_large);
+
+  return 0;
+}
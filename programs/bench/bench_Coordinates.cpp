@@ -0,0 +1,269 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+//***************************************************************************
+// Micro-benchmarks for DUNE::Coordinates.                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Math/Angles.hpp>
+#include <DUNE/Coordinates/LocalFrame.hpp>
+#include <DUNE/Coordinates/WGS84.hpp>
+#include <DUNE/Coordinates/UTM.hpp>
+
+// Local headers.
+#include "Bench.hpp"
+
+using namespace DUNE::Coordinates;
+using DUNE::Math::Angles;
+
+//! Reference location (Porto, Portugal).
+static const double c_lat = Angles::radians(41.18);
+static const double c_lon = Angles::radians(-8.70);
+
+struct Displace
+{
+  double n;
+  Displace(void): n(0) { }
+
+  void
+  operator()(void)
+  {
+    double lat = c_lat;
+    double lon = c_lon;
+    double hae = 10.0;
+    n += 0.5;
+    WGS84::displace(n, 250.0, 1.0, &lat, &lon, &hae);
+    Bench::consume(lat);
+  }
+};
+
+struct Displacement
+{
+  double lat;
+  double lon;
+  double step;
+
+  Displacement(void):
+    lat(c_lat),
+    lon(c_lon),
+    step(0)
+  {
+    double hae = 0;
+    WGS84::displace(1200.0, -300.0, 5.0, &lat, &lon, &hae);
+  }
+
+  void
+  operator()(void)
+  {
+    double n, e, d;
+    step += 1e-9;
+    WGS84::displacement(c_lat, c_lon, 0.0, lat + step, lon, 5.0, &n, &e, &d);
+    Bench::consume(n);
+  }
+};
+
+struct FrameDisplacement: Displacement
+{
+  LocalFrame frame;
+
+  FrameDisplacement(void):
+    frame(c_lat, c_lon)
+  { }
+
+  void
+  operator()(void)
+  {
+    double n, e, d;
+    step += 1e-9;
+    frame.displacement(lat + step, lon, 5.0, &n, &e, &d);
+    Bench::consume(n);
+  }
+};
+
+struct Distance
+{
+  double lat;
+  double lon;
+
+  Distance(void):
+    lat(c_lat + 1e-3),
+    lon(c_lon - 2e-3)
+  { }
+
+  void
+  operator()(void)
+  {
+    Bench::consume(WGS84::distance(c_lat, c_lon, 0.0, lat, lon, 0.0));
+  }
+};
+
+//! Number of points in batch benchmarks.
+static const size_t c_points = 1000;
+
+struct Track
+{
+  std::vector<double> lat;
+  std::vector<double> lon;
+  std::vector<double> n;
+  std::vector<double> e;
+
+  Track(void):
+    lat(c_points),
+    lon(c_points),
+    n(c_points),
+    e(c_points)
+  {
+    for (size_t i = 0; i < c_points; ++i)
+    {
+      lat[i] = c_lat + i * 1e-6;
+      lon[i] = c_lon - i * 2e-6;
+    }
+  }
+};
+
+struct DisplacementScalar: Track
+{
+  void
+  operator()(void)
+  {
+    for (size_t i = 0; i < c_points; ++i)
+      WGS84::displacement(c_lat, c_lon, 0.0, lat[i], lon[i], 0.0, &n[i], &e[i]);
+    Bench::consume(n[0]);
+  }
+};
+
+struct DisplacementBatch: Track
+{
+  void
+  operator()(void)
+  {
+    WGS84::displacement(c_lat, c_lon, 0.0, &lat[0], &lon[0], NULL, &n[0], &e[0], NULL, c_points);
+    Bench::consume(n[0]);
+  }
+};
+
+struct DisplaceScalar: Track
+{
+  void
+  operator()(void)
+  {
+    for (size_t i = 0; i < c_points; ++i)
+    {
+      double hae = 0.0;
+      lat[i] = c_lat;
+      lon[i] = c_lon;
+      WGS84::displace(i * 0.5, 250.0, 0.0, &lat[i], &lon[i], &hae);
+    }
+    Bench::consume(lat[0]);
+  }
+};
+
+struct DisplaceBatch: Track
+{
+  DisplaceBatch(void)
+  {
+    for (size_t i = 0; i < c_points; ++i)
+    {
+      n[i] = i * 0.5;
+      e[i] = 250.0;
+    }
+  }
+
+  void
+  operator()(void)
+  {
+    WGS84::displace(c_lat, c_lon, 0.0, &n[0], &e[0], NULL, &lat[0], &lon[0], NULL, c_points);
+    Bench::consume(lat[0]);
+  }
+};
+
+struct FromUTM
+{
+  void
+  operator()(void)
+  {
+    double lat, lon;
+    UTM::toWGS84(4559000.0, 524000.0, 29, true, &lat, &lon);
+    Bench::consume(lat);
+  }
+};
+
+struct ToUTM
+{
+  void
+  operator()(void)
+  {
+    double north, east;
+    int zone;
+    bool hem;
+    UTM::fromWGS84(c_lat, c_lon, &north, &east, &zone, &hem);
+    Bench::consume(north);
+  }
+};
+
+int
+main(int argc, char** argv)
+{
+  Bench bench("Coordinates", argc, argv);
+
+  Displace displace;
+  bench.run("WGS84::displace", displace);
+
+  Displacement displacement;
+  bench.run("WGS84::displacement", displacement);
+
+  FrameDisplacement frame_displacement;
+  bench.run("LocalFrame::displacement", frame_displacement);
+
+  Distance distance;
+  bench.run("WGS84::distance", distance);
+
+  DisplacementScalar displacement_scalar;
+  bench.run("WGS84::displacement x1000 (scalar)", displacement_scalar);
+
+  DisplacementBatch displacement_batch;
+  bench.run("WGS84::displacement x1000 (batch)", displacement_batch);
+
+  DisplaceScalar displace_scalar;
+  bench.run("WGS84::displace x1000 (scalar)", displace_scalar);
+
+  DisplaceBatch displace_batch;
+  bench.run("WGS84::displace x1000 (batch)", displace_batch);
+
+  FromUTM from_utm;
+  bench.run("UTM::toWGS84", from_utm);
+
+  ToUTM to_utm;
+  bench.run("UTM::fromWGS84", to_utm);
+
+  return 0;
+}
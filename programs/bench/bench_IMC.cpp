@@ -0,0 +1,148 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+//***************************************************************************
+// Micro-benchmarks for DUNE::IMC::Packet.                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstdio>
+
+// DUNE headers.
+#include <DUNE/IMC.hpp>
+
+// Local headers.
+#include "Bench.hpp"
+
+using namespace DUNE::IMC;
+
+struct Serialize
+{
+  const Message* msg;
+  uint8_t bfr[65535];
+
+  Serialize(const Message* m): msg(m) { }
+
+  void
+  operator()(void)
+  {
+    Bench::consume(Packet::serialize(msg, bfr, sizeof(bfr)));
+  }
+};
+
+struct Deserialize
+{
+  Message* msg;
+  uint8_t bfr[65535];
+  uint16_t size;
+
+  Deserialize(const Message* m):
+    msg(m->clone())
+  {
+    size = Packet::serialize(m, bfr, sizeof(bfr));
+  }
+
+  ~Deserialize(void)
+  {
+    delete msg;
+  }
+
+  void
+  operator()(void)
+  {
+    Bench::consume(Packet::deserialize(bfr, size, msg));
+  }
+};
+
+static void
+run(Bench& bench, const Message& msg)
+{
+  char name[128];
+
+  Serialize ser(&msg);
+  std::sprintf(name, "serialize %s (%u bytes)", msg.getName(), (unsigned)msg.getSerializationSize());
+  bench.run(name, ser);
+
+  Deserialize des(&msg);
+  std::sprintf(name, "deserialize %s (%u bytes)", msg.getName(), (unsigned)msg.getSerializationSize());
+  bench.run(name, des);
+}
+
+int
+main(int argc, char** argv)
+{
+  Bench bench("IMC", argc, argv);
+
+  // Navigation output, the most frequent message.
+  EstimatedState es;
+  es.lat = 0.71;
+  es.lon = -0.15;
+  es.x = es.y = es.z = 10.0;
+  es.phi = es.theta = es.psi = 0.1;
+  es.u = 1.2;
+  run(bench, es);
+
+  // String heavy.
+  Announce ann;
+  ann.sys_name = "lauv-xplore-1";
+  ann.owner = 0xffff;
+  ann.lat = 0.71;
+  ann.lon = -0.15;
+  ann.services = "imc+udp://10.0.10.100:6002/;imc+tcp://10.0.10.100:6002/;"
+    "ftp://10.0.10.100:30021/;http://10.0.10.100:8080/dune";
+  run(bench, ann);
+
+  // Nested messages.
+  PlanSpecification spec;
+  spec.plan_id = "survey";
+  for (unsigned i = 0; i < 20; ++i)
+  {
+    char id[16];
+    std::sprintf(id, "Goto%u", i);
+
+    Goto man;
+    man.lat = 0.71 + i * 1e-5;
+    man.lon = -0.15;
+    man.z = 2.0;
+    man.speed = 1.2;
+
+    PlanManeuver pm;
+    pm.maneuver_id = id;
+    pm.data.set(man);
+    spec.maneuvers.push_back(pm);
+  }
+
+  PlanDB db;
+  db.type = PlanDB::DBT_REQUEST;
+  db.op = PlanDB::DBOP_SET;
+  db.plan_id = spec.plan_id;
+  db.arg.set(spec);
+  run(bench, db);
+
+  return 0;
+}
@@ -0,0 +1,204 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+// Micro-benchmarks for DUNE::Navigation::KalmanFilter.                     *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstdio>
+
+// DUNE headers.
+#include <DUNE/Math/Matrix.hpp>
+#include <DUNE/Navigation/KalmanFilter.hpp>
+
+// Local headers.
+#include "Bench.hpp"
+
+using DUNE::Math::Matrix;
+using DUNE::Navigation::KalmanFilter;
+
+//! Filter configuration shared by the current and legacy forms.
+struct KalmanSetup
+{
+  //! Number of states.
+  int n;
+  //! Number of outputs.
+  int m;
+  //! State transition matrix.
+  Matrix a;
+  //! Observation matrix.
+  Matrix c;
+  //! Process noise.
+  Matrix q;
+  //! Measurement noise.
+  Matrix r;
+  //! Current measurements.
+  Matrix y;
+  //! Step counter.
+  unsigned k;
+
+  KalmanSetup(int states, int outputs):
+    n(states),
+    m(outputs),
+    a(states),
+    c(outputs, states, 0.0),
+    q(states),
+    r(outputs, outputs, 0.0),
+    y(outputs, 1, 0.0),
+    k(0)
+  {
+    a *= 0.99;
+    for (int i = 0; i < n - 1; ++i)
+      a(i, i + 1) = 0.05;
+
+    q *= 0.01;
+
+    for (int i = 0; i < m; ++i)
+    {
+      c(i, i % n) = 1.0;
+      c(i, (i + 1) % n) = 0.1 * (i + 1);
+      r(i, i) = 0.1 + 0.01 * i;
+    }
+  }
+
+  //! Generate the next set of measurements.
+  void
+  measure(void)
+  {
+    ++k;
+    for (int i = 0; i < m; ++i)
+      y(i) = std::sin(0.01 * k + i);
+  }
+};
+
+//! Predict and update with KalmanFilter.
+struct KalmanStep: KalmanSetup
+{
+  KalmanFilter kal;
+
+  KalmanStep(int states, int outputs):
+    KalmanSetup(states, outputs)
+  {
+    kal.reset(n, m);
+    kal.setCovariance(1.0);
+    kal.setProcessNoise(0.01);
+    kal.setTransitions(a);
+
+    for (int i = 0; i < m; ++i)
+    {
+      kal.setObservation(i, i % n, c(i, i % n));
+      kal.setObservation(i, (i + 1) % n, c(i, (i + 1) % n));
+      kal.setMeasurementNoise(i, r(i, i));
+    }
+  }
+
+  void
+  operator()(void)
+  {
+    measure();
+    kal.predict();
+
+    for (int i = 0; i < m; ++i)
+    {
+      double e = y(i);
+      for (int j = 0; j < n; ++j)
+        e -= c(i, j) * kal.getState(j);
+      kal.setInnovation(i, e);
+    }
+
+    kal.update(0.0);
+    Bench::consume(kal.getState(0));
+  }
+};
+
+//! Predict and update with the explicit inverse formulas used before
+//! the sequential/LDL' update.
+struct LegacyStep: KalmanSetup
+{
+  Matrix x;
+  Matrix p;
+  Matrix innov;
+
+  LegacyStep(int states, int outputs):
+    KalmanSetup(states, outputs),
+    x(states, 1, 0.0),
+    p(states),
+    innov(outputs, 1, 0.0)
+  { }
+
+  void
+  operator()(void)
+  {
+    measure();
+    x = a * x;
+    p = a * p * transpose(a) + q;
+
+    for (int i = 0; i < m; ++i)
+    {
+      double e = y(i);
+      for (int j = 0; j < n; ++j)
+        e -= c(i, j) * x(j);
+      innov(i) = e;
+    }
+
+    Matrix s = (c * p * transpose(c)) + r;
+    Matrix s_1 = inverse(s);
+    Matrix gain = p * transpose(c) * s_1;
+    x = x + gain * innov;
+    p = p - gain * c * p;
+    p = 0.5 * (p + transpose(p));
+    Bench::consume(x(0));
+  }
+};
+
+int
+main(int argc, char** argv)
+{
+  Bench bench("KalmanFilter", argc, argv);
+
+  // Navigation/AUV/Navigation: 9 states, 6 outputs plus 4 LBL ranges.
+  // Navigation/General/ROV: 4 states, 4 outputs plus 4 LBL ranges.
+  const int dims[][2] = {{9, 6}, {9, 10}, {4, 4}, {4, 8}};
+  for (unsigned i = 0; i < sizeof(dims) / sizeof(dims[0]); ++i)
+  {
+    char name[64];
+    int n = dims[i][0];
+    int m = dims[i][1];
+
+    LegacyStep legacy(n, m);
+    std::sprintf(name, "KalmanFilter %dx%d step (legacy)", n, m);
+    bench.run(name, legacy);
+
+    KalmanStep current(n, m);
+    std::sprintf(name, "KalmanFilter %dx%d step", n, m);
+    bench.run(name, current);
+  }
+
+  return 0;
+}
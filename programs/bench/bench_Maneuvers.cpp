@@ -0,0 +1,129 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+// Micro-benchmarks for DUNE::Maneuvers.                                    *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Math/Angles.hpp>
+#include <DUNE/Math/Constants.hpp>
+#include <DUNE/Maneuvers/Coverage.hpp>
+
+// Local headers.
+#include "Bench.hpp"
+
+using DUNE::Maneuvers::Coverage;
+using DUNE::Math::Angles;
+
+//! Reference location (Porto, Portugal).
+static const double c_lat = Angles::radians(41.18);
+static const double c_lon = Angles::radians(-8.70);
+//! Number of survey area vertices.
+static const unsigned c_vertices = 24;
+
+//! Irregular survey area about 3 km wide.
+static std::vector<Coverage::Point>
+surveyArea(void)
+{
+  std::vector<Coverage::Point> vertices(c_vertices);
+  for (unsigned i = 0; i < c_vertices; ++i)
+  {
+    double angle = 2.0 * DUNE::Math::c_pi * i / c_vertices;
+    double radius = 1500.0 + 300.0 * std::sin(3.0 * angle) + 100.0 * std::cos(7.0 * angle);
+    vertices[i].north = radius * std::cos(angle);
+    vertices[i].east = radius * std::sin(angle);
+  }
+
+  return vertices;
+}
+
+struct CoveragePlan
+{
+  std::vector<Coverage::Point> area;
+  Coverage::Parameters params;
+  Coverage::Plan plan;
+
+  CoveragePlan(unsigned threads):
+    area(surveyArea())
+  {
+    params.width = 25.0;
+    params.speed = 1.5;
+    params.turn_radius = 15.0;
+    params.run_out = 10.0;
+    params.threads = threads;
+  }
+
+  void
+  operator()(void)
+  {
+    Coverage cov;
+    cov.setPolygon(c_lat, c_lon, area);
+    cov.plan(params, plan);
+    Bench::consume(plan.duration);
+  }
+};
+
+struct CoverageReplan: CoveragePlan
+{
+  Coverage cov;
+
+  CoverageReplan(void):
+    CoveragePlan(1)
+  {
+    cov.setPolygon(c_lat, c_lon, area);
+  }
+
+  void
+  operator()(void)
+  {
+    params.speed += 1e-3;
+    cov.setPolygon(c_lat, c_lon, area);
+    cov.plan(params, plan);
+    Bench::consume(plan.duration);
+  }
+};
+
+int
+main(int argc, char** argv)
+{
+  Bench bench("Maneuvers", argc, argv);
+
+  CoveragePlan plan(1);
+  bench.run("Coverage::plan 3 km", plan);
+
+  CoveragePlan parallel(4);
+  bench.run("Coverage::plan 3 km (4 threads)", parallel);
+
+  CoverageReplan replan;
+  bench.run("Coverage::plan 3 km (cached sweeps)", replan);
+
+  return 0;
+}
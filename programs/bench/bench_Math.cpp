@@ -0,0 +1,409 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+//***************************************************************************
+// Micro-benchmarks for DUNE::Math.                                         *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Math/Matrix.hpp>
+#include <DUNE/Math/Quaternion.hpp>
+#include <DUNE/Math/EulerAnglesZyx.hpp>
+#include <DUNE/Math/KDTree.hpp>
+#include <DUNE/Math/QPSolver.hpp>
+#include <DUNE/Math/Random.hpp>
+
+// Local headers.
+#include "Bench.hpp"
+#include "QuadTree.hpp"
+
+using namespace DUNE::Math;
+
+static Matrix
+randomMatrix(int n)
+{
+  Matrix m(n, n);
+  for (int i = 0; i < m.size(); ++i)
+    m(i) = (std::rand() % 2001 - 1000) / 1000.0;
+
+  // Diagonally dominant, hence invertible.
+  for (int i = 0; i < n; ++i)
+    m(i, i) += n;
+
+  return m;
+}
+
+struct MatrixMultiply
+{
+  Matrix a, b;
+  MatrixMultiply(int n): a(randomMatrix(n)), b(randomMatrix(n)) { }
+  void operator()(void) { Bench::consume((a * b)(0)); }
+};
+
+struct MatrixAdd
+{
+  Matrix a, b;
+  MatrixAdd(int n): a(randomMatrix(n)), b(randomMatrix(n)) { }
+  void operator()(void) { Bench::consume((a + b)(0)); }
+};
+
+struct MatrixTranspose
+{
+  Matrix a;
+  MatrixTranspose(int n): a(randomMatrix(n)) { }
+  void operator()(void) { Bench::consume(transpose(a)(0)); }
+};
+
+struct MatrixInverse
+{
+  Matrix a;
+  MatrixInverse(int n): a(randomMatrix(n)) { }
+  void operator()(void) { Bench::consume(inverse(a)(0)); }
+};
+
+struct MatrixExp
+{
+  Matrix a;
+  MatrixExp(int n): a(randomMatrix(n) * (0.1 / n)) { }
+  void operator()(void) { Bench::consume(a.expmts()(0)); }
+};
+
+struct QuaternionMultiply
+{
+  Quaternion a, b;
+  QuaternionMultiply(void): a(EulerAnglesZyx(0.1, 0.2, 0.3)), b(EulerAnglesZyx(-0.3, 0.1, 2.0)) { }
+  void operator()(void) { Bench::consume((a * b).w()); }
+};
+
+struct QuaternionRotation
+{
+  Quaternion a;
+  QuaternionRotation(void): a(EulerAnglesZyx(0.1, 0.2, 0.3)) { }
+  void operator()(void) { Bench::consume(a.rotationMatrix()(0)); }
+};
+
+struct QuaternionNormalize
+{
+  Quaternion a;
+  QuaternionNormalize(void): a(1.0, 0.1, 0.2, 0.3) { }
+  void operator()(void) { Bench::consume(a.normalized().w()); }
+};
+
+struct EulerFromQuaternion
+{
+  Quaternion a;
+  EulerFromQuaternion(void): a(EulerAnglesZyx(0.1, 0.2, 0.3)) { }
+  void operator()(void) { Bench::consume(EulerAnglesZyx(a).yaw); }
+};
+
+struct EulerToQuaternion
+{
+  EulerAnglesZyx a;
+  EulerToQuaternion(void): a(0.1, 0.2, 0.3) { }
+  void operator()(void) { Bench::consume(Quaternion(a).w()); }
+};
+
+//! Thrust allocation QP: minimize |B u - tau|^2 + eps |u|^2 with
+//! |u| <= 1, tau slowly varying between calls.
+struct QPAllocation
+{
+  Matrix B, H, f, A, b, tau, x;
+  QPSolver qp;
+  bool warm;
+  int step;
+
+  QPAllocation(int n, int k, bool w):
+    B(k, n), tau(k, 1), warm(w), step(0)
+  {
+    for (int i = 0; i < B.size(); ++i)
+      B(i) = (std::rand() % 2001 - 1000) / 1000.0;
+
+    H = transpose(B) * B + Matrix(n) * 1e-3;
+    A = Matrix(2 * n, n, 0.0);
+    b = Matrix(2 * n, 1, 1.0);
+    for (int i = 0; i < n; ++i)
+    {
+      A(i, i) = 1.0;
+      A(n + i, i) = -1.0;
+    }
+  }
+
+  void
+  operator()(void)
+  {
+    for (int i = 0; i < tau.rows(); ++i)
+      tau(i) = 3.0 * std::sin(0.02 * step + i);
+    ++step;
+
+    f = transpose(B) * tau * -1.0;
+    if (warm)
+      Bench::consume(qp.minimize(H, f, A, b, x));
+    else
+      Bench::consume(QPSolver::solve(H, f, A, b, x));
+  }
+};
+
+//! Draw 64 gaussian numbers, one call per number.
+struct RandomGaussian
+{
+  Random::Generator* prng;
+  double out[64];
+  RandomGaussian(const char* id): prng(Random::Factory::create(id, 1)) { }
+  ~RandomGaussian(void) { delete prng; }
+  void
+  operator()(void)
+  {
+    for (int i = 0; i < 64; ++i)
+      out[i] = prng->gaussian();
+    Bench::consume(out[63]);
+  }
+};
+
+//! Draw 64 gaussian numbers in one batch.
+struct RandomGaussianBatch
+{
+  Random::Generator* prng;
+  double out[64];
+  RandomGaussianBatch(const char* id): prng(Random::Factory::create(id, 1)) { }
+  ~RandomGaussianBatch(void) { delete prng; }
+  void operator()(void) { prng->fillGaussian(out, 64); Bench::consume(out[63]); }
+};
+
+//! Scattered points over a 1 km x 1 km area.
+struct SpatialPoints
+{
+  std::vector<KDTree::Item> items;
+  unsigned k;
+
+  SpatialPoints(size_t count):
+    items(count),
+    k(0)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      items[i].x = 1000.0 * std::rand() / RAND_MAX;
+      items[i].y = 1000.0 * std::rand() / RAND_MAX;
+      items[i].value = 20.0 * std::rand() / RAND_MAX;
+    }
+  }
+
+  //! Next query point, spread over the area.
+  void
+  next(double& x, double& y)
+  {
+    ++k;
+    x = (k * 7919 % 1000) + 0.5;
+    y = (k * 104729 % 1000) + 0.5;
+  }
+};
+
+//! Closest point by linear scan.
+struct SpatialScan: SpatialPoints
+{
+  SpatialScan(size_t count): SpatialPoints(count) { }
+
+  void
+  operator()(void)
+  {
+    double x, y;
+    next(x, y);
+    double best = HUGE_VAL;
+    double value = 0;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+      double d = (items[i].x - x) * (items[i].x - x) + (items[i].y - y) * (items[i].y - y);
+      if (d < best)
+      {
+        best = d;
+        value = items[i].value;
+      }
+    }
+    Bench::consume(value);
+  }
+};
+
+//! Closest point with the quad-tree previously used by the
+//! Environment simulator: search a square around the query point and
+//! pick the closest item found.
+struct SpatialQuadTree: SpatialPoints
+{
+  Legacy::QuadTree tree;
+  std::vector<Legacy::QuadTree::Item> found;
+
+  SpatialQuadTree(size_t count):
+    SpatialPoints(count),
+    tree(Legacy::Bounds(Legacy::Point(500.0, 500.0), 500.0))
+  {
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+      Legacy::QuadTree::Item item = {items[i].x, items[i].y, items[i].value};
+      tree.insert(item);
+    }
+  }
+
+  void
+  operator()(void)
+  {
+    double x, y;
+    next(x, y);
+    Legacy::Point p(x, y);
+    double value = 0;
+    if (tree.search(Legacy::Bounds(p, 10.0), found))
+    {
+      double dmin = p.distance(Legacy::Point(found[0].x, found[0].y));
+      value = found[0].value;
+      for (size_t i = 1; i < found.size(); ++i)
+      {
+        double d = p.distance(Legacy::Point(found[i].x, found[i].y));
+        if (d < dmin)
+        {
+          dmin = d;
+          value = found[i].value;
+        }
+      }
+    }
+    Bench::consume(value);
+  }
+};
+
+//! Closest point with a k-d tree.
+struct SpatialNearest: SpatialPoints
+{
+  KDTree tree;
+  SpatialNearest(size_t count): SpatialPoints(count) { tree.build(items); }
+
+  void
+  operator()(void)
+  {
+    double x, y;
+    next(x, y);
+    size_t index = 0;
+    tree.nearest(x, y, index, 10.0);
+    Bench::consume(tree[index].value);
+  }
+};
+
+//! Forward-looking ray against points taken as 1 m discs.
+struct SpatialRaycast: SpatialNearest
+{
+  SpatialRaycast(size_t count): SpatialNearest(count) { }
+
+  void
+  operator()(void)
+  {
+    double x, y;
+    next(x, y);
+    double range = 0;
+    size_t index;
+    tree.raycast(x, y, std::cos((double)k), std::sin((double)k), 100.0, 1.0, range, index);
+    Bench::consume(range);
+  }
+};
+
+int
+main(int argc, char** argv)
+{
+  Bench bench("Math", argc, argv);
+  std::srand(1);
+
+  const int sizes[] = {3, 6, 9, 12};
+  for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+  {
+    char name[64];
+    int n = sizes[i];
+
+    MatrixMultiply mul(n);
+    std::sprintf(name, "Matrix multiply %dx%d", n, n);
+    bench.run(name, mul);
+
+    MatrixAdd add(n);
+    std::sprintf(name, "Matrix add %dx%d", n, n);
+    bench.run(name, add);
+
+    MatrixTranspose tr(n);
+    std::sprintf(name, "Matrix transpose %dx%d", n, n);
+    bench.run(name, tr);
+
+    MatrixInverse inv(n);
+    std::sprintf(name, "Matrix inverse %dx%d", n, n);
+    bench.run(name, inv);
+
+    MatrixExp exp(n);
+    std::sprintf(name, "Matrix expmts %dx%d", n, n);
+    bench.run(name, exp);
+  }
+
+  QuaternionMultiply qmul;
+  bench.run("Quaternion multiply", qmul);
+
+  QuaternionRotation qrot;
+  bench.run("Quaternion rotationMatrix", qrot);
+
+  QuaternionNormalize qnorm;
+  bench.run("Quaternion normalized", qnorm);
+
+  EulerFromQuaternion e_from_q;
+  bench.run("EulerAnglesZyx from Quaternion", e_from_q);
+
+  EulerToQuaternion e_to_q;
+  bench.run("Quaternion from EulerAnglesZyx", e_to_q);
+
+  QPAllocation qp_cold(6, 4, false);
+  bench.run("QPSolver solve 6x12 (static)", qp_cold);
+
+  QPAllocation qp_warm(6, 4, true);
+  bench.run("QPSolver minimize 6x12 (warm)", qp_warm);
+
+  RandomGaussian fsr_gauss(Random::Factory::c_fsr256);
+  bench.run("Random fsr256 gaussian x64", fsr_gauss);
+
+  RandomGaussian xo_gauss(Random::Factory::c_xoshiro256);
+  bench.run("Random xoshiro256 gaussian x64", xo_gauss);
+
+  RandomGaussianBatch xo_batch(Random::Factory::c_xoshiro256);
+  bench.run("Random xoshiro256 fillGaussian 64", xo_batch);
+
+  SpatialScan kd_scan(10000);
+  bench.run("KDTree 10k linear scan", kd_scan);
+
+  SpatialQuadTree qt_nearest(10000);
+  bench.run("QuadTree 10k nearest", qt_nearest);
+
+  SpatialNearest kd_nearest(10000);
+  bench.run("KDTree 10k nearest", kd_nearest);
+
+  SpatialRaycast kd_ray(10000);
+  bench.run("KDTree 10k raycast 100 m", kd_ray);
+
+  return 0;
+}
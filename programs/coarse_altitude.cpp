@@ -62,116 +62,109 @@ createCA(DUNE::Control::CoarseAltitude::Arguments* args)
   args->sample_limit = 2;
 }
 
-int
-main(int32_t argc, char** argv)
+//! Replay of coarse altitude control over a log.
+class CoarseAltitudeReplay: public IMC::LogProcessor
 {
-  if (argc <= 1)
+public:
+  CoarseAltitudeReplay(DUNE::Control::CoarseAltitude::Arguments* args, const char* output):
+    m_lsf(output, std::ios::binary),
+    m_bottom_follow_depth(-1.0),
+    m_vertical_ref(-1.0),
+    m_got_state(false),
+    m_ca(args)
   {
-    std::cerr << "Usage: " << argv[0] << " <path_to_log/Data.lsf[.gz]>"
-              << std::endl;
-    return 1;
+    bind<IMC::EstimatedState>(this);
+    bind<IMC::DesiredZ>(this);
+    bind<IMC::LoggingControl>(this);
   }
 
-  std::istream* is = 0;
-  Compression::Methods method = Compression::Factory::detect(argv[1]);
-  if (method == METHOD_UNKNOWN)
-    is = new std::ifstream(argv[1], std::ios::binary);
-  else
-    is = new Compression::FileInput(argv[1], method);
+  void
+  consume(const IMC::EstimatedState* state)
+  {
+    if (!m_got_state)
+    {
+      m_last_state = *state;
+      m_got_state = true;
+      return;
+    }
+
+    write(state);
 
-  IMC::Message* msg = NULL;
+    if (m_bottom_follow_depth > 0.0)
+    {
+      m_bottom_follow_depth = state->depth + (state->alt - m_vertical_ref);
+      m_parcel.p = m_bottom_follow_depth;
+      m_parcel.i = m_ca.update(state->getTimeStamp() - m_last_state.getTimeStamp(),
+                               state->depth, m_bottom_follow_depth);
+      m_parcel.d = state->depth - m_bottom_follow_depth;
+      // m_parcel.a = state->depth - m_parcel.i;
+      m_parcel.a = m_ca.getCorridor();
 
-  std::ofstream lsf("Data.lsf", std::ios::binary);
+      m_parcel.setTimeStamp(state->getTimeStamp());
 
-  DUNE::Utils::ByteBuffer buffer;
+      write(&m_parcel);
+    }
 
-  float bottom_follow_depth = -1.0;
-  float vertical_ref = -1.0;
+    m_last_state = *state;
+  }
 
-  // Control parcel for debug
-  IMC::ControlParcel parcel;
+  void
+  consume(const IMC::DesiredZ* msg)
+  {
+    if (msg->z_units == IMC::Z_ALTITUDE)
+    {
+      m_vertical_ref = msg->value;
+      m_bottom_follow_depth = m_last_state.depth;
+    }
 
-  // Last EstimatedState
-  IMC::EstimatedState last_state;
-  bool got_state = false;
+    write(msg);
+  }
 
+  void
+  consume(const IMC::LoggingControl* msg)
+  {
+    write(msg);
+  }
+
+private:
+  std::ofstream m_lsf;
+  DUNE::Utils::ByteBuffer m_buffer;
+  float m_bottom_follow_depth;
+  float m_vertical_ref;
+  // Control parcel for debug
+  IMC::ControlParcel m_parcel;
+  // Last EstimatedState
+  IMC::EstimatedState m_last_state;
+  bool m_got_state;
   // Coarse altitude control
-  DUNE::Control::CoarseAltitude::Arguments args;
-  createCA(&args);
-  DUNE::Control::CoarseAltitude ca(&args);
+  DUNE::Control::CoarseAltitude m_ca;
 
-  try
+  void
+  write(const IMC::Message* msg)
   {
-    while ((msg = IMC::Packet::deserialize(*is)) != 0)
-    {
-      if (msg->getId() == DUNE_IMC_ESTIMATEDSTATE)
-      {
-        IMC::EstimatedState* state = static_cast<IMC::EstimatedState*>(msg);
-
-        if (!got_state)
-        {
-          last_state = *state;
-          got_state = true;
-        }
-        else
-        {
-          IMC::Packet::serialize(state, buffer);
-          lsf.write(buffer.getBufferSigned(), buffer.getSize());
-          buffer.resetBuffer();
-
-          if (bottom_follow_depth > 0.0)
-          {
-            bottom_follow_depth = state->depth + (state->alt - vertical_ref);
-            parcel.p = bottom_follow_depth;
-            parcel.i = ca.update(state->getTimeStamp() - last_state.getTimeStamp(),
-                                 state->depth, bottom_follow_depth);
-            parcel.d = state->depth - bottom_follow_depth;
-            // parcel.a = state->depth - parcel.i;
-            parcel.a = ca.getCorridor();
-
-            parcel.setTimeStamp(state->getTimeStamp());
-
-            IMC::Packet::serialize(&parcel, buffer);
-            lsf.write(buffer.getBufferSigned(), buffer.getSize());
-            buffer.resetBuffer();
-          }
-
-          last_state = *state;
-        }
-      }
-      else if (msg->getId() == DUNE_IMC_DESIREDZ)
-      {
-        IMC::DesiredZ* ptr = static_cast<IMC::DesiredZ*>(msg);
-
-        if (ptr->z_units == IMC::Z_ALTITUDE)
-        {
-          vertical_ref = ptr->value;
-          bottom_follow_depth = last_state.depth;
-        }
-
-        IMC::Packet::serialize(ptr, buffer);
-        lsf.write(buffer.getBufferSigned(), buffer.getSize());
-        buffer.resetBuffer();
-      }
-      else if (msg->getId() == DUNE_IMC_LOGGINGCONTROL)
-      {
-        IMC::LoggingControl* ptr = static_cast<IMC::LoggingControl*>(msg);
-        IMC::Packet::serialize(ptr, buffer);
-        lsf.write(buffer.getBufferSigned(), buffer.getSize());
-        buffer.resetBuffer();
-      }
-
-      delete msg;
-    }
+    IMC::Packet::serialize(msg, m_buffer);
+    m_lsf.write(m_buffer.getBufferSigned(), m_buffer.getSize());
+    m_buffer.resetBuffer();
   }
-  catch (std::runtime_error& e)
+};
+
+int
+main(int32_t argc, char** argv)
+{
+  if (argc <= 1)
   {
-    std::cerr << "ERROR: " << e.what() << std::endl;
+    std::cerr << "Usage: " << argv[0] << " <path_to_log/Data.lsf[.gz]>"
+              << std::endl;
+    return 1;
   }
 
-  lsf.close();
+  DUNE::Control::CoarseAltitude::Arguments args;
+  createCA(&args);
+
+  CoarseAltitudeReplay replay(&args, "Data.lsf");
 
-  delete is;
+  if (!replay.process(argv[1]))
+    std::cerr << "ERROR: " << replay.getError() << std::endl;
 
   return 0;
 }
@@ -73,155 +73,200 @@ const float c_max_speed = 6.0;
 // Timestep
 const float c_timestep = 0.5;
 
-int
-main(int32_t argc, char** argv)
+struct Arguments
 {
-  if (argc <= 1)
+  //! Minimum rpm to consider the vehicle moving.
+  float min_rpm;
+  //! Maximum speed to consider when integrating.
+  float max_speed;
+  //! Minimum time between integrated states.
+  float timestep;
+};
+
+//! Distance travelled in a single log.
+class DistanceTravelled: public IMC::LogProcessor
+{
+public:
+  DistanceTravelled(const Arguments& args):
+    log_name("unknown"),
+    distance(0.0),
+    duration(0.0),
+    ignore(false),
+    m_args(args),
+    m_curr_rpm(0),
+    m_got_state(false),
+    m_last_lat(0.0),
+    m_last_lon(0.0),
+    m_got_name(false),
+    m_sys_id(0xffff)
   {
-    std::cerr << "Usage: " << argv[0] << " <path_to_log_1/Data.lsf[.gz]> ... <path_to_log_n/Data.lsf[.gz]>"
-              << std::endl;
-    return 1;
+    bind<IMC::Announce>(this);
+    bind<IMC::LoggingControl>(this);
+    bind<IMC::EstimatedState>(this);
+    bind<IMC::Rpm>(this);
+    bind<IMC::SimulatedState>(this);
   }
 
-  std::map<std::string, Vehicle> vehicles;
-
-  for (int32_t i = 1; i < argc; ++i)
+  void
+  consume(const IMC::Announce* msg)
   {
-    std::istream* is = 0;
-    Compression::Methods method = Compression::Factory::detect(argv[i]);
-    if (method == METHOD_UNKNOWN)
-      is = new std::ifstream(argv[i], std::ios::binary);
-    else
-      is = new Compression::FileInput(argv[i], method);
-
-    IMC::Message* msg = NULL;
+    if (m_sys_id == msg->getSource())
+      sys_name = msg->sys_name;
+  }
 
-    uint16_t curr_rpm = 0;
+  void
+  consume(const IMC::LoggingControl* msg)
+  {
+    if (!m_got_name && msg->op == IMC::LoggingControl::COP_STARTED)
+    {
+      m_sys_id = msg->getSource();
+      log_name = msg->name;
+      m_got_name = true;
+
+      // ignore idles
+      // either has the string _idle or has only the time.
+      if (log_name.find("_idle") != std::string::npos ||
+          log_name.size() == 15)
+      {
+        ignore = true;
+        reason = "this is an idle log";
+        stop();
+      }
+    }
+  }
 
-    bool got_state = false;
-    IMC::EstimatedState estate;
-    double last_lat;
-    double last_lon;
+  void
+  consume(const IMC::EstimatedState* msg)
+  {
+    if (msg->getTimeStamp() - m_estate.getTimeStamp() <= m_args.timestep)
+      return;
 
-    // Accumulated travelled distance
-    double distance = 0.0;
-    // Accumulated travelled time
-    double duration = 0.0;
+    if (!m_got_state)
+    {
+      m_estate = *msg;
+      Coordinates::toWGS84(*msg, m_last_lat, m_last_lon);
 
-    bool got_name = false;
-    std::string log_name = "unknown";
+      m_got_state = true;
+    }
+    else if (m_curr_rpm > m_args.min_rpm)
+    {
+      double lat, lon;
+      Coordinates::toWGS84(*msg, lat, lon);
 
-    bool ignore = false;
-    uint16_t sys_id = 0xffff;
-    std::string sys_name;
+      double dist = Coordinates::WGS84::distance(m_last_lat, m_last_lon, 0.0,
+                                                 lat, lon, 0.0);
 
-    try
-    {
-      while ((msg = IMC::Packet::deserialize(*is)) != 0)
+      // Not faster than maximum considered speed
+      if (dist / (msg->getTimeStamp() - m_estate.getTimeStamp()) < m_args.max_speed)
       {
-        if (msg->getId() == DUNE_IMC_ANNOUNCE)
-        {
-          IMC::Announce* ptr = static_cast<IMC::Announce*>(msg);
-          if (sys_id == ptr->getSource())
-          {
-            sys_name = ptr->sys_name;
-          }
-        }
-        else if (msg->getId() == DUNE_IMC_LOGGINGCONTROL)
-        {
-          if (!got_name)
-          {
-            IMC::LoggingControl* ptr = static_cast<IMC::LoggingControl*>(msg);
-
-            if (ptr->op == IMC::LoggingControl::COP_STARTED)
-            {
-              sys_id = ptr->getSource();
-              log_name = ptr->name;
-              got_name = true;
-            }
-          }
-        }
-        else if (msg->getId() == DUNE_IMC_ESTIMATEDSTATE)
-        {
-          if (msg->getTimeStamp() - estate.getTimeStamp() > c_timestep)
-          {
-            IMC::EstimatedState* ptr = static_cast<IMC::EstimatedState*>(msg);
-
-            if (!got_state)
-            {
-              estate = *ptr;
-              Coordinates::toWGS84(*ptr, last_lat, last_lon);
-
-              got_state = true;
-            }
-            else if (curr_rpm > c_min_rpm)
-            {
-              double lat, lon;
-              Coordinates::toWGS84(*ptr, lat, lon);
-
-              double dist = Coordinates::WGS84::distance(last_lat, last_lon, 0.0,
-                                                         lat, lon, 0.0);
-
-              // Not faster than maximum considered speed
-              if (dist / (ptr->getTimeStamp() - estate.getTimeStamp()) < c_max_speed)
-              {
-                distance += dist;
-                duration += msg->getTimeStamp() - estate.getTimeStamp();
-              }
-
-              estate = *ptr;
-              last_lat = lat;
-              last_lon = lon;
-            }
-          }
-        }
-        else if (msg->getId() == DUNE_IMC_RPM)
-        {
-          IMC::Rpm* ptr = static_cast<IMC::Rpm*>(msg);
-          curr_rpm = ptr->value;
-        }
-        else if (msg->getId() == DUNE_IMC_SIMULATEDSTATE)
-        {
-          // since it has simulated state let us ignore this log
-          ignore = true;
-          delete msg;
-          std::cerr << "this is a simulated log";
-          break;
-        }
-
-        delete msg;
-
-        // ignore idles
-        // either has the string _idle or has only the time.
-        if (log_name.find("_idle") != std::string::npos ||
-            log_name.size() == 15)
-        {
-          ignore = true;
-          std::cerr << "this is an idle log";
-          break;
-        }
+        distance += dist;
+        duration += msg->getTimeStamp() - m_estate.getTimeStamp();
       }
+
+      m_estate = *msg;
+      m_last_lat = lat;
+      m_last_lon = lon;
     }
-    catch (std::runtime_error& e)
-    {
-      std::cerr << "ERROR: " << e.what() << std::endl;
-    }
+  }
+
+  void
+  consume(const IMC::Rpm* msg)
+  {
+    m_curr_rpm = msg->value;
+  }
 
-    delete is;
+  void
+  consume(const IMC::SimulatedState* msg)
+  {
+    (void)msg;
+
+    // since it has simulated state let us ignore this log
+    ignore = true;
+    reason = "this is a simulated log";
+    stop();
+  }
+
+  //! Name of the log.
+  std::string log_name;
+  //! Name of the system.
+  std::string sys_name;
+  //! Accumulated travelled distance.
+  double distance;
+  //! Accumulated travelled time.
+  double duration;
+  //! True if the log must be ignored.
+  bool ignore;
+  //! Reason to ignore the log.
+  std::string reason;
+
+private:
+  const Arguments& m_args;
+  uint16_t m_curr_rpm;
+  bool m_got_state;
+  IMC::EstimatedState m_estate;
+  double m_last_lat;
+  double m_last_lon;
+  bool m_got_name;
+  uint16_t m_sys_id;
+};
 
-    if (ignore)
+//! Distance travelled per vehicle.
+struct Vehicles
+{
+  std::map<std::string, Vehicle> vehicles;
+
+  void
+  reduce(DistanceTravelled& log)
+  {
+    if (!log.getError().empty())
+      std::cerr << "ERROR: " << log.getError() << std::endl;
+
+    if (log.ignore)
     {
-      std::cerr << "... ignoring" << std::endl;
-      continue;
+      std::cerr << log.reason << "... ignoring" << std::endl;
+      return;
     }
 
-    if (distance > 0)
+    if (log.distance > 0)
     {
-      vehicles[sys_name].duration += duration;
-      vehicles[sys_name].distance += distance;
-      vehicles[sys_name].logs.push_back(Log(log_name, distance, duration));
+      vehicles[log.sys_name].duration += log.duration;
+      vehicles[log.sys_name].distance += log.distance;
+      vehicles[log.sys_name].logs.push_back(Log(log.log_name, log.distance, log.duration));
     }
   }
+};
+
+int
+main(int32_t argc, char** argv)
+{
+  if (argc <= 1)
+  {
+    std::cerr << "Usage: " << argv[0] << " [-j <threads>] <path_to_log_1/Data.lsf[.gz]> ... <path_to_log_n/Data.lsf[.gz]>"
+              << std::endl;
+    return 1;
+  }
+
+  int32_t start_index = 1;
+  unsigned threads = 0;
+
+  if (argc > 2 && strcmp(argv[1], "-j") == 0)
+  {
+    threads = std::atoi(argv[2]);
+    start_index = 3;
+  }
+
+  std::vector<std::string> paths(argv + start_index, argv + argc);
+
+  Arguments args;
+  args.min_rpm = c_min_rpm;
+  args.max_speed = c_max_speed;
+  args.timestep = c_timestep;
+
+  Vehicles result;
+  IMC::LogMapReduce<DistanceTravelled, Arguments> logs(args, threads);
+  logs.run(paths, result);
+
+  std::map<std::string, Vehicle>& vehicles = result.vehicles;
 
   double total_distance = 0;
   double total_duration = 0;
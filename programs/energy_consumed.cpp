@@ -50,190 +50,248 @@ const unsigned c_samples = 7;
 // Minimum number of samples before starting to count energy
 const unsigned c_min_samples = 20;
 
-int
-main(int32_t argc, char** argv)
+using Monitors::FuelLevel::BatteryData;
+
+struct Arguments
 {
-  if (argc <= 1)
+  //! Entity label of voltage measurements.
+  std::string volt_label;
+  //! Entity label of current measurements.
+  std::string curr_label;
+};
+
+//! Energy consumed in a single log.
+class EnergyConsumed: public DUNE::IMC::LogProcessor
+{
+public:
+  EnergyConsumed(const Arguments& args):
+    log_name("unknown"),
+    accum(0.0),
+    deviation(0.0),
+    motor_accum(0.0),
+    ignore(false),
+    m_args(args),
+    m_bdata(c_wsizes),
+    m_got_name(false),
+    m_volt_entity_set(false),
+    m_curr_entity_set(false),
+    m_entities_set(false),
+    m_samples(0),
+    m_last_timestamp(0.0),
+    m_rpm(0.0)
   {
-    std::cerr << "Usage: " << argv[0] << " <path_to_log_1/Data.lsf[.gz]> ... <path_to_log_n/Data.lsf[.gz]>"
-              << std::endl;
-    std::cerr << "Or: " << argv[0] << "-e <Voltage Entity Label> <Current Entity Label> <path_to_log_1/Data.lsf[.gz]> ... <path_to_log_n/Data.lsf[.gz]>"
-              << std::endl;
-    return 1;
+    for (unsigned k = 0; k < BatteryData::BM_TOTAL; k++)
+      m_eids[k] = 0;
+
+    bind<DUNE::IMC::LoggingControl>(this);
+    bind<DUNE::IMC::EntityInfo>(this);
+    bind<DUNE::IMC::Voltage>(this);
+    bind<DUNE::IMC::Current>(this);
+    bind<DUNE::IMC::Rpm>(this);
+    bind<DUNE::IMC::SimulatedState>(this);
   }
 
-  std::string volt_label;
-  std::string curr_label;
+  void
+  consume(const DUNE::IMC::LoggingControl* msg)
+  {
+    if (!m_got_name && msg->op == DUNE::IMC::LoggingControl::COP_STARTED)
+    {
+      log_name = msg->name;
+      m_got_name = true;
+    }
+  }
+
+  void
+  consume(const DUNE::IMC::EntityInfo* msg)
+  {
+    if (msg->label.compare(m_args.volt_label) == 0)
+    {
+      m_eids[BatteryData::BM_VOLTAGE] = msg->id;
+      m_volt_entity_set = true;
+    }
 
-  unsigned start_index = 1;
+    if (msg->label.compare(m_args.curr_label) == 0)
+    {
+      m_eids[BatteryData::BM_CURRENT] = msg->id;
+      m_curr_entity_set = true;
+    }
+
+    if (!m_entities_set && m_volt_entity_set && m_curr_entity_set)
+    {
+      m_bdata.setEntities(m_eids);
+      m_entities_set = true;
+    }
+  }
 
-  if (strcmp(argv[1], "-e") == 0)
+  void
+  consume(const DUNE::IMC::Voltage* msg)
   {
-    if (argc < 5)
+    if (m_entities_set)
     {
-      std::cerr << "Too few arguments" << std::endl;
-      return 1;
+      m_bdata.update(msg);
+      ++m_samples;
+
+      if (m_samples > c_min_samples)
+      {
+        float delta = msg->getTimeStamp() - m_last_timestamp;
+        float drop = m_bdata.getEnergyDrop(delta);
+        accum += drop;
+        // Overlapping windows have correlated errors: add deviations.
+        deviation += m_bdata.getEnergyDropDeviation(delta);
+
+        if (m_rpm > c_min_rpm)
+          motor_accum += drop;
+      }
     }
 
-    volt_label = argv[2];
-    curr_label = argv[3];
+    m_last_timestamp = msg->getTimeStamp();
+  }
 
-    start_index = 4;
+  void
+  consume(const DUNE::IMC::Current* msg)
+  {
+    if (m_entities_set)
+      m_bdata.update(msg);
   }
-  else
+
+  void
+  consume(const DUNE::IMC::Rpm* msg)
   {
-    volt_label = c_label;
-    curr_label = c_label;
+    m_rpm = msg->value;
   }
 
+  void
+  consume(const DUNE::IMC::SimulatedState* msg)
+  {
+    (void)msg;
+
+    // since it has simulated state let us ignore this log
+    ignore = true;
+    stop();
+  }
+
+  //! Name of the log.
+  std::string log_name;
+  //! Energy consumed.
+  double accum;
+  //! Standard deviation of the energy consumed.
+  double deviation;
+  //! Energy consumed while the motor was on.
+  double motor_accum;
+  //! True if the log must be ignored.
+  bool ignore;
+
+private:
+  //! Moving average window sizes.
+  static const unsigned c_wsizes[BatteryData::BM_TOTAL];
+  //! Arguments.
+  const Arguments& m_args;
+  //! Energy computation related data.
+  BatteryData m_bdata;
+  //! Entity identifiers of measurements.
+  unsigned m_eids[BatteryData::BM_TOTAL];
+  bool m_got_name;
+  bool m_volt_entity_set;
+  bool m_curr_entity_set;
+  bool m_entities_set;
+  unsigned m_samples;
+  double m_last_timestamp;
+  //! Current rpm value.
+  float m_rpm;
+};
+
+const unsigned EnergyConsumed::c_wsizes[BatteryData::BM_TOTAL] = {c_samples, c_samples, c_samples};
+
+//! Totals over all logs.
+struct Totals
+{
   // Total of energy spent
-  double total_accum = 0.0;
+  double accum;
+  // Variance of the total energy spent (logs are independent)
+  double variance;
   // Total energy spent while the motor was on
-  double motor_total_accum = 0.0;
+  double motor_accum;
 
-  // Moving average window sizes
-  unsigned wsizes[Monitors::FuelLevel::BatteryData::BM_TOTAL];
+  Totals(void):
+    accum(0.0),
+    variance(0.0),
+    motor_accum(0.0)
+  { }
 
-  for (unsigned k = 0; k < Monitors::FuelLevel::BatteryData::BM_TOTAL; k++)
-    wsizes[k] = c_samples;
-
-  for (int32_t i = start_index; i < argc; ++i)
+  void
+  reduce(EnergyConsumed& log)
   {
-    std::istream* is = 0;
-    DUNE::Compression::Methods method = DUNE::Compression::Factory::detect(argv[i]);
-    if (method == DUNE::Compression::METHOD_UNKNOWN)
-      is = new std::ifstream(argv[i], std::ios::binary);
-    else
-      is = new DUNE::Compression::FileInput(argv[i], method);
-
-    DUNE::IMC::Message* msg = NULL;
-
-    bool got_name = false;
-    std::string log_name = "unknown";
-
-    // Energy computation related data
-    Monitors::FuelLevel::BatteryData bdata(wsizes);
-    bool volt_entity_set = false;
-    bool curr_entity_set = false;
-    bool entities_set = false;
-    unsigned eids[Monitors::FuelLevel::BatteryData::BM_TOTAL] = {0};
-    unsigned samples = 0;
-    double last_timestamp = 0.0;
-    double accum = 0.0;
-
-    // Current rpm value
-    float rpm = 0.0;
-
-    // Ignore some logs
-    bool ignore = false;
-
-    try
-    {
-      while ((msg = DUNE::IMC::Packet::deserialize(*is)) != 0)
-      {
+    if (!log.getError().empty())
+      std::cerr << "ERROR: " << log.getError() << std::endl;
 
-        if (msg->getId() == DUNE_IMC_LOGGINGCONTROL)
-        {
-          if (!got_name)
-          {
-            DUNE::IMC::LoggingControl* ptr = static_cast<DUNE::IMC::LoggingControl*>(msg);
-
-            if (ptr->op == DUNE::IMC::LoggingControl::COP_STARTED)
-            {
-              log_name = ptr->name;
-              got_name = true;
-            }
-          }
-        }
-        else if (msg->getId() == DUNE_IMC_ENTITYINFO)
-        {
-          DUNE::IMC::EntityInfo* ptr = static_cast<DUNE::IMC::EntityInfo*>(msg);
-
-          if (ptr->label.compare(volt_label) == 0)
-          {
-            eids[Monitors::FuelLevel::BatteryData::BM_VOLTAGE] = ptr->id;
-            volt_entity_set = true;
-          }
-
-          if (ptr->label.compare(curr_label) == 0)
-          {
-            eids[Monitors::FuelLevel::BatteryData::BM_CURRENT] = ptr->id;
-            curr_entity_set = true;
-          }
-
-          if (!entities_set && volt_entity_set && curr_entity_set)
-          {
-            bdata.setEntities(eids);
-            entities_set = true;
-          }
-        }
-        else if (msg->getId() == DUNE_IMC_VOLTAGE)
-        {
-          if (entities_set)
-          {
-            DUNE::IMC::Voltage* ptr = static_cast<DUNE::IMC::Voltage*>(msg);
-            bdata.update(ptr);
-            ++samples;
-
-            if (samples > c_min_samples)
-            {
-              float drop = bdata.getEnergyDrop(msg->getTimeStamp() - last_timestamp);
-              accum += drop;
-
-              if (rpm > c_min_rpm)
-                motor_total_accum += drop;
-            }
-          }
-
-          last_timestamp = msg->getTimeStamp();
-        }
-        else if (msg->getId() == DUNE_IMC_CURRENT)
-        {
-          if (entities_set)
-          {
-            DUNE::IMC::Current* ptr = static_cast<DUNE::IMC::Current*>(msg);
-            bdata.update(ptr);
-          }
-        }
-        else if (msg->getId() == DUNE_IMC_RPM)
-        {
-          DUNE::IMC::Rpm* ptr = static_cast<DUNE::IMC::Rpm*>(msg);
-          rpm = ptr->value;
-        }
-        else if (msg->getId() == DUNE_IMC_SIMULATEDSTATE)
-        {
-          // since it has simulated state let us ignore this log
-          ignore = true;
-          delete msg;
-          std::cerr << "this is a simulated log";
-          break;
-        }
-
-        delete msg;
-      }
-    }
-    catch (std::runtime_error& e)
+    if (log.ignore)
     {
-      std::cerr << "ERROR: " << e.what() << std::endl;
+      std::cerr << "this is a simulated log... ignoring" << std::endl;
+      return;
     }
 
-    delete is;
+    std::cerr << "Consumed " << log.accum << " (+/- " << 1.96 * log.deviation
+              << ") in " << log.log_name << "." << std::endl;
+
+    accum += log.accum;
+    variance += log.deviation * log.deviation;
+    motor_accum += log.motor_accum;
+  }
+};
 
-    if (ignore)
+int
+main(int32_t argc, char** argv)
+{
+  if (argc <= 1)
+  {
+    std::cerr << "Usage: " << argv[0] << " [-j <threads>] <path_to_log_1/Data.lsf[.gz]> ... <path_to_log_n/Data.lsf[.gz]>"
+              << std::endl;
+    std::cerr << "Or: " << argv[0] << " [-j <threads>] -e <Voltage Entity Label> <Current Entity Label> <path_to_log_1/Data.lsf[.gz]> ... <path_to_log_n/Data.lsf[.gz]>"
+              << std::endl;
+    return 1;
+  }
+
+  Arguments args;
+
+  int32_t start_index = 1;
+  unsigned threads = 0;
+
+  if (argc > 2 && strcmp(argv[start_index], "-j") == 0)
+  {
+    threads = std::atoi(argv[start_index + 1]);
+    start_index += 2;
+  }
+
+  if (start_index < argc && strcmp(argv[start_index], "-e") == 0)
+  {
+    if (argc < start_index + 4)
     {
-      std::cerr << "... ignoring" << std::endl;
-      continue;
+      std::cerr << "Too few arguments" << std::endl;
+      return 1;
     }
 
-    std::cerr << "Consumed " << accum << " in " << log_name << "." << std::endl;
+    args.volt_label = argv[start_index + 1];
+    args.curr_label = argv[start_index + 2];
 
-    total_accum += accum;
+    start_index += 3;
+  }
+  else
+  {
+    args.volt_label = c_label;
+    args.curr_label = c_label;
   }
 
-  std::cerr << "Total energy consumed is " << total_accum << "Wh" << std::endl
-            << "The amount of " << motor_total_accum
+  std::vector<std::string> paths(argv + start_index, argv + argc);
+
+  Totals totals;
+  DUNE::IMC::LogMapReduce<EnergyConsumed, Arguments> logs(args, threads);
+  logs.run(paths, totals);
+
+  std::cerr << "Total energy consumed is " << totals.accum << "Wh (+/- "
+            << 1.96 * std::sqrt(totals.variance) << "Wh)" << std::endl
+            << "The amount of " << totals.motor_accum
             << std::fixed << std::setprecision(1)
-            << "Wh (" << motor_total_accum / total_accum * 100.0
+            << "Wh (" << totals.motor_accum / totals.accum * 100.0
             << "%) was consumed while the motor was on" << std::endl;
 
   return 0;
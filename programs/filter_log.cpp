@@ -35,18 +35,127 @@
 #include <cstring>
 #include <cstdlib>
 #include <map>
+#include <set>
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
 using DUNE_NAMESPACES;
 
+struct Arguments
+{
+  //! Identifiers of messages to keep.
+  std::vector<uint32_t> ids;
+};
+
+//! Messages of a single log that pass the filter, serialized.
+class FilterLog: public IMC::LogProcessor
+{
+public:
+  FilterLog(const Arguments& args):
+    count(0)
+  {
+    bind(this, args.ids);
+  }
+
+  void
+  consume(const IMC::Message* msg)
+  {
+    IMC::Packet::serialize(msg, m_buffer);
+    data.append(m_buffer.getBufferSigned(), m_buffer.getSize());
+
+    ++count;
+  }
+
+  //! Serialized messages.
+  std::string data;
+  //! Number of messages.
+  uint32_t count;
+
+private:
+  ByteBuffer m_buffer;
+};
+
+//! Find the time of the first message of the logs, filtered or not.
+//! @param[in] paths paths to log files.
+//! @param[out] time time stamp.
+//! @return true if a message was found before any error.
+static bool
+getFirstTime(const std::vector<std::string>& paths, double& time)
+{
+  for (size_t i = 0; i < paths.size(); ++i)
+  {
+    try
+    {
+      IMC::LogReader reader(paths[i]);
+      IMC::Message* msg = reader.read();
+      if (msg == NULL)
+        continue;
+
+      time = msg->getTimeStamp();
+      delete msg;
+      return true;
+    }
+    catch (std::runtime_error& e)
+    {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+//! Concatenation of the filtered logs. Messages read before an error
+//! are kept and no further logs are written.
+struct Output
+{
+  std::ofstream lsf;
+  uint32_t accum;
+  bool failed;
+
+  Output(const char* path, const std::vector<std::string>& paths):
+    lsf(path, std::ios::binary),
+    accum(0),
+    failed(false)
+  {
+    double time = 0;
+    if (getFirstTime(paths, time))
+    {
+      // place an empty estimatedstate message in the log
+      ByteBuffer buffer;
+      IMC::EstimatedState state;
+      state.setTimeStamp(time);
+      IMC::Packet::serialize(&state, buffer);
+      lsf.write(buffer.getBufferSigned(), buffer.getSize());
+    }
+  }
+
+  void
+  reduce(FilterLog& log)
+  {
+    if (failed)
+      return;
+
+    lsf.write(log.data.data(), log.data.size());
+
+    if (!log.getError().empty())
+    {
+      std::cerr << "ERROR: " << log.getError() << std::endl;
+      failed = true;
+      return;
+    }
+
+    std::cerr << log.count << " messages in " << log.getPath() << std::endl;
+    accum += log.count;
+  }
+};
+
 int
 main(int32_t argc, char** argv)
 {
   if (argc < 2)
   {
-    std::cerr << "Usage: " << argv[0] << " <abbrev of imc message 1>,<abbrev of imc message 2>,..,"
+    std::cerr << "Usage: " << argv[0] << " [-j <threads>] <abbrev of imc message 1>,<abbrev of imc message 2>,..,"
               << "<abbrev of imc message n> Data.lsf[.gz] .. Data.lsf[.gz]"
               << std::endl;
     std::cerr << argv[0] << " accepts multiple IMC messages comma separated and "
@@ -55,79 +164,37 @@ main(int32_t argc, char** argv)
     return 1;
   }
 
-  ByteBuffer buffer;
-  std::ofstream lsf("FilteredData.lsf", std::ios::binary);
-
-  IMC::Message* msg;
+  int32_t start_index = 1;
+  unsigned threads = 0;
 
-  uint32_t accum = 0;
-
-  bool done_first = false;
+  if (argc > 3 && strcmp(argv[1], "-j") == 0)
+  {
+    threads = std::atoi(argv[2]);
+    start_index = 3;
+  }
 
-  std::set<uint32_t> ids;
+  Arguments args;
   std::vector<std::string> msgs;
-  Utils::String::split(argv[1], ",", msgs);
+  Utils::String::split(argv[start_index], ",", msgs);
 
+  std::set<uint32_t> ids;
   for (unsigned k = 0; k < msgs.size(); ++k)
-  {
-    uint32_t got = IMC::Factory::getIdFromAbbrev(Utils::String::trim(msgs[k]));
-    ids.insert(got);
-  }
+    ids.insert(IMC::Factory::getIdFromAbbrev(Utils::String::trim(msgs[k])));
 
-  for (uint32_t j = 2; j < (uint32_t)argc; ++j)
-  {
-    std::istream* is = 0;
-    Compression::Methods method = Compression::Factory::detect(argv[j]);
-    if (method == METHOD_UNKNOWN)
-      is = new std::ifstream(argv[j], std::ios::binary);
-    else
-      is = new Compression::FileInput(argv[j], method);
+  args.ids.assign(ids.begin(), ids.end());
 
-    uint32_t i = 0;
+  std::vector<std::string> paths(argv + start_index + 1, argv + argc);
 
-    try
-    {
-      while ((msg = IMC::Packet::deserialize(*is)) != 0)
-      {
-        if (!done_first)
-        {
-          // place an empty estimatedstate message in the log
-          IMC::EstimatedState state;
-          state.setTimeStamp(msg->getTimeStamp());
-          IMC::Packet::serialize(&state, buffer);
-          lsf.write(buffer.getBufferSigned(), buffer.getSize());
-          done_first = true;
-        }
-
-        std::set<uint32_t>::const_iterator it;
-        it = ids.find(msg->getId());
-
-        if (it != ids.end())
-        {
-          IMC::Packet::serialize(msg, buffer);
-          lsf.write(buffer.getBufferSigned(), buffer.getSize());
-
-          ++i;
-        }
-
-        delete msg;
-      }
-    }
-    catch (std::runtime_error& e)
-    {
-      std::cerr << "ERROR: " << e.what() << std::endl;
-      return -1;
-    }
-
-    std::cerr << i << " messages in " << argv[j] << std::endl;
-    accum += i;
+  Output output("FilteredData.lsf", paths);
+  IMC::LogMapReduce<FilterLog, Arguments> logs(args, threads);
+  logs.run(paths, output);
 
-    delete is;
-  }
+  output.lsf.close();
 
-  lsf.close();
+  if (output.failed)
+    return -1;
 
-  std::cerr << "Total of " << accum << " " << argv[1] << " messages." << std::endl;
+  std::cerr << "Total of " << output.accum << " " << argv[start_index] << " messages." << std::endl;
 
   return 0;
 }
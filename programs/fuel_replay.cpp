@@ -178,211 +178,245 @@ readArgs(char* file, Arguments& args)
   cfg.get(sec, "Estimated Entity Power List", "", args.est_power);
 }
 
-int
-main(int32_t argc, char** argv)
+//! Replay of the fuel filter over a log.
+class FuelReplay: public IMC::LogProcessor
 {
-  if (argc != 3)
+public:
+  FuelReplay(Arguments& args, const char* output):
+    m_args(args),
+    m_fuel_filter(NULL),
+    m_got_entities(false),
+    m_pr(1.0),
+    m_lsf(output, std::ios::binary),
+    m_prog_timer(5.0),
+    m_last(NULL),
+    m_got_first(false)
   {
-    std::cerr << "Usage: " << argv[0] << " <config ini file> <path_to_log.lsf[.gz]>"
-              << std::endl;
-    return 1;
+    for (unsigned i = 0; i < BatteryData::BM_TOTAL; ++i)
+    {
+      m_eids[i] = 0;
+      m_resolved_entities[i] = false;
+    }
+
+    bind<IMC::EntityInfo>(this);
+    bind<IMC::Voltage>(this);
+    bind<IMC::Current>(this);
+    bind<IMC::Temperature>(this);
+    bind<IMC::VehicleState>(this);
+    bind<IMC::FuelLevel>(this);
+    bind<IMC::EntityActivationState>(this);
   }
 
-  Arguments m_args;
+  ~FuelReplay(void)
+  {
+    Memory::clear(m_fuel_filter);
+    Memory::clear(m_last);
+  }
 
-  readArgs(argv[1], m_args);
-  m_args.filter_args.decay_factor *= 0.01f;
+  void
+  consume(const IMC::EntityInfo* msg)
+  {
+    prepare(msg);
 
-  //! Array of entities
-  unsigned m_eids[BatteryData::BM_TOTAL];
+    if (!m_got_entities)
+    {
+      bool got_all = true;
 
-  // Filter pointer
-  FuelFilter* m_fuel_filter = NULL;
+      for (unsigned i = 0; i < BatteryData::BM_TOTAL; ++i)
+      {
+        if (msg->label == m_args.elb[i])
+        {
+          m_eids[i] = msg->id;
+          m_resolved_entities[i] = true;
+        }
 
-  bool resolved_entities[BatteryData::BM_TOTAL];
-  for (unsigned i = 0; i < BatteryData::BM_TOTAL; ++i)
-    resolved_entities[i] = false;
+        if (m_resolved_entities[i] == false)
+          got_all = false;
+      }
 
-  EPMap m_epower;
+      m_got_entities = got_all;
 
-  bool got_entities = false;
+      if (m_got_entities)
+        std::cerr << "Got all entities" << std::endl;
+    }
 
-  PseudoTimer timer;
-  PeriodicRun pr(1.0);
+    for (unsigned i = 0; i < m_args.est_list.size(); i++)
+    {
+      if (msg->label == m_args.est_list[i])
+        m_epower.insert(EPPair(msg->id, EntityPower(m_args.est_power[i])));
+    }
 
-  ByteBuffer buffer;
-  std::ofstream lsf("NewFuel.lsf", std::ios::binary);
+    if (m_args.est_list.size() < m_epower.size())
+      std::cerr << "TOO MANY ENTRIES!" << std::endl;
 
-  std::istream* is = 0;
-  DUNE::Compression::Methods method = DUNE::Compression::Factory::detect(argv[2]);
-  if (method == DUNE::Compression::METHOD_UNKNOWN)
-    is = new std::ifstream(argv[2], std::ios::binary);
-  else
-    is = new DUNE::Compression::FileInput(argv[2], method);
+    write(msg);
+  }
 
-  if (!is)
+  void
+  consume(const IMC::Voltage* msg)
   {
-    std::cerr << "bad file" << std::endl;
-    return 1;
+    prepare(msg);
+    m_fuel_filter->onVoltage(msg);
+    record(msg);
   }
 
-  is->seekg(0, is->end);
-  unsigned file_length = is->tellg();
-  is->seekg(0, is->beg);
-  Time::Counter<float> prog_timer(5.0);
-
-  DUNE::IMC::Message* msg = NULL;
-
-  DUNE::IMC::FuelLevel* ptr = NULL;
+  void
+  consume(const IMC::Current* msg)
+  {
+    prepare(msg);
+    m_fuel_filter->onCurrent(msg);
+    record(msg);
+  }
 
-  bool got_first = false;
+  void
+  consume(const IMC::Temperature* msg)
+  {
+    prepare(msg);
+    m_fuel_filter->onTemperature(msg);
+    record(msg);
+  }
 
-  try
+  void
+  consume(const IMC::VehicleState* msg)
   {
-    while ((msg = DUNE::IMC::Packet::deserialize(*is)) != 0)
-    {
-      bool log_it = false;
+    prepare(msg);
+    m_fuel_filter->onVehicleState(msg);
+    record(msg);
+  }
 
-      timer.update(msg->getTimeStamp());
+  void
+  consume(const IMC::FuelLevel* msg)
+  {
+    prepare(msg);
+    record(msg);
+  }
 
-      if (!got_first)
-      {
-        IMC::EstimatedState state;
-        state.setTimeStamp(msg->getTimeStamp());
-        IMC::Packet::serialize(&state, buffer);
-        lsf.write(buffer.getBufferSigned(), buffer.getSize());
-        got_first = true;
+  void
+  consume(const IMC::EntityActivationState* msg)
+  {
+    prepare(msg);
+    m_fuel_filter->onEntityActivationState(msg);
+    record(msg);
+  }
 
-        std::cerr << "got first timestamp" << std::endl;
+  //! Print energy consumed since the last estimate.
+  void
+  printEnergy(void)
+  {
+    if (m_fuel_filter != NULL)
+      std::cerr << "Energy consumed since last estimate: " << m_fuel_filter->getEnergyConsumed()
+                << " Wh (+/- " << m_fuel_filter->getEnergyConfidence() << " Wh)" << std::endl;
+  }
 
-        m_fuel_filter = new FuelFilter(&m_args.filter_args, m_eids, &m_epower,
-                                       NULL, true, msg->getTimeStamp());
-      }
+private:
+  Arguments& m_args;
+  //! Array of entities
+  unsigned m_eids[BatteryData::BM_TOTAL];
+  bool m_resolved_entities[BatteryData::BM_TOTAL];
+  // Filter pointer
+  FuelFilter* m_fuel_filter;
+  EPMap m_epower;
+  bool m_got_entities;
+  PseudoTimer m_timer;
+  PeriodicRun m_pr;
+  ByteBuffer m_buffer;
+  std::ofstream m_lsf;
+  Time::Counter<float> m_prog_timer;
+  //! Last fuel level computed.
+  IMC::FuelLevel* m_last;
+  bool m_got_first;
+
+  //! Update timer and start the filter on the first message.
+  void
+  prepare(const IMC::Message* msg)
+  {
+    m_timer.update(msg->getTimeStamp());
 
-      if (msg->getId() == DUNE_IMC_ENTITYINFO)
-      {
-        IMC::EntityInfo* ent = static_cast<IMC::EntityInfo*>(msg);
+    if (m_got_first)
+      return;
 
-        if (!got_entities)
-        {
-          bool got_all = true;
+    IMC::EstimatedState state;
+    state.setTimeStamp(msg->getTimeStamp());
+    write(&state);
+    m_got_first = true;
 
-          for (unsigned i = 0; i < BatteryData::BM_TOTAL; ++i)
-          {
-            if (ent->label == m_args.elb[i])
-            {
-              m_eids[i] = ent->id;
-              resolved_entities[i] = true;
-            }
+    std::cerr << "got first timestamp" << std::endl;
 
-            if (resolved_entities[i] == false)
-              got_all = false;
-          }
+    m_fuel_filter = new FuelFilter(&m_args.filter_args, m_eids, &m_epower,
+                                   NULL, true, msg->getTimeStamp());
+  }
 
-          got_entities = got_all;
+  //! Run the filter periodically and log a message.
+  void
+  record(const IMC::Message* msg)
+  {
+    if (m_timer.isValid() && m_pr.doRun(m_timer.getTime()))
+    {
+      // Update fuel filter
+      if (m_fuel_filter->update())
+      {
+        IMC::FuelLevel fl;
+        fl.setSourceEntity(250);
+        fl.setTimeStamp(msg->getTimeStamp());
 
-          if (got_entities)
-            std::cerr << "Got all entities" << std::endl;
-        }
+        m_fuel_filter->fillMessage(fl, m_args.op_labels, m_args.op_values);
 
-        for (unsigned i = 0; i < m_args.est_list.size(); i++)
+        if (m_last != NULL)
         {
-          if (ent->label == m_args.est_list[i])
-            m_epower.insert(EPPair(ent->id, EntityPower(m_args.est_power[i])));
+          float diff = m_last->value - fl.value;
+          char sign = (diff > 0)? '-' : '+';
+          if (std::fabs(diff) > 1.0)
+            std::cerr << "jumped " << sign
+                      << std::fabs(diff) / 100 * m_args.filter_args.full_capacity
+                      << " (" << std::fabs(diff) << "%)" << std::endl;
         }
 
-        if (m_args.est_list.size() < m_epower.size())
-          std::cerr << "TOO MANY ENTRIES!" << std::endl;
-
-        IMC::Packet::serialize(msg, buffer);
-        lsf.write(buffer.getBufferSigned(), buffer.getSize());
-        delete msg;
-        continue;
-      }
-
-      if (msg->getId() == DUNE_IMC_VOLTAGE)
-      {
-        m_fuel_filter->onVoltage(static_cast<IMC::Voltage*>(msg));
-        log_it = true;
-      }
-      else if (msg->getId() == DUNE_IMC_CURRENT)
-      {
-        m_fuel_filter->onCurrent(static_cast<IMC::Current*>(msg));
-        log_it = true;
-      }
-      else if (msg->getId() == DUNE_IMC_TEMPERATURE)
-      {
-        m_fuel_filter->onTemperature(static_cast<IMC::Temperature*>(msg));
-        log_it = true;
-      }
-      else if (msg->getId() == DUNE_IMC_VEHICLESTATE)
-      {
-        m_fuel_filter->onVehicleState(static_cast<IMC::VehicleState*>(msg));
-        log_it = true;
-      }
-      else if (msg->getId() == DUNE_IMC_FUELLEVEL)
-      {
-        log_it = true;
-      }
-      else if (msg->getId() == DUNE_IMC_ENTITYACTIVATIONSTATE)
-      {
-        m_fuel_filter->onEntityActivationState(static_cast<IMC::EntityActivationState*>(msg));
-        log_it = true;
-      }
-
-      if (timer.isValid() && pr.doRun(timer.getTime()))
-      {
-        // Update fuel filter
-        if (m_fuel_filter->update())
-        {
-          IMC::FuelLevel fl;
-          fl.setSourceEntity(250);
-          fl.setTimeStamp(msg->getTimeStamp());
-
-          m_fuel_filter->fillMessage(fl, m_args.op_labels, m_args.op_values);
-
-          if (ptr != NULL)
-          {
-            float diff = ptr->value - fl.value;
-            char sign = (diff > 0)? '-' : '+';
-            if (std::fabs(diff) > 1.0)
-              std::cerr << "jumped " << sign
-                        << std::fabs(diff) / 100 * m_args.filter_args.full_capacity
-                        << " (" << std::fabs(diff) << "%)" << std::endl;
-          }
-
-          Memory::clear(ptr);
-          ptr = static_cast<IMC::FuelLevel*>(fl.clone());
-
-          IMC::Packet::serialize(&fl, buffer);
-          lsf.write(buffer.getBufferSigned(), buffer.getSize());
-        }
-      }
+        Memory::clear(m_last);
+        m_last = static_cast<IMC::FuelLevel*>(fl.clone());
 
-      if (log_it)
-      {
-        IMC::Packet::serialize(msg, buffer);
-        lsf.write(buffer.getBufferSigned(), buffer.getSize());
+        write(&fl);
       }
+    }
 
-      if (prog_timer.overflow())
-      {
-        std::cerr << (float)is->tellg() / file_length * 100.0 << "%" << std::endl;
-        prog_timer.reset();
-      }
+    write(msg);
 
-      delete msg;
+    if (m_prog_timer.overflow())
+    {
+      std::cerr << getProgress() * 100.0 << "%" << std::endl;
+      m_prog_timer.reset();
     }
   }
-  catch (std::runtime_error& e)
+
+  //! Write a message to the output log.
+  void
+  write(const IMC::Message* msg)
+  {
+    IMC::Packet::serialize(msg, m_buffer);
+    m_lsf.write(m_buffer.getBufferSigned(), m_buffer.getSize());
+  }
+};
+
+int
+main(int32_t argc, char** argv)
+{
+  if (argc != 3)
   {
-    std::cerr << "ERROR: " << e.what() << std::endl;
+    std::cerr << "Usage: " << argv[0] << " <config ini file> <path_to_log.lsf[.gz]>"
+              << std::endl;
+    return 1;
   }
 
-  Memory::clear(m_fuel_filter);
-  Memory::clear(ptr);
+  Arguments m_args;
+
+  readArgs(argv[1], m_args);
+  m_args.filter_args.decay_factor *= 0.01f;
+
+  FuelReplay replay(m_args, "NewFuel.lsf");
+
+  if (!replay.process(argv[2]))
+    std::cerr << "ERROR: " << replay.getError() << std::endl;
 
-  delete is;
+  replay.printEnergy();
 
   return 0;
 }
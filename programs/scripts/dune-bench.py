@@ -0,0 +1,159 @@
+# -*- coding: utf-8 -*-
+############################################################################
+# Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      #
+# Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  #
+############################################################################
+# This file is part of DUNE: Unified Navigation Environment.               #
+#                                                                          #
+# Commercial Licence Usage                                                 #
+# Licencees holding valid commercial DUNE licences may use this file in    #
+# accordance with the commercial licence agreement provided with the       #
+# Software or, alternatively, in accordance with the terms contained in a  #
+# written agreement between you and Faculdade de Engenharia da             #
+# Universidade do Porto. For licensing terms, conditions, and further      #
+# information contact lsts@fe.up.pt.                                       #
+#                                                                          #
+# Modified European Union Public Licence - EUPL v.1.1 Usage                #
+# Alternatively, this file may be used under the terms of the Modified     #
+# EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md #
+# included in the packaging of this file. You may not use this work        #
+# except in compliance with the Licence. Unless required by applicable     #
+# law or agreed to in writing, software distributed under the Licence is   #
+# distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     #
+# ANY KIND, either express or implied. See the Licence for the specific    #
+# language governing permissions and limitations at                        #
+# https://github.com/LSTS/dune/blob/master/LICENCE.md and                  #
+# http://ec.europa.eu/idabc/eupl.html.                                     #
+############################################################################
+# Author: Ricardo Martins                                                  #
+############################################################################
+# Run the micro-benchmarks in programs/bench and compare results against  #
+# a stored baseline.                                                       #
+#                                                                          #
+#   dune-bench.py run BUILD_DIR [-o FILE] [--reps N] [--filter STR]        #
+#   dune-bench.py compare BASELINE CURRENT [--threshold PCT] [--metric M]  #
+#                                                                          #
+# Build the programs with 'make bench' and keep one baseline per target   #
+# (e.g. baseline-armv7.json); 'compare' exits with status 1 if any       #
+# benchmark got slower than the threshold.                                 #
+############################################################################
+
+import os
+import sys
+import json
+import glob
+import platform
+import argparse
+import tempfile
+import subprocess
+
+def run(args):
+    programs = sorted(glob.glob(os.path.join(args.build_dir, 'bench_*')))
+    programs = [p for p in programs if os.access(p, os.X_OK) and not os.path.isdir(p)]
+    if not programs:
+        print("ERROR: no benchmark programs in '%s' (run 'make bench')." % args.build_dir)
+        return 1
+
+    results = {
+        'host': {
+            'machine': platform.machine(),
+            'system': platform.system(),
+            'release': platform.release()
+        },
+        'suites': {}
+    }
+
+    for program in programs:
+        fd, path = tempfile.mkstemp(suffix = '.json')
+        os.close(fd)
+        cmd = [program, '--json', path]
+        if args.reps:
+            cmd += ['--reps', str(args.reps)]
+        if args.filter:
+            cmd += ['--filter', args.filter]
+
+        try:
+            subprocess.check_call(cmd)
+            with open(path) as f:
+                suite = json.load(f)
+        finally:
+            os.remove(path)
+
+        results['suites'][suite['suite']] = suite['results']
+
+    if args.output == '-':
+        json.dump(results, sys.stdout, indent = 2)
+    else:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent = 2)
+        print("Results written to '%s'." % args.output)
+    return 0
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+
+    table = {}
+    for suite, results in data['suites'].items():
+        for r in results:
+            table[suite + '/' + r['name']] = r
+    return data.get('host', {}), table
+
+def compare(args):
+    base_host, base = load(args.baseline)
+    curr_host, curr = load(args.current)
+
+    if base_host.get('machine') != curr_host.get('machine'):
+        print('WARNING: comparing results from different machines (%s vs %s).'
+              % (base_host.get('machine'), curr_host.get('machine')))
+
+    regressions = 0
+    width = max([len(k) for k in curr] + [9])
+    print('%-*s %12s %12s %8s' % (width, 'benchmark', 'baseline', 'current', 'change'))
+    for name in sorted(curr):
+        if name not in base:
+            print('%-*s %12s %12.1f %8s' % (width, name, '-', curr[name][args.metric], 'new'))
+            continue
+
+        b = base[name][args.metric]
+        c = curr[name][args.metric]
+        change = 100.0 * (c - b) / b if b > 0 else 0.0
+        mark = ''
+        if change > args.threshold:
+            mark = ' REGRESSION'
+            regressions += 1
+        elif change < -args.threshold:
+            mark = ' improved'
+        print('%-*s %12.1f %12.1f %+7.1f%%%s' % (width, name, b, c, change, mark))
+
+    for name in sorted(set(base) - set(curr)):
+        print('%-*s %12.1f %12s %8s' % (width, name, base[name][args.metric], '-', 'missing'))
+
+    if regressions:
+        print('%d benchmark(s) slower than %.1f%% (%s).' % (regressions, args.threshold, args.metric))
+        return 1
+    return 0
+
+parser = argparse.ArgumentParser(description = 'DUNE micro-benchmarks.')
+sub = parser.add_subparsers(dest = 'command')
+
+p = sub.add_parser('run', help = 'run benchmarks and store results')
+p.add_argument('build_dir', help = 'folder containing bench_* programs')
+p.add_argument('-o', '--output', default = 'bench.json', help = "output file ('-' for stdout)")
+p.add_argument('--reps', type = int, help = 'number of timed samples')
+p.add_argument('--filter', help = 'only run benchmarks containing this string')
+
+p = sub.add_parser('compare', help = 'compare results against a baseline')
+p.add_argument('baseline')
+p.add_argument('current')
+p.add_argument('--threshold', type = float, default = 10.0, help = 'allowed slowdown in percent')
+p.add_argument('--metric', default = 'p50', choices = ['mean', 'min', 'p50', 'p90', 'p99', 'max'])
+
+args = parser.parse_args()
+if args.command == 'run':
+    sys.exit(run(args))
+elif args.command == 'compare':
+    sys.exit(compare(args))
+else:
+    parser.print_help()
+    sys.exit(1)
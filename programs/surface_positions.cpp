@@ -44,70 +44,69 @@
 
 using DUNE_NAMESPACES;
 
-int
-main(int32_t argc, char** argv)
+//! Extract accurate GPS fixes from a log.
+class SurfacePositions: public IMC::LogProcessor
 {
-  if (argc != 2)
+public:
+  SurfacePositions(const char* output):
+    count(0),
+    m_lsf(output, std::ios::binary),
+    m_timestamp(-1.0)
   {
-    std::cerr << "Usage: " << argv[0] << " Data.lsf[.gz]"
-              << std::endl;
-    return 1;
-  }
-
-  std::istream* is = 0;
-  Compression::Methods method = Compression::Factory::detect(argv[1]);
-  if (method == METHOD_UNKNOWN)
-    is = new std::ifstream(argv[1], std::ios::binary);
-  else
-    is = new Compression::FileInput(argv[1], method);
+    IMC::EstimatedState state;
+    write(&state);
 
-  ByteBuffer buffer;
-  std::ofstream lsf("SurfaceData.lsf", std::ios::binary);
-
-  IMC::Message* msg;
-
-  unsigned i = 0;
-
-  IMC::EstimatedState state;
-  IMC::Packet::serialize(&state, buffer);
-  lsf.write(buffer.getBufferSigned(), buffer.getSize());
-  double timestamp = -1.0;
+    bind<IMC::GpsFix>(this);
+  }
 
-  try
+  void
+  consume(const IMC::GpsFix* fix)
   {
-    while ((msg = IMC::Packet::deserialize(*is)) != 0)
+    if ((fix->hacc <= MIN_HACC) &&
+        (fix->validity & IMC::GpsFix::GFV_VALID_POS) &&
+        (fix->getTimeStamp() >= m_timestamp))
     {
-      if (msg->getId() == DUNE_IMC_GPSFIX)
-      {
-        IMC::GpsFix* fix = static_cast<IMC::GpsFix*>(msg);
-
-        if ((fix->hacc <= MIN_HACC) &&
-            (fix->validity & IMC::GpsFix::GFV_VALID_POS) &&
-            (fix->getTimeStamp() >= timestamp))
-        {
-          timestamp = fix->getTimeStamp();
+      m_timestamp = fix->getTimeStamp();
+      write(fix);
+      ++count;
+    }
+  }
 
-          IMC::Packet::serialize(msg, buffer);
-          lsf.write(buffer.getBufferSigned(), buffer.getSize());
+  //! Number of fixes written.
+  unsigned count;
 
-          ++i;
-        }
-      }
+private:
+  ByteBuffer m_buffer;
+  std::ofstream m_lsf;
+  double m_timestamp;
 
-      delete msg;
-    }
+  void
+  write(const IMC::Message* msg)
+  {
+    IMC::Packet::serialize(msg, m_buffer);
+    m_lsf.write(m_buffer.getBufferSigned(), m_buffer.getSize());
   }
-  catch (std::runtime_error& e)
+};
+
+int
+main(int32_t argc, char** argv)
+{
+  if (argc != 2)
   {
-    std::cerr << "ERROR: " << e.what() << std::endl;
-    return -1;
+    std::cerr << "Usage: " << argv[0] << " Data.lsf[.gz]"
+              << std::endl;
+    return 1;
   }
 
-  lsf.close();
+  SurfacePositions positions("SurfaceData.lsf");
 
-  delete is;
+  if (!positions.process(argv[1]))
+  {
+    std::cerr << "ERROR: " << positions.getError() << std::endl;
+    return -1;
+  }
 
-  std::cerr << "Got " << i << " GpsFix messages." << std::endl;
+  std::cerr << "Got " << positions.count << " GpsFix messages." << std::endl;
 
   return 0;
 }
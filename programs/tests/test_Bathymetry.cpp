@@ -0,0 +1,176 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+// Test program for DUNE::Simulation::Bathymetry class.                     *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/FileSystem/Path.hpp>
+#include <DUNE/Simulation/Bathymetry.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using DUNE::FileSystem::Path;
+using DUNE::Simulation::Bathymetry;
+
+//! Planar depth field.
+static double
+plane(double north, double east)
+{
+  return 20.0 + 0.1 * north - 0.05 * east;
+}
+
+int
+main(void)
+{
+  Test test("Simulation::Bathymetry");
+
+#if defined(DUNE_OS_POSIX)
+  Path path("/tmp/test_bathymetry.bty");
+#elif defined(DUNE_OS_WINDOWS)
+  Path path("c:/test_bathymetry.bty");
+#endif
+
+  // Samples on the grid nodes, spanning several tiles.
+  std::vector<Bathymetry::Sample> samples;
+  for (int n = -100; n <= 400; n += 5)
+  {
+    for (int e = 0; e <= 350; e += 5)
+    {
+      // Leave a hole too large to be filled.
+      if (n >= 200 && n <= 300 && e >= 100 && e <= 200)
+        continue;
+
+      Bathymetry::Sample s = {(double)n, (double)e, plane(n, e)};
+      samples.push_back(s);
+    }
+  }
+
+  Bathymetry::write(path, 0.7, -0.15, samples, 5.0, 2);
+
+  Bathymetry grid;
+  grid.open(path);
+
+  {
+    test.boolean("open", grid.isOpen());
+    test.boolean("reference", grid.getLatitude() == 0.7 && grid.getLongitude() == -0.15);
+    test.boolean("resolution", grid.getResolution() == 5.0);
+    test.boolean("dimensions", grid.getRows() >= 101 && grid.getColumns() >= 71);
+  }
+
+  {
+    double depth = 0;
+    bool exact = true;
+    for (double n = -99.3; n < 190.0; n += 3.7)
+    {
+      for (double e = 0.2; e < 350.0; e += 4.1)
+      {
+        if (!grid.depthAt(n, e, depth) || std::fabs(depth - plane(n, e)) > 1e-4)
+          exact = false;
+      }
+    }
+
+    test.boolean("bilinear: planar field", exact);
+    test.boolean("bilinear: node", grid.depthAt(50.0, 50.0, depth) && std::fabs(depth - plane(50, 50)) < 1e-4);
+  }
+
+  {
+    double depth = 0;
+    test.boolean("no data: hole", !grid.depthAt(250.0, 150.0, depth));
+    test.boolean("no data: filled edge", grid.depthAt(200.0, 150.0, depth));
+    test.boolean("out of bounds: north", !grid.depthAt(1000.0, 10.0, depth));
+    test.boolean("out of bounds: east", !grid.depthAt(10.0, -50.0, depth));
+  }
+
+  {
+    double range = 0;
+    double c = std::sqrt(0.5);
+
+    Bathymetry::Ray slant = {0.0, 50.0, 0.0, c, 0.0, c};
+    test.boolean("ray: slanted", grid.castRay(slant, 100.0, range) && std::fabs(range - 17.5 / (0.9 * c)) < 1e-3);
+
+    Bathymetry::Ray level = {0.0, 50.0, 15.0, -1.0, 0.0, 0.0};
+    test.boolean("ray: horizontal", grid.castRay(level, 100.0, range) && std::fabs(range - 25.0) < 1e-3);
+    test.boolean("ray: short range", !grid.castRay(level, 20.0, range));
+
+    Bathymetry::Ray below = {0.0, 50.0, 30.0, 1.0, 0.0, 0.0};
+    test.boolean("ray: below bottom", grid.castRay(below, 100.0, range) && range == 0.0);
+
+    Bathymetry::Ray up = {0.0, 50.0, 10.0, c, 0.0, -c};
+    test.boolean("ray: upwards", !grid.castRay(up, 100.0, range));
+
+    Bathymetry::Ray outside = {0.0, 50.0, 1.0, 0.0, 1.0, 0.0};
+    test.boolean("ray: leaves grid", !grid.castRay(outside, 1000.0, range));
+
+    Bathymetry::Ray entering = {0.0, -100.0, 10.0, 0.0, 1.0, 0.0};
+    test.boolean("ray: enters grid", !grid.castRay(entering, 50.0, range));
+
+    Bathymetry::Ray vertical = {50.0, 50.0, 0.0, 0.0, 0.0, 1.0};
+    test.boolean("ray: vertical", grid.castRay(vertical, 100.0, range) && std::fabs(range - plane(50, 50)) < 1e-4);
+
+    std::vector<Bathymetry::Ray> rays;
+    rays.push_back(slant);
+    rays.push_back(up);
+    rays.push_back(level);
+
+    std::vector<double> ranges;
+    size_t hits = grid.castRays(rays, 100.0, ranges);
+    test.boolean("rays: hits", hits == 2 && ranges.size() == 3);
+    test.boolean("rays: miss at maximum range", ranges[1] == 100.0 && std::fabs(ranges[2] - 25.0) < 1e-3);
+  }
+
+  {
+    grid.close();
+    test.boolean("close", !grid.isOpen());
+
+    double depth = 0;
+    test.boolean("closed: no data", !grid.depthAt(10.0, 10.0, depth));
+  }
+
+  {
+    bool thrown = false;
+    try
+    {
+      grid.open(Path("/nonexistent/test_bathymetry.bty"));
+    }
+    catch (Bathymetry::Error& e)
+    {
+      thrown = true;
+    }
+
+    test.boolean("open: missing file", thrown);
+  }
+
+  path.remove();
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,214 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <fstream>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include <Transports/Cache/Log.hpp>
+#include "Test.hpp"
+
+using namespace DUNE;
+using DUNE::FileSystem::Path;
+using DUNE::Utils::String;
+using Transports::Cache::Log;
+
+//! Store the position of a servo.
+static void
+store(Log& log, uint8_t id, float value)
+{
+  IMC::ServoPosition msg;
+  msg.id = id;
+  msg.value = value;
+  log.append(&msg);
+}
+
+//! Read the file contents.
+static std::vector<char>
+readFile(const Path& path)
+{
+  std::ifstream ifs(path.c_str(), std::ios::binary);
+  return std::vector<char>((std::istreambuf_iterator<char>(ifs)),
+                           std::istreambuf_iterator<char>());
+}
+
+//! Replace the file contents.
+static void
+writeFile(const Path& path, const std::vector<char>& data)
+{
+  std::ofstream ofs(path.c_str(), std::ios::binary | std::ios::trunc);
+  ofs.write(&data[0], data.size());
+}
+
+//! Get the positions of all servos, in snapshot order.
+static std::vector<float>
+positions(Log& log, bool& sized)
+{
+  std::vector<std::string> order;
+  std::vector<uint8_t> data;
+  std::vector<uint16_t> sizes;
+  log.snapshot(order, data, sizes);
+
+  std::vector<float> values;
+  size_t pos = 0;
+  for (size_t i = 0; i < sizes.size(); ++i)
+  {
+    IMC::Message* msg = IMC::Packet::deserialize(&data[pos], sizes[i]);
+    IMC::ServoPosition* servo = dynamic_cast<IMC::ServoPosition*>(msg);
+    if (servo != NULL)
+      values.push_back(servo->value);
+    pos += sizes[i];
+    delete msg;
+  }
+
+  sized = pos == data.size();
+  return values;
+}
+
+int
+main(void)
+{
+  Test test("Transports::Cache::Log");
+  Path dir = Path::current() / "test_CacheLog.d";
+  Path path = dir / "cache.log";
+  bool sized = false;
+
+  if (dir.exists())
+    dir.remove(Path::MODE_RECURSIVE);
+  dir.create();
+
+  {
+    Log log(path);
+    test.boolean("open: empty", log.open() == 0 && log.size() == 0);
+
+    store(log, 2, 20);
+    store(log, 1, 10);
+    store(log, 1, 11);
+    test.boolean("append: latest per sub identifier", log.size() == 2);
+
+    std::vector<float> values = positions(log, sized);
+    test.boolean("snapshot: sorted by sub identifier",
+                 values.size() == 2 && values[0] == 11 && values[1] == 20);
+    test.boolean("snapshot: stored sizes", sized);
+  }
+
+  {
+    Log log(path);
+    test.boolean("reopen: restored", log.open() == 0 && log.size() == 2);
+
+    int64_t before = log.getFileSize();
+    log.compact();
+    test.boolean("compact: superseded records dropped",
+                 log.getFileSize() < before && log.getFileSize() == (int64_t)readFile(path).size());
+
+    std::vector<float> values = positions(log, sized);
+    test.boolean("compact: latest records kept",
+                 values.size() == 2 && values[0] == 11 && values[1] == 20);
+
+    for (unsigned i = 0; i < 10000; ++i)
+      store(log, i % 3, i);
+    values = positions(log, sized);
+    test.boolean("compact: automatic",
+                 log.getFileSize() < 10000 * 10 && values.size() == 3
+                 && values[0] == 9999 && values[1] == 9997 && values[2] == 9998);
+  }
+
+  {
+    std::vector<char> data = readFile(path);
+    data.resize(data.size() - 3);
+    writeFile(path, data);
+
+    Log log(path);
+    int64_t dropped = log.open();
+    std::vector<float> values = positions(log, sized);
+    test.boolean("truncated tail: dropped", dropped > 0 && log.size() == 3);
+    test.boolean("truncated tail: previous record restored",
+                 values.size() == 3 && values[0] == 9996 && values[1] == 9997 && values[2] == 9998);
+
+    store(log, 2, 42);
+  }
+
+  {
+    std::vector<char> data = readFile(path);
+    data[data.size() - 1] ^= 0x55;
+    writeFile(path, data);
+
+    Log log(path);
+    int64_t dropped = log.open();
+    std::vector<float> values = positions(log, sized);
+    test.boolean("corrupt tail: dropped", dropped > 0 && values.size() == 3 && values[2] == 9998);
+
+    store(log, 2, 43);
+    log.close();
+    test.boolean("corrupt tail: appends after it restored",
+                 log.open() == 0 && positions(log, sized)[2] == 43);
+  }
+
+  {
+    Path legacy = dir / "legacy";
+    (legacy / "ServoPosition").create();
+    (legacy / "Announce").create();
+
+    for (unsigned i = 0; i < 3; ++i)
+    {
+      IMC::ServoPosition msg;
+      msg.id = i;
+      msg.value = i * 10;
+      std::ofstream ofs((legacy / "ServoPosition" / String::str("%u", i)).c_str(), std::ios::binary);
+      IMC::Packet::serialize(&msg, ofs);
+    }
+
+    std::ofstream((legacy / "Announce" / "damaged").c_str()) << "not a message";
+
+    std::vector<IMC::Message*> msgs;
+    Log::readLegacy(legacy, msgs);
+    test.boolean("legacy: messages imported", msgs.size() == 3);
+
+    Log log(dir / "imported.log");
+    log.open();
+    for (size_t i = 0; i < msgs.size(); ++i)
+    {
+      log.append(msgs[i]);
+      delete msgs[i];
+    }
+
+    std::vector<float> values = positions(log, sized);
+    test.boolean("legacy: stored in log",
+                 values.size() == 3 && values[0] == 0 && values[1] == 10 && values[2] == 20);
+  }
+
+  dir.remove(Path::MODE_RECURSIVE);
+
+  return test.getReturnValue();
+}
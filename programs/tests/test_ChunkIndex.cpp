@@ -0,0 +1,127 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <fstream>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/FileSystem.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using DUNE::FileSystem::ChunkIndex;
+using DUNE::FileSystem::Path;
+
+static void
+append(const Path& path, size_t size, char value)
+{
+  std::ofstream ofs(path.c_str(), std::ios::binary | std::ios::app);
+  std::string data(size, value);
+  ofs.write(data.c_str(), data.size());
+}
+
+int
+main(void)
+{
+  Test test("FileSystem::ChunkIndex");
+
+  Path path = Path::current() / "test_ChunkIndex.dat";
+  if (path.exists())
+    path.remove();
+
+  append(path, ChunkIndex::c_chunk_size + 100, 'a');
+
+  ChunkIndex index;
+  test.boolean("update: changed", index.update(path));
+  test.boolean("update: unchanged", !index.update(path));
+  test.boolean("count", index.getCount() == 2);
+  test.boolean("size", index.getSize() == ChunkIndex::c_chunk_size + 100);
+  test.boolean("last chunk size", index.getChunkSize(1) == 100);
+  test.boolean("empty digest", ChunkIndex::digest("", 0) == "d41d8cd98f00b204e9800998ecf8427e");
+
+  std::string first = index.getDigest(0);
+  std::string second = index.getDigest(1);
+
+  append(path, ChunkIndex::c_chunk_size, 'b');
+  index.update(path);
+  test.boolean("append: count", index.getCount() == 3);
+  test.boolean("append: first chunk kept", index.getDigest(0) == first);
+  test.boolean("append: last chunk rehashed", index.getDigest(1) != second);
+
+  ChunkIndex fresh;
+  fresh.update(path);
+  test.boolean("append: same as fresh index", fresh.getDigest(1) == index.getDigest(1)
+               && fresh.getDigest(2) == index.getDigest(2));
+
+  std::vector<char> data;
+  unsigned size = ChunkIndex::read(path, 2, data);
+  test.boolean("read: size", size == 100);
+  test.boolean("read: digest", ChunkIndex::digest(&data[0], size) == index.getDigest(2));
+
+  ChunkIndex partial;
+  test.boolean("resume: partial", !partial.resume(path, 2) && partial.getHashed() == 2
+               && partial.getCount() == 3);
+
+  append(path, 10, 'c');
+  test.boolean("resume: complete after append", partial.resume(path, 1)
+               && partial.getHashed() == 3);
+
+  fresh.update(path);
+  test.boolean("resume: same as full update", partial.getDigest(0) == fresh.getDigest(0)
+               && partial.getDigest(1) == fresh.getDigest(1)
+               && partial.getDigest(2) == fresh.getDigest(2));
+
+  {
+    // One stream for the whole transfer, while the file grows.
+    std::ifstream ifs(path.c_str(), std::ios::binary);
+    ChunkIndex streamed;
+    bool partial = !streamed.resume(path, ifs, 1);
+    append(path, ChunkIndex::c_chunk_size, 'd');
+    while (!streamed.resume(path, ifs, 1))
+      ;
+
+    fresh.update(path);
+    bool same = streamed.getCount() == fresh.getCount();
+    for (size_t i = 0; same && i < fresh.getCount(); ++i)
+      same = streamed.getDigest(i) == fresh.getDigest(i);
+
+    test.boolean("resume: open stream", partial && same);
+
+    std::vector<char> data;
+    unsigned size = ChunkIndex::read(ifs, fresh.getCount() - 1, data);
+    test.boolean("read: open stream", size == fresh.getChunkSize(fresh.getCount() - 1)
+                 && ChunkIndex::digest(&data[0], size) == fresh.getDigest(fresh.getCount() - 1));
+  }
+
+  path.remove();
+  return test.getReturnValue();
+}
@@ -0,0 +1,145 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <string>
+
+// DUNE headers.
+#include <DUNE/FileSystem.hpp>
+#include <DUNE/Parsers.hpp>
+#include <DUNE/Parsers/Exceptions.hpp>
+#include <DUNE/Utils/String.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using DUNE::FileSystem::Path;
+using DUNE::Parsers::Config;
+using DUNE::Utils::String;
+
+//! Write a value and parse it back.
+//! @param[in] path scratch file.
+//! @param[in] value option value.
+//! @param[out] result parsed value.
+//! @return true if the value was written, false if it was rejected.
+static bool
+roundTrip(const Path& path, const std::string& value, std::string& result)
+{
+  Config out;
+  out.set("Section", "Option", value);
+  out.set("Section", "Next", "next");
+
+  try
+  {
+    out.writeToFile(path.c_str());
+  }
+  catch (DUNE::Parsers::InvalidValue&)
+  {
+    return false;
+  }
+
+  Config in(path.c_str());
+  in.get("Section", "Option", "", result);
+
+  std::string next;
+  in.get("Section", "Next", "", next);
+  if (next != "next")
+    result = "<corrupted>";
+
+  return true;
+}
+
+//! Build a comma separated list.
+//! @param[in] count number of items.
+//! @param[in] fmt item format.
+//! @return list.
+static std::string
+list(unsigned count, const char* fmt)
+{
+  std::string value;
+  for (unsigned i = 0; i < count; ++i)
+  {
+    if (i > 0)
+      value += ", ";
+    value += String::str(fmt, i);
+  }
+  return value;
+}
+
+int
+main(void)
+{
+  Test test("Parsers::Config");
+  Path path = Path::current() / "test_Config.ini";
+  std::string result;
+
+  test.boolean("short value",
+               roundTrip(path, "1, 2, 3", result) && result == "1, 2, 3");
+
+  {
+    std::string value = list(200, "Item%u");
+    test.boolean("long list",
+                 roundTrip(path, value, result) && result == value);
+  }
+
+  {
+    std::string value = list(200, "Item%u") + ",no space,  two spaces, [bracket]";
+    test.boolean("long list: irregular spacing",
+                 roundTrip(path, value, result) && result == value);
+  }
+
+  {
+    std::string value = list(50, "Key%u=Value") + ", " + list(200, "Item%u");
+    test.boolean("long list: equal signs",
+                 roundTrip(path, value, result) && result == value);
+  }
+
+  {
+    std::string value = list(200, "Item%u") + ", a=b";
+    test.boolean("long list: late equal sign rejected",
+                 !roundTrip(path, value, result));
+  }
+
+  test.boolean("comment delimiter rejected",
+               !roundTrip(path, "a; b", result));
+  test.boolean("pipe rejected",
+               !roundTrip(path, "a | b", result));
+  test.boolean("hash rejected",
+               !roundTrip(path, "#1", result));
+  test.boolean("new line rejected",
+               !roundTrip(path, "a\nb", result));
+  test.boolean("surrounding whitespace rejected",
+               !roundTrip(path, " a", result));
+  test.boolean("long item rejected",
+               !roundTrip(path, std::string(2000, 'x'), result));
+
+  path.remove();
+
+  return test.getReturnValue();
+}
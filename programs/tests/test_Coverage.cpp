@@ -0,0 +1,201 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+// Test program for DUNE::Maneuvers::Coverage class.                        *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Math/Angles.hpp>
+#include <DUNE/Math/Constants.hpp>
+#include <DUNE/Maneuvers/Coverage.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using DUNE::Maneuvers::Coverage;
+using DUNE::Math::Angles;
+using DUNE::Math::c_pi;
+
+//! Reference location.
+static const double c_lat = Angles::radians(41.18);
+static const double c_lon = Angles::radians(-8.70);
+
+static std::vector<Coverage::Point>
+polygon(const double* coords, unsigned count)
+{
+  std::vector<Coverage::Point> vertices(count);
+  for (unsigned i = 0; i < count; ++i)
+  {
+    vertices[i].north = coords[2 * i];
+    vertices[i].east = coords[2 * i + 1];
+  }
+
+  return vertices;
+}
+
+int
+main(void)
+{
+  Test test("Maneuvers::Coverage");
+
+  {
+    double r = 5.0;
+    test.boolean("turn: semicircle", std::fabs(Coverage::getTurnLength(10.0, r) - c_pi * r) < 1e-9);
+    test.boolean("turn: wide", std::fabs(Coverage::getTurnLength(30.0, r) - (c_pi * r + 20.0)) < 1e-9);
+    test.boolean("turn: omega", Coverage::getTurnLength(2.0, r) > c_pi * r);
+    test.boolean("turn: continuous", std::fabs(Coverage::getTurnLength(10.0 - 1e-9, r) - c_pi * r) < 1e-3);
+    test.boolean("turn: no radius", Coverage::getTurnLength(10.0, 0.0) == 10.0);
+  }
+
+  const double square[] = {0, 0, 100, 0, 100, 100, 0, 100};
+  const double strip[] = {0, 0, 300, 0, 300, 100, 0, 100};
+  const double u_shape[] = {0, 0, 100, 0, 100, 30, 30, 30, 30, 70, 100, 70, 100, 100, 0, 100};
+
+  {
+    Coverage cov;
+    cov.setPolygon(c_lat, c_lon, polygon(square, 4));
+
+    Coverage::Parameters params;
+    params.width = 10.0;
+
+    Coverage::Plan plan;
+    test.boolean("square: plan", cov.plan(0.0, params, plan));
+    test.boolean("square: rows", plan.rows == 10 && plan.cells == 1 && plan.waypoints.size() == 20);
+    test.boolean("square: spacing", std::fabs(plan.spacing - 10.0) < 1e-9);
+    test.boolean("square: length", std::fabs(plan.length - 1090.0) < 1e-6);
+
+    bool inside = true;
+    for (size_t i = 0; i < plan.waypoints.size(); ++i)
+    {
+      const Coverage::Waypoint& wp = plan.waypoints[i];
+      if (wp.north < -1e-6 || wp.north > 100 + 1e-6 || wp.east < -1e-6 || wp.east > 100 + 1e-6)
+        inside = false;
+    }
+
+    test.boolean("square: inside", inside);
+    test.boolean("square: alternating", plan.waypoints[1].north > plan.waypoints[0].north &&
+                 plan.waypoints[3].north < plan.waypoints[2].north);
+
+    params.run_out = 5.0;
+    cov.plan(0.0, params, plan);
+    test.boolean("square: run-out", std::fabs(plan.length - 1190.0) < 1e-6 && plan.waypoints[0].north == -5.0);
+
+    params.run_out = 0.0;
+    params.turn_radius = 20.0;
+    cov.plan(0.0, params, plan);
+    test.boolean("square: turn points", plan.waypoints.size() == 29 &&
+                 plan.waypoints[2].type == Coverage::WP_TURN);
+  }
+
+  {
+    Coverage cov;
+    cov.setPolygon(c_lat, c_lon, polygon(strip, 4));
+
+    Coverage::Parameters params;
+    params.width = 10.0;
+    params.turn_radius = 5.0;
+    params.speed = 2.0;
+
+    Coverage::Plan plan;
+    test.boolean("strip: plan", cov.plan(params, plan));
+    test.boolean("strip: long rows", std::fabs(std::sin(plan.heading)) < 1e-9 && plan.rows == 10);
+    test.boolean("strip: duration", std::fabs(plan.duration - plan.length / 2.0) < 1e-9);
+
+    params.threads = 4;
+    Coverage::Plan parallel;
+    test.boolean("strip: parallel", cov.plan(params, parallel) &&
+                 parallel.heading == plan.heading && parallel.length == plan.length);
+
+    params.speed = 1.0;
+    params.threads = 1;
+    Coverage::Plan cached;
+    cov.plan(params, cached);
+    test.boolean("strip: cached", cached.length == plan.length &&
+                 std::fabs(cached.duration - 2.0 * plan.duration) < 1e-9);
+  }
+
+  {
+    Coverage cov;
+    cov.setPolygon(c_lat, c_lon, polygon(u_shape, 8));
+
+    Coverage::Parameters params;
+    params.width = 10.0;
+
+    Coverage::Plan plan;
+    cov.plan(0.0, params, plan);
+    test.boolean("concave: along arms", plan.cells == 1 && plan.rows == 10);
+
+    cov.plan(c_pi / 2.0, params, plan);
+    test.boolean("concave: across arms", plan.cells == 3 && plan.rows == 17);
+
+    bool outside = false;
+    for (size_t i = 0; i < plan.waypoints.size(); ++i)
+    {
+      const Coverage::Waypoint& wp = plan.waypoints[i];
+      if (wp.north > 30 + 1e-6 && wp.east > 30 + 1e-6 && wp.east < 70 - 1e-6)
+        outside = true;
+    }
+
+    test.boolean("concave: gap avoided", !outside);
+  }
+
+  {
+    std::vector<double> lats;
+    std::vector<double> lons;
+    lats.push_back(c_lat);
+    lons.push_back(c_lon);
+    lats.push_back(c_lat + 1e-4);
+    lons.push_back(c_lon);
+    lats.push_back(c_lat + 1e-4);
+    lons.push_back(c_lon + 1e-4);
+
+    Coverage cov;
+    cov.setPolygon(c_lat, c_lon, lats, lons);
+
+    double lat, lon;
+    const Coverage::Point& p = cov.getPolygon()[2];
+    cov.toWGS84(p.north, p.east, &lat, &lon);
+    test.boolean("wgs84: round trip", std::fabs(lat - lats[2]) < 1e-8 && std::fabs(lon - lons[2]) < 1e-8);
+  }
+
+  {
+    Coverage cov;
+    Coverage::Parameters params;
+    Coverage::Plan plan;
+    test.boolean("invalid: no polygon", !cov.plan(params, plan));
+
+    cov.setPolygon(c_lat, c_lon, polygon(square, 4));
+    params.width = 0.0;
+    test.boolean("invalid: width", !cov.plan(params, plan));
+  }
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,181 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <vector>
+#include <string>
+
+// DUNE headers.
+#include <DUNE/IMC.hpp>
+#include <DUNE/Utils/Codecs/DeltaCodec.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+using DUNE::Utils::Codecs::DeltaCodec;
+
+static void
+fill(IMC::EstimatedState& msg, unsigned i)
+{
+  msg.setTimeStamp(1.6e9 + i * 0.1);
+  msg.setSource(0x2001);
+  msg.setSourceEntity(7);
+  msg.lat = 0.71883 + i * 1e-7;
+  msg.lon = -0.15194 - i * 1e-7;
+  msg.height = 0.0;
+  msg.x = 10.0 + i * 0.15;
+  msg.y = -3.0 + i * 0.05;
+  msg.z = 2.0;
+  msg.phi = 0.01;
+  msg.theta = -0.02;
+  msg.psi = 1.2 + i * 0.001;
+  msg.u = 1.5;
+  msg.depth = 2.0;
+  msg.alt = 8.3 - i * 0.01;
+}
+
+static bool
+close(const IMC::EstimatedState& a, const IMC::EstimatedState& b)
+{
+  return std::fabs(a.lat - b.lat) <= 1e-9
+  && std::fabs(a.lon - b.lon) <= 1e-9
+  && std::fabs(a.x - b.x) <= 0.0051
+  && std::fabs(a.y - b.y) <= 0.0051
+  && std::fabs(a.psi - b.psi) <= 0.00051
+  && std::fabs(a.alt - b.alt) <= 0.0051
+  && std::fabs(a.getTimeStamp() - b.getTimeStamp()) <= 0.001
+  && a.getSource() == b.getSource()
+  && a.getSourceEntity() == b.getSourceEntity();
+}
+
+int
+main(void)
+{
+  Test test("Utils::Codecs::DeltaCodec");
+
+  std::vector<std::string> msgs;
+  msgs.push_back("EstimatedState");
+
+  DeltaCodec tx;
+  tx.setMessages(msgs);
+  tx.setKeyframeInterval(5, 1000.0);
+  DeltaCodec rx;
+
+  uint8_t bfr[1024];
+  IMC::EstimatedState in;
+
+  {
+    IMC::Temperature temp;
+    test.boolean("encode(): disabled message", tx.encode(&temp, bfr, sizeof(bfr)) == 0);
+  }
+
+  bool ok = true;
+  size_t key_size = 0;
+  size_t delta_size = 0;
+  for (unsigned i = 0; i < 12; ++i)
+  {
+    fill(in, i);
+    size_t size = tx.encode(&in, bfr, sizeof(bfr));
+    if (i == 0)
+      key_size = size;
+    if (i == 1)
+      delta_size = size;
+
+    // Drop one delta frame, following frames must still decode.
+    if (i == 3)
+      continue;
+
+    IMC::Message* out = rx.decode(bfr, size);
+    if (out == NULL || !close(in, *static_cast<IMC::EstimatedState*>(out)))
+      ok = false;
+    delete out;
+  }
+
+  test.boolean("decode(): round trip", ok);
+  test.boolean("isCoded()", DeltaCodec::isCoded(bfr, 1));
+  test.boolean("keyframe smaller than IMC", key_size > 0 && key_size < in.getSerializationSize());
+  test.boolean("delta smaller than keyframe", delta_size > 0 && delta_size < key_size / 2);
+
+  {
+    DeltaCodec late;
+    fill(in, 20);
+    tx.encode(&in, bfr, sizeof(bfr));
+    fill(in, 21);
+    size_t size = tx.encode(&in, bfr, sizeof(bfr));
+    test.boolean("decode(): missing keyframe", late.decode(bfr, size) == NULL);
+  }
+
+  {
+    std::vector<std::string> res;
+    res.push_back("EstimatedState.x:1");
+    DeltaCodec coarse;
+    coarse.setMessages(msgs);
+    coarse.setResolutions(res);
+    fill(in, 0);
+    in.x = 12.3;
+    size_t size = coarse.encode(&in, bfr, sizeof(bfr));
+    IMC::Message* out = rx.decode(bfr, size);
+    test.boolean("setResolutions()", out != NULL
+                 && static_cast<IMC::EstimatedState*>(out)->x == 12.0f);
+    delete out;
+  }
+
+  {
+    bool thrown = false;
+    try
+    {
+      std::vector<std::string> bad;
+      bad.push_back("PlanControl");
+      tx.setMessages(bad);
+    }
+    catch (std::runtime_error&)
+    {
+      thrown = true;
+    }
+    test.boolean("setMessages(): unsupported", thrown);
+  }
+
+  {
+    bool thrown = false;
+    try
+    {
+      bfr[0] = DeltaCodec::c_magic;
+      rx.decode(bfr, 4);
+    }
+    catch (std::runtime_error&)
+    {
+      thrown = true;
+    }
+    test.boolean("decode(): truncated frame", thrown);
+  }
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,167 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/Math/Matrix.hpp>
+#include <DUNE/Math/FixedMatrix.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE::Math;
+
+template <size_t R, size_t C>
+static void
+randomize(FixedMatrix<R, C>& m)
+{
+  for (int i = 0; i < m.size(); ++i)
+    m(i) = (std::rand() % 2001 - 1000) / 100.0;
+}
+
+template <size_t R, size_t C>
+static bool
+equal(const FixedMatrix<R, C>& a, const Matrix& b)
+{
+  if (b.rows() != (int)R || b.columns() != (int)C)
+    return false;
+
+  for (size_t i = 0; i < R; ++i)
+  {
+    for (size_t j = 0; j < C; ++j)
+    {
+      if (std::fabs(a(i, j) - b(i, j)) > 1e-9 * (1.0 + std::fabs(b(i, j))))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+template <size_t N>
+static void
+testSize(Test& test, const std::string& name)
+{
+  FixedMatrix<N, N> a;
+  FixedMatrix<N, N> b;
+  randomize(a);
+  randomize(b);
+  Matrix ma = a.toMatrix();
+  Matrix mb = b.toMatrix();
+
+  test.boolean((name + ": product").c_str(), equal(a * b, ma * mb));
+  test.boolean((name + ": product by transpose").c_str(), equal(a * transpose(b), ma * transpose(mb)));
+  test.boolean((name + ": transpose product").c_str(), equal(transpose(a) * b, transpose(ma) * mb));
+
+  FixedMatrix<N, N> c = a + b * 2.0 - transpose(a);
+  test.boolean((name + ": expression").c_str(), equal(c, ma + mb * 2.0 - transpose(ma)));
+
+  FixedMatrix<N, N> s = a + transpose(b);
+  s *= 0.5;
+  FixedMatrix<N, N> sym = s;
+  sym = transpose(sym);
+  test.boolean((name + ": aliased transpose").c_str(), equal(sym, transpose(s.toMatrix())));
+
+  FixedMatrix<N, N> d;
+  d.identity();
+  d *= 100.0;
+  d += a;
+  test.boolean((name + ": inverse").c_str(), equal(inverse(d), inverse(d.toMatrix())));
+}
+
+int
+main(void)
+{
+  Test test("Math::FixedMatrix");
+
+  std::srand(1);
+  testSize<3>(test, "3x3");
+  testSize<6>(test, "6x6");
+  testSize<9>(test, "9x9");
+  testSize<12>(test, "12x12");
+
+  {
+    FixedMatrix<2, 3> a;
+    FixedMatrix<3, 4> b;
+    randomize(a);
+    randomize(b);
+    test.boolean("2x3 * 3x4", equal(a * b, a.toMatrix() * b.toMatrix()));
+  }
+
+  {
+    Matrix m(2, 2, 1.0);
+    bool thrown = false;
+    try
+    {
+      FixedMatrix<3, 3> f(m);
+    }
+    catch (Matrix::Error&)
+    {
+      thrown = true;
+    }
+    test.boolean("Matrix conversion: dimension mismatch", thrown);
+
+    FixedMatrix<2, 2> f(m);
+    test.boolean("Matrix conversion", equal(f, m));
+  }
+
+  {
+    FixedMatrix<3, 3> a;
+    FixedMatrix<3, 3> b;
+    bool thrown = false;
+    try
+    {
+      multiply(a, b, a);
+    }
+    catch (Matrix::Error&)
+    {
+      thrown = true;
+    }
+    test.boolean("product aliasing", thrown);
+  }
+
+  {
+    FixedMatrix<3, 3> a;
+    bool thrown = false;
+    try
+    {
+      inverse(a);
+    }
+    catch (Matrix::Error&)
+    {
+      thrown = true;
+    }
+    test.boolean("singular inverse", thrown);
+  }
+
+  return test.getReturnValue();
+}
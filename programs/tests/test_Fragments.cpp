@@ -0,0 +1,136 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/IMC.hpp>
+#include <DUNE/Network/Fragments.hpp>
+#include <DUNE/Network/FragmentedMessage.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+using namespace DUNE::Network;
+
+static IMC::LogBookEntry
+createMessage(void)
+{
+  IMC::LogBookEntry msg;
+  msg.setSource(0x1234);
+  msg.context = "test";
+  msg.text.assign(1000, 'x');
+  for (size_t i = 0; i < msg.text.size(); ++i)
+    msg.text[i] = 'a' + (i % 26);
+  return msg;
+}
+
+static bool
+isEqual(IMC::Message* res, const IMC::LogBookEntry& msg)
+{
+  IMC::LogBookEntry* entry = dynamic_cast<IMC::LogBookEntry*>(res);
+  return entry != NULL && entry->text == msg.text && entry->context == msg.context;
+}
+
+static IMC::Message*
+feed(FragmentedMessage& fm, Fragments& frags, int frag_number)
+{
+  IMC::MessagePart part;
+  frags.getFragment(frag_number, part);
+  part.setSource(0x1234);
+  return fm.setFragment(&part);
+}
+
+int
+main(void)
+{
+  Test test("Network::Fragments");
+
+  IMC::LogBookEntry msg = createMessage();
+
+  {
+    Fragments frags(&msg, 200);
+    int n = frags.getNumberOfFragments();
+    test.boolean("split: several fragments", n > 5);
+
+    FragmentedMessage fm;
+    IMC::Message* res = NULL;
+    for (int i = 0; i < n && res == NULL; ++i)
+      res = feed(fm, frags, i);
+
+    test.boolean("in order: reassembled", isEqual(res, msg));
+    delete res;
+  }
+
+  {
+    Fragments frags(&msg, 200);
+    int n = frags.getNumberOfFragments();
+    FragmentedMessage fm;
+
+    // Last fragment first, then every other fragment.
+    test.boolean("last first: pending", feed(fm, frags, n - 1) == NULL);
+    for (int i = 0; i < n - 1; i += 2)
+      feed(fm, frags, i);
+
+    std::vector<unsigned> missing;
+    fm.getMissing(missing);
+    test.boolean("missing list", (int)missing.size() == fm.getFragmentsMissing()
+                 && missing.size() > 0 && missing[0] == 1);
+
+    IMC::Message* res = NULL;
+    for (size_t i = 0; i < missing.size(); ++i)
+    {
+      // Duplicates are ignored.
+      feed(fm, frags, 0);
+      res = feed(fm, frags, missing[i]);
+    }
+
+    test.boolean("out of order: reassembled", isEqual(res, msg));
+    test.boolean("complete: nothing missing", fm.getFragmentsMissing() == 0);
+    delete res;
+  }
+
+  {
+    Fragments frags(&msg, 200);
+    FragmentedMessage fm;
+    feed(fm, frags, 0);
+    test.boolean("memory: preallocated",
+                 fm.getMemoryUsage() >= (size_t)frags.getNumberOfFragments() * frags.getFragment(0)->data.size());
+
+    IMC::MessagePart bad;
+    frags.getFragment(1, bad);
+    bad.setSource(0x1234);
+    bad.data.resize(bad.data.size() - 1);
+    test.boolean("invalid size: rejected", fm.setFragment(&bad) == NULL && fm.getFragmentsMissing() == frags.getNumberOfFragments() - 1);
+  }
+
+  return test.getReturnValue();
+}
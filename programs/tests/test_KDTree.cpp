@@ -0,0 +1,245 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+// Test program for DUNE::Math::KDTree class.                               *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Math/KDTree.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using DUNE::Math::KDTree;
+
+//! Uniform random number in [a, b).
+static double
+uniform(double a, double b)
+{
+  return a + (b - a) * (std::rand() / (RAND_MAX + 1.0));
+}
+
+//! Distance from a point to an item.
+static double
+distance(const KDTree::Item& it, double x, double y)
+{
+  return std::sqrt((it.x - x) * (it.x - x) + (it.y - y) * (it.y - y));
+}
+
+//! Count visited items.
+struct Counter
+{
+  Counter(void):
+    count(0),
+    sum(0)
+  { }
+
+  void
+  operator()(const KDTree::Item& item)
+  {
+    ++count;
+    sum += item.value;
+  }
+
+  size_t count;
+  double sum;
+};
+
+int
+main(void)
+{
+  Test test("Math::KDTree");
+
+  std::srand(1234);
+
+  std::vector<KDTree::Item> items(5000);
+  for (size_t i = 0; i < items.size(); ++i)
+  {
+    items[i].x = uniform(-500, 500);
+    items[i].y = uniform(-200, 200);
+    items[i].value = (double)i;
+  }
+
+  // Duplicates and collinear points.
+  for (size_t i = 0; i < 20; ++i)
+  {
+    items[i].x = 10.0;
+    items[i].y = 10.0;
+    items[20 + i].x = 50.0;
+  }
+
+  KDTree tree;
+
+  {
+    size_t index;
+    test.boolean("empty: nearest", !tree.nearest(0, 0, index));
+    tree.build(items);
+    test.boolean("build: size", tree.size() == items.size());
+  }
+
+  {
+    bool ok = true;
+    for (unsigned q = 0; q < 500; ++q)
+    {
+      double x = uniform(-600, 600);
+      double y = uniform(-300, 300);
+
+      double best = HUGE_VAL;
+      for (size_t i = 0; i < items.size(); ++i)
+        best = std::min(best, distance(items[i], x, y));
+
+      size_t index;
+      if (!tree.nearest(x, y, index) || distance(tree[index], x, y) != best)
+        ok = false;
+    }
+
+    test.boolean("nearest: brute force", ok);
+  }
+
+  {
+    bool ok = true;
+    size_t indices[16];
+    double distances[16];
+
+    for (unsigned q = 0; q < 200; ++q)
+    {
+      double x = uniform(-500, 500);
+      double y = uniform(-200, 200);
+      double limit = (q % 2) ? 15.0 : -1.0;
+
+      std::vector<double> all;
+      for (size_t i = 0; i < items.size(); ++i)
+      {
+        double d = distance(items[i], x, y);
+        if (limit < 0 || d <= limit)
+          all.push_back(d);
+      }
+      std::sort(all.begin(), all.end());
+
+      size_t n = tree.nearest(x, y, 16, indices, distances, limit);
+      if (n != std::min(all.size(), (size_t)16))
+        ok = false;
+
+      for (size_t i = 0; ok && i < n; ++i)
+      {
+        if (std::fabs(distances[i] - all[i]) > 1e-9
+            || std::fabs(distance(tree[indices[i]], x, y) - all[i]) > 1e-9)
+          ok = false;
+      }
+    }
+
+    test.boolean("k-nearest: brute force", ok);
+  }
+
+  {
+    bool ok = true;
+    for (unsigned q = 0; q < 200; ++q)
+    {
+      double x = uniform(-500, 500);
+      double y = uniform(-200, 200);
+      double r = uniform(0, 60);
+
+      Counter expected;
+      for (size_t i = 0; i < items.size(); ++i)
+      {
+        if (distance(items[i], x, y) <= r)
+          expected(items[i]);
+      }
+
+      Counter counter;
+      size_t n = tree.search(x, y, r, counter);
+      if (n != expected.count || counter.count != expected.count || counter.sum != expected.sum)
+        ok = false;
+    }
+
+    test.boolean("search: brute force", ok);
+
+    Counter counter;
+    tree.search(10.0, 10.0, 0.0, counter);
+    test.boolean("search: duplicates", counter.count >= 20);
+  }
+
+  {
+    bool ok = true;
+    unsigned hits = 0;
+    for (unsigned q = 0; q < 300; ++q)
+    {
+      double x = uniform(-500, 500);
+      double y = uniform(-200, 200);
+      double a = uniform(0, 6.283185307179586);
+      double dx = std::cos(a);
+      double dy = std::sin(a);
+      double radius = 1.5;
+      double length = 150.0;
+
+      double best = HUGE_VAL;
+      for (size_t i = 0; i < items.size(); ++i)
+      {
+        double px = items[i].x - x;
+        double py = items[i].y - y;
+        double b = px * dx + py * dy;
+        double c = px * px + py * py - radius * radius;
+        double disc = b * b - c;
+        if (disc < 0)
+          continue;
+
+        double t = (c <= 0) ? 0 : b - std::sqrt(disc);
+        if (t >= 0 && t <= length)
+          best = std::min(best, t);
+      }
+
+      double range = -1;
+      size_t index = 0;
+      bool hit = tree.raycast(x, y, 10 * dx, 10 * dy, length, radius, range, index);
+      if (hit != (best <= length))
+        ok = false;
+
+      if (hit)
+      {
+        ++hits;
+        if (std::fabs(range - best) > 1e-9 || distance(tree[index], x + range * dx, y + range * dy) > radius + 1e-9)
+          ok = false;
+      }
+    }
+
+    test.boolean("raycast: brute force", ok && hits > 0);
+  }
+
+  {
+    tree.clear();
+    size_t index;
+    test.boolean("clear", tree.empty() && !tree.nearest(0, 0, index));
+  }
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,243 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+// Test program for DUNE::Navigation::KalmanFilter class.                   *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/Math/Matrix.hpp>
+#include <DUNE/Navigation/KalmanFilter.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE::Math;
+using DUNE::Navigation::KalmanFilter;
+
+static double
+uniform(void)
+{
+  return (std::rand() % 2001 - 1000) / 1000.0;
+}
+
+//! Fill filter with a random symmetric positive definite covariance,
+//! random observation and innovation. Copy everything to the legacy
+//! matrices.
+static void
+setup(KalmanFilter& kal, int n, int m, bool diagonal,
+      Matrix& x, Matrix& p, Matrix& c, Matrix& r, Matrix& innov)
+{
+  kal.reset(n, m);
+
+  Matrix a(n, n);
+  for (int i = 0; i < n * n; ++i)
+    a(i) = uniform();
+  p = a * transpose(a) + Matrix(n) * 0.1;
+
+  x = Matrix(n, 1);
+  c = Matrix(m, n);
+  r = Matrix(m, m, 0.0);
+  innov = Matrix(m, 1);
+
+  for (int i = 0; i < n; ++i)
+  {
+    x(i) = uniform();
+    kal.setState(i, x(i));
+    for (int j = 0; j < n; ++j)
+      kal.setCovariance(i, j, p(i, j));
+  }
+
+  for (int i = 0; i < m; ++i)
+  {
+    innov(i) = uniform();
+    kal.setInnovation(i, innov(i));
+    for (int j = 0; j < n; ++j)
+    {
+      c(i, j) = uniform();
+      kal.setObservation(i, j, c(i, j));
+    }
+  }
+
+  Matrix b(m, m);
+  for (int i = 0; i < m * m; ++i)
+    b(i) = uniform() * (diagonal ? 0.0 : 0.2);
+  for (int i = 0; i < m; ++i)
+    b(i, i) = 0.5 + std::fabs(uniform());
+
+  r = b * transpose(b);
+  for (int i = 0; i < m; ++i)
+  {
+    for (int j = 0; j < m; ++j)
+      kal.setMeasurementNoise(i, j, r(i, j));
+  }
+}
+
+//! Reference update: explicit inverse of the innovation covariance.
+static void
+legacy(Matrix& x, Matrix& p, const Matrix& c, const Matrix& r, const Matrix& innov)
+{
+  Matrix s = c * p * transpose(c) + r;
+  Matrix k = p * transpose(c) * inverse(s);
+  x = x + k * innov;
+  p = p - k * c * p;
+}
+
+static bool
+equal(const Matrix& a, const Matrix& b)
+{
+  if (a.rows() != b.rows() || a.columns() != b.columns())
+    return false;
+
+  for (int i = 0; i < a.size(); ++i)
+  {
+    if (std::fabs(a(i) - b(i)) > 1e-8 * (1.0 + std::fabs(b(i))))
+      return false;
+  }
+
+  return true;
+}
+
+static bool
+symmetric(const Matrix& a)
+{
+  for (int i = 0; i < a.rows(); ++i)
+  {
+    for (int j = i + 1; j < a.columns(); ++j)
+    {
+      if (a(i, j) != a(j, i))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+int
+main(void)
+{
+  Test test("Navigation::KalmanFilter");
+
+  std::srand(1);
+
+  {
+    KalmanFilter kal;
+    Matrix x, p, c, r, innov;
+    setup(kal, 9, 6, true, x, p, c, r, innov);
+    legacy(x, p, c, r, innov);
+    test.boolean("diagonal: update result", kal.update(0.0) == 0);
+    test.boolean("diagonal: state", equal(kal.getState(), x));
+    test.boolean("diagonal: covariance", equal(kal.getCovariance(), p));
+    test.boolean("diagonal: symmetric", symmetric(kal.getCovariance()));
+  }
+
+  {
+    KalmanFilter kal;
+    Matrix x, p, c, r, innov;
+    setup(kal, 9, 8, false, x, p, c, r, innov);
+    legacy(x, p, c, r, innov);
+    test.boolean("full: update result", kal.update(0.0) == 0);
+    test.boolean("full: state", equal(kal.getState(), x));
+    test.boolean("full: covariance", equal(kal.getCovariance(), p));
+    test.boolean("full: symmetric", symmetric(kal.getCovariance()));
+  }
+
+  {
+    KalmanFilter kal;
+    Matrix x, p, c, r, innov;
+    setup(kal, 4, 4, false, x, p, c, r, innov);
+    Matrix z = transpose(innov) * inverse(c * p * transpose(c) + r) * innov;
+    test.boolean("gate: rejected", kal.update(z(0) * 0.5) == -1);
+    test.boolean("gate: state untouched", equal(kal.getState(), x));
+    test.boolean("gate: accepted", kal.update(z(0) * 2.0) == 0);
+  }
+
+  {
+    KalmanFilter kal;
+    Matrix x, p, c, r, innov;
+    setup(kal, 4, 4, true, x, p, c, r, innov);
+    kal.resize(6);
+    kal.setInnovation(4, 10.0);
+    kal.setInnovation(5, 10.0);
+    legacy(x, p, c, r, innov);
+    test.boolean("unused output: update result", kal.update(0.0) == 0);
+    test.boolean("unused output: state", equal(kal.getState(), x));
+    test.boolean("unused output: covariance", equal(kal.getCovariance(), p));
+  }
+
+  {
+    KalmanFilter kal;
+    Matrix x, p, c, r, innov;
+    setup(kal, 4, 2, false, x, p, c, r, innov);
+    for (int i = 0; i < 2; ++i)
+    {
+      for (int j = 0; j < 2; ++j)
+        kal.setMeasurementNoise(i, j, -1.0);
+    }
+    for (int j = 0; j < 4; ++j)
+      kal.setObservation(1, j, kal.getObservation()(0, j));
+
+    bool thrown = false;
+    int rv = 0;
+    try
+    {
+      rv = kal.update(0.1f);
+    }
+    catch (...)
+    {
+      thrown = true;
+    }
+    test.boolean("singular: no exception", !thrown);
+    test.boolean("singular: rejected", rv == -1);
+    test.boolean("singular: state untouched", equal(kal.getState(), x));
+  }
+
+  {
+    KalmanFilter kal;
+    Matrix x, p, c, r, innov;
+    setup(kal, 4, 4, true, x, p, c, r, innov);
+    Matrix a(4, 4);
+    for (int i = 0; i < 16; ++i)
+      a(i) = uniform();
+    Matrix q(4, 4, 0.0);
+    q(0, 0) = q(3, 3) = 0.5;
+    for (int i = 0; i < 4; ++i)
+      kal.setProcessNoise(i, q(i, i));
+    kal.setTransitions(a);
+    kal.predict();
+    x = a * x;
+    p = a * p * transpose(a) + q;
+    test.boolean("predict: state", equal(kal.getState(), x));
+    test.boolean("predict: covariance", equal(kal.getCovariance(), p));
+    test.boolean("predict: symmetric", symmetric(kal.getCovariance()));
+  }
+
+  return test.getReturnValue();
+}
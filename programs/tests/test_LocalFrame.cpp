@@ -0,0 +1,131 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+// Test program for DUNE::Coordinates::LocalFrame class.                   *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/Coordinates/General.hpp>
+#include <DUNE/Coordinates/LocalFrame.hpp>
+#include <DUNE/Coordinates/WGS84.hpp>
+#include <DUNE/IMC/Definitions.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+using namespace DUNE::Coordinates;
+
+static double
+uniform(double min, double max)
+{
+  return min + (max - min) * (std::rand() / (double)RAND_MAX);
+}
+
+//! Equal up to rounding (contraction to FMA may differ by context).
+static bool
+same(double a, double b)
+{
+  return std::fabs(a - b) <= 1e-12 * (1.0 + std::fabs(a));
+}
+
+int
+main(void)
+{
+  Test test("Coordinates::LocalFrame");
+
+  std::srand(1);
+
+  {
+    LocalFrame frame;
+    test.boolean("setReference: changed", frame.setReference(0.71, -0.15, 10.0));
+    test.boolean("setReference: unchanged", !frame.setReference(0.71, -0.15, 10.0));
+    test.boolean("setReference: height", frame.setReference(0.71, -0.15, 11.0));
+  }
+
+  bool displacement = true;
+  bool displace = true;
+  bool displace_ne = true;
+  for (unsigned i = 0; i < 1000; ++i)
+  {
+    double rlat = uniform(-1.4, 1.4);
+    double rlon = uniform(-3.1, 3.1);
+    double rhae = uniform(-50.0, 500.0);
+    LocalFrame frame(rlat, rlon, rhae);
+
+    double lat = rlat + uniform(-0.01, 0.01);
+    double lon = rlon + uniform(-0.01, 0.01);
+    double hae = uniform(-50.0, 500.0);
+
+    double n0, e0, d0, n1, e1, d1;
+    WGS84::displacement(rlat, rlon, rhae, lat, lon, hae, &n0, &e0, &d0);
+    frame.displacement(lat, lon, hae, &n1, &e1, &d1);
+    displacement &= same(n0, n1) && same(e0, e1) && same(d0, d1);
+
+    double lat0 = rlat, lon0 = rlon, hae0 = rhae;
+    double lat1, lon1, hae1;
+    WGS84::displace(n0, e0, d0, &lat0, &lon0, &hae0);
+    frame.displace(n0, e0, d0, &lat1, &lon1, &hae1);
+    displace &= same(lat0, lat1) && same(lon0, lon1) && same(hae0, hae1);
+
+    LocalFrame flat(rlat, rlon);
+    lat0 = rlat;
+    lon0 = rlon;
+    WGS84::displace(n0, e0, &lat0, &lon0);
+    flat.displace(n0, e0, &lat1, &lon1);
+    displace_ne &= same(lat0, lat1) && same(lon0, lon1);
+  }
+
+  test.boolean("displacement: same as WGS84", displacement);
+  test.boolean("displace: same as WGS84", displace);
+  test.boolean("displace (NE): same as WGS84", displace_ne);
+
+  {
+    IMC::EstimatedState state;
+    state.lat = 0.7188;
+    state.lon = -0.1528;
+    state.height = 12.5;
+    state.x = 150.0;
+    state.y = -320.0;
+    state.z = 4.0;
+
+    double lat0, lon0, lat1, lon1;
+    float hae0, hae1;
+    Coordinates::toWGS84(state, lat0, lon0, hae0);
+
+    LocalFrame frame;
+    frame.toWGS84(state, lat1, lon1, hae1);
+    test.boolean("toWGS84: same as Coordinates::toWGS84", same(lat0, lat1) && same(lon0, lon1) && same(hae0, hae1));
+    test.boolean("toWGS84: reference kept", !frame.setReference(state));
+  }
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,390 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+// Test program for DUNE::IMC::LogReader and related classes.               *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using DUNE_NAMESPACES;
+
+//! Number of states in each test log.
+static const unsigned c_states = 20000;
+
+//! Write a log with c_states EstimatedState messages (x = index) and
+//! a Voltage message after every tenth state.
+static void
+writeLog(std::ostream& os, double offset)
+{
+  Utils::ByteBuffer bfr;
+
+  for (unsigned i = 0; i < c_states; ++i)
+  {
+    IMC::EstimatedState state;
+    state.setTimeStamp(offset + i);
+    state.x = i;
+    IMC::Packet::serialize(&state, bfr);
+    os.write(bfr.getBufferSigned(), bfr.getSize());
+
+    if (i % 10 == 0)
+    {
+      IMC::Voltage voltage;
+      voltage.setTimeStamp(offset + i);
+      voltage.value = offset;
+      IMC::Packet::serialize(&voltage, bfr);
+      os.write(bfr.getBufferSigned(), bfr.getSize());
+    }
+  }
+}
+
+//! Count messages of a log, checking order.
+static bool
+readAll(IMC::LogReader& reader, unsigned& states, unsigned& voltages)
+{
+  bool ordered = true;
+  states = 0;
+  voltages = 0;
+
+  IMC::Message* msg = NULL;
+  while ((msg = reader.read()) != NULL)
+  {
+    if (msg->getId() == DUNE_IMC_ESTIMATEDSTATE)
+    {
+      ordered = ordered && static_cast<IMC::EstimatedState*>(msg)->x == states;
+      ++states;
+    }
+    else if (msg->getId() == DUNE_IMC_VOLTAGE)
+    {
+      ++voltages;
+    }
+
+    delete msg;
+  }
+
+  return ordered;
+}
+
+struct Arguments
+{
+  unsigned stop_after;
+  bool throw_in_consume;
+  bool throw_in_constructor;
+
+  Arguments(void):
+    stop_after(0),
+    throw_in_consume(false),
+    throw_in_constructor(false)
+  { }
+};
+
+//! Number of live VoltageCounter objects and its maximum.
+static Concurrency::Mutex s_alive_lock;
+static unsigned s_alive = 0;
+static unsigned s_alive_max = 0;
+
+class VoltageCounter: public IMC::LogProcessor
+{
+public:
+  VoltageCounter(const Arguments& args):
+    voltages(0),
+    states(0),
+    offset(-1.0),
+    m_args(args)
+  {
+    if (m_args.throw_in_constructor)
+      throw std::logic_error("constructor failed");
+
+    bind<IMC::Voltage>(this);
+
+    Concurrency::ScopedMutex l(s_alive_lock);
+    s_alive_max = std::max(s_alive_max, ++s_alive);
+  }
+
+  ~VoltageCounter(void)
+  {
+    Concurrency::ScopedMutex l(s_alive_lock);
+    --s_alive;
+  }
+
+  void
+  consume(const IMC::Voltage* msg)
+  {
+    if (m_args.throw_in_consume)
+      throw std::logic_error("consumer failed");
+
+    offset = msg->value;
+
+    if (++voltages == m_args.stop_after)
+      stop();
+  }
+
+  unsigned voltages;
+  unsigned states;
+  float offset;
+
+protected:
+  void
+  onMessage(const IMC::Message* msg)
+  {
+    if (msg->getId() == DUNE_IMC_ESTIMATEDSTATE)
+      ++states;
+  }
+
+private:
+  const Arguments& m_args;
+};
+
+struct Collector
+{
+  std::vector<float> offsets;
+  unsigned voltages;
+  //! Throw after this many reductions (zero to never throw).
+  unsigned fail_after;
+
+  Collector(void):
+    voltages(0),
+    fail_after(0)
+  { }
+
+  void
+  reduce(VoltageCounter& counter)
+  {
+    if (fail_after > 0 && offsets.size() == fail_after)
+      throw std::runtime_error("reducer failed");
+
+    // A slow first reduction lets workers run ahead if they can.
+    if (offsets.empty())
+      Delay::wait(0.2);
+
+    offsets.push_back(counter.offset);
+    voltages += counter.voltages;
+  }
+};
+
+int
+main(void)
+{
+  Test test("IMC::LogReader");
+
+  Path plain = Path::current() / "test_LogReader.lsf";
+  Path gzip = Path::current() / "test_LogReader.lsf.gz";
+  Path truncated = Path::current() / "test_LogReader_truncated.lsf";
+
+  {
+    std::ofstream os(plain.c_str(), std::ios::binary);
+    writeLog(os, 0);
+  }
+
+  {
+    Compression::FileOutput os(gzip.c_str(), Compression::METHOD_GZIP);
+    writeLog(os, 0);
+  }
+
+  {
+    std::ifstream is(plain.c_str(), std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    std::ofstream os(truncated.c_str(), std::ios::binary);
+    os.write(&data[0], data.size() - 10);
+  }
+
+  {
+    IMC::LogReader reader(plain.c_str());
+    unsigned states, voltages;
+    test.boolean("plain: order", readAll(reader, states, voltages));
+    test.boolean("plain: all messages", states == c_states && voltages == c_states / 10);
+    test.boolean("plain: progress", reader.getProgress() == 1.0f);
+    test.boolean("plain: end is sticky", reader.read() == NULL);
+  }
+
+  {
+    IMC::LogReader reader(gzip.c_str());
+    unsigned states, voltages;
+    test.boolean("gzip: order", readAll(reader, states, voltages));
+    test.boolean("gzip: all messages", states == c_states && voltages == c_states / 10);
+  }
+
+  {
+    std::vector<bool> filter(DUNE_IMC_CONST_NULL_ID, false);
+    filter[DUNE_IMC_VOLTAGE] = true;
+    IMC::LogReader reader(gzip.c_str(), filter);
+    unsigned states, voltages;
+    readAll(reader, states, voltages);
+    test.boolean("filter", states == 0 && voltages == c_states / 10);
+  }
+
+  {
+    IMC::LogReader reader(truncated.c_str());
+    unsigned states = 0;
+    bool thrown = false;
+
+    try
+    {
+      IMC::Message* msg = NULL;
+      while ((msg = reader.read()) != NULL)
+      {
+        states += msg->getId() == DUNE_IMC_ESTIMATEDSTATE;
+        delete msg;
+      }
+    }
+    catch (std::runtime_error& e)
+    {
+      thrown = true;
+    }
+
+    test.boolean("truncated: error", thrown);
+    test.boolean("truncated: messages before error", states == c_states - 1);
+  }
+
+  {
+    bool thrown = false;
+
+    try
+    {
+      IMC::LogReader reader("test_LogReader_missing.lsf");
+    }
+    catch (std::runtime_error& e)
+    {
+      thrown = true;
+    }
+
+    test.boolean("missing file", thrown);
+  }
+
+  {
+    // Destroy reader with most of the log still in the pipeline.
+    IMC::LogReader reader(plain.c_str());
+    delete reader.read();
+    test.boolean("early destruction", true);
+  }
+
+  Arguments args;
+
+  {
+    VoltageCounter counter(args);
+    test.boolean("processor: result", counter.process(gzip.c_str()));
+    test.boolean("processor: typed consumer", counter.voltages == c_states / 10);
+    test.boolean("processor: only bound messages", counter.states == 0);
+  }
+
+  {
+    VoltageCounter counter(args);
+    test.boolean("processor: error", !counter.process(truncated.c_str()) && !counter.getError().empty());
+  }
+
+  {
+    Arguments stop_args;
+    stop_args.stop_after = 5;
+    VoltageCounter counter(stop_args);
+    test.boolean("processor: stop", counter.process(plain.c_str()) && counter.isStopped()
+                 && counter.voltages == 5);
+  }
+
+  {
+    Arguments throw_args;
+    throw_args.throw_in_consume = true;
+    VoltageCounter counter(throw_args);
+    test.boolean("processor: consumer exception", !counter.process(plain.c_str())
+                 && counter.getError() == "consumer failed");
+  }
+
+  {
+    std::vector<Path> logs;
+    std::vector<std::string> paths;
+
+    for (unsigned i = 0; i < 6; ++i)
+    {
+      Path log = Path::current() / String::str("test_LogReader_%u.lsf", i);
+      std::ofstream os(log.c_str(), std::ios::binary);
+      writeLog(os, i + 1);
+      logs.push_back(log);
+      paths.push_back(log.str());
+    }
+
+    Collector collector;
+    IMC::LogMapReduce<VoltageCounter, Arguments> map_reduce(args, 3);
+    s_alive_max = 0;
+    map_reduce.run(paths, collector);
+
+    bool ordered = collector.offsets.size() == logs.size();
+    for (unsigned i = 0; ordered && i < collector.offsets.size(); ++i)
+      ordered = collector.offsets[i] == i + 1;
+
+    test.boolean("map/reduce: log order", ordered);
+    test.boolean("map/reduce: total", collector.voltages == logs.size() * c_states / 10);
+    test.boolean("map/reduce: bounded read-ahead", s_alive_max <= 3 && s_alive == 0);
+
+    Arguments throw_args;
+    throw_args.throw_in_constructor = true;
+    IMC::LogMapReduce<VoltageCounter, Arguments> failing(throw_args, 3);
+    Collector failed;
+    bool thrown = false;
+    try
+    {
+      failing.run(paths, failed);
+    }
+    catch (std::runtime_error& e)
+    {
+      thrown = std::string(e.what()) == "constructor failed";
+    }
+    test.boolean("map/reduce: constructor exception", thrown && failed.offsets.empty());
+
+    // Arguments are copied, so a temporary can be used.
+    IMC::LogMapReduce<VoltageCounter, Arguments> reducing(Arguments(), 3);
+    Collector failing_reducer;
+    failing_reducer.fail_after = 2;
+    thrown = false;
+    try
+    {
+      reducing.run(paths, failing_reducer);
+    }
+    catch (std::runtime_error& e)
+    {
+      thrown = std::string(e.what()) == "reducer failed";
+    }
+    test.boolean("map/reduce: reducer exception", thrown && failing_reducer.offsets.size() == 2);
+    test.boolean("map/reduce: joined after reducer error", s_alive == 0);
+
+    for (unsigned i = 0; i < logs.size(); ++i)
+      logs[i].remove();
+  }
+
+  plain.remove();
+  gzip.remove();
+  truncated.remove();
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,182 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/IMC.hpp>
+#include <DUNE/Tasks/MessageFilter.hpp>
+#include <DUNE/Time/Clock.hpp>
+#include <DUNE/Time/Delay.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE;
+
+static std::vector<std::string>
+spec(const char* item)
+{
+  return std::vector<std::string>(1, item);
+}
+
+int
+main(void)
+{
+  Test test("Tasks::MessageFilter");
+
+  {
+    Tasks::MessageFilter filter;
+    IMC::EntityState msg;
+    test.boolean("unconfigured: passes", !filter.filter(&msg) && !filter.filter(&msg));
+  }
+
+  {
+    Tasks::MessageFilter filter;
+    filter.setupRates(spec("EntityState:0.001"));
+    IMC::EntityState msg;
+    msg.setSourceEntity(1);
+    test.boolean("rate: first passes", !filter.filter(&msg));
+    test.boolean("rate: second filtered", filter.filter(&msg));
+    msg.setSourceEntity(2);
+    test.boolean("rate: per entity", !filter.filter(&msg));
+
+    IMC::Voltage other;
+    test.boolean("rate: other message passes", !filter.filter(&other));
+  }
+
+  {
+    Tasks::MessageFilter filter;
+    filter.setupDuplicates(spec("EntityState:1000"));
+    IMC::EntityState msg;
+    msg.description = "Active";
+    test.boolean("dedup: first passes", !filter.filter(&msg));
+    msg.setTimeStamp(msg.getTimeStamp() + 1.0);
+    test.boolean("dedup: unchanged filtered", filter.filter(&msg));
+    msg.description = "Idle";
+    test.boolean("dedup: changed passes", !filter.filter(&msg));
+    test.boolean("dedup: changed filtered", filter.filter(&msg));
+  }
+
+  {
+    Tasks::MessageFilter filter;
+    filter.setupDuplicates(spec("EntityState:0.000001"));
+    IMC::EntityState msg;
+    filter.filter(&msg);
+    Time::Delay::wait(0.01);
+    test.boolean("dedup: maximum silence", !filter.filter(&msg));
+  }
+
+  {
+    bool thrown = false;
+    Tasks::MessageFilter filter;
+    try
+    {
+      filter.setupDuplicates(spec("EntityState:-1"));
+    }
+    catch (std::runtime_error&)
+    {
+      thrown = true;
+    }
+    test.boolean("dedup: invalid specification", thrown);
+  }
+
+  {
+    Tasks::MessageFilter filter;
+    filter.setupDuplicates(spec("EntityState"));
+    IMC::EntityState msg;
+    unsigned size = msg.getSerializationSize();
+    filter.setupLink(1e-3, size * 2);
+    double now = Time::Clock::get();
+
+    msg.setSourceEntity(1);
+    bool first = !filter.filter(&msg) && !filter.shape(&msg, size, 1, now);
+    msg.setSourceEntity(2);
+    bool second = !filter.filter(&msg) && !filter.shape(&msg, size, 1, now);
+    msg.setSourceEntity(3);
+    test.boolean("link: budget", first && second && !filter.filter(&msg) && filter.shape(&msg, size, 1, now));
+    test.boolean("link: rate limiters slowed down", filter.getScale() > 1.0);
+    test.boolean("link: per peer", !filter.shape(&msg, size, 2, now));
+
+    msg.setSourceEntity(4);
+    filter.filter(&msg);
+    filter.shape(&msg, size, 1, now);
+    test.boolean("link: rejected message not forwarded", !filter.filter(&msg));
+
+    IMC::Abort abort;
+    test.boolean("link: unmanaged message passes", !filter.filter(&abort) && !filter.shape(&abort, size, 1, now));
+
+    filter.removeLink(1);
+    test.boolean("link: removed link no longer slows down", filter.getScale() == 1.0);
+  }
+
+  {
+    Tasks::MessageFilter filter;
+    filter.setupDuplicates(spec("EntityState"));
+    IMC::EntityState msg;
+    filter.setupLink(1e-3, 100);
+    double now = Time::Clock::get();
+
+    msg.setSourceEntity(1);
+    bool small = !filter.filter(&msg) && !filter.shape(&msg, 60, 1, now);
+    msg.setSourceEntity(2);
+    test.boolean("link: charges bytes sent", small && !filter.filter(&msg) && filter.shape(&msg, 60, 1, now));
+    test.boolean("link: encoded size", !filter.shape(&msg, 40, 1, now));
+
+    msg.setSourceEntity(3);
+    filter.filter(&msg);
+    filter.shape(&msg, 100, 2, now);
+    double scale = filter.getScale();
+    for (unsigned i = 0; i < 100; ++i)
+    {
+      msg.setSourceEntity(4);
+      filter.filter(&msg);
+      filter.shape(&msg, 1, 3, now);
+    }
+    test.boolean("link: spare link does not undo slowdown", filter.getScale() == scale && scale > 1.0);
+  }
+
+  {
+    Tasks::MessageFilter filter;
+    filter.setupLink(1000, 100);
+    filter.onTransmission(1, false);
+    test.boolean("capacity: decrease", filter.getLinkCapacity(1) == 500);
+    test.boolean("capacity: per peer", filter.getLinkCapacity(2) == 1000);
+    filter.onTransmission(1, true);
+    test.boolean("capacity: increase", filter.getLinkCapacity(1) == 510);
+    filter.onLinkLoss(1, 0.2);
+    test.boolean("capacity: measured loss", filter.getLinkCapacity(1) == 408);
+    filter.onLinkLoss(1, 0.01);
+    test.boolean("capacity: low loss", filter.getLinkCapacity(1) == 418);
+  }
+
+  return test.getReturnValue();
+}
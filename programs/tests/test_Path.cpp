@@ -33,6 +33,11 @@
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
+// POSIX headers.
+#if defined(DUNE_OS_POSIX)
+#  include <unistd.h>
+#endif
+
 using DUNE_NAMESPACES;
 
 // Local headers.
@@ -144,5 +149,27 @@ main(void)
     test.boolean("Path::suffix()", a.suffix(b) == "dir2");
   }
 
+#if defined(DUNE_OS_POSIX)
+  {
+    Path a = tmp / "canonical_level0";
+    (a / "real").create();
+    bool linked = symlink("real", (a / "link").c_str()) == 0;
+    test.boolean("Path::canonical()", linked && (a / "link" / "..").canonical() == a.canonical()
+                 && (a / "link").canonical() == (a / "real").canonical());
+
+    bool thrown = false;
+    try
+    {
+      (a / "missing").canonical();
+    }
+    catch (System::Error&)
+    {
+      thrown = true;
+    }
+    test.boolean("Path::canonical() of missing path", thrown);
+    pathRemove(a, Path::MODE_RECURSIVE);
+  }
+#endif
+
   return 0;
 }
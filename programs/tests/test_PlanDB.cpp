@@ -0,0 +1,119 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Eduardo Marques                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/IMC.hpp>
+
+// Local headers.
+#include <Plan/DB/ReplyQueue.hpp>
+#include "Test.hpp"
+
+using namespace DUNE;
+
+static IMC::PlanDB
+reply(uint8_t op, uint8_t type, uint16_t request_id)
+{
+  IMC::PlanDB msg;
+  msg.op = op;
+  msg.type = type;
+  msg.request_id = request_id;
+  return msg;
+}
+
+int
+main(void)
+{
+  Test test("Plan::DB::ReplyQueue");
+
+  {
+    Plan::DB::ReplyQueue queue;
+    test.boolean("committed: SET acknowledged now",
+                 queue.post(reply(IMC::PlanDB::DBOP_SET, IMC::PlanDB::DBT_SUCCESS, 1), false));
+    test.boolean("committed: GET answered now",
+                 queue.post(reply(IMC::PlanDB::DBOP_GET, IMC::PlanDB::DBT_SUCCESS, 2), true));
+    test.boolean("failure: sent now",
+                 queue.post(reply(IMC::PlanDB::DBOP_SET, IMC::PlanDB::DBT_FAILURE, 3), true));
+    test.boolean("nothing held", queue.empty());
+  }
+
+  {
+    Plan::DB::ReplyQueue queue;
+    std::vector<IMC::PlanDB> out;
+
+    bool set = queue.post(reply(IMC::PlanDB::DBOP_SET, IMC::PlanDB::DBT_SUCCESS, 1), true);
+    bool del = queue.post(reply(IMC::PlanDB::DBOP_DEL, IMC::PlanDB::DBT_SUCCESS, 2), true);
+    bool prg = queue.post(reply(IMC::PlanDB::DBOP_GET, IMC::PlanDB::DBT_IN_PROGRESS, 3), true);
+    bool get = queue.post(reply(IMC::PlanDB::DBOP_GET, IMC::PlanDB::DBT_SUCCESS, 3), true);
+    test.boolean("uncommitted: SET held", !set);
+    test.boolean("uncommitted: DEL held", !del);
+    test.boolean("uncommitted: progress sent now", prg);
+    test.boolean("uncommitted: GET waits behind changes", !get);
+
+    queue.commit(out);
+    test.boolean("commit: releases all", out.size() == 3 && queue.empty());
+    test.boolean("commit: request order",
+                 out.size() == 3 && out[0].request_id == 1
+                 && out[1].request_id == 2 && out[2].request_id == 3);
+    test.boolean("commit: replies unchanged",
+                 out.size() == 3 && out[0].type == IMC::PlanDB::DBT_SUCCESS
+                 && out[2].op == IMC::PlanDB::DBOP_GET);
+
+    test.boolean("after commit: GET answered now",
+                 queue.post(reply(IMC::PlanDB::DBOP_GET, IMC::PlanDB::DBT_SUCCESS, 4), false));
+  }
+
+  {
+    Plan::DB::ReplyQueue queue;
+    std::vector<IMC::PlanDB> out;
+
+    IMC::PlanDB set = reply(IMC::PlanDB::DBOP_SET, IMC::PlanDB::DBT_SUCCESS, 1);
+    set.info = "OK (new entry)";
+    IMC::PlanDBInformation info;
+    info.plan_id = "plan";
+    set.arg.set(info);
+    queue.post(set, true);
+    IMC::PlanDB failed = reply(IMC::PlanDB::DBOP_DEL, IMC::PlanDB::DBT_FAILURE, 2);
+    failed.info = "undefined plan";
+    queue.post(failed, true);
+
+    queue.abort("disk full", out);
+    test.boolean("abort: releases all", out.size() == 2 && queue.empty());
+    test.boolean("abort: acknowledgement fails",
+                 out.size() == 2 && out[0].type == IMC::PlanDB::DBT_FAILURE
+                 && out[0].info == "disk full" && out[0].arg.isNull());
+    test.boolean("abort: failure kept",
+                 out.size() == 2 && out[1].type == IMC::PlanDB::DBT_FAILURE
+                 && out[1].info == "undefined plan");
+  }
+
+  return test.getReturnValue();
+}
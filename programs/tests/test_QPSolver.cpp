@@ -0,0 +1,205 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+// Test program for DUNE::Math::QPSolver class.                             *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/Math/Matrix.hpp>
+#include <DUNE/Math/FixedMatrix.hpp>
+#include <DUNE/Math/QPSolver.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE::Math;
+
+//! Number of actuators of the allocation problem.
+static const int c_n = 6;
+//! Number of generalized forces of the allocation problem.
+static const int c_k = 4;
+
+static double
+uniform(void)
+{
+  return (std::rand() % 2001 - 1000) / 1000.0;
+}
+
+static bool
+equal(const Matrix& a, const Matrix& b, double tol = 1e-9)
+{
+  if (a.rows() != b.rows() || a.columns() != b.columns())
+    return false;
+
+  for (int i = 0; i < a.size(); ++i)
+  {
+    if (std::fabs(a(i) - b(i)) > tol)
+      return false;
+  }
+
+  return true;
+}
+
+//! Thrust allocation: minimize |B u - tau|^2 + eps |u|^2 with |u| <= 1.
+static void
+allocation(const Matrix& B, const Matrix& tau, Matrix& H, Matrix& f, Matrix& A, Matrix& b)
+{
+  H = transpose(B) * B + Matrix(c_n) * 1e-3;
+  f = transpose(B) * tau * -1.0;
+  A = Matrix(2 * c_n, c_n, 0.0);
+  b = Matrix(2 * c_n, 1, 1.0);
+  for (int i = 0; i < c_n; ++i)
+  {
+    A(i, i) = 1.0;
+    A(c_n + i, i) = -1.0;
+  }
+}
+
+int
+main(void)
+{
+  Test test("Math::QPSolver");
+  std::srand(7);
+
+  {
+    // Minimize 0.5 x^2 - 2 x subject to x <= 1.
+    Matrix H(1, 1, 1.0), f(1, 1, -2.0), A(1, 1, -1.0), b(1, 1, 1.0), x;
+    double v = QPSolver::solve(H, f, A, b, x);
+    test.boolean("static: solution", std::fabs(x(0) - 1.0) < 1e-12);
+    test.boolean("static: objective", std::fabs(v + 1.5) < 1e-12);
+  }
+
+  {
+    // Minimize 0.5 |x|^2 subject to x0 + x1 = 1.
+    Matrix H(2), f(2, 1, 0.0), Aeq(1, 2, 1.0), beq(1, 1, -1.0);
+    Matrix A(1, 2, 0.0), b(1, 1, 10.0), x;
+    A(0, 0) = 1.0;
+    QPSolver qp;
+    qp.minimize(H, f, Aeq, beq, A, b, x);
+    test.boolean("equality: solution", std::fabs(x(0) - 0.5) < 1e-12 && std::fabs(x(1) - 0.5) < 1e-12);
+  }
+
+  Matrix B(c_k, c_n);
+  for (int i = 0; i < B.size(); ++i)
+    B(i) = uniform();
+
+  {
+    QPSolver qp;
+    bool same = true;
+    bool feasible = true;
+    unsigned warm_iterations = 0;
+    unsigned cold_iterations = 0;
+    Matrix tau(c_k, 1), H, f, A, b, x, y;
+
+    for (int step = 0; step < 50; ++step)
+    {
+      // Slowly varying demand, large enough to saturate actuators.
+      for (int i = 0; i < c_k; ++i)
+        tau(i) = 3.0 * std::sin(0.05 * step + i);
+
+      allocation(B, tau, H, f, A, b);
+      double v = qp.minimize(H, f, A, b, x);
+      double w = QPSolver::solve(H, f, A, b, y);
+      same = same && equal(x, y) && std::fabs(v - w) < 1e-9;
+
+      for (int i = 0; i < c_n; ++i)
+        feasible = feasible && std::fabs(x(i)) <= 1.0 + 1e-9;
+
+      if (step > 0)
+      {
+        warm_iterations += qp.getStatistics().iterations;
+        QPSolver cold;
+        cold.minimize(H, f, A, b, y);
+        cold_iterations += cold.getStatistics().iterations;
+      }
+    }
+
+    const QPSolver::Statistics& stats = qp.getStatistics();
+    test.boolean("warm start: same solution as cold", same);
+    test.boolean("warm start: feasible", feasible);
+    test.boolean("warm start: fewer iterations", warm_iterations < cold_iterations);
+    test.boolean("statistics: solves", stats.solves == 50);
+    test.boolean("statistics: factorization reused", stats.factorization_reused);
+    test.boolean("statistics: converged", stats.converged && stats.interrupted == 0);
+    test.boolean("statistics: solve time", stats.solve_time >= 0.0 && stats.max_solve_time >= stats.solve_time);
+  }
+
+  {
+    Matrix tau(c_k, 1, 5.0), H, f, A, b, x;
+    allocation(B, tau, H, f, A, b);
+
+    QPSolver qp;
+    qp.setWarmStart(false);
+    qp.minimize(H, f, A, b, x);
+    unsigned needed = qp.getStatistics().iterations;
+
+    qp.setMaximumIterations(1);
+    qp.minimize(H, f, A, b, x);
+    test.boolean("budget: problem needs iterations", needed > 1);
+    test.boolean("budget: interrupted", !qp.getStatistics().converged && qp.getStatistics().interrupted == 1);
+    test.boolean("budget: iterations bounded", qp.getStatistics().iterations == 1);
+  }
+
+  {
+    Matrix tau(c_k, 1, 2.0), H, f, A, b, x;
+    allocation(B, tau, H, f, A, b);
+
+    FixedMatrix<c_n, c_n> fH(H);
+    FixedMatrix<c_n, 1> ff(f);
+    FixedMatrix<2 * c_n, c_n> fA(A);
+    FixedMatrix<2 * c_n, 1> fb(b);
+    FixedMatrix<c_n, 1> fx;
+
+    QPSolver qp;
+    double v = qp.minimize(fH, ff, fA, fb, fx);
+    double w = QPSolver::solve(H, f, A, b, x);
+    test.boolean("fixed size: same solution", equal(fx.toMatrix(), x) && std::fabs(v - w) < 1e-9);
+  }
+
+  {
+    // x >= 1 and x <= -1.
+    Matrix H(1, 1, 1.0), f(1, 1, 0.0), A(2, 1, 1.0), b(2, 1, -1.0), x;
+    A(1) = -1.0;
+    bool thrown = false;
+    try
+    {
+      QPSolver::solve(H, f, A, b, x);
+    }
+    catch (QPSolver::Error&)
+    {
+      thrown = true;
+    }
+    test.boolean("infeasible: throws", thrown);
+  }
+
+  return test.getReturnValue();
+}
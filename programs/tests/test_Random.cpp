@@ -48,6 +48,12 @@ test_MT19937(void);
 void
 test_KernelDevice(void);
 
+void
+test_Xoshiro256(void);
+
+void
+test_Streams(void);
+
 Test test("DUNE::Math::Random");
 
 int
@@ -71,6 +77,11 @@ main(int argc, char** argv)
   test_MT19937();
   // ** FOR KernelDevice: we merely check for sanity if /dev/urandom is available **
   test_KernelDevice();
+  // ** FOR Xoshiro256: batch/scalar consistency and moments **
+  test_Xoshiro256();
+  test_Streams();
+
+  return test.getReturnValue();
 }
 
 // Sample seeds obtained from /dev/urandom
@@ -220,3 +231,86 @@ test_KernelDevice(void)
 
   test.boolean("KernelDevice", b);
 }
+
+void
+test_Xoshiro256(void)
+{
+  const int count = 1000;
+  Xoshiro256 a(seeds[0]);
+  Xoshiro256 b(seeds[0]);
+  double batch[count];
+  bool same = true;
+
+  // Mixed request sizes must yield the same sequence.
+  a.fillUniform(batch, 3);
+  a.fillUniform(batch + 3, count - 3);
+  for (int i = 0; i < count; ++i)
+    same = same && batch[i] == b.uniform();
+  test.boolean("Xoshiro256 uniform batch", same);
+
+  a.fillGaussian(batch, count);
+  for (int i = 0; i < count; ++i)
+    same = same && batch[i] == b.gaussian();
+  test.boolean("Xoshiro256 gaussian batch", same);
+
+  a.seed(seeds[1]);
+  b.seed(seeds[1]);
+  for (int i = 0; i < N; ++i)
+    same = same && a.random() == b.random();
+  test.boolean("Xoshiro256 reseed", same);
+
+  const int samples = 200000;
+  double sum = 0;
+  double sum2 = 0;
+  int tail = 0;
+  bool range = true;
+  for (int i = 0; i < samples; i += count)
+  {
+    a.fillGaussian(batch, count);
+    for (int j = 0; j < count; ++j)
+    {
+      sum += batch[j];
+      sum2 += batch[j] * batch[j];
+      if (std::fabs(batch[j]) > 3.0)
+        ++tail;
+    }
+
+    a.fillUniform(batch, count);
+    for (int j = 0; j < count; ++j)
+      range = range && batch[j] >= 0.0 && batch[j] < 1.0;
+  }
+
+  double mean = sum / samples;
+  double var = sum2 / samples - mean * mean;
+  // P(|x| > 3) = 0.0027
+  double ptail = (double)tail / samples;
+  test.boolean("Xoshiro256 uniform range", range);
+  test.boolean("Xoshiro256 gaussian mean", std::fabs(mean) < 0.01);
+  test.boolean("Xoshiro256 gaussian variance", std::fabs(var - 1.0) < 0.02);
+  test.boolean("Xoshiro256 gaussian tail", std::fabs(ptail - 0.0027) < 0.0006);
+}
+
+void
+test_Streams(void)
+{
+  Generator* a = Factory::create(Factory::c_xoshiro256, seeds[2], "Simulators.IMU");
+  Generator* b = Factory::create(Factory::c_xoshiro256, seeds[2], "Simulators.IMU");
+  Generator* c = Factory::create(Factory::c_xoshiro256, seeds[2], "Simulators.DVL");
+
+  bool same = true;
+  bool different = false;
+  for (int i = 0; i < N; ++i)
+  {
+    int32_t va = a->random();
+    same = same && va == b->random();
+    different = different || va != c->random();
+  }
+
+  test.boolean("Streams reproducible", same);
+  test.boolean("Streams independent", different);
+  test.boolean("Streams derived seed", Generator::deriveSeed(seeds[2], "A") != Generator::deriveSeed(seeds[2], "B"));
+
+  delete a;
+  delete b;
+  delete c;
+}
@@ -0,0 +1,140 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+// Test program for DUNE::Math::RunningStatistics class.                    *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Math/RunningStatistics.hpp>
+#include <DUNE/Math/Random.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE::Math;
+
+//! Reference statistics computed over the last samples of a sequence.
+static void
+reference(const std::vector<double>& values, unsigned window,
+          double& mean, double& variance)
+{
+  unsigned first = values.size() > window ? values.size() - window : 0;
+  unsigned count = values.size() - first;
+
+  mean = 0.0;
+  for (unsigned i = first; i < values.size(); ++i)
+    mean += values[i];
+  mean /= count;
+
+  variance = 0.0;
+  for (unsigned i = first; i < values.size(); ++i)
+    variance += (values[i] - mean) * (values[i] - mean);
+  variance /= count;
+}
+
+int
+main(void)
+{
+  Test test("Math::RunningStatistics");
+
+  {
+    RunningStatistics<double> rs(4);
+    test.boolean("empty sample size", rs.sampleSize() == 0);
+    test.boolean("empty mean", rs.mean() == 0.0);
+    test.boolean("empty variance", rs.variance() == 0.0);
+    test.boolean("empty confidence", rs.confidence() == 0.0);
+    test.boolean("window size", rs.windowSize() == 4);
+  }
+
+  {
+    RunningStatistics<double> rs(4);
+    rs.update(2.0);
+    rs.update(4.0);
+    rs.update(4.0);
+    rs.update(6.0);
+    test.boolean("mean of full window", std::fabs(rs.mean() - 4.0) < 1e-12);
+    test.boolean("variance of full window", std::fabs(rs.variance() - 2.0) < 1e-12);
+
+    // 2.0 leaves the window.
+    rs.update(10.0);
+    test.boolean("sample size is bounded", rs.sampleSize() == 4);
+    test.boolean("mean after wrap", std::fabs(rs.mean() - 6.0) < 1e-12);
+    test.boolean("variance after wrap", std::fabs(rs.variance() - 6.0) < 1e-12);
+
+    double se = std::sqrt(8.0 / 4.0);
+    test.boolean("standard error", std::fabs(rs.standardError() - se) < 1e-12);
+    test.boolean("confidence", std::fabs(rs.confidence(2.0) - 2.0 * se) < 1e-12);
+
+    rs.clear();
+    test.boolean("clear", rs.sampleSize() == 0 && rs.mean() == 0.0 && rs.variance() == 0.0);
+  }
+
+  {
+    RunningStatistics<double> rs(5);
+    for (unsigned i = 0; i < 100; ++i)
+      rs.update(12.5);
+    test.boolean("constant input has zero variance", rs.variance() == 0.0 && rs.stdev() == 0.0);
+  }
+
+  {
+    // Long sequence with a large offset: running estimates must track
+    // the brute-force statistics of the window.
+    Random::Generator* prng = Random::Factory::create(Random::Factory::c_default, 42);
+    const unsigned window = 37;
+    RunningStatistics<double> rs(window);
+    std::vector<double> values;
+    double max_mean_err = 0.0;
+    double max_var_err = 0.0;
+
+    for (unsigned i = 0; i < 100000; ++i)
+    {
+      double value = 1.0e4 + 3.0 * prng->gaussian();
+      values.push_back(value);
+      rs.update(value);
+
+      if (i % 997 == 0 || i < window)
+      {
+        double mean;
+        double variance;
+        reference(values, window, mean, variance);
+        max_mean_err = std::max(max_mean_err, std::fabs(rs.mean() - mean));
+        max_var_err = std::max(max_var_err, std::fabs(rs.variance() - variance));
+      }
+    }
+
+    test.boolean("mean tracks window", max_mean_err < 1e-8);
+    test.boolean("variance tracks window", max_var_err < 1e-6);
+
+    delete prng;
+  }
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,218 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstring>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include <Transports/DataStore/SampleQueue.hpp>
+#include "Test.hpp"
+
+using namespace DUNE;
+using DUNE::FileSystem::Directory;
+using DUNE::FileSystem::Path;
+using Transports::DataStore::DataSample;
+using Transports::DataStore::SampleQueue;
+
+//! Segment size (the smallest accepted).
+static const size_t c_segment = 70000;
+
+//! Create a sample of about one kilobyte.
+static DataSample*
+create(int priority, double timestamp)
+{
+  IMC::DevDataBinary* msg = new IMC::DevDataBinary();
+  msg->value.assign(950, (char)priority);
+
+  DataSample* sample = new DataSample();
+  sample->sample = msg;
+  sample->priority = priority;
+  sample->timestamp = timestamp;
+  sample->source = 1;
+  sample->latDegs = 0.5;
+  sample->lonDegs = -0.5;
+  sample->zMeters = 2;
+  return sample;
+}
+
+//! Store a sample.
+static bool
+push(SampleQueue& queue, int priority, double timestamp)
+{
+  DataSample* sample = create(priority, timestamp);
+  bool rv = queue.push(*sample);
+  delete sample;
+  return rv;
+}
+
+//! Extract samples, up to a size budget.
+static void
+pop(SampleQueue& queue, int size, std::vector<DataSample*>& samples)
+{
+  for (size_t i = 0; i < samples.size(); ++i)
+    delete samples[i];
+  samples.clear();
+
+  queue.pop(size, 15, samples);
+}
+
+//! Count segment files.
+static unsigned
+countSegments(const Path& dir)
+{
+  unsigned count = 0;
+  const char* fname = 0;
+  Directory directory(dir);
+  while ((fname = directory.readEntry(Directory::RD_FILE_NAME)))
+  {
+    if (std::strstr(fname, ".seg") != NULL)
+      ++count;
+  }
+  return count;
+}
+
+int
+main(void)
+{
+  Test test("Transports::DataStore::SampleQueue");
+  Path dir = Path::current() / "test_SampleQueue.d";
+  std::vector<DataSample*> samples;
+
+  if (dir.exists())
+    dir.remove(Path::MODE_RECURSIVE);
+
+  {
+    SampleQueue queue;
+    queue.open(dir, c_segment, c_segment * 4, SampleQueue::EP_LOWEST_PRIORITY);
+    int priorities[] = {1, 5, 3, 5, 1, 3};
+    for (unsigned i = 0; i < 6; ++i)
+      push(queue, priorities[i], i);
+
+    pop(queue, 1000000, samples);
+    bool order = samples.size() == 6;
+    for (size_t i = 1; order && i < samples.size(); ++i)
+    {
+      if (samples[i]->priority > samples[i - 1]->priority)
+        order = false;
+      else if (samples[i]->priority == samples[i - 1]->priority)
+        order = samples[i]->timestamp < samples[i - 1]->timestamp;
+    }
+    test.boolean("pop: priority, then newest first", order);
+    test.boolean("pop: queue drained", queue.size() == 0 && queue.getBytes() == 0);
+
+    for (unsigned i = 0; i < 6; ++i)
+      push(queue, 1, i);
+    int size = samples[0]->serializationSize() * 2 + 100;
+    pop(queue, size, samples);
+    test.boolean("pop: size budget", samples.size() == 2 && queue.size() == 4);
+    test.boolean("pop: newest first", samples[0]->timestamp == 5 && samples[1]->timestamp == 4);
+  }
+
+  {
+    SampleQueue queue;
+    test.boolean("restart: restored", queue.open(dir, c_segment, c_segment * 4,
+                                                 SampleQueue::EP_LOWEST_PRIORITY) == 4);
+    pop(queue, 1000000, samples);
+    IMC::DevDataBinary* msg = dynamic_cast<IMC::DevDataBinary*>(samples.empty() ? NULL : samples[0]->sample);
+    test.boolean("restart: contents",
+                 samples.size() == 4 && msg != NULL && msg->value == std::vector<char>(950, (char)1)
+                 && samples[0]->timestamp == 3 && samples[0]->source == 1
+                 && samples[0]->latDegs == 0.5 && samples[0]->zMeters == 2);
+
+    // Fill two segments and leave half of each record extracted.
+    for (unsigned i = 0; i < 120; ++i)
+      push(queue, (i % 2) ? 5 : 1, 100 + i);
+    pop(queue, 60 * samples[0]->serializationSize() + 100, samples);
+    test.boolean("compaction: sparse segments",
+                 samples.size() == 60 && queue.size() == 60 && countSegments(dir) >= 2);
+
+    uint64_t budget = c_segment * 4;
+    bool within = true;
+    for (unsigned i = 0; i < 150; ++i)
+    {
+      push(queue, 3, 1000 + i);
+      within = within && queue.getStorage() <= budget;
+    }
+    test.boolean("compaction: no samples evicted", queue.getEvicted() == 0 && queue.size() == 210);
+    test.boolean("compaction: within budget", within && countSegments(dir) <= 4);
+  }
+
+  {
+    SampleQueue queue;
+    uint64_t budget = c_segment * 2;
+    queue.open(dir, c_segment, budget, SampleQueue::EP_LOWEST_PRIORITY);
+    test.boolean("budget: lowered", queue.getStorage() <= budget && queue.getEvicted() > 0);
+
+    for (unsigned i = 0; i < 300; ++i)
+      push(queue, 9, 5000 + i);
+    pop(queue, 1000000, samples);
+    bool lowest = !samples.empty();
+    for (size_t i = 0; i < samples.size(); ++i)
+      lowest = lowest && samples[i]->priority == 9;
+    test.boolean("evict lowest: higher priority kept", lowest);
+    test.boolean("evict lowest: within budget", queue.getStorage() <= budget);
+  }
+
+  {
+    SampleQueue queue;
+    uint64_t budget = c_segment * 2;
+    queue.open(dir, c_segment, budget, SampleQueue::EP_OLDEST);
+    for (unsigned i = 0; i < 300; ++i)
+      push(queue, (i % 2) ? 1 : 9, i);
+    pop(queue, 1000000, samples);
+    bool newest = !samples.empty();
+    for (size_t i = 0; i < samples.size(); ++i)
+      newest = newest && samples[i]->timestamp >= 300 - samples.size() - 1;
+    test.boolean("evict oldest: newest kept", newest && queue.getEvicted() > 0);
+  }
+
+  {
+    SampleQueue queue;
+    uint64_t budget = c_segment * 2;
+    queue.open(dir, c_segment, budget, SampleQueue::EP_REJECT);
+    unsigned accepted = 0;
+    for (unsigned i = 0; i < 300; ++i)
+      accepted += push(queue, 1, i) ? 1 : 0;
+    test.boolean("reject: new samples refused",
+                 accepted < 300 && queue.getEvicted() == 300 - accepted && queue.size() == accepted);
+    pop(queue, 1000000, samples);
+    test.boolean("reject: oldest kept", !samples.empty() && samples.back()->timestamp == 0);
+  }
+
+  for (size_t i = 0; i < samples.size(); ++i)
+    delete samples[i];
+
+  dir.remove(Path::MODE_RECURSIVE);
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,198 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+// Test program for DUNE::Navigation::Strapdown class.                      *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/Navigation/Strapdown.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using DUNE::Navigation::Strapdown;
+
+//! Sensor rate (Hz).
+static const double c_rate = 1000.0;
+//! Steps used to integrate the reference solution per sample.
+static const int c_substeps = 50;
+//! Coning half-amplitude of the angular rate (rad/s).
+static const double c_amplitude = 0.2;
+//! Coning frequency (rad/s).
+static const double c_frequency = 2.0 * 3.14159265358979 * 10.0;
+
+//! Angular rate of a classic coning motion.
+static void
+rate(double t, double* w)
+{
+  w[0] = c_amplitude * std::cos(c_frequency * t);
+  w[1] = c_amplitude * std::sin(c_frequency * t);
+  w[2] = 0.0;
+}
+
+//! q = q + h * 0.5 * q * (0, w)
+static void
+derivative(const double* q, const double* w, double h, double* out)
+{
+  out[0] = q[0] - h * 0.5 * (q[1] * w[0] + q[2] * w[1] + q[3] * w[2]);
+  out[1] = q[1] + h * 0.5 * (q[0] * w[0] + q[2] * w[2] - q[3] * w[1]);
+  out[2] = q[2] + h * 0.5 * (q[0] * w[1] - q[1] * w[2] + q[3] * w[0]);
+  out[3] = q[3] + h * 0.5 * (q[0] * w[2] + q[1] * w[1] - q[2] * w[0]);
+}
+
+//! Midpoint integration of the reference attitude and of the gyro
+//! delta angles over one sample.
+static void
+reference(double t, double* q, double* dtheta)
+{
+  double h = 1.0 / (c_rate * c_substeps);
+  dtheta[0] = dtheta[1] = dtheta[2] = 0.0;
+
+  for (int i = 0; i < c_substeps; ++i)
+  {
+    double w[3];
+    double mid[4];
+    rate(t + h * i, w);
+    derivative(q, w, h * 0.5, mid);
+    rate(t + h * (i + 0.5), w);
+    double d[4];
+    derivative(mid, w, h, d);
+    // d - mid = h * f(mid).
+    for (int j = 0; j < 4; ++j)
+      q[j] += d[j] - mid[j];
+
+    for (int j = 0; j < 3; ++j)
+      dtheta[j] += w[j] * h;
+  }
+}
+
+//! Angle between two attitude quaternions.
+static double
+error(const double* a, const double* b)
+{
+  // Vector part of conj(a) * b.
+  double x = a[0] * b[1] - a[1] * b[0] - a[2] * b[3] + a[3] * b[2];
+  double y = a[0] * b[2] + a[1] * b[3] - a[2] * b[0] - a[3] * b[1];
+  double z = a[0] * b[3] - a[1] * b[2] + a[2] * b[1] - a[3] * b[0];
+  return 2.0 * std::asin(std::sqrt(x * x + y * y + z * z));
+}
+
+int
+main(void)
+{
+  Test test("Navigation::Strapdown");
+
+  {
+    Strapdown sd;
+    sd.setAttitude(0.1, -0.2, 2.5);
+    double phi, theta, psi;
+    sd.getEulerAngles(phi, theta, psi);
+    test.boolean("euler angles: round trip",
+                 std::fabs(phi - 0.1) < 1e-12 && std::fabs(theta + 0.2) < 1e-12 && std::fabs(psi - 2.5) < 1e-12);
+  }
+
+  {
+    // Constant rate about z, 1 s in 400 samples decimated by 8.
+    Strapdown sd(8);
+    double dtheta[400 * 3] = {0};
+    double dv[400 * 3] = {0};
+    for (int i = 0; i < 400; ++i)
+    {
+      dtheta[3 * i + 2] = 0.5 / 400;
+      dv[3 * i] = 1.0 / 400;
+    }
+
+    size_t done = 0;
+    unsigned outputs = 0;
+    bool consistent = true;
+    while (done < 400)
+    {
+      done += sd.integrate(dtheta + 3 * done, dv + 3 * done, 400 - done);
+      if (sd.ready())
+      {
+        ++outputs;
+        consistent = consistent && std::fabs(sd.getDeltaAngle()[2] - 8 * 0.5 / 400) < 1e-15;
+      }
+    }
+
+    double phi, theta, psi;
+    sd.getEulerAngles(phi, theta, psi);
+    test.boolean("batch: outputs", outputs == 50);
+    test.boolean("batch: delta angle", consistent);
+    test.boolean("batch: yaw", std::fabs(psi - 0.5) < 1e-12);
+    test.boolean("batch: velocity rotated", sd.getNavigationDeltaVelocity()[1] > 0.0);
+  }
+
+  {
+    // Coning motion: compare compensated and uncompensated attitude.
+    Strapdown sd(10);
+    double q_ref[4] = {1, 0, 0, 0};
+    double q_naive[4] = {1, 0, 0, 0};
+    double sum[3] = {0, 0, 0};
+    double dv[3] = {0, 0, 0};
+    int samples = (int)c_rate;
+
+    for (int k = 0; k < samples; ++k)
+    {
+      double dtheta[3];
+      reference(k / c_rate, q_ref, dtheta);
+      for (int i = 0; i < 3; ++i)
+        sum[i] += dtheta[i];
+
+      if (sd.integrate(dtheta, dv) || k == samples - 1)
+      {
+        // Uncompensated: rotate by the plain sum of delta angles.
+        double a = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+        double s = a > 0 ? std::sin(0.5 * a) / a : 0.5;
+        double r[4] = {std::cos(0.5 * a), s * sum[0], s * sum[1], s * sum[2]};
+        double* q = q_naive;
+        double n[4];
+        n[0] = q[0] * r[0] - q[1] * r[1] - q[2] * r[2] - q[3] * r[3];
+        n[1] = q[0] * r[1] + q[1] * r[0] + q[2] * r[3] - q[3] * r[2];
+        n[2] = q[0] * r[2] - q[1] * r[3] + q[2] * r[0] + q[3] * r[1];
+        n[3] = q[0] * r[3] + q[1] * r[2] - q[2] * r[1] + q[3] * r[0];
+        for (int i = 0; i < 4; ++i)
+          q_naive[i] = n[i];
+        sum[0] = sum[1] = sum[2] = 0.0;
+      }
+    }
+
+    double e_sd = error(sd.getQuaternion(), q_ref);
+    double e_naive = error(q_naive, q_ref);
+    test.boolean("coning: compensated error", e_sd < 1e-8);
+    test.boolean("coning: better than uncompensated", e_sd * 1000.0 < e_naive);
+    const double* q = sd.getQuaternion();
+    double norm = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+    test.boolean("coning: unit quaternion", std::fabs(norm - 1.0) < 1e-12);
+  }
+
+  return test.getReturnValue();
+}
@@ -0,0 +1,68 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// DUNE headers.
+#include <DUNE/Network/TokenBucket.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using DUNE::Network::TokenBucket;
+
+int
+main(void)
+{
+  Test test("Network::TokenBucket");
+
+  {
+    TokenBucket tb;
+    test.boolean("unlimited: consume()", tb.consume(1e6, 0.0));
+    test.boolean("unlimited: getDelay()", tb.getDelay(1e6, 0.0) == 0);
+  }
+
+  {
+    TokenBucket tb(10, 100);
+    test.boolean("burst: starts full", tb.getTokens(0.0) == 100);
+    test.boolean("burst: consume()", tb.consume(60, 0.0));
+    test.boolean("burst: reject", !tb.consume(60, 0.0));
+    test.boolean("refill: getDelay()", tb.getDelay(60, 0.0) == 2.0);
+    test.boolean("refill: consume()", tb.consume(60, 2.0));
+    test.boolean("refill: clamped", tb.getTokens(1000.0) == 100);
+  }
+
+  {
+    TokenBucket tb(10, 50);
+    test.boolean("oversized: consume()", tb.consume(80, 0.0));
+    test.boolean("oversized: debt", tb.getTokens(0.0) == -30);
+    test.boolean("oversized: reject", !tb.consume(10, 3.0));
+    test.boolean("oversized: repaid", tb.consume(10, 4.0));
+  }
+
+  return test.getReturnValue();
+}
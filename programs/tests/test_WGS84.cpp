@@ -0,0 +1,201 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+// Test program for DUNE::Coordinates::WGS84 batch routines.              *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Coordinates/WGS84.hpp>
+#include <DUNE/Math/Constants.hpp>
+#include <DUNE/Math/Vectorized.hpp>
+
+// Local headers.
+#include "Test.hpp"
+
+using namespace DUNE::Coordinates;
+using namespace DUNE::Math;
+
+//! Number of random points.
+static const size_t c_count = 5000;
+
+static double
+uniform(double min, double max)
+{
+  return min + (max - min) * (std::rand() / (double)RAND_MAX);
+}
+
+int
+main(void)
+{
+  Test test("Coordinates::WGS84 (batch)");
+
+  std::srand(1);
+
+  std::vector<double> lat(c_count), lon(c_count), hae(c_count);
+  for (size_t i = 0; i < c_count; ++i)
+  {
+    lat[i] = uniform(-1.5, 1.5);
+    lon[i] = uniform(-c_pi, c_pi);
+    hae[i] = uniform(-100.0, 1000.0);
+  }
+
+  {
+    std::vector<double> x(c_count), y(c_count);
+    std::vector<double> s(c_count), c(c_count), r(c_count);
+    for (size_t i = 0; i < c_count; ++i)
+    {
+      x[i] = uniform(-100.0, 100.0);
+      y[i] = uniform(-10.0, 10.0);
+    }
+    x[0] = 1e6;
+    y[1] = 0.0;
+
+    Vectorized::sincos(&x[0], &s[0], &c[0], c_count);
+    Vectorized::atan2(&y[0], &x[0], &r[0], c_count);
+
+    double es = 0, ec = 0, ea = 0;
+    for (size_t i = 0; i < c_count; ++i)
+    {
+      es = std::max(es, std::fabs(s[i] - std::sin(x[i])));
+      ec = std::max(ec, std::fabs(c[i] - std::cos(x[i])));
+      ea = std::max(ea, std::fabs(r[i] - std::atan2(y[i], x[i])));
+    }
+
+    test.boolean("Vectorized::sincos sine", es < 4e-16);
+    test.boolean("Vectorized::sincos cosine", ec < 4e-16);
+    test.boolean("Vectorized::atan2", ea < 5e-16);
+
+    double zy[4] = {0.0, 0.0, 1.0, -1.0};
+    double zx[4] = {0.0, -1.0, 0.0, 0.0};
+    Vectorized::atan2(zy, zx, &r[0], 4);
+    test.boolean("Vectorized::atan2 axes", r[0] == 0.0 && r[1] == c_pi
+                 && r[2] == c_half_pi && r[3] == -c_half_pi);
+  }
+
+  {
+    std::vector<double> x(c_count), y(c_count), z(c_count);
+    WGS84::toECEF(&lat[0], &lon[0], &hae[0], &x[0], &y[0], &z[0], c_count);
+
+    double err = 0;
+    for (size_t i = 0; i < c_count; ++i)
+    {
+      double sx, sy, sz;
+      WGS84::toECEF(lat[i], lon[i], hae[i], &sx, &sy, &sz);
+      err = std::max(err, std::fabs(sx - x[i]) + std::fabs(sy - y[i]) + std::fabs(sz - z[i]));
+    }
+    test.boolean("toECEF matches scalar", err < 1e-8);
+
+    std::vector<double> blat(c_count), blon(c_count), bhae(c_count);
+    WGS84::fromECEF(&x[0], &y[0], &z[0], &blat[0], &blon[0], &bhae[0], c_count);
+
+    double ea = 0, eh = 0;
+    for (size_t i = 0; i < c_count; ++i)
+    {
+      double slat, slon, shae;
+      WGS84::fromECEF(x[i], y[i], z[i], &slat, &slon, &shae);
+      ea = std::max(ea, std::fabs(slat - blat[i]) + std::fabs(slon - blon[i]));
+      eh = std::max(eh, std::fabs(shae - bhae[i]));
+    }
+    test.boolean("fromECEF matches scalar (angles)", ea < 1e-14);
+    test.boolean("fromECEF matches scalar (height)", eh < 1e-7);
+
+    // In place.
+    WGS84::fromECEF(&x[0], &y[0], &z[0], &x[0], &y[0], &z[0], c_count);
+    test.boolean("fromECEF in place", std::equal(x.begin(), x.end(), blat.begin())
+                 && std::equal(z.begin(), z.end(), bhae.begin()));
+  }
+
+  double rlat = 0.7188;
+  double rlon = -0.1528;
+  double rhae = 20.0;
+
+  {
+    std::vector<double> n(c_count), e(c_count), d(c_count);
+    std::vector<double> plat(c_count), plon(c_count);
+    for (size_t i = 0; i < c_count; ++i)
+    {
+      plat[i] = rlat + uniform(-0.01, 0.01);
+      plon[i] = rlon + uniform(-0.01, 0.01);
+    }
+
+    WGS84::displacement(rlat, rlon, rhae, &plat[0], &plon[0], &hae[0], &n[0], &e[0], &d[0], c_count);
+
+    double err = 0;
+    for (size_t i = 0; i < c_count; ++i)
+    {
+      double sn, se, sd;
+      WGS84::displacement(rlat, rlon, rhae, plat[i], plon[i], hae[i], &sn, &se, &sd);
+      err = std::max(err, std::fabs(sn - n[i]) + std::fabs(se - e[i]) + std::fabs(sd - d[i]));
+    }
+    test.boolean("displacement matches scalar", err < 1e-8);
+
+    std::vector<double> b(c_count), r(c_count);
+    WGS84::getNEBearingAndRange(rlat, rlon, &plat[0], &plon[0], &b[0], &r[0], c_count);
+
+    double eb = 0, er = 0;
+    for (size_t i = 0; i < c_count; ++i)
+    {
+      double sb, sr;
+      WGS84::getNEBearingAndRange(rlat, rlon, plat[i], plon[i], &sb, &sr);
+      eb = std::max(eb, std::fabs(sb - b[i]));
+      er = std::max(er, std::fabs(sr - r[i]));
+    }
+    test.boolean("getNEBearingAndRange matches scalar", eb < 1e-12 && er < 1e-8);
+  }
+
+  {
+    std::vector<double> n(c_count), e(c_count), d(c_count);
+    for (size_t i = 0; i < c_count; ++i)
+    {
+      n[i] = uniform(-5000.0, 5000.0);
+      e[i] = uniform(-5000.0, 5000.0);
+      d[i] = uniform(-10.0, 100.0);
+    }
+
+    std::vector<double> blat(c_count), blon(c_count), bhae(c_count);
+    WGS84::displace(rlat, rlon, rhae, &n[0], &e[0], &d[0], &blat[0], &blon[0], &bhae[0], c_count);
+
+    double ea = 0, eh = 0;
+    for (size_t i = 0; i < c_count; ++i)
+    {
+      double slat = rlat, slon = rlon, shae = rhae;
+      WGS84::displace(n[i], e[i], d[i], &slat, &slon, &shae);
+      ea = std::max(ea, std::fabs(slat - blat[i]) + std::fabs(slon - blon[i]));
+      eh = std::max(eh, std::fabs(shae - bhae[i]));
+    }
+    test.boolean("displace matches scalar (angles)", ea < 1e-14);
+    test.boolean("displace matches scalar (height)", eh < 1e-8);
+  }
+
+  return test.getReturnValue();
+}
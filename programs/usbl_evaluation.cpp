@@ -32,161 +32,198 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <cstdlib>
 #include <vector>
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
-int
-main(int32_t argc, char** argv)
+struct Arguments
+{ };
+
+//! Differences between USBL fixes and estimated states in a single log.
+class UsblEvaluation: public DUNE::IMC::LogProcessor
 {
-  // Check arguments.
-  if (argc <= 1)
+public:
+  UsblEvaluation(const Arguments& args):
+    log_name("unknown"),
+    sum_ranges(0.0),
+    sum_bearings(0.0),
+    m_got_name(false),
+    m_got_state(false),
+    m_lat(0.0),
+    m_lon(0.0)
   {
-    std::cerr << "Usage: " << argv[0]
-              << " <path_to_log_1/Data.lsf[.gz]> ... <path_to_log_n/Data.lsf[.gz]>"
-              << std::endl;
-    return 1;
-  }
+    (void)args;
 
-  unsigned start_index = 1;
-
-  std::vector<float> m_avg_ranges;
-  std::vector<float> m_avg_bearings;
-  float m_total_ranges = 0.0;
-  float m_total_bearings = 0.0;
+    bind<DUNE::IMC::LoggingControl>(this);
+    bind<DUNE::IMC::EstimatedState>(this);
+    bind<DUNE::IMC::UsblFixExtended>(this);
+    bind<DUNE::IMC::UsblFix>(this);
+  }
 
-  for (int32_t i = start_index; i < argc; ++i)
+  void
+  consume(const DUNE::IMC::LoggingControl* msg)
   {
-    std::vector<float> m_ranges;
-    std::vector<float> m_bearings;
-    float m_sum_ranges = 0.0;
-    float m_sum_bearings = 0.0;
-    std::istream* is = 0;
-    DUNE::Compression::Methods method = DUNE::Compression::Factory::detect(argv[i]);
-    if (method == DUNE::Compression::METHOD_UNKNOWN)
-      is = new std::ifstream(argv[i], std::ios::binary);
-    else
-      is = new DUNE::Compression::FileInput(argv[i], method);
-
-    DUNE::IMC::Message* msg = NULL;
-
-    bool got_name = false;
-    bool got_state = false;
-    std::string log_name = "unknown";
-    double lat, lon;
-
-    try
+    if (!m_got_name && msg->op == DUNE::IMC::LoggingControl::COP_STARTED)
     {
-      while ((msg = DUNE::IMC::Packet::deserialize(*is)) != 0)
-      {
-        if (msg->getId() == DUNE_IMC_LOGGINGCONTROL)
-        {
-          if (!got_name)
-          {
-            DUNE::IMC::LoggingControl* ptr = static_cast<DUNE::IMC::LoggingControl*>(msg);
-
-            if (ptr->op == DUNE::IMC::LoggingControl::COP_STARTED)
-            {
-              log_name = ptr->name;
-              got_name = true;
-            }
-          }
-        }
-        else if (msg->getId() == DUNE_IMC_ESTIMATEDSTATE)
-        {
-          if (!got_state)
-            got_state = true;
-
-          DUNE::IMC::EstimatedState* ptr = static_cast<DUNE::IMC::EstimatedState*>(msg);
-          DUNE::Coordinates::toWGS84(*ptr, lat, lon);
-        }
-        else if (msg->getId() == DUNE_IMC_USBLFIXEXTENDED)
-        {
-          if (got_state)
-          {
-            float b, r;
-            DUNE::IMC::UsblFixExtended* ptr = static_cast<DUNE::IMC::UsblFixExtended*>(msg);
-            DUNE::Coordinates::WGS84::getNEBearingAndRange(lat, lon, ptr->lat,
-                                                           ptr->lon, &b, &r);
-            m_ranges.push_back(r);
-            m_bearings.push_back(b);
-            m_sum_ranges += r;
-            m_sum_bearings += b;
-          }
-        }
-        else if (msg->getId() == DUNE_IMC_USBLFIX)
-        {
-          if (got_state)
-          {
-            float b, r;
-            DUNE::IMC::UsblFix* ptr = static_cast<DUNE::IMC::UsblFix*>(msg);
-            DUNE::Coordinates::WGS84::getNEBearingAndRange(lat, lon, ptr->lat,
-                                                           ptr->lon, &b, &r);
-            m_ranges.push_back(r);
-            m_bearings.push_back(b);
-            m_sum_ranges += r;
-            m_sum_bearings += b;
-          }
-        }
-
-        delete msg;
-      }
-    }
-    catch (std::runtime_error& e)
-    {
-      std::cerr << "ERROR: " << e.what() << std::endl;
+      log_name = msg->name;
+      m_got_name = true;
     }
+  }
+
+  void
+  consume(const DUNE::IMC::EstimatedState* msg)
+  {
+    m_got_state = true;
+    DUNE::Coordinates::toWGS84(*msg, m_lat, m_lon);
+  }
+
+  void
+  consume(const DUNE::IMC::UsblFixExtended* msg)
+  {
+    addFix(msg->lat, msg->lon);
+  }
+
+  void
+  consume(const DUNE::IMC::UsblFix* msg)
+  {
+    addFix(msg->lat, msg->lon);
+  }
 
-    delete is;
+  //! Name of the log.
+  std::string log_name;
+  //! Ranges between fixes and estimated states.
+  std::vector<float> ranges;
+  //! Bearings between fixes and estimated states.
+  std::vector<float> bearings;
+  //! Sum of ranges.
+  float sum_ranges;
+  //! Sum of bearings.
+  float sum_bearings;
+
+private:
+  bool m_got_name;
+  bool m_got_state;
+  double m_lat;
+  double m_lon;
+
+  void
+  addFix(double lat, double lon)
+  {
+    if (!m_got_state)
+      return;
+
+    float b, r;
+    DUNE::Coordinates::WGS84::getNEBearingAndRange(m_lat, m_lon, lat, lon, &b, &r);
+    ranges.push_back(r);
+    bearings.push_back(b);
+    sum_ranges += r;
+    sum_bearings += b;
+  }
+};
+
+//! Averages over all logs.
+struct Averages
+{
+  std::vector<float> avg_ranges;
+  std::vector<float> avg_bearings;
+  float total_ranges;
+  float total_bearings;
+  unsigned index;
+  unsigned count;
+
+  Averages(unsigned logs):
+    total_ranges(0.0),
+    total_bearings(0.0),
+    index(0),
+    count(logs)
+  { }
+
+  void
+  reduce(UsblEvaluation& log)
+  {
+    ++index;
+
+    if (!log.getError().empty())
+      std::cerr << "ERROR: " << log.getError() << std::endl;
 
-    if (m_ranges.size() == 0)
+    if (log.ranges.size() == 0)
     {
-      std::cerr << "\r\nThere is no USBL in " << log_name << "." << std::endl;
-      continue;
+      std::cerr << "\r\nThere is no USBL in " << log.log_name << "." << std::endl;
+      return;
     }
 
     std::cerr << " - - - - - - - - - - - - - - - - - - - - - - - - " << std::endl;
-    std::cerr << "\r\n Errors in log (" << i << "/" << argc << "): '" << log_name << "'\r\n" << std::endl;
+    std::cerr << "\r\n Errors in log (" << index << "/" << count << "): '" << log.log_name << "'\r\n" << std::endl;
 
-    std::vector<float>::iterator itrr = m_ranges.begin();
-    std::vector<float>::iterator itrb = m_bearings.begin();
-    for (; itrr < m_ranges.end(); ++itrr, ++itrb)
+    std::vector<float>::iterator itrr = log.ranges.begin();
+    std::vector<float>::iterator itrb = log.bearings.begin();
+    for (; itrr < log.ranges.end(); ++itrr, ++itrb)
       std::cerr << std::setprecision(4) << "\t" << *itrr << "m | "
                 << DUNE::Math::Angles::degrees(*itrb) << "º" << std::endl;
 
-    float avg_ranges = m_sum_ranges / m_ranges.size();
-    float avg_bearings = m_sum_bearings / m_bearings.size();
-    std::cerr << "\r\n\t\t Average (" << m_ranges.size() << "):"
-              << std::setprecision(4) << avg_ranges << "m | "
-              << DUNE::Math::Angles::degrees(avg_bearings)
+    float avg_range = log.sum_ranges / log.ranges.size();
+    float avg_bearing = log.sum_bearings / log.bearings.size();
+    std::cerr << "\r\n\t\t Average (" << log.ranges.size() << "):"
+              << std::setprecision(4) << avg_range << "m | "
+              << DUNE::Math::Angles::degrees(avg_bearing)
               << "º" << std::endl;
 
-    m_avg_ranges.push_back(avg_ranges);
-    m_avg_bearings.push_back(avg_bearings);
-    m_total_ranges += avg_ranges;
-    m_total_bearings += avg_bearings;
+    avg_ranges.push_back(avg_range);
+    avg_bearings.push_back(avg_bearing);
+    total_ranges += avg_range;
+    total_bearings += avg_bearing;
   }
+};
+
+int
+main(int32_t argc, char** argv)
+{
+  // Check arguments.
+  if (argc <= 1)
+  {
+    std::cerr << "Usage: " << argv[0]
+              << " [-j <threads>] <path_to_log_1/Data.lsf[.gz]> ... <path_to_log_n/Data.lsf[.gz]>"
+              << std::endl;
+    return 1;
+  }
+
+  int32_t start_index = 1;
+  unsigned threads = 0;
+
+  if (argc > 2 && strcmp(argv[1], "-j") == 0)
+  {
+    threads = std::atoi(argv[2]);
+    start_index = 3;
+  }
+
+  std::vector<std::string> paths(argv + start_index, argv + argc);
+
+  Arguments args;
+  Averages averages(paths.size());
+  DUNE::IMC::LogMapReduce<UsblEvaluation, Arguments> logs(args, threads);
+  logs.run(paths, averages);
 
   std::cerr << "\r\n - - - - - - - - - - - - - - - - - - - - - - - - - - - -" << std::endl;
   std::cerr << " - - - - - - - - - - - - - - - - - - - - - - - - - - - -" << std::endl;
   std::cerr << "\r\n\t    # # # S U M M A R Y # # #\r\n" << std::endl;
-  if (m_avg_ranges.size() == 0)
+  if (averages.avg_ranges.size() == 0)
   {
     std::cerr << "\tNo USBL data in logs." << std::endl;
     return 0;
   }
 
-  std::vector<float>::iterator itrr = m_avg_ranges.begin();
-  std::vector<float>::iterator itrb = m_avg_bearings.begin();
-  for (; itrr < m_avg_ranges.end(); ++itrr, ++itrb)
+  std::vector<float>::iterator itrr = averages.avg_ranges.begin();
+  std::vector<float>::iterator itrb = averages.avg_bearings.begin();
+  for (; itrr < averages.avg_ranges.end(); ++itrr, ++itrb)
     std::cerr << std::setprecision(4) << "\t\t" << *itrr << "m | "
               << DUNE::Math::Angles::degrees(*itrb) << "º" << std::endl;
 
   std::cerr << "\r\n\t\t\t AVERAGE OF ALL LOG AVERAGES ("
-            << m_avg_ranges.size() << "): " << std::setprecision(4)
-            << m_total_ranges / m_avg_ranges.size() << "m | "
-            << DUNE::Math::Angles::degrees(m_total_bearings / m_avg_bearings.size())
+            << averages.avg_ranges.size() << "): " << std::setprecision(4)
+            << averages.total_ranges / averages.avg_ranges.size() << "m | "
+            << DUNE::Math::Angles::degrees(averages.total_bearings / averages.avg_bearings.size())
             << "º" << std::endl;
   return 0;
 }
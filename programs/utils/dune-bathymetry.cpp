@@ -0,0 +1,161 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+// Utility program to convert scattered bathymetry to a gridded file.       *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+#include <DUNE/Simulation/Bathymetry.hpp>
+
+using DUNE_NAMESPACES;
+
+//! Read bathymetry from a simulator configuration file, with
+//! "north east depth" lines relative to a reference.
+static void
+readConfig(const Path& path, double& lat, double& lon,
+           std::vector<Simulation::Bathymetry::Sample>& samples)
+{
+  Parsers::Config cfg(path.c_str());
+  std::vector<std::string> lines;
+  cfg.get("Bathymetry", "Data", "", lines);
+  cfg.get("Bathymetry", "Latitude (degrees)", "0", lat);
+  cfg.get("Bathymetry", "Longitude (degrees)", "0", lon);
+  lat = Angles::radians(lat);
+  lon = Angles::radians(lon);
+
+  for (size_t i = 0; i < lines.size(); ++i)
+  {
+    std::vector<double> v;
+    String::split(lines[i], " ", v);
+    if (v.size() < 3)
+      continue;
+
+    Simulation::Bathymetry::Sample s = {v[0], v[1], v[2]};
+    samples.push_back(s);
+  }
+}
+
+//! Read bathymetry from a text file with "latitude longitude depth"
+//! lines, in decimal degrees. The first point is the reference.
+static void
+readXYZ(const Path& path, double& lat, double& lon,
+        std::vector<Simulation::Bathymetry::Sample>& samples)
+{
+  std::ifstream ifs(path.c_str());
+  if (!ifs)
+    throw std::runtime_error("unable to open " + path.str());
+
+  std::vector<double> lats;
+  std::vector<double> lons;
+  std::vector<double> depths;
+  std::string line;
+  while (std::getline(ifs, line))
+  {
+    double v[3];
+    if (std::sscanf(line.c_str(), "%lf %lf %lf", &v[0], &v[1], &v[2]) != 3)
+      continue;
+
+    lats.push_back(Angles::radians(v[0]));
+    lons.push_back(Angles::radians(v[1]));
+    depths.push_back(v[2]);
+  }
+
+  if (lats.empty())
+    return;
+
+  lat = lats[0];
+  lon = lons[0];
+
+  std::vector<double> n(lats.size());
+  std::vector<double> e(lats.size());
+  WGS84::displacement(lat, lon, 0, &lats[0], &lons[0], NULL,
+                      &n[0], &e[0], NULL, lats.size());
+
+  for (size_t i = 0; i < lats.size(); ++i)
+  {
+    Simulation::Bathymetry::Sample s = {n[i], e[i], depths[i]};
+    samples.push_back(s);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 3)
+  {
+    std::cerr << "Usage: " << argv[0] << " <input> <output> [resolution] [fill passes]" << std::endl
+              << std::endl
+              << "  input       simulator bathymetry file (.ini) or 'lat lon depth' lines" << std::endl
+              << "  output      gridded bathymetry file (.bty)" << std::endl
+              << "  resolution  distance between grid nodes in meters (default: 5)" << std::endl
+              << "  fill passes number of hole filling passes (default: 2)" << std::endl;
+    return 1;
+  }
+
+  Path input(argv[1]);
+  Path output(argv[2]);
+  double resolution = (argc > 3) ? std::atof(argv[3]) : 5.0;
+  unsigned fill = (argc > 4) ? (unsigned)std::atoi(argv[4]) : 2;
+
+  try
+  {
+    double lat = 0;
+    double lon = 0;
+    std::vector<Simulation::Bathymetry::Sample> samples;
+
+    if (String::endsWith(input.str(), ".ini"))
+      readConfig(input, lat, lon, samples);
+    else
+      readXYZ(input, lat, lon, samples);
+
+    std::cerr << "read " << samples.size() << " samples" << std::endl;
+    Simulation::Bathymetry::write(output, lat, lon, samples, resolution, fill);
+
+    Simulation::Bathymetry grid;
+    grid.open(output);
+    std::cerr << "wrote " << grid.getRows() << "x" << grid.getColumns()
+              << " nodes to " << output.str() << std::endl;
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,310 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstdlib>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+using DUNE_NAMESPACES;
+
+//! Delay between reconnection attempts.
+static const double c_retry_delay = 5.0;
+//! Maximum number of consecutive failed connection attempts.
+static const unsigned c_max_retries = 120;
+
+//! Remote file.
+struct RemoteFile
+{
+  std::string path;
+  int64_t size;
+  int64_t mtime;
+};
+
+//! Buffered reader of lines and blocks from a socket.
+class Reader
+{
+public:
+  Reader(TCPSocket& sock):
+    m_sock(sock),
+    m_pos(0),
+    m_len(0)
+  { }
+
+  std::string
+  readLine(void)
+  {
+    std::string line;
+    while (true)
+    {
+      fill();
+      char c = m_bfr[m_pos++];
+      if (c == '\n')
+        return line;
+      line.push_back(c);
+    }
+  }
+
+  void
+  readBlock(char* data, size_t size)
+  {
+    while (size > 0)
+    {
+      fill();
+      size_t n = std::min(size, m_len - m_pos);
+      std::memcpy(data, m_bfr + m_pos, n);
+      m_pos += n;
+      data += n;
+      size -= n;
+    }
+  }
+
+private:
+  TCPSocket& m_sock;
+  char m_bfr[65536];
+  size_t m_pos;
+  size_t m_len;
+
+  void
+  fill(void)
+  {
+    if (m_pos < m_len)
+      return;
+
+    if (!Poll::poll(m_sock, 30.0))
+      throw std::runtime_error("timeout waiting for server");
+
+    m_len = m_sock.read(m_bfr, sizeof(m_bfr));
+    m_pos = 0;
+  }
+};
+
+static void
+sendLine(TCPSocket& sock, const std::string& line)
+{
+  std::string data = line + "\n";
+  const char* ptr = data.c_str();
+  size_t size = data.size();
+  while (size > 0)
+  {
+    size_t rv = sock.write(ptr, size);
+    ptr += rv;
+    size -= rv;
+  }
+}
+
+//! Fetch missing or changed chunks of a file.
+//! @return number of bytes transferred.
+static int64_t
+fetchFile(TCPSocket& sock, Reader& reader, const RemoteFile& file,
+          const Path& dest, unsigned window)
+{
+  sendLine(sock, "HASH " + file.path);
+  std::string line = reader.readLine();
+
+  // The server reports progress while hashing large files.
+  while (line.compare(0, 2, "P ") == 0)
+    line = reader.readLine();
+  long long size = 0;
+  unsigned count = 0;
+  if (std::sscanf(line.c_str(), "H %lld %u", &size, &count) != 2)
+    throw std::runtime_error("invalid reply to HASH: " + line);
+
+  std::vector<std::string> remote(count);
+  for (unsigned i = 0; i < count; ++i)
+    remote[i] = reader.readLine();
+
+  Path local = dest / file.path;
+  local.dirname().create();
+
+  // Rewritten files are fetched from scratch.
+  if (local.isFile() && local.size() > size)
+    local.remove();
+
+  ChunkIndex index;
+  if (local.isFile())
+    index.update(local);
+
+  std::deque<size_t> missing;
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (i >= index.getCount() || index.getDigest(i) != remote[i])
+      missing.push_back(i);
+  }
+
+  if (missing.empty())
+    return 0;
+
+  std::cerr << file.path << ": fetching " << missing.size() << " of "
+            << count << " chunks" << std::endl;
+
+  if (!local.isFile())
+    std::ofstream(local.c_str(), std::ios::binary);
+
+  std::fstream ofs(local.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+  if (!ofs)
+    throw std::runtime_error("unable to open " + local.str());
+
+  // Keep up to 'window' requests in flight.
+  std::deque<size_t> pending;
+  std::vector<char> chunk(ChunkIndex::c_chunk_size);
+  int64_t bytes = 0;
+
+  while (!missing.empty() || !pending.empty())
+  {
+    while (!missing.empty() && pending.size() < window)
+    {
+      sendLine(sock, String::str("GET %u %s", (unsigned)missing.front(),
+                                 file.path.c_str()));
+      pending.push_back(missing.front());
+      missing.pop_front();
+    }
+
+    line = reader.readLine();
+    unsigned idx = 0;
+    unsigned len = 0;
+    char digest[64];
+    if (std::sscanf(line.c_str(), "D %u %u %63s", &idx, &len, digest) != 3)
+      throw std::runtime_error("invalid reply to GET: " + line);
+
+    if (idx != pending.front() || len > chunk.size())
+      throw std::runtime_error("unexpected chunk: " + line);
+    pending.pop_front();
+
+    reader.readBlock(&chunk[0], len);
+    if (ChunkIndex::digest(&chunk[0], len) != digest)
+      throw std::runtime_error("corrupted chunk: " + line);
+
+    ofs.seekp((std::streamoff)idx * ChunkIndex::c_chunk_size, std::ios::beg);
+    ofs.write(&chunk[0], len);
+    bytes += len;
+  }
+
+  return bytes;
+}
+
+//! Run one session, fetching every file not yet complete.
+static void
+fetchAll(const Address& host, uint16_t port, const Path& dest,
+         unsigned window, std::set<std::string>& done)
+{
+  TCPSocket sock;
+  sock.connect(host, port);
+  sock.setNoDelay(true);
+  sock.setKeepAlive(true);
+  Reader reader(sock);
+
+  sendLine(sock, "LIST");
+  std::vector<RemoteFile> files;
+  while (true)
+  {
+    std::string line = reader.readLine();
+    if (line == ".")
+      break;
+
+    RemoteFile file;
+    long long size = 0;
+    long long mtime = 0;
+    int offset = 0;
+    if (std::sscanf(line.c_str(), "F %lld %lld %n", &size, &mtime, &offset) != 2)
+      throw std::runtime_error("invalid reply to LIST: " + line);
+
+    file.size = size;
+    file.mtime = mtime;
+    file.path = line.substr(offset);
+    files.push_back(file);
+  }
+
+  // Newest files first, as listed by the server.
+  for (size_t i = 0; i < files.size(); ++i)
+  {
+    std::string key = String::str("%s:%lld:%lld", files[i].path.c_str(),
+                                  (long long)files[i].size, (long long)files[i].mtime);
+    if (done.find(key) != done.end())
+      continue;
+
+    int64_t bytes = fetchFile(sock, reader, files[i], dest, window);
+    if (bytes > 0)
+      std::cerr << files[i].path << ": " << bytes << " bytes" << std::endl;
+
+    done.insert(key);
+  }
+
+  sendLine(sock, "QUIT");
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0]
+              << " <host> [port] [destination folder] [window]" << std::endl;
+    return 1;
+  }
+
+  Address host(argv[1]);
+  uint16_t port = (argc > 2) ? std::atoi(argv[2]) : 30022;
+  Path dest = (argc > 3) ? argv[3] : ".";
+  unsigned window = (argc > 4) ? std::atoi(argv[4]) : 8;
+  if (window == 0)
+    window = 1;
+
+  // Files known to be complete, skipped when resuming.
+  std::set<std::string> done;
+  unsigned retries = 0;
+
+  while (true)
+  {
+    try
+    {
+      fetchAll(host, port, dest, window, done);
+      return 0;
+    }
+    catch (std::exception& e)
+    {
+      std::cerr << "ERROR: " << e.what() << std::endl;
+    }
+
+    if (++retries > c_max_retries)
+      return 1;
+
+    std::cerr << "resuming in " << c_retry_delay << " s" << std::endl;
+    Delay::wait(c_retry_delay);
+  }
+}
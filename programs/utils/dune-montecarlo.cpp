@@ -0,0 +1,682 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+// Utility program to run a plan in many simulated vehicles at once.        *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// POSIX headers.
+#if defined(DUNE_OS_POSIX)
+#  include <fcntl.h>
+#  include <signal.h>
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+using DUNE_NAMESPACES;
+
+//! First port given to runs.
+static const unsigned c_port_base = 40000;
+//! Number of ports reserved for each simultaneous run.
+static const unsigned c_port_stride = 32;
+//! Maximum number of simultaneous runs.
+static const unsigned c_max_jobs = (65536 - c_port_base) / c_port_stride;
+//! Wall clock allowance for daemon start up and shut down.
+static const double c_margin = 60.0;
+//! Time given to a daemon to stop before it is killed.
+static const double c_stop_timeout = 10.0;
+
+//! Runner settings.
+struct Settings
+{
+  //! Base configuration file.
+  Path config;
+  //! Plan file.
+  Path plan;
+  //! Plan identifier.
+  std::string plan_id;
+  //! Output directory.
+  Path output;
+  //! Daemon executable.
+  Path daemon;
+  //! Execution profile.
+  std::string profile;
+  //! Number of runs.
+  unsigned runs;
+  //! Number of simultaneous runs.
+  unsigned jobs;
+  //! Master seed.
+  int32_t seed;
+  //! Simulation time multiplier.
+  double speed;
+  //! Run timeout in simulated seconds.
+  double timeout;
+  //! Maximum stream speed.
+  double current;
+  //! Configuration overrides.
+  Parsers::Config overrides;
+};
+
+//! Single simulated mission.
+struct Run
+{
+  //! Run number.
+  unsigned index;
+  //! Seed of the simulator tasks.
+  int32_t seed;
+  //! Stream speed.
+  double current_n;
+  double current_e;
+  //! Run directory.
+  Path dir;
+  //! Slot among simultaneous runs.
+  unsigned slot;
+  //! Ports listened on.
+  std::vector<unsigned> ports;
+#if defined(DUNE_OS_POSIX)
+  //! Daemon process.
+  pid_t pid;
+#endif
+  //! Wall clock deadline.
+  double deadline;
+  //! Run outcome, empty if never started.
+  std::string outcome;
+  //! Run metrics (negative if unknown).
+  double duration;
+  double distance;
+  double xtrack_mean;
+  double xtrack_max;
+  double energy;
+  unsigned aborts;
+
+  Run(void):
+    index(0),
+    seed(0),
+    current_n(0),
+    current_e(0),
+    slot(0),
+    deadline(0),
+    duration(-1),
+    distance(-1),
+    xtrack_mean(-1),
+    xtrack_max(-1),
+    energy(-1),
+    aborts(0)
+  { }
+};
+
+//! Minimum, maximum and mean of a metric.
+struct Statistic
+{
+  unsigned count;
+  double sum;
+  double min;
+  double max;
+
+  Statistic(void):
+    count(0),
+    sum(0),
+    min(0),
+    max(0)
+  { }
+
+  void
+  add(double value)
+  {
+    if (value < 0)
+      return;
+
+    min = count ? std::min(min, value) : value;
+    max = count ? std::max(max, value) : value;
+    sum += value;
+    ++count;
+  }
+
+  void
+  fill(Parsers::Config& cfg, const std::string& section)
+  {
+    if (!count)
+      return;
+
+    cfg.set(section, "Mean", String::str("%.3f", sum / count));
+    cfg.set(section, "Minimum", String::str("%.3f", min));
+    cfg.set(section, "Maximum", String::str("%.3f", max));
+  }
+};
+
+#if defined(DUNE_OS_POSIX)
+
+static volatile sig_atomic_t s_stop = 0;
+
+extern "C" void
+handleTerminate(int signo)
+{
+  (void)signo;
+  s_stop = 1;
+}
+
+//! Check if a section exists in a configuration.
+static bool
+hasSection(Parsers::Config& cfg, const std::string& section)
+{
+  return !cfg.options(section).empty();
+}
+
+//! Check if an option holds a port number.
+static bool
+isPort(const std::string& option)
+{
+  return String::endsWith(option, "Port") || String::endsWith(option, "Ports");
+}
+
+//! Give the listening ports of a run a range of its own and disable
+//! other network tasks, so that simultaneous runs never meet.
+static void
+isolate(Parsers::Config& cfg, Run& run)
+{
+  run.ports.clear();
+
+  std::vector<std::string> sections = cfg.sections();
+  for (size_t i = 0; i < sections.size(); ++i)
+  {
+    std::vector<std::string> opts = cfg.options(sections[i]);
+    bool network = false;
+
+    for (size_t j = 0; j < opts.size(); ++j)
+    {
+      if (opts[j] == "Port" || opts[j] == "Local Port")
+      {
+        if (run.ports.size() == c_port_stride)
+          throw std::runtime_error("too many listening ports");
+
+        unsigned port = c_port_base + run.slot * c_port_stride + run.ports.size();
+        cfg.set(sections[i], opts[j], String::str("%u", port));
+        run.ports.push_back(port);
+      }
+      else if (isPort(opts[j]))
+      {
+        network = true;
+      }
+    }
+
+    if (network)
+      cfg.set(sections[i], "Enabled", "Never");
+  }
+}
+
+//! Check if two runs listen on a common port.
+static bool
+sharePorts(const Run& a, const Run& b)
+{
+  for (size_t i = 0; i < a.ports.size(); ++i)
+  {
+    if (std::find(b.ports.begin(), b.ports.end(), a.ports[i]) != b.ports.end())
+      return true;
+  }
+
+  return false;
+}
+
+//! Write the configuration file of a run.
+static void
+prepare(Settings& s, Run& run)
+{
+  Parsers::Config cfg(s.config.c_str());
+
+  std::vector<std::string> sections = s.overrides.sections();
+  for (size_t i = 0; i < sections.size(); ++i)
+  {
+    std::vector<std::string> opts = s.overrides.options(sections[i]);
+    for (size_t j = 0; j < opts.size(); ++j)
+      cfg.set(sections[i], opts[j], s.overrides.get(sections[i], opts[j]));
+  }
+
+  // Simulators derive their streams from the seed and their names.
+  sections = cfg.sections();
+  for (size_t i = 0; i < sections.size(); ++i)
+  {
+    std::vector<std::string> opts = cfg.options(sections[i]);
+    for (size_t j = 0; j < opts.size(); ++j)
+    {
+      if (opts[j] == "PRNG Seed")
+        cfg.set(sections[i], opts[j], String::str("%d", run.seed));
+    }
+  }
+
+  isolate(cfg, run);
+
+  if (hasSection(cfg, "Simulators.VSIM"))
+    cfg.set("Simulators.VSIM", "Time Multiplier", String::str("%f", s.speed));
+
+  if (s.current > 0 && hasSection(cfg, "Simulators.StreamVelocity"))
+  {
+    Random::Generator* prng = Random::Factory::create(Random::Factory::c_default,
+                                                      run.seed, "Stream Velocity");
+    double speed = s.current * std::sqrt(prng->uniform());
+    double heading = prng->uniform(0, Math::c_two_pi);
+    delete prng;
+
+    run.current_n = speed * std::cos(heading);
+    run.current_e = speed * std::sin(heading);
+
+    cfg.set("Simulators.StreamVelocity", "Stream Velocity Source", "Constant");
+    cfg.set("Simulators.StreamVelocity", "Default Speed North", String::str("%f", run.current_n));
+    cfg.set("Simulators.StreamVelocity", "Default Speed East", String::str("%f", run.current_e));
+  }
+
+  std::string section("Simulators.MonteCarlo");
+  cfg.set(section, "Enabled", "Always");
+  cfg.set(section, "Entity Label", "Monte Carlo");
+  cfg.set(section, "Plan File", s.plan.str());
+  cfg.set(section, "Plan Identifier", s.plan_id);
+  cfg.set(section, "Report File", (run.dir / "report.ini").str());
+  cfg.set(section, "Timeout", String::str("%f", s.timeout));
+
+  (run.dir / "log").create();
+  (run.dir / "db").create();
+  std::remove((run.dir / "report.ini").c_str());
+  cfg.writeToFile((run.dir / "run.ini").c_str());
+}
+
+//! Start the daemon of a run.
+static bool
+launch(const Settings& s, Run& run)
+{
+  Path ini = run.dir / "run.ini";
+  Path out = run.dir / "output.txt";
+
+  run.pid = fork();
+  if (run.pid < 0)
+    return false;
+
+  if (run.pid == 0)
+  {
+    int fd = open(out.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0)
+    {
+      dup2(fd, 1);
+      dup2(fd, 2);
+      close(fd);
+    }
+
+    execl(s.daemon.c_str(), s.daemon.c_str(), "-c", ini.c_str(),
+          "-p", s.profile.c_str(), "-D", run.dir.c_str(), (char*)NULL);
+    _exit(127);
+  }
+
+  run.deadline = Clock::get() + s.timeout / s.speed + c_margin;
+  return true;
+}
+
+//! Stop the daemon of a run.
+static void
+terminate(const Run& run)
+{
+  int status = 0;
+  kill(run.pid, SIGTERM);
+
+  double deadline = Clock::get() + c_stop_timeout;
+  while (Clock::get() < deadline)
+  {
+    if (waitpid(run.pid, &status, WNOHANG) == run.pid)
+      return;
+
+    Delay::wait(0.1);
+  }
+
+  kill(run.pid, SIGKILL);
+  waitpid(run.pid, &status, 0);
+}
+
+//! Read the metrics of a finished run.
+static void
+readReport(Run& run)
+{
+  try
+  {
+    Parsers::Config rep((run.dir / "report.ini").c_str());
+    rep.get("Run", "Outcome", "unknown", run.outcome);
+    rep.get("Run", "Duration", "-1", run.duration);
+    rep.get("Run", "Distance", "-1", run.distance);
+    rep.get("Run", "Path Error Mean", "-1", run.xtrack_mean);
+    rep.get("Run", "Path Error Max", "-1", run.xtrack_max);
+    rep.get("Run", "Energy", "-1", run.energy);
+    rep.get("Run", "Aborts", "0", run.aborts);
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "ERROR: run " << run.index << ": " << e.what() << std::endl;
+    run.outcome = "unknown";
+  }
+}
+
+//! Check if a slot belongs to one of the running missions.
+static bool
+isSlotTaken(const std::vector<Run*>& active, unsigned slot)
+{
+  for (size_t i = 0; i < active.size(); ++i)
+  {
+    if (active[i]->slot == slot)
+      return true;
+  }
+
+  return false;
+}
+
+//! Run all missions, at most s.jobs at a time.
+static void
+execute(Settings& s, std::vector<Run>& runs)
+{
+  std::vector<Run*> active;
+  size_t next = 0;
+
+  while ((next < runs.size() && !s_stop) || !active.empty())
+  {
+    while (!s_stop && next < runs.size() && active.size() < s.jobs)
+    {
+      Run& run = runs[next++];
+
+      run.slot = 0;
+      while (isSlotTaken(active, run.slot))
+        ++run.slot;
+
+      try
+      {
+        prepare(s, run);
+
+        for (size_t i = 0; i < active.size(); ++i)
+        {
+          if (sharePorts(run, *active[i]))
+            throw std::runtime_error(String::str("ports in use by run %u", active[i]->index));
+        }
+      }
+      catch (std::exception& e)
+      {
+        std::cerr << "ERROR: run " << run.index << ": " << e.what() << std::endl;
+        run.outcome = "invalid";
+        continue;
+      }
+
+      if (!launch(s, run))
+      {
+        std::cerr << "ERROR: run " << run.index << ": "
+                  << System::Error::getLastMessage() << std::endl;
+        run.outcome = "crashed";
+        continue;
+      }
+
+      active.push_back(&run);
+    }
+
+    Delay::wait(0.2);
+
+    std::vector<Run*>::iterator itr = active.begin();
+    while (itr != active.end())
+    {
+      Run& run = **itr;
+      int status = 0;
+
+      if ((run.dir / "report.ini").isFile())
+      {
+        terminate(run);
+        readReport(run);
+      }
+      else if (waitpid(run.pid, &status, WNOHANG) == run.pid)
+      {
+        run.outcome = "crashed";
+      }
+      else if (s_stop || Clock::get() > run.deadline)
+      {
+        terminate(run);
+        run.outcome = s_stop ? "interrupted" : "timeout";
+      }
+      else
+      {
+        ++itr;
+        continue;
+      }
+
+      std::cout << String::str("run %04u: %s", run.index, run.outcome.c_str()) << std::endl;
+      itr = active.erase(itr);
+    }
+  }
+}
+
+//! Write per run metrics and the summary report.
+static void
+summarize(Settings& s, const std::vector<Run>& runs)
+{
+  std::ofstream csv((s.output / "runs.csv").c_str());
+  csv << "run,seed,current_north,current_east,outcome,duration,distance,"
+      << "path_error_mean,path_error_max,energy,aborts" << std::endl;
+
+  std::map<std::string, unsigned> outcomes;
+  Statistic duration;
+  Statistic distance;
+  Statistic xtrack_mean;
+  Statistic xtrack_max;
+  Statistic energy;
+  unsigned started = 0;
+  unsigned aborts = 0;
+
+  for (size_t i = 0; i < runs.size(); ++i)
+  {
+    const Run& run = runs[i];
+    if (run.outcome.empty())
+      continue;
+
+    csv << String::str("%u,%d,%.3f,%.3f,%s,%.3f,%.3f,%.3f,%.3f,%.3f,%u",
+                       run.index, run.seed, run.current_n, run.current_e,
+                       run.outcome.c_str(), run.duration, run.distance,
+                       run.xtrack_mean, run.xtrack_max, run.energy, run.aborts)
+        << std::endl;
+
+    ++started;
+    ++outcomes[run.outcome];
+    aborts += run.aborts;
+    duration.add(run.duration);
+    distance.add(run.distance);
+    xtrack_mean.add(run.xtrack_mean);
+    xtrack_max.add(run.xtrack_max);
+    energy.add(run.energy);
+  }
+
+  Parsers::Config summary;
+  summary.set("Summary", "Runs", String::str("%u", started));
+  summary.set("Summary", "Aborts", String::str("%u", aborts));
+  summary.set("Summary", "Seed", String::str("%d", s.seed));
+
+  std::map<std::string, unsigned>::const_iterator itr = outcomes.begin();
+  for (; itr != outcomes.end(); ++itr)
+    summary.set("Outcomes", itr->first, String::str("%u", itr->second));
+
+  duration.fill(summary, "Duration (s)");
+  distance.fill(summary, "Distance (m)");
+  xtrack_mean.fill(summary, "Mean Path Error (m)");
+  xtrack_max.fill(summary, "Maximum Path Error (m)");
+  energy.fill(summary, "Energy (Wh)");
+
+  summary.writeToFile((s.output / "summary.ini").c_str());
+  std::cout << std::endl << summary;
+}
+
+#endif
+
+int
+main(int argc, char** argv)
+{
+  OptionParser options;
+  options.executable("dune-montecarlo")
+  .program(DUNE_SHORT_NAME)
+  .copyright(DUNE_COPYRIGHT)
+  .email(DUNE_CONTACT)
+  .version(getFullVersion())
+  .date(getCompileDate())
+  .arch(DUNE_SYSTEM_NAME)
+  .description("Run a plan in many simulated vehicles and summarize the results.")
+  .add("-c", "--config-file",
+       "Simulator configuration file CONFIG", "CONFIG")
+  .add("-P", "--plan-file",
+       "LSF file with the plan specification", "FILE")
+  .add("-i", "--plan-id",
+       "Plan to execute (default: first plan in file)", "ID")
+  .add("-n", "--runs",
+       "Number of runs (default: 10)", "RUNS")
+  .add("-j", "--jobs",
+       "Number of simultaneous runs (default: 2)", "JOBS")
+  .add("-s", "--seed",
+       "Master seed (default: random)", "SEED")
+  .add("-x", "--speed",
+       "Simulation time multiplier (default: 10)", "SPEED")
+  .add("-t", "--timeout",
+       "Run timeout in simulated seconds (default: 3600)", "SECONDS")
+  .add("-w", "--current",
+       "Maximum random stream speed in m/s (default: 0)", "SPEED")
+  .add("-f", "--overrides",
+       "Configuration file with options applied to every run", "FILE")
+  .add("-o", "--output",
+       "Output directory (default: montecarlo)", "DIR")
+  .add("-p", "--profile",
+       "Execution profile (default: Simulation)", "PROFILE")
+  .add("-b", "--daemon",
+       "DUNE executable (default: dune next to this program)", "FILE");
+
+  // Parse command line arguments.
+  if (!options.parse(argc, argv))
+  {
+    if (options.bad())
+      std::cerr << "ERROR: " << options.error() << std::endl;
+    options.usage();
+    return 1;
+  }
+
+#if defined(DUNE_OS_POSIX)
+  Settings s;
+  s.runs = 10;
+  s.jobs = 2;
+  s.seed = Random::Generator::arbitrarySeed();
+  s.speed = 10;
+  s.timeout = 3600;
+  s.current = 0;
+  s.output = "montecarlo";
+  s.profile = "Simulation";
+  s.daemon = Path(Path::applicationFile()).dirname() / "dune";
+  s.plan_id = options.value("--plan-id");
+
+  castLexical(options.value("--runs"), s.runs);
+  castLexical(options.value("--jobs"), s.jobs);
+  castLexical(options.value("--seed"), s.seed);
+  castLexical(options.value("--speed"), s.speed);
+  castLexical(options.value("--timeout"), s.timeout);
+  castLexical(options.value("--current"), s.current);
+
+  if (!options.value("--output").empty())
+    s.output = options.value("--output");
+
+  if (!options.value("--profile").empty())
+    s.profile = options.value("--profile");
+
+  if (!options.value("--daemon").empty())
+    s.daemon = options.value("--daemon");
+
+  if (!s.output.isAbsolute())
+    s.output = Path::current() / s.output;
+
+  s.plan = options.value("--plan-file");
+  if (!s.plan.isFile())
+  {
+    std::cerr << "ERROR: plan file not found" << std::endl;
+    return 1;
+  }
+
+  if (!s.plan.isAbsolute())
+    s.plan = Path::current() / s.plan;
+
+  if (s.jobs == 0 || s.jobs > c_max_jobs || s.speed <= 0)
+  {
+    std::cerr << "ERROR: invalid number of jobs or speed" << std::endl;
+    return 1;
+  }
+
+  Tasks::Context context;
+  s.config = context.dir_cfg / options.value("--config-file") + ".ini";
+  if (!s.config.isFile())
+    s.config = context.dir_usr_cfg / options.value("--config-file") + ".ini";
+
+  try
+  {
+    // Check configuration files before starting any run.
+    Parsers::Config check(s.config.c_str());
+
+    if (!options.value("--overrides").empty())
+      s.overrides.parseFile(options.value("--overrides").c_str());
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+
+  struct sigaction actions;
+  std::memset(&actions, 0, sizeof(actions));
+  sigemptyset(&actions.sa_mask);
+  actions.sa_handler = handleTerminate;
+  sigaction(SIGINT, &actions, 0);
+  sigaction(SIGTERM, &actions, 0);
+
+  std::vector<Run> runs(s.runs);
+  for (unsigned i = 0; i < s.runs; ++i)
+  {
+    runs[i].index = i;
+    runs[i].seed = Random::Generator::deriveSeed(s.seed, String::str("run-%u", i));
+    runs[i].dir = s.output / String::str("run-%04u", i);
+  }
+
+  s.output.create();
+  execute(s, runs);
+  summarize(s, runs);
+
+  return 0;
+#else
+  std::cerr << "ERROR: not supported on this platform" << std::endl;
+  return 1;
+#endif
+}
@@ -0,0 +1,143 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_CONCURRENCY_BOUNDED_QUEUE_HPP_INCLUDED_
+#define DUNE_CONCURRENCY_BOUNDED_QUEUE_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <deque>
+
+// DUNE headers.
+#include <DUNE/Concurrency/ScopedCondition.hpp>
+
+namespace DUNE
+{
+  namespace Concurrency
+  {
+    //! The BoundedQueue is a thread-safe FIFO with a fixed capacity,
+    //! used to connect the stages of a pipeline. Producers block
+    //! while the queue is full and consumers block while it is
+    //! empty, so a fast stage cannot run arbitrarily ahead of a slow
+    //! one. Closing the queue wakes every waiting thread.
+    template <typename T>
+    class BoundedQueue
+    {
+    public:
+      //! Constructor.
+      //! @param[in] capacity maximum number of elements in the queue.
+      BoundedQueue(unsigned capacity):
+        m_capacity(capacity > 0 ? capacity : 1),
+        m_closed(false)
+      { }
+
+      //! Add an element to the end of the queue, waiting for room if
+      //! the queue is full.
+      //! @param[in] v element to insert.
+      //! @return true if the element was inserted, false if the queue
+      //! was closed.
+      bool
+      push(const T& v)
+      {
+        ScopedCondition l(m_cond);
+
+        while (!m_closed && m_queue.size() >= m_capacity)
+          m_cond.wait();
+
+        if (m_closed)
+          return false;
+
+        m_queue.push_back(v);
+        m_cond.broadcast();
+        return true;
+      }
+
+      //! Remove the first element of the queue, waiting for one to
+      //! be available if the queue is empty.
+      //! @param[out] v removed element.
+      //! @return true if an element was removed, false if the queue
+      //! is closed and empty.
+      bool
+      pop(T& v)
+      {
+        ScopedCondition l(m_cond);
+
+        while (!m_closed && m_queue.empty())
+          m_cond.wait();
+
+        if (m_queue.empty())
+          return false;
+
+        v = m_queue.front();
+        m_queue.pop_front();
+        m_cond.broadcast();
+        return true;
+      }
+
+      //! Close the queue. Pending elements can still be removed but
+      //! no more elements are accepted.
+      void
+      close(void)
+      {
+        ScopedCondition l(m_cond);
+        m_closed = true;
+        m_cond.broadcast();
+      }
+
+      //! Test if the queue is closed.
+      //! @return true if the queue is closed, false otherwise.
+      bool
+      closed(void)
+      {
+        ScopedCondition l(m_cond);
+        return m_closed;
+      }
+
+      //! Retrieve the number of elements currently in the queue.
+      //! @return number of elements in the queue.
+      unsigned
+      size(void)
+      {
+        ScopedCondition l(m_cond);
+        return (unsigned)m_queue.size();
+      }
+
+    private:
+      //! Internal queue data structure.
+      std::deque<T> m_queue;
+      //! Internal queue condition.
+      Condition m_cond;
+      //! Maximum number of elements.
+      unsigned m_capacity;
+      //! True if queue is closed.
+      bool m_closed;
+    };
+  }
+}
+
+#endif
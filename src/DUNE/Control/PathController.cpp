@@ -418,9 +418,8 @@ namespace DUNE
     void
     PathController::setEndPoint(const IMC::DesiredPath* dpath)
     {
-      WGS84::displacement(m_estate.lat, m_estate.lon, 0,
-                          m_pcs.start_lat, m_pcs.start_lon, 0,
-                          &m_ts.start.x, &m_ts.start.y);
+      m_frame.displacement(m_pcs.start_lat, m_pcs.start_lon, 0,
+                           &m_ts.start.x, &m_ts.start.y);
       m_ts.start.z = m_pcs.start_z;
 
       if ((dpath->flags & IMC::DesiredPath::FL_LOITER_CURR) != 0 &&
@@ -441,9 +440,8 @@ namespace DUNE
         m_pcs.end_z_units = dpath->end_z_units;
       }
 
-      WGS84::displacement(m_estate.lat, m_estate.lon, 0,
-                          m_pcs.end_lat, m_pcs.end_lon, 0,
-                          &m_ts.end.x, &m_ts.end.y);
+      m_frame.displacement(m_pcs.end_lat, m_pcs.end_lon, 0,
+                           &m_ts.end.x, &m_ts.end.y);
       m_ts.end.z = m_pcs.end_z;
     }
 
@@ -605,6 +603,7 @@ namespace DUNE
 
       // Save new EstimatedState values
       m_estate = *es;
+      m_frame.setReference(m_estate.lat, m_estate.lon);
 
       if (!isActive() || m_error || !m_tracking)
         return;
@@ -643,15 +642,10 @@ namespace DUNE
       // Apply new LLH reference.
       if (change_ref)
       {
-        const double lat = m_estate.lat;
-        const double lon = m_estate.lon;
-
-        WGS84::displacement(lat, lon, 0,
-                            m_pcs.start_lat, m_pcs.start_lon, 0,
-                            &m_ts.start.x, &m_ts.start.y);
-        WGS84::displacement(lat, lon, 0,
-                            m_pcs.end_lat, m_pcs.end_lon, 0,
-                            &m_ts.end.x, &m_ts.end.y);
+        m_frame.displacement(m_pcs.start_lat, m_pcs.start_lon, 0,
+                             &m_ts.start.x, &m_ts.start.y);
+        m_frame.displacement(m_pcs.end_lat, m_pcs.end_lon, 0,
+                             &m_ts.end.x, &m_ts.end.y);
       }
 
       const double now = Clock::get();
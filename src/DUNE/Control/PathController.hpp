@@ -484,6 +484,8 @@ namespace DUNE
       IMC::ControlLoops m_cloops;
       //! EstimatedState message
       IMC::EstimatedState m_estate;
+      //! Local frame at the navigation reference (zero height).
+      Coordinates::LocalFrame m_frame;
       //! DesiredZ reference
       IMC::DesiredZ m_zref;
       //! DesiredSpeed reference
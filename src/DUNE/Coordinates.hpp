@@ -42,5 +42,6 @@ namespace DUNE
 #include <DUNE/Coordinates/WGS84.hpp>
 #include <DUNE/Coordinates/WMM.hpp>
 #include <DUNE/Coordinates/UTM.hpp>
+#include <DUNE/Coordinates/LocalFrame.hpp>
 
 #endif
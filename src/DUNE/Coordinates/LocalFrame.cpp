@@ -0,0 +1,113 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/Coordinates/LocalFrame.hpp>
+#include <DUNE/IMC/Definitions.hpp>
+
+namespace DUNE
+{
+  namespace Coordinates
+  {
+    LocalFrame::LocalFrame(void):
+      m_lat(0.0),
+      m_lon(0.0),
+      m_hae(0.0)
+    {
+      update();
+    }
+
+    LocalFrame::LocalFrame(double lat, double lon, double hae):
+      m_lat(lat),
+      m_lon(lon),
+      m_hae(hae)
+    {
+      update();
+    }
+
+    bool
+    LocalFrame::setReference(double lat, double lon, double hae)
+    {
+      if (lat == m_lat && lon == m_lon && hae == m_hae)
+        return false;
+
+      m_lat = lat;
+      m_lon = lon;
+      m_hae = hae;
+      update();
+      return true;
+    }
+
+    bool
+    LocalFrame::setReference(const IMC::EstimatedState& state)
+    {
+      return setReference(state.lat, state.lon, state.height);
+    }
+
+    void
+    LocalFrame::toWGS84(const IMC::EstimatedState& state, double& lat, double& lon, float& hae)
+    {
+      setReference(state);
+      displace(state.x, state.y, state.z, &lat, &lon, &hae);
+    }
+
+    void
+    LocalFrame::toWGS84(const IMC::EstimatedState& state, double& lat, double& lon)
+    {
+      float hae = 0.0f;
+      toWGS84(state, lat, lon, hae);
+    }
+
+    void
+    LocalFrame::update(void)
+    {
+      WGS84::toECEF(m_lat, m_lon, m_hae, &m_x, &m_y, &m_z);
+
+      m_slat = std::sin(m_lat);
+      m_clat = std::cos(m_lat);
+      m_slon = std::sin(m_lon);
+      m_clon = std::cos(m_lon);
+
+      // Geocentric latitude, as used by WGS84::displace().
+      double p = std::sqrt(m_x * m_x + m_y * m_y);
+#if defined(DUNE_ELLIPSOIDAL_DISPLACE)
+      double rn = c_wgs84_a / std::sqrt(1 - c_wgs84_e2 * (m_slat * m_slat));
+      double phi = std::atan2(m_z, p * (1 - c_wgs84_e2 * rn / (rn + m_hae)));
+#else
+      double phi = std::atan2(m_z, p);
+#endif
+
+      m_sphi = std::sin(phi);
+      m_cphi = std::cos(phi);
+    }
+  }
+}
@@ -0,0 +1,216 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_COORDINATES_LOCAL_FRAME_HPP_INCLUDED_
+#define DUNE_COORDINATES_LOCAL_FRAME_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Coordinates/WGS84.hpp>
+
+namespace DUNE
+{
+  // Forward declarations.
+  namespace IMC
+  {
+    class EstimatedState;
+  }
+
+  namespace Coordinates
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM LocalFrame;
+
+    //! North-East-Down frame attached to a WGS-84 reference point.
+    //!
+    //! The ECEF position of the reference and the sines and cosines
+    //! needed by WGS84::displacement() and WGS84::displace() are
+    //! computed once, when the reference changes. Conversions give
+    //! the same results as the corresponding WGS84 routines called
+    //! with this reference, at roughly half the cost.
+    class LocalFrame
+    {
+    public:
+      //! Create frame with reference at latitude, longitude and
+      //! height zero.
+      LocalFrame(void);
+
+      //! Create frame.
+      //! @param[in] lat reference latitude (rad).
+      //! @param[in] lon reference longitude (rad).
+      //! @param[in] hae reference height above ellipsoid (m).
+      LocalFrame(double lat, double lon, double hae = 0.0);
+
+      //! Change the reference. Nothing is computed if the reference
+      //! is unchanged.
+      //! @param[in] lat reference latitude (rad).
+      //! @param[in] lon reference longitude (rad).
+      //! @param[in] hae reference height above ellipsoid (m).
+      //! @return true if the reference changed, false otherwise.
+      bool
+      setReference(double lat, double lon, double hae = 0.0);
+
+      //! Use the LLH reference of an estimated state message.
+      //! @param[in] state estimated state.
+      //! @return true if the reference changed, false otherwise.
+      bool
+      setReference(const IMC::EstimatedState& state);
+
+      //! Get reference latitude.
+      //! @return latitude (rad).
+      double
+      getLatitude(void) const
+      {
+        return m_lat;
+      }
+
+      //! Get reference longitude.
+      //! @return longitude (rad).
+      double
+      getLongitude(void) const
+      {
+        return m_lon;
+      }
+
+      //! Get reference height above ellipsoid.
+      //! @return height (m).
+      double
+      getHeight(void) const
+      {
+        return m_hae;
+      }
+
+      //! Compute NED displacement of a WGS-84 coordinate relative
+      //! to the reference. Same as WGS84::displacement().
+      //! @param[in] lat latitude (rad).
+      //! @param[in] lon longitude (rad).
+      //! @param[in] hae height above ellipsoid (m).
+      //! @param[out] n northing offset (m).
+      //! @param[out] e easting offset (m).
+      //! @param[out] d down offset (m), may be NULL.
+      template <typename T>
+      void
+      displacement(double lat, double lon, double hae, T* n, T* e, T* d = NULL) const
+      {
+        double x, y, z;
+        WGS84::toECEF(lat, lon, hae, &x, &y, &z);
+
+        double ox = x - m_x;
+        double oy = y - m_y;
+        double oz = z - m_z;
+
+        if (n != NULL)
+          *n = -m_slat * m_clon * ox - m_slat * m_slon * oy + m_clat * oz;
+
+        if (e != NULL)
+          *e = -m_slon * ox + m_clon * oy;
+
+        if (d != NULL)
+          *d = -m_clat * m_clon * ox - m_clat * m_slon * oy - m_slat * oz;
+      }
+
+      //! Compute WGS-84 coordinates of a NED offset from the reference.
+      //! Same as WGS84::displace() starting at the reference.
+      //! @param[in] n northing offset (m).
+      //! @param[in] e easting offset (m).
+      //! @param[in] d down offset (m).
+      //! @param[out] lat latitude (rad).
+      //! @param[out] lon longitude (rad).
+      //! @param[out] hae height above ellipsoid (m).
+      template <typename Ta, typename Tb>
+      void
+      displace(double n, double e, double d, Ta* lat, Ta* lon, Tb* hae) const
+      {
+        double x = m_x + (-m_slon * e - m_clon * m_sphi * n - m_clon * m_cphi * d);
+        double y = m_y + (m_clon * e - m_slon * m_sphi * n - m_slon * m_cphi * d);
+        double z = m_z + (m_cphi * n - m_sphi * d);
+
+        WGS84::fromECEF(x, y, z, lat, lon, hae);
+      }
+
+      //! Compute WGS-84 coordinates of a NE offset from the reference,
+      //! discarding height. Same as WGS84::displace() with latitude
+      //! and longitude only, for a reference at height zero.
+      //! @param[in] n northing offset (m).
+      //! @param[in] e easting offset (m).
+      //! @param[out] lat latitude (rad).
+      //! @param[out] lon longitude (rad).
+      template <typename T>
+      void
+      displace(double n, double e, T* lat, T* lon) const
+      {
+        double hae = 0.0;
+        displace(n, e, 0.0, lat, lon, &hae);
+      }
+
+      //! Convert the position in an estimated state message to WGS-84
+      //! coordinates, updating the reference if needed. Same as
+      //! Coordinates::toWGS84().
+      //! @param[in] state estimated state.
+      //! @param[out] lat latitude (rad).
+      //! @param[out] lon longitude (rad).
+      //! @param[out] hae height above ellipsoid (m).
+      void
+      toWGS84(const IMC::EstimatedState& state, double& lat, double& lon, float& hae);
+
+      //! Convert the position in an estimated state message to WGS-84
+      //! coordinates, updating the reference if needed.
+      //! @param[in] state estimated state.
+      //! @param[out] lat latitude (rad).
+      //! @param[out] lon longitude (rad).
+      void
+      toWGS84(const IMC::EstimatedState& state, double& lat, double& lon);
+
+    private:
+      //! Reference latitude.
+      double m_lat;
+      //! Reference longitude.
+      double m_lon;
+      //! Reference height above ellipsoid.
+      double m_hae;
+      //! Reference ECEF coordinates.
+      double m_x, m_y, m_z;
+      //! Sine and cosine of reference latitude.
+      double m_slat, m_clat;
+      //! Sine and cosine of reference longitude.
+      double m_slon, m_clon;
+      //! Sine and cosine of the latitude used by WGS84::displace().
+      double m_sphi, m_cphi;
+
+      //! Compute reference dependent quantities.
+      void
+      update(void);
+    };
+  }
+}
+
+#endif
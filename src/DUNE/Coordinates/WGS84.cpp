@@ -0,0 +1,251 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/Coordinates/WGS84.hpp>
+#include <DUNE/Math/Vectorized.hpp>
+
+namespace DUNE
+{
+  namespace Coordinates
+  {
+    using Math::Vectorized;
+
+    //! Number of points converted per block.
+    static const size_t c_block = 128;
+
+    //! Block conversion to ECEF.
+    static void
+    blockToECEF(const double* lat, const double* lon, const double* hae,
+                double* x, double* y, double* z, size_t count)
+    {
+      double slat[c_block];
+      double clat[c_block];
+      double slon[c_block];
+      double clon[c_block];
+
+      Vectorized::sincos(lat, slat, clat, count);
+      Vectorized::sincos(lon, slon, clon, count);
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        double h = (hae == NULL) ? 0.0 : hae[i];
+        double rn = c_wgs84_a / std::sqrt(1.0 - c_wgs84_e2 * (slat[i] * slat[i]));
+        x[i] = (rn + h) * clat[i] * clon[i];
+        y[i] = (rn + h) * clat[i] * slon[i];
+        z[i] = (((1.0 - c_wgs84_e2) * rn) + h) * slat[i];
+      }
+    }
+
+    //! Block conversion from ECEF.
+    static void
+    blockFromECEF(const double* x, const double* y, const double* z,
+                  double* lat, double* lon, double* hae, size_t count)
+    {
+      double p[c_block];
+      double a[c_block];
+      double b[c_block];
+      double s[c_block];
+      double c[c_block];
+      double rlon[c_block];
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        p[i] = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+        a[i] = c_wgs84_a * z[i];
+        b[i] = p[i] * c_wgs84_b;
+      }
+
+      Vectorized::atan2(y, x, rlon, count);
+      Vectorized::atan2(a, b, s, count);
+      std::copy(s, s + count, a);
+      Vectorized::sincos(a, s, c, count);
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        a[i] = z[i] + c_wgs84_ep2 * c_wgs84_b * s[i] * s[i] * s[i];
+        b[i] = p[i] - c_wgs84_e2 * c_wgs84_a * c[i] * c[i] * c[i];
+      }
+
+      Vectorized::atan2(a, b, lat, count);
+      std::copy(rlon, rlon + count, lon);
+
+      if (hae == NULL)
+        return;
+
+      Vectorized::sincos(lat, s, c, count);
+      for (size_t i = 0; i < count; ++i)
+        hae[i] = p[i] / c[i] - c_wgs84_a / std::sqrt(1.0 - c_wgs84_e2 * (s[i] * s[i]));
+    }
+
+    void
+    WGS84::toECEF(const double* lat, const double* lon, const double* hae,
+                  double* x, double* y, double* z, size_t count)
+    {
+      double tx[c_block];
+      double ty[c_block];
+      double tz[c_block];
+
+      for (size_t i = 0; i < count; i += c_block)
+      {
+        size_t size = std::min(c_block, count - i);
+        blockToECEF(lat + i, lon + i, (hae == NULL) ? NULL : hae + i, tx, ty, tz, size);
+        std::copy(tx, tx + size, x + i);
+        std::copy(ty, ty + size, y + i);
+        std::copy(tz, tz + size, z + i);
+      }
+    }
+
+    void
+    WGS84::fromECEF(const double* x, const double* y, const double* z,
+                    double* lat, double* lon, double* hae, size_t count)
+    {
+      double tlat[c_block];
+      double tlon[c_block];
+      double thae[c_block];
+
+      for (size_t i = 0; i < count; i += c_block)
+      {
+        size_t size = std::min(c_block, count - i);
+        blockFromECEF(x + i, y + i, z + i, tlat, tlon, (hae == NULL) ? NULL : thae, size);
+        std::copy(tlat, tlat + size, lat + i);
+        std::copy(tlon, tlon + size, lon + i);
+        if (hae != NULL)
+          std::copy(thae, thae + size, hae + i);
+      }
+    }
+
+    void
+    WGS84::displacement(double rlat, double rlon, double rhae,
+                        const double* lat, const double* lon, const double* hae,
+                        double* n, double* e, double* d, size_t count)
+    {
+      double rx, ry, rz;
+      toECEF(rlat, rlon, rhae, &rx, &ry, &rz);
+
+      double slat = std::sin(rlat);
+      double clat = std::cos(rlat);
+      double slon = std::sin(rlon);
+      double clon = std::cos(rlon);
+
+      double x[c_block];
+      double y[c_block];
+      double z[c_block];
+
+      for (size_t i = 0; i < count; i += c_block)
+      {
+        size_t size = std::min(c_block, count - i);
+        blockToECEF(lat + i, lon + i, (hae == NULL) ? NULL : hae + i, x, y, z, size);
+
+        for (size_t j = 0; j < size; ++j)
+        {
+          double ox = x[j] - rx;
+          double oy = y[j] - ry;
+          double oz = z[j] - rz;
+          x[j] = -slat * clon * ox - slat * slon * oy + clat * oz;
+          y[j] = -slon * ox + clon * oy;
+          z[j] = -clat * clon * ox - clat * slon * oy - slat * oz;
+        }
+
+        std::copy(x, x + size, n + i);
+        std::copy(y, y + size, e + i);
+        if (d != NULL)
+          std::copy(z, z + size, d + i);
+      }
+    }
+
+    void
+    WGS84::displace(double rlat, double rlon, double rhae,
+                    const double* n, const double* e, const double* d,
+                    double* lat, double* lon, double* hae, size_t count)
+    {
+      double rx, ry, rz;
+      toECEF(rlat, rlon, rhae, &rx, &ry, &rz);
+
+      // Same local frame as the scalar displace().
+      double p = std::sqrt(rx * rx + ry * ry);
+#if defined(DUNE_ELLIPSOIDAL_DISPLACE)
+      double rn = computeRn(rlat);
+      double phi = std::atan2(rz, p * (1 - c_wgs84_e2 * rn / (rn + rhae)));
+#else
+      double phi = std::atan2(rz, p);
+#endif
+
+      double slon = std::sin(rlon);
+      double clon = std::cos(rlon);
+      double sphi = std::sin(phi);
+      double cphi = std::cos(phi);
+
+      double x[c_block];
+      double y[c_block];
+      double z[c_block];
+
+      for (size_t i = 0; i < count; i += c_block)
+      {
+        size_t size = std::min(c_block, count - i);
+
+        for (size_t j = 0; j < size; ++j)
+        {
+          double dn = n[i + j];
+          double de = e[i + j];
+          double dd = (d == NULL) ? 0.0 : d[i + j];
+          x[j] = rx - slon * de - clon * sphi * dn - clon * cphi * dd;
+          y[j] = ry + clon * de - slon * sphi * dn - slon * cphi * dd;
+          z[j] = rz + cphi * dn - sphi * dd;
+        }
+
+        fromECEF(x, y, z, lat + i, lon + i, (hae == NULL) ? NULL : hae + i, size);
+      }
+    }
+
+    void
+    WGS84::getNEBearingAndRange(double lat1, double lon1,
+                                const double* lat2, const double* lon2,
+                                double* bearing, double* range, size_t count)
+    {
+      double n[c_block];
+      double e[c_block];
+
+      for (size_t i = 0; i < count; i += c_block)
+      {
+        size_t size = std::min(c_block, count - i);
+        displacement(lat1, lon1, 0.0, lat2 + i, lon2 + i, NULL, n, e, NULL, size);
+
+        for (size_t j = 0; j < size; ++j)
+          range[i + j] = std::sqrt(n[j] * n[j] + e[j] * e[j]);
+
+        Vectorized::atan2(e, n, bearing + i, size);
+      }
+    }
+  }
+}
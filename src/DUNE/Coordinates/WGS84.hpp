@@ -345,6 +345,89 @@ namespace DUNE
         *hae = p / std::cos(*lat) - computeRn(*lat);
       }
 
+      //! @name Batch conversions.
+      //! Structure of arrays versions of the routines above, for
+      //! converting many points per call. Trigonometry uses
+      //! Math::Vectorized and reference quantities are computed once
+      //! per call. Outputs may alias inputs. Results agree with the
+      //! scalar routines within 1e-14 rad for angles and 1e-8 m for
+      //! positions, except heights computed from ECEF near the poles
+      //! (1e-7 m at 86 degrees), where both paths are ill-conditioned
+      //! (see programs/tests/test_WGS84.cpp).
+      //! @{
+
+      //! Convert WGS-84 coordinates to ECEF coordinates.
+      //! @param[in] lat WGS-84 latitudes (rad).
+      //! @param[in] lon WGS-84 longitudes (rad).
+      //! @param[in] hae heights above ellipsoid (m), NULL for zero.
+      //! @param[out] x ECEF x coordinates (m).
+      //! @param[out] y ECEF y coordinates (m).
+      //! @param[out] z ECEF z coordinates (m).
+      //! @param[in] count number of points.
+      static void
+      toECEF(const double* lat, const double* lon, const double* hae,
+             double* x, double* y, double* z, size_t count);
+
+      //! Convert ECEF coordinates to WGS-84 coordinates.
+      //! @param[in] x ECEF x coordinates (m).
+      //! @param[in] y ECEF y coordinates (m).
+      //! @param[in] z ECEF z coordinates (m).
+      //! @param[out] lat WGS-84 latitudes (rad).
+      //! @param[out] lon WGS-84 longitudes (rad).
+      //! @param[out] hae heights above ellipsoid (m), may be NULL.
+      //! @param[in] count number of points.
+      static void
+      fromECEF(const double* x, const double* y, const double* z,
+               double* lat, double* lon, double* hae, size_t count);
+
+      //! Compute NED displacements of points relative to a reference.
+      //! @param[in] rlat reference latitude (rad).
+      //! @param[in] rlon reference longitude (rad).
+      //! @param[in] rhae reference height above ellipsoid (m).
+      //! @param[in] lat latitudes (rad).
+      //! @param[in] lon longitudes (rad).
+      //! @param[in] hae heights above ellipsoid (m), NULL for zero.
+      //! @param[out] n northing offsets (m).
+      //! @param[out] e easting offsets (m).
+      //! @param[out] d down offsets (m), may be NULL.
+      //! @param[in] count number of points.
+      static void
+      displacement(double rlat, double rlon, double rhae,
+                   const double* lat, const double* lon, const double* hae,
+                   double* n, double* e, double* d, size_t count);
+
+      //! Displace a reference point by many NED offsets.
+      //! @param[in] rlat reference latitude (rad).
+      //! @param[in] rlon reference longitude (rad).
+      //! @param[in] rhae reference height above ellipsoid (m).
+      //! @param[in] n northing offsets (m).
+      //! @param[in] e easting offsets (m).
+      //! @param[in] d down offsets (m), NULL for zero.
+      //! @param[out] lat latitudes (rad).
+      //! @param[out] lon longitudes (rad).
+      //! @param[out] hae heights above ellipsoid (m), may be NULL.
+      //! @param[in] count number of points.
+      static void
+      displace(double rlat, double rlon, double rhae,
+               const double* n, const double* e, const double* d,
+               double* lat, double* lon, double* hae, size_t count);
+
+      //! Get North-East bearing and range from a reference to many
+      //! points.
+      //! @param[in] lat1 reference latitude (rad).
+      //! @param[in] lon1 reference longitude (rad).
+      //! @param[in] lat2 latitudes (rad).
+      //! @param[in] lon2 longitudes (rad).
+      //! @param[out] bearing bearings (rad).
+      //! @param[out] range ranges (m).
+      //! @param[in] count number of points.
+      static void
+      getNEBearingAndRange(double lat1, double lon1,
+                           const double* lat2, const double* lon2,
+                           double* bearing, double* range, size_t count);
+
+      //! @}
+
     private:
       //! Compute the radius of curvature in the prime vertical (Rn).
       //!
@@ -41,5 +41,6 @@ namespace DUNE
 #include <DUNE/FileSystem/Directory.hpp>
 #include <DUNE/FileSystem/FileLock.hpp>
 #include <DUNE/FileSystem/Exceptions.hpp>
+#include <DUNE/FileSystem/ChunkIndex.hpp>
 
 #endif
@@ -0,0 +1,172 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+// DUNE headers.
+#include <DUNE/FileSystem/ChunkIndex.hpp>
+#include <DUNE/Algorithms/MD5.hpp>
+#include <DUNE/Utils/String.hpp>
+
+namespace DUNE
+{
+  namespace FileSystem
+  {
+    ChunkIndex::ChunkIndex(void):
+      m_size(0),
+      m_mtime(0),
+      m_hashed(0)
+    { }
+
+    void
+    ChunkIndex::clear(void)
+    {
+      m_size = 0;
+      m_mtime = 0;
+      m_digests.clear();
+      m_hashed = 0;
+    }
+
+    unsigned
+    ChunkIndex::getChunkSize(size_t index) const
+    {
+      int64_t offset = (int64_t)index * c_chunk_size;
+      if (offset >= m_size)
+        return 0;
+
+      return (unsigned)std::min((int64_t)c_chunk_size, m_size - offset);
+    }
+
+    bool
+    ChunkIndex::update(const Path& path)
+    {
+      int64_t size = m_size;
+      std::time_t mtime = m_mtime;
+      size_t hashed = m_hashed;
+
+      resume(path, std::numeric_limits<size_t>::max());
+
+      return m_size != size || m_mtime != mtime || m_hashed != hashed;
+    }
+
+    bool
+    ChunkIndex::resume(const Path& path, size_t max_chunks)
+    {
+      std::ifstream ifs(path.c_str(), std::ios::binary);
+      if (!ifs)
+        throw std::runtime_error(Utils::String::str("cannot read file '%s'", path.c_str()));
+
+      return resume(path, ifs, max_chunks);
+    }
+
+    bool
+    ChunkIndex::resume(const Path& path, std::istream& is, size_t max_chunks)
+    {
+      int64_t size = path.size();
+      if (size < 0)
+        throw std::runtime_error(Utils::String::str("cannot read file '%s'", path.c_str()));
+
+      std::time_t mtime = path.getLastModifiedTime();
+      if (size != m_size || mtime != m_mtime)
+      {
+        // Only the last (partial) chunk and new ones change in a file
+        // that grew; anything else is hashed from scratch.
+        if (size > m_size)
+          m_hashed = std::min(m_hashed, (size_t)(m_size / c_chunk_size));
+        else
+          m_hashed = 0;
+
+        m_size = size;
+        m_mtime = mtime;
+        m_digests.resize((size_t)((size + c_chunk_size - 1) / c_chunk_size));
+      }
+
+      size_t end = m_hashed + std::min(max_chunks, m_digests.size() - m_hashed);
+      for (size_t i = m_hashed; i < end; ++i)
+      {
+        unsigned rv = read(is, i, m_bfr);
+        m_digests[i] = digest(m_bfr.empty() ? NULL : &m_bfr[0], rv);
+        m_hashed = i + 1;
+
+        // File shrunk while we were reading it.
+        if (rv < c_chunk_size && i + 1 < m_digests.size())
+        {
+          m_size = (int64_t)i * c_chunk_size + rv;
+          m_digests.resize(i + 1);
+          break;
+        }
+      }
+
+      return isComplete();
+    }
+
+    unsigned
+    ChunkIndex::read(const Path& path, size_t index, std::vector<char>& data)
+    {
+      std::ifstream ifs(path.c_str(), std::ios::binary);
+      if (!ifs)
+        throw std::runtime_error(Utils::String::str("cannot read file '%s'", path.c_str()));
+
+      return read(ifs, index, data);
+    }
+
+    unsigned
+    ChunkIndex::read(std::istream& is, size_t index, std::vector<char>& data)
+    {
+      // A previous read may have hit the end of a file that grew since.
+      is.clear();
+
+      data.resize(c_chunk_size);
+      is.seekg((std::streamoff)index * c_chunk_size, std::ios::beg);
+      if (is.fail())
+        return 0;
+
+      is.read(&data[0], c_chunk_size);
+      return (unsigned)is.gcount();
+    }
+
+    std::string
+    ChunkIndex::digest(const char* data, unsigned size)
+    {
+      uint8_t md5[16];
+      Algorithms::MD5::compute((const uint8_t*)data, size, md5);
+
+      char hex[33];
+      for (unsigned i = 0; i < 16; ++i)
+        std::sprintf(hex + i * 2, "%02x", md5[i]);
+
+      return std::string(hex, 32);
+    }
+  }
+}
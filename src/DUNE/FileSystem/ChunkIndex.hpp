@@ -0,0 +1,187 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_FILE_SYSTEM_CHUNK_INDEX_HPP_INCLUDED_
+#define DUNE_FILE_SYSTEM_CHUNK_INDEX_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <istream>
+#include <string>
+#include <vector>
+#include <ctime>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/FileSystem/Path.hpp>
+
+namespace DUNE
+{
+  namespace FileSystem
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM ChunkIndex;
+
+    //! Content addressed view of a file as a sequence of fixed size
+    //! chunks, each identified by its MD5 digest. Files are assumed
+    //! to be append-only: when a file grows only the chunks past the
+    //! previous end are hashed again. Large files can be hashed a few
+    //! chunks at a time with resume().
+    class ChunkIndex
+    {
+    public:
+      //! Size of a chunk.
+      static const unsigned c_chunk_size = 256 * 1024;
+
+      ChunkIndex(void);
+
+      //! Refresh the index of a file.
+      //! @param[in] path file path.
+      //! @return true if the index changed, false otherwise.
+      //! @throw std::runtime_error if the file cannot be read.
+      bool
+      update(const Path& path);
+
+      //! Hash at most a given number of chunks of a file, continuing
+      //! where the previous call stopped. Chunks already hashed are
+      //! kept if the file only grew in the meantime.
+      //! @param[in] path file path.
+      //! @param[in] max_chunks maximum number of chunks to hash.
+      //! @return true if the index is complete, false otherwise.
+      //! @throw std::runtime_error if the file cannot be read.
+      bool
+      resume(const Path& path, size_t max_chunks);
+
+      //! Same as resume(), reading chunks from an already open stream
+      //! of the file.
+      //! @param[in] path file path.
+      //! @param[in] is binary input stream of the file.
+      //! @param[in] max_chunks maximum number of chunks to hash.
+      //! @return true if the index is complete, false otherwise.
+      //! @throw std::runtime_error if the file cannot be read.
+      bool
+      resume(const Path& path, std::istream& is, size_t max_chunks);
+
+      //! Forget all chunks.
+      void
+      clear(void);
+
+      //! Get file size.
+      //! @return file size in bytes.
+      int64_t
+      getSize(void) const
+      {
+        return m_size;
+      }
+
+      //! Get modification time of the indexed file.
+      //! @return modification time.
+      std::time_t
+      getModifiedTime(void) const
+      {
+        return m_mtime;
+      }
+
+      //! Get number of chunks.
+      //! @return number of chunks.
+      size_t
+      getCount(void) const
+      {
+        return m_digests.size();
+      }
+
+      //! Get number of chunks already hashed.
+      //! @return number of chunks.
+      size_t
+      getHashed(void) const
+      {
+        return m_hashed;
+      }
+
+      //! Check if all chunks are hashed.
+      //! @return true if the index is complete, false otherwise.
+      bool
+      isComplete(void) const
+      {
+        return m_hashed == m_digests.size();
+      }
+
+      //! Get size of a chunk.
+      //! @param[in] index chunk index.
+      //! @return chunk size in bytes.
+      unsigned
+      getChunkSize(size_t index) const;
+
+      //! Get the digest of a chunk.
+      //! @param[in] index chunk index.
+      //! @return hexadecimal MD5 digest.
+      const std::string&
+      getDigest(size_t index) const
+      {
+        return m_digests[index];
+      }
+
+      //! Read a chunk of a file.
+      //! @param[in] path file path.
+      //! @param[in] index chunk index.
+      //! @param[out] data chunk contents, at most c_chunk_size bytes.
+      //! @return number of bytes read.
+      static unsigned
+      read(const Path& path, size_t index, std::vector<char>& data);
+
+      //! Read a chunk from an open stream.
+      //! @param[in] is binary input stream of the file.
+      //! @param[in] index chunk index.
+      //! @param[out] data chunk contents, at most c_chunk_size bytes.
+      //! @return number of bytes read.
+      static unsigned
+      read(std::istream& is, size_t index, std::vector<char>& data);
+
+      //! Compute the digest of a chunk.
+      //! @param[in] data chunk contents.
+      //! @param[in] size chunk size.
+      //! @return hexadecimal MD5 digest.
+      static std::string
+      digest(const char* data, unsigned size);
+
+    private:
+      //! File size.
+      int64_t m_size;
+      //! Modification time.
+      std::time_t m_mtime;
+      //! Chunk digests.
+      std::vector<std::string> m_digests;
+      //! Number of valid digests.
+      size_t m_hashed;
+      //! Scratch buffer.
+      std::vector<char> m_bfr;
+    };
+  }
+}
+
+#endif
@@ -52,6 +52,7 @@
 #include <cstdio>
 #include <cctype>
 #include <climits>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <list>
@@ -191,6 +192,29 @@ namespace DUNE
       return bfr;
     }
 
+    Path
+    Path::canonical(void) const
+    {
+      char bfr[PATH_MAX] = {0};
+
+      // Microsoft Windows implementation.
+#if defined(DUNE_SYS_HAS__FULLPATH)
+      if (_fullpath(bfr, m_path.c_str(), PATH_MAX) == 0 || !exists())
+        throw System::Error(ENOENT, "resolving path", m_path);
+
+      // POSIX implementation.
+#elif defined(DUNE_SYS_HAS_REALPATH)
+      if (realpath(m_path.c_str(), bfr) == 0)
+        throw System::Error(errno, "resolving path", m_path);
+
+      // Lacking implementation.
+#else
+#  error Path::canonical() is not yet implemented in this system.
+#endif
+
+      return bfr;
+    }
+
     Path
     Path::applicationFile(void)
     {
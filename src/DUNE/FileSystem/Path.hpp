@@ -202,6 +202,12 @@ namespace DUNE
         return current().str() + separator() + m_path;
       }
 
+      //! Resolve symbolic links and '.' and '..' components.
+      //! @return absolute path without links.
+      //! @throw System::Error if the path does not exist.
+      Path
+      canonical(void) const;
+
       Path
       root(void) const;
 
@@ -51,5 +51,8 @@ namespace DUNE
 #include <DUNE/IMC/Definitions.hpp>
 #include <DUNE/IMC/Blob.hpp>
 #include <DUNE/IMC/IridiumMessageDefinitions.hpp>
+#include <DUNE/IMC/LogReader.hpp>
+#include <DUNE/IMC/LogProcessor.hpp>
+#include <DUNE/IMC/LogMapReduce.hpp>
 
 #endif
@@ -0,0 +1,287 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_IMC_LOG_MAP_REDUCE_HPP_INCLUDED_
+#define DUNE_IMC_LOG_MAP_REDUCE_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ISO C++ 11 headers.
+#include <thread>
+
+// DUNE headers.
+#include <DUNE/Concurrency/Condition.hpp>
+#include <DUNE/Concurrency/ScopedCondition.hpp>
+#include <DUNE/Concurrency/Thread.hpp>
+#include <DUNE/IMC/LogProcessor.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    //! Process a set of logs in parallel. Each log is processed by a
+    //! fresh processor object on one of the worker threads (map) and
+    //! processors are handed to a reducer in the order of the logs
+    //! (reduce), so output does not depend on scheduling.
+    //!
+    //! Workers never run more than one log per thread ahead of the
+    //! reducer, so at most that many processors are alive at a time.
+    //!
+    //! P must derive from LogProcessor and be constructible from
+    //! const A&; the arguments are copied. The reducer must provide
+    //! reduce(P&), which is always called from the thread that called
+    //! run(). Errors while processing a log are reported by the
+    //! processor's getError(); if a processor cannot be constructed
+    //! run() throws std::runtime_error. Exceptions thrown by the
+    //! reducer propagate out of run() after the workers are joined.
+    template <typename P, typename A>
+    class LogMapReduce
+    {
+    public:
+      //! Constructor.
+      //! @param[in] args arguments used to construct processors.
+      //! @param[in] threads number of worker threads, zero to use one
+      //! per hardware thread.
+      LogMapReduce(const A& args, unsigned threads = 0):
+        m_args(args),
+        m_threads(threads),
+        m_paths(NULL),
+        m_next(0),
+        m_reduced(0)
+      {
+        if (m_threads == 0)
+          m_threads = std::thread::hardware_concurrency();
+
+        if (m_threads == 0)
+          m_threads = 1;
+      }
+
+      //! Process logs and reduce the results.
+      //! @param[in] paths paths to log files.
+      //! @param[in] reducer reducer object.
+      template <typename R>
+      void
+      run(const std::vector<std::string>& paths, R& reducer)
+      {
+        if (m_threads == 1 || paths.size() <= 1)
+        {
+          for (size_t i = 0; i < paths.size(); ++i)
+          {
+            P processor(m_args);
+            processor.process(paths[i]);
+            reducer.reduce(processor);
+          }
+
+          return;
+        }
+
+        m_paths = &paths;
+        m_next = 0;
+        m_reduced = 0;
+        m_done.assign(paths.size(), NULL);
+        m_ready.assign(paths.size(), false);
+        m_error.clear();
+
+        std::vector<Worker*> workers;
+        for (size_t i = 0; i < m_threads && i < paths.size(); ++i)
+        {
+          workers.push_back(new Worker(*this));
+          workers.back()->start();
+        }
+
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+          P* processor = NULL;
+
+          {
+            Concurrency::ScopedCondition l(m_cond);
+            while (!m_ready[i])
+              m_cond.wait();
+
+            processor = m_done[i];
+            m_done[i] = NULL;
+          }
+
+          if (processor == NULL)
+          {
+            std::string error = m_error;
+            finish(workers);
+            throw std::runtime_error(error);
+          }
+
+          try
+          {
+            reducer.reduce(*processor);
+          }
+          catch (...)
+          {
+            delete processor;
+            finish(workers);
+            throw;
+          }
+
+          delete processor;
+
+          Concurrency::ScopedCondition l(m_cond);
+          ++m_reduced;
+          m_cond.broadcast();
+        }
+
+        finish(workers);
+      }
+
+      //! Retrieve the number of worker threads.
+      //! @return number of worker threads.
+      unsigned
+      getThreads(void) const
+      {
+        return m_threads;
+      }
+
+    private:
+      class Worker;
+
+      //! Stop handing out logs, join workers and release processors
+      //! that were not reduced.
+      //! @param[in] workers worker threads.
+      void
+      finish(std::vector<Worker*>& workers)
+      {
+        {
+          Concurrency::ScopedCondition l(m_cond);
+          m_next = m_paths->size();
+          m_cond.broadcast();
+        }
+
+        for (size_t i = 0; i < workers.size(); ++i)
+        {
+          workers[i]->stopAndJoin();
+          delete workers[i];
+        }
+
+        for (size_t i = 0; i < m_done.size(); ++i)
+        {
+          delete m_done[i];
+          m_done[i] = NULL;
+        }
+
+        m_paths = NULL;
+      }
+
+      //! Worker thread, processing logs until none are left.
+      class Worker: public Concurrency::Thread
+      {
+      public:
+        Worker(LogMapReduce& parent):
+          m_parent(parent)
+        { }
+
+      private:
+        LogMapReduce& m_parent;
+
+        void
+        run(void)
+        {
+          while (true)
+          {
+            size_t index = 0;
+
+            {
+              Concurrency::ScopedCondition l(m_parent.m_cond);
+              size_t count = m_parent.m_paths->size();
+              while (m_parent.m_next < count
+                     && m_parent.m_next >= m_parent.m_reduced + m_parent.m_threads)
+                m_parent.m_cond.wait();
+
+              if (m_parent.m_next >= count)
+                break;
+
+              index = m_parent.m_next++;
+            }
+
+            P* processor = NULL;
+            std::string error;
+
+            try
+            {
+              processor = new P(m_parent.m_args);
+              processor->process((*m_parent.m_paths)[index]);
+            }
+            catch (std::exception& e)
+            {
+              error = e.what();
+            }
+            catch (...)
+            {
+              error = "unknown error";
+            }
+
+            if (!error.empty())
+            {
+              delete processor;
+              processor = NULL;
+            }
+
+            Concurrency::ScopedCondition l(m_parent.m_cond);
+            if (processor == NULL && m_parent.m_error.empty())
+              m_parent.m_error = error;
+
+            m_parent.m_done[index] = processor;
+            m_parent.m_ready[index] = true;
+            m_parent.m_cond.broadcast();
+          }
+        }
+      };
+
+      //! Arguments used to construct processors.
+      const A m_args;
+      //! Number of worker threads.
+      unsigned m_threads;
+      //! Paths to log files.
+      const std::vector<std::string>* m_paths;
+      //! Index of next log to process.
+      size_t m_next;
+      //! Number of logs already reduced.
+      size_t m_reduced;
+      //! Processed logs waiting to be reduced.
+      std::vector<P*> m_done;
+      //! True for logs whose worker has finished.
+      std::vector<bool> m_ready;
+      //! First error that prevented a log from being processed.
+      std::string m_error;
+      //! Lock and signal for shared state.
+      Concurrency::Condition m_cond;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,118 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <stdexcept>
+
+// DUNE headers.
+#include <DUNE/IMC/Constants.hpp>
+#include <DUNE/IMC/LogProcessor.hpp>
+#include <DUNE/IMC/LogReader.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    LogProcessor::LogProcessor(void):
+      m_reader(NULL),
+      m_stop(false)
+    { }
+
+    LogProcessor::~LogProcessor(void)
+    {
+      std::map<unsigned, ConsumerList>::iterator itr = m_consumers.begin();
+      for (; itr != m_consumers.end(); ++itr)
+      {
+        for (unsigned i = 0; i < itr->second.size(); ++i)
+          delete itr->second[i];
+      }
+    }
+
+    void
+    LogProcessor::bind(unsigned int message_id, Tasks::AbstractConsumer* consumer)
+    {
+      m_consumers[message_id].push_back(consumer);
+    }
+
+    bool
+    LogProcessor::process(const std::string& path)
+    {
+      m_path = path;
+      m_error.clear();
+      m_stop = false;
+
+      std::vector<bool> filter(DUNE_IMC_CONST_NULL_ID, false);
+      std::map<unsigned, ConsumerList>::const_iterator itr = m_consumers.begin();
+      for (; itr != m_consumers.end(); ++itr)
+      {
+        if (itr->first < filter.size())
+          filter[itr->first] = true;
+      }
+
+      Message* msg = NULL;
+
+      try
+      {
+        LogReader reader(path, filter);
+        m_reader = &reader;
+
+        while (!m_stop && (msg = reader.read()) != NULL)
+        {
+          const ConsumerList& list = m_consumers[msg->getId()];
+          for (unsigned i = 0; i < list.size() && !m_stop; ++i)
+            list[i]->consume(msg);
+
+          if (!m_stop)
+            onMessage(msg);
+
+          delete msg;
+          msg = NULL;
+        }
+      }
+      catch (std::exception& e)
+      {
+        delete msg;
+        m_error = e.what();
+      }
+
+      m_reader = NULL;
+
+      return m_error.empty();
+    }
+
+    float
+    LogProcessor::getProgress(void)
+    {
+      if (m_reader == NULL)
+        return 0.0f;
+
+      return m_reader->getProgress();
+    }
+  }
+}
@@ -0,0 +1,174 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_IMC_LOG_PROCESSOR_HPP_INCLUDED_
+#define DUNE_IMC_LOG_PROCESSOR_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <map>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/IMC/Factory.hpp>
+#include <DUNE/IMC/Message.hpp>
+#include <DUNE/Tasks/AbstractConsumer.hpp>
+#include <DUNE/Tasks/Consumer.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM LogProcessor;
+
+    // Forward declarations.
+    class LogReader;
+
+    //! Base class of LSF log analyses. Derived classes bind consumer
+    //! methods to message types, as tasks do, and process() reads a
+    //! log with a LogReader, decoding only the bound messages and
+    //! dispatching them in log order.
+    class LogProcessor
+    {
+    public:
+      //! Constructor.
+      LogProcessor(void);
+
+      //! Destructor.
+      virtual
+      ~LogProcessor(void);
+
+      //! Bind a message type to a consumer method.
+      //! @param obj consumer object.
+      //! @param consumer consumer method.
+      template <typename M, typename T>
+      void
+      bind(T* obj, void (T::* consumer)(const M*) = &T::consume)
+      {
+        bind(M::getIdStatic(), new Tasks::Consumer<T, M>(*obj, consumer));
+      }
+
+      //! Bind multiple messages to a default consumer method.
+      //! @param obj consumer object.
+      //! @param list list of message identifiers.
+      template <typename T>
+      void
+      bind(T* obj, const std::vector<uint32_t>& list)
+      {
+        void (T::* func)(const Message*) = &T::consume;
+        for (unsigned int i = 0; i < list.size(); ++i)
+          bind(list[i], new Tasks::Consumer<T, Message>(*obj, func));
+      }
+
+      //! Register a consumer for a given message identifier.
+      //! @param[in] message_id message identifier.
+      //! @param[in] consumer consumer object (ownership is taken).
+      void
+      bind(unsigned int message_id, Tasks::AbstractConsumer* consumer);
+
+      //! Process a log file.
+      //! @param[in] path path to the log file.
+      //! @return true if the log was processed until its end or until
+      //! stop() was called, false if an error occurred.
+      bool
+      process(const std::string& path);
+
+      //! Stop processing the current log. Meant to be called from
+      //! consumers, no more messages are dispatched afterwards.
+      void
+      stop(void)
+      {
+        m_stop = true;
+      }
+
+      //! Test if processing was stopped by a consumer.
+      //! @return true if processing was stopped, false otherwise.
+      bool
+      isStopped(void) const
+      {
+        return m_stop;
+      }
+
+      //! Retrieve the error that interrupted processing.
+      //! @return error description or empty string if there was none.
+      const std::string&
+      getError(void) const
+      {
+        return m_error;
+      }
+
+      //! Retrieve the fraction of the current log already read.
+      //! @return value between 0 and 1.
+      float
+      getProgress(void);
+
+      //! Retrieve the path of the log being (or last) processed.
+      //! @return log path.
+      const std::string&
+      getPath(void) const
+      {
+        return m_path;
+      }
+
+    protected:
+      //! Called for every decoded message, after its consumers.
+      //! @param[in] msg message.
+      virtual void
+      onMessage(const Message* msg)
+      {
+        (void)msg;
+      }
+
+    private:
+      typedef std::vector<Tasks::AbstractConsumer*> ConsumerList;
+
+      //! Consumers indexed by message identifier.
+      std::map<unsigned, ConsumerList> m_consumers;
+      //! Reader of the current log.
+      LogReader* m_reader;
+      //! Path of the current log.
+      std::string m_path;
+      //! Error that interrupted processing.
+      std::string m_error;
+      //! True if processing was stopped.
+      bool m_stop;
+
+      //! Non-copyable.
+      LogProcessor(const LogProcessor&);
+
+      //! Non-assignable.
+      LogProcessor&
+      operator=(const LogProcessor&);
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,326 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <stdexcept>
+
+// DUNE headers.
+#include <DUNE/Compression/Factory.hpp>
+#include <DUNE/Concurrency/ScopedMutex.hpp>
+#include <DUNE/IMC/Constants.hpp>
+#include <DUNE/IMC/Exceptions.hpp>
+#include <DUNE/IMC/Header.hpp>
+#include <DUNE/IMC/LogReader.hpp>
+#include <DUNE/IMC/Message.hpp>
+#include <DUNE/IMC/Packet.hpp>
+#include <DUNE/Utils/String.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    //! Size of raw data chunks.
+    static const size_t c_chunk_size = 65536;
+    //! Maximum number of chunks waiting to be parsed.
+    static const unsigned c_chunk_queue = 16;
+    //! Maximum number of messages in a batch.
+    static const size_t c_batch_size = 512;
+    //! Maximum number of batches waiting to be consumed.
+    static const unsigned c_batch_queue = 16;
+
+    //! Delete a batch and the messages it still holds.
+    static void
+    deleteBatch(std::vector<Message*>* batch, size_t first = 0)
+    {
+      for (size_t i = first; i < batch->size(); ++i)
+        delete (*batch)[i];
+
+      delete batch;
+    }
+
+    class LogReader::Decompressor: public Concurrency::Thread
+    {
+    public:
+      Decompressor(LogReader& reader):
+        m_reader(reader)
+      { }
+
+    private:
+      LogReader& m_reader;
+
+      void
+      run(void)
+      {
+        try
+        {
+          while (!isStopping())
+          {
+            Chunk* chunk = m_reader.readChunk();
+            if (chunk == NULL)
+              break;
+
+            if (!m_reader.m_chunks.push(chunk))
+            {
+              delete chunk;
+              break;
+            }
+          }
+        }
+        catch (std::exception& e)
+        {
+          m_reader.setError(e.what());
+        }
+
+        m_reader.m_chunks.close();
+      }
+    };
+
+    class LogReader::Parser: public Concurrency::Thread
+    {
+    public:
+      Parser(LogReader& reader):
+        m_reader(reader)
+      { }
+
+    private:
+      LogReader& m_reader;
+
+      void
+      run(void)
+      {
+        m_reader.parse();
+      }
+    };
+
+    LogReader::LogReader(const std::string& path, const std::vector<bool>& filter):
+      m_path(path),
+      m_filter(filter),
+      m_sbuf(NULL),
+      m_is(NULL),
+      m_file_size(0),
+      m_file_read(0),
+      m_chunks(c_chunk_queue),
+      m_batches(c_batch_queue),
+      m_batch(NULL),
+      m_index(0),
+      m_decompressor(NULL),
+      m_parser(NULL)
+    {
+      m_file.open(path.c_str(), std::ios::binary);
+      if (!m_file.is_open())
+        throw std::runtime_error(Utils::String::str("unable to open log '%s'", path.c_str()));
+
+      m_file.seekg(0, std::ios::end);
+      m_file_size = (double)m_file.tellg();
+      m_file.seekg(0, std::ios::beg);
+
+      Compression::Methods method = Compression::Factory::detect(path.c_str());
+      if (method == Compression::METHOD_UNKNOWN)
+      {
+        m_is = &m_file;
+      }
+      else
+      {
+        m_sbuf = new Compression::StreamBuffer(&m_file, method);
+        m_is = new std::istream(m_sbuf);
+      }
+
+      m_parser = new Parser(*this);
+      m_parser->start();
+      m_decompressor = new Decompressor(*this);
+      m_decompressor->start();
+    }
+
+    LogReader::~LogReader(void)
+    {
+      // Unblock pipeline stages if the log was not fully consumed.
+      m_chunks.close();
+      m_batches.close();
+
+      m_decompressor->stopAndJoin();
+      delete m_decompressor;
+      m_parser->stopAndJoin();
+      delete m_parser;
+
+      Chunk* chunk = NULL;
+      while (m_chunks.pop(chunk))
+        delete chunk;
+
+      Batch* batch = NULL;
+      while (m_batches.pop(batch))
+        deleteBatch(batch);
+
+      if (m_batch != NULL)
+        deleteBatch(m_batch, m_index);
+
+      if (m_sbuf != NULL)
+      {
+        delete m_is;
+        delete m_sbuf;
+      }
+    }
+
+    Message*
+    LogReader::read(void)
+    {
+      while (m_batch == NULL || m_index >= m_batch->size())
+      {
+        delete m_batch;
+        m_batch = NULL;
+        m_index = 0;
+
+        Batch* batch = NULL;
+        if (!m_batches.pop(batch))
+        {
+          Concurrency::ScopedMutex l(m_mutex);
+          if (!m_error.empty())
+            throw std::runtime_error(m_error);
+
+          return NULL;
+        }
+
+        m_batch = batch;
+      }
+
+      return (*m_batch)[m_index++];
+    }
+
+    float
+    LogReader::getProgress(void)
+    {
+      Concurrency::ScopedMutex l(m_mutex);
+
+      if (m_file_size <= 0)
+        return 1.0f;
+
+      return m_file_read / m_file_size;
+    }
+
+    LogReader::Chunk*
+    LogReader::readChunk(void)
+    {
+      Chunk* chunk = new Chunk(c_chunk_size);
+      m_is->read(&(*chunk)[0], c_chunk_size);
+
+      std::streamsize length = m_is->gcount();
+      if (length <= 0)
+      {
+        delete chunk;
+        chunk = NULL;
+      }
+      else
+      {
+        chunk->resize(length);
+      }
+
+      // Position in the raw file is unavailable after its end.
+      std::streamoff position = m_file.tellg();
+      Concurrency::ScopedMutex l(m_mutex);
+      m_file_read = position < 0 ? m_file_size : (double)position;
+
+      return chunk;
+    }
+
+    void
+    LogReader::parse(void)
+    {
+      std::vector<uint8_t> data;
+      size_t start = 0;
+      Batch* batch = new Batch;
+      batch->reserve(c_batch_size);
+
+      try
+      {
+        Chunk* chunk = NULL;
+        while (m_chunks.pop(chunk))
+        {
+          // Keep the incomplete packet of the previous chunk.
+          data.erase(data.begin(), data.begin() + start);
+          data.insert(data.end(), chunk->begin(), chunk->end());
+          delete chunk;
+          start = 0;
+
+          while (data.size() - start >= DUNE_IMC_CONST_HEADER_SIZE)
+          {
+            Header hdr;
+            Packet::deserializeHeader(hdr, &data[start], DUNE_IMC_CONST_HEADER_SIZE);
+
+            size_t length = DUNE_IMC_CONST_HEADER_SIZE + hdr.size + DUNE_IMC_CONST_FOOTER_SIZE;
+            if (data.size() - start < length)
+              break;
+
+            if (m_filter.empty() || (hdr.mgid < m_filter.size() && m_filter[hdr.mgid]))
+            {
+              batch->push_back(Packet::deserializePayload(hdr, &data[start], (uint16_t)length, NULL));
+
+              if (batch->size() >= c_batch_size)
+              {
+                if (!m_batches.push(batch))
+                {
+                  deleteBatch(batch);
+                  return;
+                }
+
+                batch = new Batch;
+                batch->reserve(c_batch_size);
+              }
+            }
+
+            start += length;
+          }
+        }
+
+        // A truncated header marks the end of the log, a truncated
+        // packet is an error.
+        if (!m_batches.closed() && data.size() - start >= DUNE_IMC_CONST_HEADER_SIZE)
+          throw BufferTooShort();
+      }
+      catch (std::exception& e)
+      {
+        setError(e.what());
+      }
+
+      if (batch->empty() || !m_batches.push(batch))
+        deleteBatch(batch);
+
+      m_batches.close();
+    }
+
+    void
+    LogReader::setError(const std::string& error)
+    {
+      Concurrency::ScopedMutex l(m_mutex);
+
+      // Keep the first error, later ones are likely a consequence.
+      if (m_error.empty())
+        m_error = error;
+    }
+  }
+}
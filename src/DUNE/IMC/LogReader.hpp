@@ -0,0 +1,143 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_IMC_LOG_READER_HPP_INCLUDED_
+#define DUNE_IMC_LOG_READER_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <string>
+#include <vector>
+#include <fstream>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Compression/Methods.hpp>
+#include <DUNE/Compression/StreamBuffer.hpp>
+#include <DUNE/Concurrency/Thread.hpp>
+#include <DUNE/Concurrency/Mutex.hpp>
+#include <DUNE/Concurrency/BoundedQueue.hpp>
+
+namespace DUNE
+{
+  namespace IMC
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM LogReader;
+
+    // Forward declarations.
+    class Message;
+
+    //! Pipelined reader of LSF logs, optionally compressed. Reading
+    //! and decompression run on one thread, splitting and decoding
+    //! packets on another, so the caller only pays for processing
+    //! the decoded messages.
+    class LogReader
+    {
+    public:
+      //! Constructor.
+      //! @param[in] path path to the log file (LSF, LSF.gz, LSF.bz2).
+      //! @param[in] filter message identifiers to decode, indexed by
+      //! identifier. Other messages are skipped without decoding. An
+      //! empty filter decodes every message.
+      LogReader(const std::string& path, const std::vector<bool>& filter = std::vector<bool>());
+
+      //! Destructor. Stops reading if the log has not been consumed.
+      ~LogReader(void);
+
+      //! Retrieve the next message of the log. Messages are returned
+      //! in log order and ownership passes to the caller.
+      //! @return message object or NULL at the end of the log.
+      //! @throw std::runtime_error if the log is truncated or
+      //! corrupted, after all messages before the fault are returned.
+      Message*
+      read(void);
+
+      //! Retrieve the fraction of the log file already read.
+      //! @return value between 0 and 1.
+      float
+      getProgress(void);
+
+    private:
+      //! Block of raw (decompressed) log data.
+      typedef std::vector<char> Chunk;
+      //! Block of decoded messages.
+      typedef std::vector<Message*> Batch;
+
+      class Decompressor;
+      class Parser;
+
+      //! Read next chunk from the log file.
+      //! @return chunk or NULL at the end of the file.
+      Chunk*
+      readChunk(void);
+
+      //! Split chunks in packets and decode accepted messages.
+      void
+      parse(void);
+
+      //! Record an error raised by one of the pipeline stages.
+      //! @param[in] error error description.
+      void
+      setError(const std::string& error);
+
+      //! Path to log file.
+      std::string m_path;
+      //! Accepted message identifiers.
+      std::vector<bool> m_filter;
+      //! Raw file stream.
+      std::ifstream m_file;
+      //! Decompression buffer, if the log is compressed.
+      Compression::StreamBuffer* m_sbuf;
+      //! Decompressed stream.
+      std::istream* m_is;
+      //! Size of the log file.
+      double m_file_size;
+      //! Bytes read from the log file.
+      double m_file_read;
+      //! Chunks waiting to be parsed.
+      Concurrency::BoundedQueue<Chunk*> m_chunks;
+      //! Batches waiting to be consumed.
+      Concurrency::BoundedQueue<Batch*> m_batches;
+      //! Batch being consumed.
+      Batch* m_batch;
+      //! Index of next message in the batch being consumed.
+      size_t m_index;
+      //! Error raised by the pipeline.
+      std::string m_error;
+      //! Lock for shared state.
+      Concurrency::Mutex m_mutex;
+      //! Reading and decompression thread.
+      Decompressor* m_decompressor;
+      //! Packet splitting and decoding thread.
+      Parser* m_parser;
+    };
+  }
+}
+
+#endif
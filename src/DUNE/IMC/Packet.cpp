@@ -163,6 +163,41 @@ namespace DUNE
       return deserializePayload(hdr, bfr.getBuffer(), DUNE_IMC_CONST_HEADER_SIZE + remaining, 0);
     }
 
+    Message*
+    Packet::deserialize(std::istream& ifs, Utils::ByteBuffer& bfr, const std::vector<bool>& filter)
+    {
+      while (true)
+      {
+        // Get the message header.
+        bfr.setSize(DUNE_IMC_CONST_HEADER_SIZE);
+        ifs.read(bfr.getBufferSigned(), DUNE_IMC_CONST_HEADER_SIZE);
+
+        // If we're at the EOF there's nothing more to do.
+        if (ifs.eof())
+          return 0;
+
+        if (ifs.gcount() < DUNE_IMC_CONST_HEADER_SIZE)
+          throw BufferTooShort();
+
+        Header hdr;
+        deserializeHeader(hdr, bfr.getBuffer(), DUNE_IMC_CONST_HEADER_SIZE);
+
+        // Get remaining data. Compressed streams only support bulk
+        // reads, so rejected messages are read as well but not decoded.
+        uint16_t remaining = hdr.size + DUNE_IMC_CONST_FOOTER_SIZE;
+        bfr.setSize(DUNE_IMC_CONST_HEADER_SIZE + remaining);
+        ifs.read(bfr.getBufferSigned() + DUNE_IMC_CONST_HEADER_SIZE, remaining);
+
+        if (ifs.gcount() < remaining)
+          throw BufferTooShort();
+
+        if (hdr.mgid >= filter.size() || !filter[hdr.mgid])
+          continue;
+
+        return deserializePayload(hdr, bfr.getBuffer(), DUNE_IMC_CONST_HEADER_SIZE + remaining, 0);
+      }
+    }
+
     uint16_t
     Packet::serializeHeader(const Message* msg, uint8_t* bfr, uint16_t bfr_len)
     {
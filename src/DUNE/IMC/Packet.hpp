@@ -33,6 +33,7 @@
 // ISO C++ 98 headers.
 #include <cstddef>
 #include <ostream>
+#include <vector>
 
 // DUNE headers.
 #include <DUNE/Config.hpp>
@@ -85,6 +86,17 @@ namespace DUNE
       static Message*
       deserialize(std::istream& ifs, Utils::ByteBuffer& bfr);
 
+      //! Deserialize the next accepted message of a stream. Messages
+      //! that are not accepted by the filter are skipped without
+      //! decoding their payload.
+      //! @param[in] ifs input stream.
+      //! @param[in] bfr scratch buffer, reused between calls.
+      //! @param[in] filter accepted message identifiers, indexed by
+      //! identifier (identifiers beyond its size are rejected).
+      //! @return message object or NULL at the end of the stream.
+      static Message*
+      deserialize(std::istream& ifs, Utils::ByteBuffer& bfr, const std::vector<bool>& filter);
+
       static uint16_t
       serializeHeader(const Message* msg, uint8_t* bfr, uint16_t bfr_len);
 
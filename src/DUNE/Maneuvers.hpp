@@ -41,6 +41,7 @@ namespace DUNE
 #include <DUNE/Maneuvers/FollowTrajectory.hpp>
 #include <DUNE/Maneuvers/VehicleFormation.hpp>
 #include <DUNE/Maneuvers/RowsStages.hpp>
+#include <DUNE/Maneuvers/Coverage.hpp>
 #include <DUNE/Maneuvers/StationKeep.hpp>
 #include <DUNE/Maneuvers/AbstractLoiter.hpp>
 #include <DUNE/Maneuvers/Circular.hpp>
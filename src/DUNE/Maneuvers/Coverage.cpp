@@ -0,0 +1,499 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// DUNE headers.
+#include <DUNE/Maneuvers/Coverage.hpp>
+#include <DUNE/Concurrency/Thread.hpp>
+#include <DUNE/Math/Constants.hpp>
+
+namespace DUNE
+{
+  namespace Maneuvers
+  {
+    //! Headings closer than this are the same candidate (rad).
+    static const double c_heading_tolerance = 1e-9;
+    //! Maximum number of cached sweeps.
+    static const size_t c_max_cache = 256;
+
+    class Coverage::Evaluator: public Concurrency::Thread
+    {
+    public:
+      //! Constructor.
+      //! @param[in] cov coverage planner.
+      //! @param[in] params planning parameters.
+      //! @param[in] sweeps sweeps, one per candidate heading.
+      //! @param[in] valid true for sweeps that are already computed.
+      //! @param[out] plans plans, one per candidate heading.
+      //! @param[in] first first candidate index.
+      //! @param[in] stride distance between evaluated candidates.
+      Evaluator(const Coverage& cov, const Parameters& params,
+                const std::vector<Sweep*>& sweeps, const std::vector<bool>& valid,
+                std::vector<Plan>& plans, unsigned first, unsigned stride):
+        m_cov(cov),
+        m_params(params),
+        m_sweeps(sweeps),
+        m_valid(valid),
+        m_plans(plans),
+        m_first(first),
+        m_stride(stride)
+      { }
+
+      void
+      run(void)
+      {
+        for (size_t i = m_first; i < m_sweeps.size(); i += m_stride)
+        {
+          if (!m_valid[i])
+            m_cov.sweep(m_sweeps[i]->heading, m_params.width, *m_sweeps[i]);
+
+          m_cov.route(*m_sweeps[i], m_params, m_plans[i]);
+        }
+      }
+
+    private:
+      const Coverage& m_cov;
+      const Parameters& m_params;
+      const std::vector<Sweep*>& m_sweeps;
+      const std::vector<bool>& m_valid;
+      std::vector<Plan>& m_plans;
+      unsigned m_first;
+      unsigned m_stride;
+    };
+
+    Coverage::Coverage(void):
+      m_cache_width(0.0)
+    { }
+
+    void
+    Coverage::setPolygon(double lat, double lon,
+                         const std::vector<double>& lats, const std::vector<double>& lons)
+    {
+      Coordinates::LocalFrame frame(lat, lon);
+
+      std::vector<Point> vertices(std::min(lats.size(), lons.size()));
+      for (size_t i = 0; i < vertices.size(); ++i)
+        frame.displacement(lats[i], lons[i], 0.0, &vertices[i].north, &vertices[i].east);
+
+      setPolygon(lat, lon, vertices);
+    }
+
+    void
+    Coverage::setPolygon(double lat, double lon, const std::vector<Point>& vertices)
+    {
+      bool same = !m_frame.setReference(lat, lon) && vertices.size() == m_polygon.size();
+      for (size_t i = 0; same && i < vertices.size(); ++i)
+      {
+        same = (vertices[i].north == m_polygon[i].north &&
+                vertices[i].east == m_polygon[i].east);
+      }
+
+      // Keep cached sweeps if nothing changed.
+      if (same)
+        return;
+
+      m_polygon = vertices;
+      m_cache.clear();
+    }
+
+    double
+    Coverage::getTurnLength(double spacing, double radius)
+    {
+      if (spacing >= 2.0 * radius)
+        return Math::c_pi * radius + (spacing - 2.0 * radius);
+
+      // Omega turn: turn away, loop around and turn back in.
+      double cx = spacing / 2.0 + radius;
+      double cy = std::sqrt(4.0 * radius * radius - cx * cx);
+      return radius * (Math::c_pi + 4.0 * std::atan2(cy, cx));
+    }
+
+    void
+    Coverage::sweep(double heading, double width, Sweep& sweep) const
+    {
+      double ch = std::cos(heading);
+      double sh = std::sin(heading);
+
+      // Polygon in the sweep frame: along and across track.
+      size_t count = m_polygon.size();
+      std::vector<double> along(count);
+      std::vector<double> across(count);
+      double c_min = std::numeric_limits<double>::max();
+      double c_max = -c_min;
+      for (size_t i = 0; i < count; ++i)
+      {
+        along[i] = m_polygon[i].north * ch + m_polygon[i].east * sh;
+        across[i] = -m_polygon[i].north * sh + m_polygon[i].east * ch;
+        c_min = std::min(c_min, across[i]);
+        c_max = std::max(c_max, across[i]);
+      }
+
+      double extent = c_max - c_min;
+      unsigned rows = std::max(1, (int)std::ceil(extent / width - 1e-9));
+
+      sweep.heading = heading;
+      sweep.spacing = extent / rows;
+      sweep.first = c_min + sweep.spacing / 2.0;
+      sweep.rows = rows;
+      sweep.cells.clear();
+
+      // Cell of each interval of the previous row.
+      std::vector<Interval> prev;
+      std::vector<size_t> prev_cells;
+      std::vector<Interval> curr;
+      std::vector<size_t> curr_cells;
+      std::vector<double> cuts;
+
+      for (unsigned r = 0; r < rows; ++r)
+      {
+        double c = sweep.first + r * sweep.spacing;
+
+        cuts.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+          size_t j = (i + 1) % count;
+          if ((across[i] <= c) != (across[j] <= c))
+            cuts.push_back(along[i] + (c - across[i]) * (along[j] - along[i]) / (across[j] - across[i]));
+        }
+
+        std::sort(cuts.begin(), cuts.end());
+
+        curr.clear();
+        for (size_t i = 0; i + 1 < cuts.size(); i += 2)
+        {
+          Interval interval = {r, cuts[i], cuts[i + 1]};
+          curr.push_back(interval);
+        }
+
+        // An interval continues a cell when it overlaps a single
+        // interval of the previous row that overlaps nothing else.
+        curr_cells.resize(curr.size());
+        for (size_t i = 0; i < curr.size(); ++i)
+        {
+          size_t match = prev.size();
+          unsigned overlaps = 0;
+          for (size_t k = 0; k < prev.size(); ++k)
+          {
+            if (curr[i].begin <= prev[k].end && curr[i].end >= prev[k].begin)
+            {
+              match = k;
+              ++overlaps;
+            }
+          }
+
+          if (overlaps == 1)
+          {
+            for (size_t k = 0; k < curr.size(); ++k)
+            {
+              if (k != i && curr[k].begin <= prev[match].end && curr[k].end >= prev[match].begin)
+              {
+                overlaps = 2;
+                break;
+              }
+            }
+          }
+
+          if (overlaps == 1)
+          {
+            curr_cells[i] = prev_cells[match];
+          }
+          else
+          {
+            curr_cells[i] = sweep.cells.size();
+            sweep.cells.push_back(std::vector<Interval>());
+          }
+
+          sweep.cells[curr_cells[i]].push_back(curr[i]);
+        }
+
+        prev.swap(curr);
+        prev_cells.swap(curr_cells);
+      }
+    }
+
+    void
+    Coverage::route(const Sweep& sweep, const Parameters& params, Plan& plan) const
+    {
+      double ch = std::cos(sweep.heading);
+      double sh = std::sin(sweep.heading);
+      double radius = params.turn_radius;
+
+      plan.heading = sweep.heading;
+      plan.spacing = sweep.spacing;
+      plan.length = 0.0;
+      plan.rows = 0;
+      plan.cells = sweep.cells.size();
+      plan.waypoints.clear();
+
+      std::vector<bool> visited(sweep.cells.size(), false);
+      bool started = false;
+      double pos_a = 0.0;
+      double pos_c = 0.0;
+
+      for (size_t n = 0; n < sweep.cells.size(); ++n)
+      {
+        // Nearest unvisited cell end.
+        size_t best = 0;
+        bool reverse = false;
+        bool backwards = false;
+        double best_dist = std::numeric_limits<double>::max();
+
+        for (size_t k = 0; k < sweep.cells.size() && started; ++k)
+        {
+          if (visited[k])
+            continue;
+
+          const std::vector<Interval>& cell = sweep.cells[k];
+          for (unsigned e = 0; e < 4; ++e)
+          {
+            const Interval& row = (e < 2) ? cell.front() : cell.back();
+            double a = (e % 2 == 0) ? row.begin : row.end;
+            double c = sweep.first + row.row * sweep.spacing;
+            double dist = (a - pos_a) * (a - pos_a) + (c - pos_c) * (c - pos_c);
+            if (dist < best_dist)
+            {
+              best_dist = dist;
+              best = k;
+              reverse = (e >= 2);
+              backwards = (e % 2 == 1);
+            }
+          }
+        }
+
+        visited[best] = true;
+        const std::vector<Interval>& cell = sweep.cells[best];
+
+        for (size_t i = 0; i < cell.size(); ++i)
+        {
+          const Interval& row = cell[reverse ? cell.size() - 1 - i : i];
+          double c = sweep.first + row.row * sweep.spacing;
+          double dir = backwards ? -1.0 : 1.0;
+          double a0 = (backwards ? row.end : row.begin) - dir * params.run_out;
+          double a1 = (backwards ? row.begin : row.end) + dir * params.run_out;
+
+          if (started)
+          {
+            double gap = std::sqrt((a0 - pos_a) * (a0 - pos_a) + (c - pos_c) * (c - pos_c));
+
+            if (i == 0)
+            {
+              // Transit between cells.
+              plan.length += gap;
+            }
+            else
+            {
+              double turn_a = -dir * std::max(-dir * pos_a, -dir * a0);
+              plan.length += getTurnLength(sweep.spacing, radius) + std::fabs(a0 - pos_a);
+
+              if (sweep.spacing < 2.0 * radius)
+              {
+                double ta = turn_a - dir * radius;
+                double tc = (c + pos_c) / 2.0;
+                Waypoint wp = {ta * ch - tc * sh, ta * sh + tc * ch, WP_TURN};
+                plan.waypoints.push_back(wp);
+              }
+            }
+          }
+
+          Waypoint start = {a0 * ch - c * sh, a0 * sh + c * ch, WP_ROW_START};
+          Waypoint end = {a1 * ch - c * sh, a1 * sh + c * ch, WP_ROW_END};
+          plan.waypoints.push_back(start);
+          plan.waypoints.push_back(end);
+          plan.length += std::fabs(a1 - a0);
+          ++plan.rows;
+
+          pos_a = a1;
+          pos_c = c;
+          started = true;
+          backwards = !backwards;
+        }
+      }
+
+      plan.duration = plan.length / params.speed;
+    }
+
+    void
+    Coverage::getHeadings(unsigned count, std::vector<double>& headings) const
+    {
+      headings.clear();
+
+      // Rows parallel to an edge are optimal for convex polygons.
+      for (size_t i = 0; i < m_polygon.size(); ++i)
+      {
+        const Point& a = m_polygon[i];
+        const Point& b = m_polygon[(i + 1) % m_polygon.size()];
+        if (a.north == b.north && a.east == b.east)
+          continue;
+
+        double h = std::atan2(b.east - a.east, b.north - a.north);
+        if (h < 0.0)
+          h += Math::c_pi;
+        if (h >= Math::c_pi)
+          h -= Math::c_pi;
+        headings.push_back(h);
+      }
+
+      for (unsigned i = 0; i < count; ++i)
+        headings.push_back(Math::c_pi * i / count);
+
+      std::sort(headings.begin(), headings.end());
+
+      size_t n = 0;
+      for (size_t i = 0; i < headings.size(); ++i)
+      {
+        if (n == 0 || headings[i] - headings[n - 1] > c_heading_tolerance)
+          headings[n++] = headings[i];
+      }
+
+      headings.resize(n);
+    }
+
+    bool
+    Coverage::plan(double heading, const Parameters& params, Plan& plan)
+    {
+      if (m_polygon.size() < 3 || !(params.width > 0.0) || !(params.speed > 0.0))
+        return false;
+
+      if (params.width != m_cache_width || m_cache.size() >= c_max_cache)
+      {
+        m_cache.clear();
+        m_cache_width = params.width;
+      }
+
+      for (size_t i = 0; i < m_cache.size(); ++i)
+      {
+        if (m_cache[i].heading == heading)
+        {
+          route(m_cache[i], params, plan);
+          return plan.rows > 0;
+        }
+      }
+
+      m_cache.push_back(Sweep());
+      sweep(heading, params.width, m_cache.back());
+      route(m_cache.back(), params, plan);
+      return plan.rows > 0;
+    }
+
+    bool
+    Coverage::plan(const Parameters& params, Plan& plan)
+    {
+      if (m_polygon.size() < 3 || !(params.width > 0.0) || !(params.speed > 0.0))
+        return false;
+
+      if (params.width != m_cache_width)
+      {
+        m_cache.clear();
+        m_cache_width = params.width;
+      }
+
+      std::vector<double> headings;
+      getHeadings(params.headings, headings);
+
+      if (m_cache.size() + headings.size() > c_max_cache)
+        m_cache.clear();
+
+      // Use cached sweeps, add empty ones for the other headings.
+      std::vector<size_t> index(headings.size());
+      std::vector<bool> valid(headings.size(), false);
+      for (size_t i = 0; i < headings.size(); ++i)
+      {
+        index[i] = m_cache.size();
+        for (size_t k = 0; k < m_cache.size(); ++k)
+        {
+          if (m_cache[k].heading == headings[i])
+          {
+            index[i] = k;
+            valid[i] = true;
+            break;
+          }
+        }
+
+        if (!valid[i])
+        {
+          m_cache.push_back(Sweep());
+          m_cache.back().heading = headings[i];
+        }
+      }
+
+      std::vector<Sweep*> sweeps(headings.size());
+      for (size_t i = 0; i < headings.size(); ++i)
+        sweeps[i] = &m_cache[index[i]];
+
+      std::vector<Plan> plans(headings.size());
+      unsigned threads = std::max(1u, std::min(params.threads, (unsigned)headings.size()));
+
+      if (threads == 1)
+      {
+        Evaluator(*this, params, sweeps, valid, plans, 0, 1).run();
+      }
+      else
+      {
+        std::vector<Evaluator*> workers;
+        for (unsigned i = 0; i < threads; ++i)
+        {
+          workers.push_back(new Evaluator(*this, params, sweeps, valid, plans, i, threads));
+          workers.back()->start();
+        }
+
+        for (unsigned i = 0; i < threads; ++i)
+        {
+          workers[i]->join();
+          delete workers[i];
+        }
+      }
+
+      size_t best = headings.size();
+      for (size_t i = 0; i < plans.size(); ++i)
+      {
+        if (plans[i].rows == 0)
+          continue;
+
+        if (best == headings.size() || plans[i].duration < plans[best].duration)
+          best = i;
+      }
+
+      if (best == headings.size())
+        return false;
+
+      plan.heading = plans[best].heading;
+      plan.spacing = plans[best].spacing;
+      plan.length = plans[best].length;
+      plan.duration = plans[best].duration;
+      plan.rows = plans[best].rows;
+      plan.cells = plans[best].cells;
+      plan.waypoints.swap(plans[best].waypoints);
+      return true;
+    }
+  }
+}
@@ -0,0 +1,274 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_MANEUVERS_COVERAGE_HPP_INCLUDED_
+#define DUNE_MANEUVERS_COVERAGE_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Coordinates/LocalFrame.hpp>
+
+namespace DUNE
+{
+  namespace Maneuvers
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM Coverage;
+
+    //! Coverage (lawn mower) planning over a polygon.
+    //!
+    //! The polygon is converted once to a local North-East frame.
+    //! For a given row heading, the polygon is swept by parallel
+    //! rows. The row intervals inside the polygon are grouped into
+    //! cells (boustrophedon decomposition), so concave polygons are
+    //! covered cell by cell. Rows inside a cell are joined by turns,
+    //! and cells are visited nearest first.
+    //!
+    //! Candidate headings are the polygon edge directions plus
+    //! evenly spaced headings. They can be evaluated in parallel,
+    //! and the plan taking the least time is kept. Sweeps depend
+    //! only on the polygon, heading and row spacing, and are cached.
+    //! Changing speed, turn radius or run-out does not sweep the
+    //! polygon again.
+    class Coverage
+    {
+    public:
+      //! Point in the local frame.
+      struct Point
+      {
+        //! Northing offset to the reference (m).
+        double north;
+        //! Easting offset to the reference (m).
+        double east;
+      };
+
+      //! Waypoint type.
+      enum WaypointType
+      {
+        //! Start of a row.
+        WP_ROW_START,
+        //! End of a row.
+        WP_ROW_END,
+        //! Intermediate turn point.
+        WP_TURN
+      };
+
+      //! Waypoint in the local frame.
+      struct Waypoint
+      {
+        //! Northing offset to the reference (m).
+        double north;
+        //! Easting offset to the reference (m).
+        double east;
+        //! Waypoint type.
+        WaypointType type;
+      };
+
+      //! Planning parameters.
+      struct Parameters
+      {
+        //! Maximum distance between rows (m).
+        double width;
+        //! Speed used to estimate the duration (m/s).
+        double speed;
+        //! Minimum turn radius (m).
+        double turn_radius;
+        //! Distance travelled past the polygon at both ends of a row (m).
+        double run_out;
+        //! Number of evenly spaced headings evaluated besides the
+        //! polygon edge directions.
+        unsigned headings;
+        //! Number of threads evaluating headings.
+        unsigned threads;
+
+        Parameters(void):
+          width(50.0),
+          speed(1.0),
+          turn_radius(0.0),
+          run_out(0.0),
+          headings(36),
+          threads(1)
+        { }
+      };
+
+      //! Coverage plan.
+      struct Plan
+      {
+        //! Row heading (rad).
+        double heading;
+        //! Distance between rows (m).
+        double spacing;
+        //! Path length, rows and turns (m).
+        double length;
+        //! Estimated duration (s).
+        double duration;
+        //! Number of rows.
+        unsigned rows;
+        //! Number of cells.
+        unsigned cells;
+        //! Waypoints in travelling order.
+        std::vector<Waypoint> waypoints;
+      };
+
+      Coverage(void);
+
+      //! Define the polygon with WGS-84 vertices. Cached sweeps are
+      //! kept if the polygon is unchanged.
+      //! @param[in] lat reference latitude (rad).
+      //! @param[in] lon reference longitude (rad).
+      //! @param[in] lats vertex latitudes (rad).
+      //! @param[in] lons vertex longitudes (rad).
+      void
+      setPolygon(double lat, double lon,
+                 const std::vector<double>& lats, const std::vector<double>& lons);
+
+      //! Define the polygon with vertices in the local frame.
+      //! @param[in] lat reference latitude (rad).
+      //! @param[in] lon reference longitude (rad).
+      //! @param[in] vertices polygon vertices.
+      void
+      setPolygon(double lat, double lon, const std::vector<Point>& vertices);
+
+      //! Get polygon vertices in the local frame.
+      //! @return polygon vertices.
+      const std::vector<Point>&
+      getPolygon(void) const
+      {
+        return m_polygon;
+      }
+
+      //! Plan the coverage with the least estimated duration.
+      //! @param[in] params planning parameters.
+      //! @param[out] plan best plan.
+      //! @return true if a plan was found, false if the polygon or
+      //! parameters are invalid.
+      bool
+      plan(const Parameters& params, Plan& plan);
+
+      //! Plan the coverage with a given row heading.
+      //! @param[in] heading row heading (rad).
+      //! @param[in] params planning parameters.
+      //! @param[out] plan plan.
+      //! @return true if a plan was found, false if the polygon or
+      //! parameters are invalid.
+      bool
+      plan(double heading, const Parameters& params, Plan& plan);
+
+      //! Convert a local position to WGS-84 coordinates.
+      //! @param[in] north northing offset to the reference (m).
+      //! @param[in] east easting offset to the reference (m).
+      //! @param[out] lat latitude (rad).
+      //! @param[out] lon longitude (rad).
+      void
+      toWGS84(double north, double east, double* lat, double* lon) const
+      {
+        m_frame.displace(north, east, lat, lon);
+      }
+
+      //! Compute the length of a turn between two parallel rows
+      //! travelled in opposite directions. Rows further apart than
+      //! twice the turn radius are joined by two quarter circles and
+      //! a straight segment, closer rows by an omega shaped turn.
+      //! @param[in] spacing distance between rows (m).
+      //! @param[in] radius turn radius (m).
+      //! @return turn length (m).
+      static double
+      getTurnLength(double spacing, double radius);
+
+    private:
+      //! Thread evaluating candidate headings.
+      class Evaluator;
+
+      //! Row interval inside the polygon, in the sweep frame.
+      struct Interval
+      {
+        //! Row index.
+        unsigned row;
+        //! Along track start and end (m).
+        double begin, end;
+      };
+
+      //! Polygon swept with a given heading.
+      struct Sweep
+      {
+        //! Row heading (rad).
+        double heading;
+        //! Across track position of the first row (m).
+        double first;
+        //! Distance between rows (m).
+        double spacing;
+        //! Number of rows.
+        unsigned rows;
+        //! Row intervals grouped by cell, in row order.
+        std::vector<std::vector<Interval> > cells;
+      };
+
+      //! Sweep the polygon.
+      //! @param[in] heading row heading (rad).
+      //! @param[in] width maximum distance between rows (m).
+      //! @param[out] sweep sweep.
+      void
+      sweep(double heading, double width, Sweep& sweep) const;
+
+      //! Order cells and rows and insert turns.
+      //! @param[in] sweep sweep.
+      //! @param[in] params planning parameters.
+      //! @param[out] plan plan.
+      void
+      route(const Sweep& sweep, const Parameters& params, Plan& plan) const;
+
+      //! Candidate row headings.
+      //! @param[in] count number of evenly spaced headings.
+      //! @param[out] headings headings (rad).
+      void
+      getHeadings(unsigned count, std::vector<double>& headings) const;
+
+      //! Sweep candidate headings not in cache.
+      //! @param[in] headings row headings (rad).
+      //! @param[in] params planning parameters.
+      void
+      updateCache(const std::vector<double>& headings, const Parameters& params);
+
+      //! Local frame.
+      Coordinates::LocalFrame m_frame;
+      //! Polygon vertices in the local frame.
+      std::vector<Point> m_polygon;
+      //! Cached sweeps.
+      std::vector<Sweep> m_cache;
+      //! Row width of cached sweeps.
+      double m_cache_width;
+    };
+  }
+}
+
+#endif
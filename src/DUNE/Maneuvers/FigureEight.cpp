@@ -182,9 +182,9 @@ namespace DUNE
     {
       Point center;
 
-      Coordinates::WGS84::displacement(msg->lat, msg->lon, 0.0,
-                                       m_loop->center_lat, m_loop->center_lon, 0.0,
-                                       &center.y, &center.x);
+      m_frame.setReference(msg->lat, msg->lon);
+      m_frame.displacement(m_loop->center_lat, m_loop->center_lon, 0.0,
+                           &center.y, &center.x);
 
       Point vehicle;
       vehicle.x = msg->y;
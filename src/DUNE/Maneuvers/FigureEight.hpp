@@ -31,6 +31,7 @@
 #define DUNE_MANEUVERS_FIGURE_EIGHT_HPP_INCLUDED_
 
 // DUNE headers.
+#include <DUNE/Coordinates/LocalFrame.hpp>
 #include <DUNE/IMC.hpp>
 #include <DUNE/Maneuvers/Maneuver.hpp>
 #include <DUNE/Maneuvers/AbstractLoiter.hpp>
@@ -218,6 +219,8 @@ namespace DUNE
       FigureEightState m_state;
       //! Arc progress
       ArcProgress m_arc;
+      //! Local frame at the navigation reference.
+      Coordinates::LocalFrame m_frame;
     };
   }
 }
@@ -104,8 +104,7 @@ namespace DUNE
       m_path.speed = msg->speed;
       m_path.speed_units = msg->speed_units;
 
-      m_rlat = msg->lat;
-      m_rlon = msg->lon;
+      m_frame.setReference(msg->lat, msg->lon);
 
       dispatch(m_path);
 
@@ -154,15 +153,11 @@ namespace DUNE
     void
     FollowTrajectory::desiredPath(const TPoint& s, const TPoint& e)
     {
-      m_path.start_lat = m_rlat;
-      m_path.start_lon = m_rlon;
-      Coordinates::WGS84::displace(s.x, s.y, &m_path.start_lat, &m_path.start_lon);
+      m_frame.displace(s.x, s.y, &m_path.start_lat, &m_path.start_lon);
       m_path.start_z = s.z;
       m_path.start_z_units = s.z_units;
 
-      m_path.end_lat = m_rlat;
-      m_path.end_lon = m_rlon;
-      Coordinates::WGS84::displace(e.x, e.y, &m_path.end_lat, &m_path.end_lon);
+      m_frame.displace(e.x, e.y, &m_path.end_lat, &m_path.end_lon);
       m_path.end_z = e.z;
       m_path.end_z_units = e.z_units;
 
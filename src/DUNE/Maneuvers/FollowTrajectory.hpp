@@ -36,6 +36,7 @@
 
 // DUNE headers.
 #include <DUNE/Config.hpp>
+#include <DUNE/Coordinates/LocalFrame.hpp>
 #include <DUNE/IMC.hpp>
 #include <DUNE/Maneuvers/Maneuver.hpp>
 
@@ -172,10 +173,8 @@ namespace DUNE
       std::vector<TPoint> m_traj;
       //! Approach stage flag.
       bool m_approach;
-      //! Reference latitude set.
-      double m_rlat;
-      //! Reference longitude set.
-      double m_rlon;
+      //! Local frame at the reference set.
+      Coordinates::LocalFrame m_frame;
       //! control step period
       double m_cstep_period;
       //! time of last control step
@@ -211,8 +211,7 @@ namespace DUNE
 
       step(*msg);
       m_cstep_time = now;
-      m_rlat = msg->lat;
-      m_rlon = msg->lon;
+      m_frame.setReference(msg->lat, msg->lon);
     }
 
     void
@@ -227,7 +226,7 @@ namespace DUNE
     void
     VehicleFormation::toLocalCoordinates(double lat, double lon, double* x, double* y)
     {
-      Coordinates::WGS84::displacement(m_rlat, m_rlon, 0, lat, lon, 0, x, y);
+      m_frame.displacement(lat, lon, 0, x, y);
     }
 
     void
@@ -244,14 +243,10 @@ namespace DUNE
     void
     VehicleFormation::desiredPath(const TPoint& s, const TPoint& e, double radius)
     {
-      m_path.start_lat = m_rlat;
-      m_path.start_lon = m_rlon;
-      Coordinates::WGS84::displace(s.x, s.y, &m_path.start_lat, &m_path.start_lon);
+      m_frame.displace(s.x, s.y, &m_path.start_lat, &m_path.start_lon);
       m_path.start_z = s.z;
 
-      m_path.end_lat = m_rlat;
-      m_path.end_lon = m_rlon;
-      Coordinates::WGS84::displace(e.x, e.y, &m_path.end_lat, &m_path.end_lon);
+      m_frame.displace(e.x, e.y, &m_path.end_lat, &m_path.end_lon);
       m_path.end_z = e.z;
 
       m_path.lradius = radius;
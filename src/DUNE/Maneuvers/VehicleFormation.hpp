@@ -35,6 +35,7 @@
 #include <map>
 
 // DUNE headers.
+#include <DUNE/Coordinates/LocalFrame.hpp>
 #include <DUNE/IMC.hpp>
 #include <DUNE/Maneuvers/Maneuver.hpp>
 
@@ -227,8 +228,7 @@ namespace DUNE
       std::map<int, int> m_addr2idx;
       bool m_approach; //!< Approach stage flag.
       int m_fidx; //!< Formation index.
-      double m_rlat; // Reference latitude set.
-      double m_rlon; // Reference longitude set.
+      Coordinates::LocalFrame m_frame; // Local frame at the reference set.
       double m_cstep_period; //! control step period
       double m_cstep_time; //! time of last control step
       IMC::DesiredPath m_path;
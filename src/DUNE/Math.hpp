@@ -42,6 +42,7 @@ namespace DUNE
 #include <DUNE/Math/EulerAnglesZyx.hpp>
 #include <DUNE/Math/General.hpp>
 #include <DUNE/Math/Matrix.hpp>
+#include <DUNE/Math/FixedMatrix.hpp>
 #include <DUNE/Math/Angles.hpp>
 #include <DUNE/Math/Random.hpp>
 #include <DUNE/Math/Optimization.hpp>
@@ -49,7 +50,10 @@ namespace DUNE
 #include <DUNE/Math/Quaternion.hpp>
 #include <DUNE/Math/MovingAverage.hpp>
 #include <DUNE/Math/MultiMovingAverage.hpp>
+#include <DUNE/Math/RunningStatistics.hpp>
 #include <DUNE/Math/Grid.hpp>
+#include <DUNE/Math/KDTree.hpp>
 #include <DUNE/Math/FIRFilter.hpp>
+#include <DUNE/Math/Vectorized.hpp>
 
 #endif
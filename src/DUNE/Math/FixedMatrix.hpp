@@ -0,0 +1,710 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_MATH_FIXED_MATRIX_HPP_INCLUDED_
+#define DUNE_MATH_FIXED_MATRIX_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Math/Matrix.hpp>
+
+// SIMD headers.
+#if defined(__AVX__)
+#  include <immintrin.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#  include <arm_neon.h>
+#endif
+
+namespace DUNE
+{
+  namespace Math
+  {
+    //! Vector kernels used by FixedMatrix products. Loop bounds are
+    //! compile time constants, so the compiler fully unrolls them for
+    //! the usual 3x3 to 12x12 sizes.
+    namespace FixedKernels
+    {
+      //! y += s * x
+      template <size_t N>
+      inline void
+      axpy(double s, const double* x, double* y)
+      {
+        size_t i = 0;
+#if defined(__AVX__)
+        __m256d vs = _mm256_set1_pd(s);
+        for (; i + 4 <= N; i += 4)
+          _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i),
+                                                _mm256_mul_pd(vs, _mm256_loadu_pd(x + i))));
+#endif
+#if defined(__SSE2__)
+        __m128d vs2 = _mm_set1_pd(s);
+        for (; i + 2 <= N; i += 2)
+          _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i),
+                                          _mm_mul_pd(vs2, _mm_loadu_pd(x + i))));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        float64x2_t vs2 = vdupq_n_f64(s);
+        for (; i + 2 <= N; i += 2)
+          vst1q_f64(y + i, vfmaq_f64(vld1q_f64(y + i), vld1q_f64(x + i), vs2));
+#endif
+        for (; i < N; ++i)
+          y[i] += s * x[i];
+      }
+
+      //! Dot product of x and y.
+      template <size_t N>
+      inline double
+      dot(const double* x, const double* y)
+      {
+        size_t i = 0;
+        double r = 0;
+#if defined(__AVX__)
+        if (N >= 4)
+        {
+          __m256d acc = _mm256_setzero_pd();
+          for (; i + 4 <= N; i += 4)
+            acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+          double t[4];
+          _mm256_storeu_pd(t, acc);
+          r = (t[0] + t[1]) + (t[2] + t[3]);
+        }
+#endif
+#if defined(__SSE2__)
+        if (N - i >= 2)
+        {
+          __m128d acc2 = _mm_setzero_pd();
+          for (; i + 2 <= N; i += 2)
+            acc2 = _mm_add_pd(acc2, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+          double t2[2];
+          _mm_storeu_pd(t2, acc2);
+          r += t2[0] + t2[1];
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        if (N - i >= 2)
+        {
+          float64x2_t acc2 = vdupq_n_f64(0.0);
+          for (; i + 2 <= N; i += 2)
+            acc2 = vfmaq_f64(acc2, vld1q_f64(x + i), vld1q_f64(y + i));
+          r += vaddvq_f64(acc2);
+        }
+#endif
+        for (; i < N; ++i)
+          r += x[i] * y[i];
+
+        return r;
+      }
+    }
+
+    //! Base of element-wise expressions over R x C operands. Derived
+    //! classes provide element access; nothing is evaluated until the
+    //! expression is assigned to a FixedMatrix.
+    template <typename E, size_t R, size_t C>
+    class FixedExpression
+    {
+    public:
+      double
+      operator()(size_t i, size_t j) const
+      {
+        return static_cast<const E&>(*this)(i, j);
+      }
+
+      const E&
+      self(void) const
+      {
+        return static_cast<const E&>(*this);
+      }
+    };
+
+    // Forward declaration.
+    template <size_t R, size_t C>
+    class FixedMatrix;
+
+    //! Element-wise sum.
+    template <typename A, typename B, size_t R, size_t C>
+    class FixedSum: public FixedExpression<FixedSum<A, B, R, C>, R, C>
+    {
+    public:
+      FixedSum(const A& a, const B& b):
+        m_a(a),
+        m_b(b)
+      { }
+
+      double
+      operator()(size_t i, size_t j) const
+      {
+        return m_a(i, j) + m_b(i, j);
+      }
+
+    private:
+      const A& m_a;
+      const B& m_b;
+    };
+
+    //! Element-wise difference.
+    template <typename A, typename B, size_t R, size_t C>
+    class FixedDifference: public FixedExpression<FixedDifference<A, B, R, C>, R, C>
+    {
+    public:
+      FixedDifference(const A& a, const B& b):
+        m_a(a),
+        m_b(b)
+      { }
+
+      double
+      operator()(size_t i, size_t j) const
+      {
+        return m_a(i, j) - m_b(i, j);
+      }
+
+    private:
+      const A& m_a;
+      const B& m_b;
+    };
+
+    //! Product by a scalar.
+    template <typename A, size_t R, size_t C>
+    class FixedScaled: public FixedExpression<FixedScaled<A, R, C>, R, C>
+    {
+    public:
+      FixedScaled(const A& a, double s):
+        m_a(a),
+        m_s(s)
+      { }
+
+      double
+      operator()(size_t i, size_t j) const
+      {
+        return m_s * m_a(i, j);
+      }
+
+    private:
+      const A& m_a;
+      double m_s;
+    };
+
+    //! Transpose of an R x C operand.
+    template <typename A, size_t R, size_t C>
+    class FixedTranspose: public FixedExpression<FixedTranspose<A, R, C>, C, R>
+    {
+    public:
+      FixedTranspose(const A& a):
+        m_a(a)
+      { }
+
+      double
+      operator()(size_t i, size_t j) const
+      {
+        return m_a(j, i);
+      }
+
+      const A&
+      operand(void) const
+      {
+        return m_a;
+      }
+
+    private:
+      const A& m_a;
+    };
+
+    //! Matrix with compile time dimensions and in-place, row-major
+    //! storage. No operation allocates memory; products use the
+    //! vector kernels above and element-wise operations are expression
+    //! templates evaluated in a single pass.
+    template <size_t R, size_t C>
+    class FixedMatrix: public FixedExpression<FixedMatrix<R, C>, R, C>
+    {
+    public:
+      //! Construct a zero matrix.
+      FixedMatrix(void)
+      {
+        fill(0.0);
+      }
+
+      //! Construct a matrix filled with a constant value.
+      //! @param[in] v value used to initialize cells.
+      explicit FixedMatrix(double v)
+      {
+        fill(v);
+      }
+
+      //! Construct a matrix from row-major data.
+      //! @param[in] data pointer to R * C values.
+      explicit FixedMatrix(const double* data)
+      {
+        std::memcpy(m_data, data, sizeof(m_data));
+      }
+
+      //! Construct a matrix from a dynamically sized one.
+      //! @param[in] m matrix with R rows and C columns.
+      //! @throw Matrix::Error if dimensions differ.
+      explicit FixedMatrix(const Matrix& m)
+      {
+        fromMatrix(m);
+      }
+
+      //! Evaluate an expression.
+      //! @param[in] e expression.
+      template <typename E>
+      FixedMatrix(const FixedExpression<E, R, C>& e)
+      {
+        evaluate(e, m_data);
+      }
+
+      template <typename E>
+      FixedMatrix&
+      operator=(const FixedExpression<E, R, C>& e)
+      {
+        // Evaluate to scratch storage: operands may alias this matrix.
+        double tmp[R * C];
+        evaluate(e, tmp);
+        std::memcpy(m_data, tmp, sizeof(m_data));
+        return *this;
+      }
+
+      //! Retrieve the number of rows of the matrix.
+      //! @return number of rows of the matrix.
+      static int
+      rows(void)
+      {
+        return R;
+      }
+
+      //! Retrieve the number of columns of the matrix.
+      //! @return number of columns of the matrix.
+      static int
+      columns(void)
+      {
+        return C;
+      }
+
+      //! Retrieve the size of the matrix
+      //! @return size of the matrix.
+      static int
+      size(void)
+      {
+        return R * C;
+      }
+
+      //! Pointer to first element.
+      double*
+      data(void)
+      {
+        return m_data;
+      }
+
+      //! Const pointer to first element.
+      const double*
+      data(void) const
+      {
+        return m_data;
+      }
+
+      double&
+      operator()(size_t i, size_t j)
+      {
+        return m_data[i * C + j];
+      }
+
+      double
+      operator()(size_t i, size_t j) const
+      {
+        return m_data[i * C + j];
+      }
+
+      //! Element access for vectors.
+      double&
+      operator()(size_t i)
+      {
+        return m_data[i];
+      }
+
+      double
+      operator()(size_t i) const
+      {
+        return m_data[i];
+      }
+
+      //! Fill the matrix with a constant value.
+      //! @param[in] value constant value to fill matrix with
+      void
+      fill(double value)
+      {
+        for (size_t i = 0; i < R * C; ++i)
+          m_data[i] = value;
+      }
+
+      //! Turns the matrix into an identity matrix if it is squared.
+      void
+      identity(void)
+      {
+        fill(0.0);
+        for (size_t i = 0; i < R && i < C; ++i)
+          m_data[i * C + i] = 1.0;
+      }
+
+      FixedMatrix&
+      operator+=(const FixedMatrix& m)
+      {
+        FixedKernels::axpy<R * C>(1.0, m.m_data, m_data);
+        return *this;
+      }
+
+      FixedMatrix&
+      operator-=(const FixedMatrix& m)
+      {
+        FixedKernels::axpy<R * C>(-1.0, m.m_data, m_data);
+        return *this;
+      }
+
+      template <typename E>
+      FixedMatrix&
+      operator+=(const FixedExpression<E, R, C>& e)
+      {
+        double tmp[R * C];
+        evaluate(e, tmp);
+        FixedKernels::axpy<R * C>(1.0, tmp, m_data);
+        return *this;
+      }
+
+      template <typename E>
+      FixedMatrix&
+      operator-=(const FixedExpression<E, R, C>& e)
+      {
+        double tmp[R * C];
+        evaluate(e, tmp);
+        FixedKernels::axpy<R * C>(-1.0, tmp, m_data);
+        return *this;
+      }
+
+      FixedMatrix&
+      operator*=(double x)
+      {
+        for (size_t i = 0; i < R * C; ++i)
+          m_data[i] *= x;
+        return *this;
+      }
+
+      FixedMatrix&
+      operator/=(double x)
+      {
+        return *this *= (1.0 / x);
+      }
+
+      //! Add s * m to this matrix.
+      //! @param[in] s scale factor.
+      //! @param[in] m matrix.
+      void
+      addScaled(double s, const FixedMatrix& m)
+      {
+        FixedKernels::axpy<R * C>(s, m.m_data, m_data);
+      }
+
+      //! Retrieve the trace of the matrix.
+      //! @return sum of the diagonal elements.
+      double
+      trace(void) const
+      {
+        double t = 0;
+        for (size_t i = 0; i < R && i < C; ++i)
+          t += m_data[i * C + i];
+        return t;
+      }
+
+      //! Retrieve the Euclidean (Frobenius) norm.
+      //! @return norm.
+      double
+      norm_2(void) const
+      {
+        return std::sqrt(FixedKernels::dot<R * C>(m_data, m_data));
+      }
+
+      //! Copy values from a dynamically sized matrix.
+      //! @param[in] m matrix with R rows and C columns.
+      //! @throw Matrix::Error if dimensions differ.
+      void
+      fromMatrix(const Matrix& m)
+      {
+        if (m.rows() != (int)R || m.columns() != (int)C)
+          throw Matrix::Error("Invalid dimensions!");
+
+        std::memcpy(m_data, m.begin(), sizeof(m_data));
+      }
+
+      //! Copy values to a dynamically sized matrix.
+      //! @return matrix with R rows and C columns.
+      Matrix
+      toMatrix(void) const
+      {
+        return Matrix(m_data, R, C);
+      }
+
+      //! Copy a block into this matrix.
+      //! @param[in] i first row.
+      //! @param[in] j first column.
+      //! @param[in] m block.
+      template <size_t BR, size_t BC>
+      void
+      put(size_t i, size_t j, const FixedMatrix<BR, BC>& m)
+      {
+        for (size_t r = 0; r < BR; ++r)
+          std::memcpy(m_data + (i + r) * C + j, m.data() + r * BC, BC * sizeof(double));
+      }
+
+      //! Retrieve a block of this matrix.
+      //! @param[in] i first row.
+      //! @param[in] j first column.
+      //! @param[out] m block.
+      template <size_t BR, size_t BC>
+      void
+      get(size_t i, size_t j, FixedMatrix<BR, BC>& m) const
+      {
+        for (size_t r = 0; r < BR; ++r)
+          std::memcpy(m.data() + r * BC, m_data + (i + r) * C + j, BC * sizeof(double));
+      }
+
+    private:
+      double m_data[R * C];
+
+      template <typename E>
+      static void
+      evaluate(const FixedExpression<E, R, C>& e, double* out)
+      {
+        const E& expr = e.self();
+        for (size_t i = 0; i < R; ++i)
+        {
+          for (size_t j = 0; j < C; ++j)
+            out[i * C + j] = expr(i, j);
+        }
+      }
+    };
+
+    //! Throw if a product output aliases one of its operands.
+    inline void
+    checkAliasing(const void* out, const void* a, const void* b)
+    {
+      if (out == a || out == b)
+        throw Matrix::Error("product output aliases an operand!");
+    }
+
+    //! out = a * b
+    template <size_t R, size_t K, size_t C>
+    inline void
+    multiply(const FixedMatrix<R, K>& a, const FixedMatrix<K, C>& b, FixedMatrix<R, C>& out)
+    {
+      checkAliasing(&out, &a, &b);
+      const double* pa = a.data();
+      const double* pb = b.data();
+      double* po = out.data();
+
+      for (size_t i = 0; i < R; ++i)
+      {
+        double* row = po + i * C;
+        for (size_t j = 0; j < C; ++j)
+          row[j] = 0.0;
+
+        for (size_t k = 0; k < K; ++k)
+          FixedKernels::axpy<C>(pa[i * K + k], pb + k * C, row);
+      }
+    }
+
+    //! out = a * transpose(b)
+    template <size_t R, size_t K, size_t C>
+    inline void
+    multiplyTransposed(const FixedMatrix<R, K>& a, const FixedMatrix<C, K>& b, FixedMatrix<R, C>& out)
+    {
+      checkAliasing(&out, &a, &b);
+      const double* pa = a.data();
+      const double* pb = b.data();
+      double* po = out.data();
+
+      for (size_t i = 0; i < R; ++i)
+      {
+        for (size_t j = 0; j < C; ++j)
+          po[i * C + j] = FixedKernels::dot<K>(pa + i * K, pb + j * K);
+      }
+    }
+
+    //! out = transpose(a) * b
+    template <size_t R, size_t K, size_t C>
+    inline void
+    transposeMultiply(const FixedMatrix<K, R>& a, const FixedMatrix<K, C>& b, FixedMatrix<R, C>& out)
+    {
+      checkAliasing(&out, &a, &b);
+      const double* pa = a.data();
+      const double* pb = b.data();
+      double* po = out.data();
+
+      for (size_t i = 0; i < R * C; ++i)
+        po[i] = 0.0;
+
+      for (size_t k = 0; k < K; ++k)
+      {
+        for (size_t i = 0; i < R; ++i)
+          FixedKernels::axpy<C>(pa[k * R + i], pb + k * C, po + i * C);
+      }
+    }
+
+    template <size_t R, size_t K, size_t C>
+    inline FixedMatrix<R, C>
+    operator*(const FixedMatrix<R, K>& a, const FixedMatrix<K, C>& b)
+    {
+      FixedMatrix<R, C> out;
+      multiply(a, b, out);
+      return out;
+    }
+
+    template <size_t R, size_t K, size_t C>
+    inline FixedMatrix<R, C>
+    operator*(const FixedMatrix<R, K>& a, const FixedTranspose<FixedMatrix<C, K>, C, K>& b)
+    {
+      FixedMatrix<R, C> out;
+      multiplyTransposed(a, b.operand(), out);
+      return out;
+    }
+
+    template <size_t R, size_t K, size_t C>
+    inline FixedMatrix<R, C>
+    operator*(const FixedTranspose<FixedMatrix<K, R>, K, R>& a, const FixedMatrix<K, C>& b)
+    {
+      FixedMatrix<R, C> out;
+      transposeMultiply(a.operand(), b, out);
+      return out;
+    }
+
+    template <typename A, typename B, size_t R, size_t C>
+    inline FixedSum<A, B, R, C>
+    operator+(const FixedExpression<A, R, C>& a, const FixedExpression<B, R, C>& b)
+    {
+      return FixedSum<A, B, R, C>(a.self(), b.self());
+    }
+
+    template <typename A, typename B, size_t R, size_t C>
+    inline FixedDifference<A, B, R, C>
+    operator-(const FixedExpression<A, R, C>& a, const FixedExpression<B, R, C>& b)
+    {
+      return FixedDifference<A, B, R, C>(a.self(), b.self());
+    }
+
+    template <typename A, size_t R, size_t C>
+    inline FixedScaled<A, R, C>
+    operator*(double s, const FixedExpression<A, R, C>& a)
+    {
+      return FixedScaled<A, R, C>(a.self(), s);
+    }
+
+    template <typename A, size_t R, size_t C>
+    inline FixedScaled<A, R, C>
+    operator*(const FixedExpression<A, R, C>& a, double s)
+    {
+      return FixedScaled<A, R, C>(a.self(), s);
+    }
+
+    template <size_t R, size_t C>
+    inline FixedTranspose<FixedMatrix<R, C>, R, C>
+    transpose(const FixedMatrix<R, C>& a)
+    {
+      return FixedTranspose<FixedMatrix<R, C>, R, C>(a);
+    }
+
+    //! Invert a square matrix by Gauss-Jordan elimination with partial
+    //! pivoting.
+    //! @param[in] a matrix to invert.
+    //! @return inverse of a.
+    //! @throw Matrix::Error if the matrix is singular.
+    template <size_t N>
+    inline FixedMatrix<N, N>
+    inverse(const FixedMatrix<N, N>& a)
+    {
+      FixedMatrix<N, N> m(a);
+      FixedMatrix<N, N> inv;
+      inv.identity();
+
+      for (size_t c = 0; c < N; ++c)
+      {
+        size_t p = c;
+        for (size_t r = c + 1; r < N; ++r)
+        {
+          if (std::fabs(m(r, c)) > std::fabs(m(p, c)))
+            p = r;
+        }
+
+        if (std::fabs(m(p, c)) < Matrix::get_precision())
+          throw Matrix::Error("Trying to invert a singular matrix!");
+
+        if (p != c)
+        {
+          for (size_t j = 0; j < N; ++j)
+          {
+            std::swap(m(p, j), m(c, j));
+            std::swap(inv(p, j), inv(c, j));
+          }
+        }
+
+        double d = 1.0 / m(c, c);
+        for (size_t j = 0; j < N; ++j)
+        {
+          m(c, j) *= d;
+          inv(c, j) *= d;
+        }
+
+        for (size_t r = 0; r < N; ++r)
+        {
+          if (r == c)
+            continue;
+
+          double f = -m(r, c);
+          if (f == 0.0)
+            continue;
+
+          FixedKernels::axpy<N>(f, m.data() + c * N, m.data() + r * N);
+          FixedKernels::axpy<N>(f, inv.data() + c * N, inv.data() + r * N);
+        }
+      }
+
+      return inv;
+    }
+
+    template <size_t R, size_t C>
+    inline std::ostream&
+    operator<<(std::ostream& os, const FixedMatrix<R, C>& a)
+    {
+      return os << a.toMatrix();
+    }
+  }
+}
+
+#endif
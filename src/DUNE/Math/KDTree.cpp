@@ -0,0 +1,302 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/Math/KDTree.hpp>
+
+namespace DUNE
+{
+  namespace Math
+  {
+    //! Compare items along one axis.
+    struct AxisLess
+    {
+      AxisLess(unsigned axis):
+        m_axis(axis)
+      { }
+
+      bool
+      operator()(const KDTree::Item& a, const KDTree::Item& b) const
+      {
+        return m_axis ? (a.y < b.y) : (a.x < b.x);
+      }
+
+      unsigned m_axis;
+    };
+
+    //! Clip a parametric interval to the half-plane o + d * t <= c.
+    static void
+    clipBelow(double o, double d, double c, double& t0, double& t1)
+    {
+      if (d > 0)
+        t1 = std::min(t1, (c - o) / d);
+      else if (d < 0)
+        t0 = std::max(t0, (c - o) / d);
+      else if (o > c)
+        t1 = -1;
+    }
+
+    //! Clip a parametric interval to the half-plane o + d * t >= c.
+    static void
+    clipAbove(double o, double d, double c, double& t0, double& t1)
+    {
+      clipBelow(-o, -d, -c, t0, t1);
+    }
+
+    KDTree::KDTree(void)
+    { }
+
+    void
+    KDTree::build(const std::vector<Item>& items)
+    {
+      if (items.empty())
+        clear();
+      else
+        build(&items[0], items.size());
+    }
+
+    void
+    KDTree::build(const Item* items, size_t count)
+    {
+      m_items.assign(items, items + count);
+      m_axis.assign(count, 0);
+
+      if (count > 0)
+        split(0, count);
+    }
+
+    void
+    KDTree::clear(void)
+    {
+      m_items.clear();
+      m_axis.clear();
+    }
+
+    void
+    KDTree::split(size_t lo, size_t hi)
+    {
+      while (hi - lo > c_leaf_size)
+      {
+        // Split along the widest extent.
+        double x0 = m_items[lo].x, x1 = x0;
+        double y0 = m_items[lo].y, y1 = y0;
+        for (size_t i = lo + 1; i < hi; ++i)
+        {
+          x0 = std::min(x0, m_items[i].x);
+          x1 = std::max(x1, m_items[i].x);
+          y0 = std::min(y0, m_items[i].y);
+          y1 = std::max(y1, m_items[i].y);
+        }
+
+        unsigned axis = (y1 - y0 > x1 - x0) ? 1 : 0;
+        size_t mid = (lo + hi) / 2;
+        std::nth_element(m_items.begin() + lo, m_items.begin() + mid,
+                         m_items.begin() + hi, AxisLess(axis));
+        m_axis[mid] = (uint8_t)axis;
+
+        // Recurse on the smaller half to bound the depth.
+        if (mid - lo < hi - mid - 1)
+        {
+          split(lo, mid);
+          lo = mid + 1;
+        }
+        else
+        {
+          split(mid + 1, hi);
+          hi = mid;
+        }
+      }
+    }
+
+    bool
+    KDTree::nearest(double x, double y, size_t& index, double max_distance) const
+    {
+      double distance;
+      return nearest(x, y, 1, &index, &distance, max_distance) == 1;
+    }
+
+    size_t
+    KDTree::nearest(double x, double y, size_t k, size_t* indices, double* distances,
+                    double max_distance) const
+    {
+      if (m_items.empty() || k == 0)
+        return 0;
+
+      // Squared distances are kept in 'distances' while searching.
+      double worst = (max_distance < 0) ? HUGE_VAL : max_distance * max_distance;
+      size_t found = 0;
+
+      Range stack[c_stack_size];
+      size_t top = 0;
+      stack[top++] = makeRange(0, m_items.size(), 0);
+
+      while (top > 0)
+      {
+        Range r = stack[--top];
+        if (r.bound > worst)
+          continue;
+
+        size_t mid = (r.lo + r.hi) / 2;
+        bool leaf = r.hi - r.lo <= c_leaf_size;
+        size_t first = leaf ? r.lo : mid;
+        size_t last = leaf ? r.hi : mid + 1;
+
+        for (size_t i = first; i < last; ++i)
+        {
+          double d2 = (m_items[i].x - x) * (m_items[i].x - x)
+          + (m_items[i].y - y) * (m_items[i].y - y);
+
+          if (d2 > worst || (found == k && d2 >= distances[k - 1]))
+            continue;
+
+          // Insert in order, dropping the furthest if full.
+          size_t j = (found < k) ? found++ : k - 1;
+          for (; j > 0 && distances[j - 1] > d2; --j)
+          {
+            distances[j] = distances[j - 1];
+            indices[j] = indices[j - 1];
+          }
+
+          distances[j] = d2;
+          indices[j] = i;
+
+          if (found == k)
+            worst = std::min(worst, distances[k - 1]);
+        }
+
+        if (leaf)
+          continue;
+
+        double d = m_axis[mid] ? (y - m_items[mid].y) : (x - m_items[mid].x);
+        double far = std::max(r.bound, d * d);
+
+        // Near side is visited first.
+        if (d < 0)
+        {
+          stack[top++] = makeRange(mid + 1, r.hi, far);
+          stack[top++] = makeRange(r.lo, mid, r.bound);
+        }
+        else
+        {
+          stack[top++] = makeRange(r.lo, mid, far);
+          stack[top++] = makeRange(mid + 1, r.hi, r.bound);
+        }
+      }
+
+      for (size_t i = 0; i < found; ++i)
+        distances[i] = std::sqrt(distances[i]);
+
+      return found;
+    }
+
+    bool
+    KDTree::raycast(double x, double y, double dx, double dy, double length, double radius,
+                    double& range, size_t& index) const
+    {
+      double norm = std::sqrt(dx * dx + dy * dy);
+      if (m_items.empty() || norm == 0)
+        return false;
+
+      dx /= norm;
+      dy /= norm;
+
+      double best = length;
+      bool hit = false;
+      double r2 = radius * radius;
+
+      Range stack[c_stack_size];
+      size_t top = 0;
+      stack[top++] = makeRange(0, m_items.size(), 0, length);
+
+      while (top > 0)
+      {
+        Range r = stack[--top];
+        if (r.bound > best)
+          continue;
+
+        size_t mid = (r.lo + r.hi) / 2;
+        bool leaf = r.hi - r.lo <= c_leaf_size;
+        size_t first = leaf ? r.lo : mid;
+        size_t last = leaf ? r.hi : mid + 1;
+
+        for (size_t i = first; i < last; ++i)
+        {
+          // Solve |o + t * d - p|^2 = r^2 for the entry point.
+          double px = m_items[i].x - x;
+          double py = m_items[i].y - y;
+          double b = px * dx + py * dy;
+          double c = px * px + py * py - r2;
+          double disc = b * b - c;
+          if (disc < 0)
+            continue;
+
+          double t = (c <= 0) ? 0 : b - std::sqrt(disc);
+          if (t >= 0 && t <= best)
+          {
+            best = t;
+            index = i;
+            hit = true;
+          }
+        }
+
+        if (leaf)
+          continue;
+
+        // Discs of each half reach 'radius' beyond the split.
+        unsigned axis = m_axis[mid];
+        double o = axis ? y : x;
+        double d = axis ? dy : dx;
+        double s = axis ? m_items[mid].y : m_items[mid].x;
+
+        double l0 = r.bound, l1 = std::min(r.end, best);
+        clipBelow(o, d, s + radius, l0, l1);
+        double h0 = r.bound, h1 = std::min(r.end, best);
+        clipAbove(o, d, s - radius, h0, h1);
+
+        // Nearest entry is visited first.
+        bool low_first = l0 <= h0;
+        if (low_first && h0 <= h1)
+          stack[top++] = makeRange(mid + 1, r.hi, h0, h1);
+        if (l0 <= l1)
+          stack[top++] = makeRange(r.lo, mid, l0, l1);
+        if (!low_first && h0 <= h1)
+          stack[top++] = makeRange(mid + 1, r.hi, h0, h1);
+      }
+
+      if (hit)
+        range = best;
+
+      return hit;
+    }
+  }
+}
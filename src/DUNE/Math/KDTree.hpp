@@ -0,0 +1,243 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_MATH_KD_TREE_HPP_INCLUDED_
+#define DUNE_MATH_KD_TREE_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+
+namespace DUNE
+{
+  namespace Math
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM KDTree;
+
+    //! Static two-dimensional k-d tree.
+    //!
+    //! Items are kept in a single array, ordered so that the median
+    //! of every range [lo, hi) is at (lo + hi) / 2 and splits the
+    //! range along the axis stored for that position. There are no
+    //! node objects nor pointers, ranges with up to c_leaf_size items
+    //! are scanned linearly, and queries use a fixed-size stack, so
+    //! they never allocate memory.
+    class KDTree
+    {
+    public:
+      //! Indexed item.
+      struct Item
+      {
+        //! First coordinate.
+        double x;
+        //! Second coordinate.
+        double y;
+        //! Associated value.
+        double value;
+      };
+
+      //! Ranges with up to this number of items are not split.
+      static const size_t c_leaf_size = 8;
+
+      //! Create an empty tree.
+      KDTree(void);
+
+      //! Build the tree, replacing any previous items.
+      //! @param[in] items items to index.
+      void
+      build(const std::vector<Item>& items);
+
+      //! Build the tree, replacing any previous items.
+      //! @param[in] items items to index.
+      //! @param[in] count number of items.
+      void
+      build(const Item* items, size_t count);
+
+      //! Remove all items.
+      void
+      clear(void);
+
+      //! Get number of items.
+      //! @return number of items.
+      size_t
+      size(void) const
+      {
+        return m_items.size();
+      }
+
+      //! Check if the tree is empty.
+      //! @return true if empty, false otherwise.
+      bool
+      empty(void) const
+      {
+        return m_items.empty();
+      }
+
+      //! Access an item. Items are reordered by build(), indices
+      //! refer to the tree order.
+      //! @param[in] index item index.
+      //! @return item.
+      const Item&
+      operator[](size_t index) const
+      {
+        return m_items[index];
+      }
+
+      //! Find the item closest to a point.
+      //! @param[in] x first coordinate.
+      //! @param[in] y second coordinate.
+      //! @param[out] index index of the closest item.
+      //! @param[in] max_distance ignore items further than this.
+      //! @return true if an item was found, false otherwise.
+      bool
+      nearest(double x, double y, size_t& index, double max_distance = -1) const;
+
+      //! Find the k items closest to a point.
+      //! @param[in] x first coordinate.
+      //! @param[in] y second coordinate.
+      //! @param[in] k maximum number of items.
+      //! @param[out] indices indices of the items, closest first
+      //! (at least k elements).
+      //! @param[out] distances distances to the items (at least k
+      //! elements).
+      //! @param[in] max_distance ignore items further than this.
+      //! @return number of items found.
+      size_t
+      nearest(double x, double y, size_t k, size_t* indices, double* distances,
+              double max_distance = -1) const;
+
+      //! Visit all items within a given distance of a point.
+      //! @param[in] x first coordinate.
+      //! @param[in] y second coordinate.
+      //! @param[in] radius search radius.
+      //! @param[in] visitor functor called with each item.
+      //! @return number of items visited.
+      template <typename Visitor>
+      size_t
+      search(double x, double y, double radius, Visitor& visitor) const
+      {
+        if (m_items.empty())
+          return 0;
+
+        double r2 = radius * radius;
+        size_t count = 0;
+        Range stack[c_stack_size];
+        size_t top = 0;
+        stack[top++] = makeRange(0, m_items.size(), 0);
+
+        while (top > 0)
+        {
+          Range r = stack[--top];
+
+          if (r.hi - r.lo <= c_leaf_size)
+          {
+            for (size_t i = r.lo; i < r.hi; ++i)
+            {
+              const Item& it = m_items[i];
+              if ((it.x - x) * (it.x - x) + (it.y - y) * (it.y - y) <= r2)
+              {
+                visitor(it);
+                ++count;
+              }
+            }
+            continue;
+          }
+
+          size_t mid = (r.lo + r.hi) / 2;
+          const Item& it = m_items[mid];
+          double d = m_axis[mid] ? (y - it.y) : (x - it.x);
+
+          if ((it.x - x) * (it.x - x) + (it.y - y) * (it.y - y) <= r2)
+          {
+            visitor(it);
+            ++count;
+          }
+
+          if (d >= -radius)
+            stack[top++] = makeRange(mid + 1, r.hi, 0);
+          if (d <= radius)
+            stack[top++] = makeRange(r.lo, mid, 0);
+        }
+
+        return count;
+      }
+
+      //! Cast a ray against the items, taken as discs of a given
+      //! radius, and find the first one hit.
+      //! @param[in] x first coordinate of the ray origin.
+      //! @param[in] y second coordinate of the ray origin.
+      //! @param[in] dx first component of the ray direction.
+      //! @param[in] dy second component of the ray direction.
+      //! @param[in] length maximum ray length.
+      //! @param[in] radius item radius.
+      //! @param[out] range distance along the ray to the first hit.
+      //! @param[out] index index of the item hit.
+      //! @return true if an item was hit, false otherwise.
+      bool
+      raycast(double x, double y, double dx, double dy, double length, double radius,
+              double& range, size_t& index) const;
+
+    private:
+      //! Query stack size (enough for any 64-bit size_t tree).
+      static const size_t c_stack_size = 128;
+
+      //! Pending range with the interval of the query metric
+      //! (squared distance or ray parameter) it may contain.
+      struct Range
+      {
+        size_t lo;
+        size_t hi;
+        double bound;
+        double end;
+      };
+
+      //! Items in tree order.
+      std::vector<Item> m_items;
+      //! Split axis of each median (0 for x, 1 for y).
+      std::vector<uint8_t> m_axis;
+
+      //! Order a range of items.
+      void
+      split(size_t lo, size_t hi);
+
+      static Range
+      makeRange(size_t lo, size_t hi, double bound, double end = 0)
+      {
+        Range r = {lo, hi, bound, end};
+        return r;
+      }
+    };
+  }
+}
+
+#endif
@@ -41,136 +41,387 @@
 // The latter is more natural and saves the caller from  matrix
 // transposition steps.
 // --------------------------------------------------------------------------
+// WORKSPACE NOTE
+//
+// - The solver works on row-major arrays held by the QPSolver instance,
+// so repeated solves of same-sized problems do not allocate. The
+// Cholesky factor of H and the initial J = L^-T are kept while H does
+// not change.
+// --------------------------------------------------------------------------
 
-#include "QPSolver.hpp"
-#include <iostream>
+// ISO C++ 98 headers.
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <limits>
-#include <sstream>
-#include <stdexcept>
 
-//#define __QPDBG__
+// DUNE headers.
+#include <DUNE/Math/QPSolver.hpp>
+#include <DUNE/Time/Clock.hpp>
+
 namespace DUNE
 {
   namespace Math
   {
-    // Template class just to encapsulate operator() in access to a std::vector
-    // (for pedantic syntactic sugar in consistencty with DUNE::Math::Matrix
-    //  and DUNE::Math::Matrix)
-    template <typename T>
-    class tvector: public std::vector<T>
+    static inline double
+    dot(const double* a, const double* b, int n)
     {
-    public:
-      tvector(size_t n):
-        std::vector<T>(n)
-      { }
+      double sum = 0.0;
+      for (int i = 0; i < n; i++)
+        sum += a[i] * b[i];
+      return sum;
+    }
 
-      inline T&
-      operator()(size_t index)
+    static double
+    distance(double a, double b)
+    {
+      double a1, b1, t;
+      a1 = std::fabs(a);
+      b1 = std::fabs(b);
+      if (a1 > b1)
       {
-        return std::vector<T>::operator[](index);
+        t = (b1 / a1);
+        return a1 * std::sqrt(1.0 + t * t);
       }
-
-      inline const T&
-      operator()(size_t index) const
+      else if (b1 > a1)
       {
-        return std::vector<T>::operator[](index);
+        t = (a1 / b1);
+        return b1 * std::sqrt(1.0 + t * t);
       }
-    };
+      return a1 * std::sqrt(2.0);
+    }
 
-    // Utility functions
     static void
-    compute_d(Matrix& d, const Matrix& J, const Matrix& np);
+    compute_d(double* d, const double* J, const double* np, int n)
+    {
+      /* compute d = H^T * np */
+      for (int i = 0; i < n; i++)
+      {
+        double sum = 0.0;
+        for (int j = 0; j < n; j++)
+          sum += J[j * n + i] * np[j];
+        d[i] = sum;
+      }
+    }
 
     static void
-    update_z(Matrix& z, const Matrix& J, const Matrix& d, int iq);
+    update_z(double* z, const double* J, const double* d, int n, int iq)
+    {
+      /* setting of z = H * d */
+      for (int i = 0; i < n; i++)
+      {
+        double sum = 0.0;
+        for (int j = iq; j < n; j++)
+          sum += J[i * n + j] * d[j];
+        z[i] = sum;
+      }
+    }
 
     static void
-    update_r(const Matrix& R, Matrix& r, const Matrix& d, int iq);
+    update_r(const double* R, double* r, const double* d, int n, int iq)
+    {
+      /* setting of r = R^-1 d */
+      for (int i = iq - 1; i >= 0; i--)
+      {
+        double sum = 0.0;
+        for (int j = i + 1; j < iq; j++)
+          sum += R[i * n + j] * r[j];
+        r[i] = (d[i] - sum) / R[i * n + i];
+      }
+    }
 
     static bool
-    add_constraint(Matrix& R, Matrix& J, Matrix& d, int& iq, double& rnorm);
+    add_constraint(double* R, double* J, double* d, int n, int& iq, double& R_norm)
+    {
+      int i, j, k;
+      double cc, ss, h, t1, t2, xny;
 
-    static void
-    delete_constraint(Matrix& R, Matrix& J, tvector<int>& A, Matrix& u, int n, int p, int& iq, int l);
+      /* we have to find the Givens rotation which will reduce the element
+        d(j) to zero.
+        if it is already zero we don't have to do anything, except of
+        decreasing j */
+      for (j = n - 1; j >= iq + 1; j--)
+      {
+        /* The Givens rotation is done with the matrix (cc cs, cs -cc).
+        If cc is one, then element (j) of d is zero compared with element
+        (j - 1). Hence we don't have to do anything.
+        If cc is zero, then we just have to switch column (j) and column (j - 1)
+        of J. Since we only switch columns in J, we have to be careful how we
+        update d depending on the sign of gs.
+        Otherwise we have to apply the Givens rotation to these columns.
+        The i - 1 element of d has to be updated to h. */
+        cc = d[j - 1];
+        ss = d[j];
+        h = distance(cc, ss);
+        if (std::fabs(h) < std::numeric_limits<double>::epsilon()) // h == 0
+          continue;
+        d[j] = 0.0;
+        ss = ss / h;
+        cc = cc / h;
+        if (cc < 0.0)
+        {
+          cc = -cc;
+          ss = -ss;
+          d[j - 1] = -h;
+        }
+        else
+          d[j - 1] = h;
+        xny = ss / (1.0 + cc);
+        for (k = 0; k < n; k++)
+        {
+          t1 = J[k * n + j - 1];
+          t2 = J[k * n + j];
+          J[k * n + j - 1] = t1 * cc + t2 * ss;
+          J[k * n + j] = xny * (t1 + J[k * n + j - 1]) - t2;
+        }
+      }
+      /* update the number of constraints added*/
+      iq++;
+      /* To update R we have to put the iq components of the d vector
+        into column iq - 1 of R
+        */
+      for (i = 0; i < iq; i++)
+        R[i * n + iq - 1] = d[i];
 
-    static void
-    cholesky_decomposition(Matrix& A);
+      if (std::fabs(d[iq - 1]) <= std::numeric_limits<double>::epsilon() * R_norm)
+      {
+        // problem degenerate
+        return false;
+      }
+      R_norm = std::max<double>(R_norm, std::fabs(d[iq - 1]));
+      return true;
+    }
 
     static void
-    cholesky_solve(const Matrix& L, Matrix& x, const Matrix& b);
+    delete_constraint(double* R, double* J, int* Aset, double* u, int n, int p, int& iq, int l)
+    {
+      int i, j, k, qq = -1; // just to prevent warnings from smart compilers
+      double cc, ss, h, xny, t1, t2;
 
-    static void
-    forward_elimination(const Matrix& L, Matrix& y, const Matrix& b);
+      /* Find the index qq for active constraint l to be removed */
+      for (i = p; i < iq; i++)
+        if (Aset[i] == l)
+        {
+          qq = i;
+          break;
+        }
 
-    static void
-    backward_elimination(const Matrix& U, Matrix& x, const Matrix& y);
+      /* remove the constraint from the active set and the duals */
+      for (i = qq; i < iq - 1; i++)
+      {
+        Aset[i] = Aset[i + 1];
+        u[i] = u[i + 1];
+        for (j = 0; j < n; j++)
+          R[j * n + i] = R[j * n + i + 1];
+      }
 
-    static double
-    distance(double a, double b);
+      Aset[iq - 1] = Aset[iq];
+      u[iq - 1] = u[iq];
+      Aset[iq] = 0;
+      u[iq] = 0.0;
+      for (j = 0; j < iq; j++)
+        R[j * n + iq - 1] = 0.0;
+      /* constraint has been fully removed */
+      iq--;
+
+      if (iq == 0)
+        return;
+
+      for (j = qq; j < iq; j++)
+      {
+        cc = R[j * n + j];
+        ss = R[(j + 1) * n + j];
+        h = distance(cc, ss);
+        if (std::fabs(h) < std::numeric_limits<double>::epsilon()) // h == 0
+          continue;
+        cc = cc / h;
+        ss = ss / h;
+        R[(j + 1) * n + j] = 0.0;
+        if (cc < 0.0)
+        {
+          R[j * n + j] = -h;
+          cc = -cc;
+          ss = -ss;
+        }
+        else
+          R[j * n + j] = h;
+
+        xny = ss / (1.0 + cc);
+        for (k = j + 1; k < iq; k++)
+        {
+          t1 = R[j * n + k];
+          t2 = R[(j + 1) * n + k];
+          R[j * n + k] = t1 * cc + t2 * ss;
+          R[(j + 1) * n + k] = xny * (t1 + R[j * n + k]) - t2;
+        }
+        for (k = 0; k < n; k++)
+        {
+          t1 = J[k * n + j];
+          t2 = J[k * n + j + 1];
+          J[k * n + j] = t1 * cc + t2 * ss;
+          J[k * n + j + 1] = xny * (J[k * n + j] + t1) - t2;
+        }
+      }
+    }
 
-#ifdef __QPDBG__
-    // Utility functions for printing vectors and matrices
     static void
-    print_matrix(const char* name, const Matrix& A, int n = -1, int m = -1);
+    cholesky_decomposition(double* A, int n)
+    {
+      int i, j, k;
+      double sum;
+
+      for (i = 0; i < n; i++)
+      {
+        for (j = i; j < n; j++)
+        {
+          sum = A[j * n + i];
+          for (k = i - 1; k >= 0; k--)
+            sum -= A[k * n + i] * A[k * n + j];
+          if (i == j)
+          {
+            if (sum <= 0.0)
+              throw QPSolver::Error("error in Cholesky decomposition");
+            A[i * n + i] = std::sqrt(sum);
+          }
+          else
+          {
+            A[i * n + j] = sum / A[i * n + i];
+          }
+        }
+        for (k = i + 1; k < n; k++)
+          A[k * n + i] = A[i * n + k];
+      }
+    }
 
-    template <typename T>
     static void
-    print_vector(const char* name, const tvector<T>& v, int n = -1);
+    forward_elimination(const double* L, double* y, const double* b, int n)
+    {
+      y[0] = b[0] / L[0];
+      for (int i = 1; i < n; i++)
+      {
+        y[i] = b[i];
+        for (int j = 0; j < i; j++)
+          y[i] -= L[i * n + j] * y[j];
+        y[i] = y[i] / L[i * n + i];
+      }
+    }
 
     static void
-    print_vector(const char* name, const Matrix& v, int n = -1)
+    backward_elimination(const double* U, double* x, const double* y, int n)
     {
-      std::cout << name << ": " << v << std::endl;
+      x[n - 1] = y[n - 1] / U[(n - 1) * n + n - 1];
+      for (int i = n - 2; i >= 0; i--)
+      {
+        x[i] = y[i];
+        for (int j = i + 1; j < n; j++)
+          x[i] -= U[i * n + j] * x[j];
+        x[i] = x[i] / U[i * n + i];
+      }
     }
 
-#endif
+    QPSolver::QPSolver(void):
+      m_max_iterations(0),
+      m_time_budget(0.0),
+      m_warm_start(true),
+      m_n(0),
+      m_p(0),
+      m_m(0),
+      m_factored(false),
+      m_c1(0.0),
+      m_c2(0.0),
+      m_warm_count(0)
+    {
+      reset();
+    }
 
-    double
-    QPSolver::solve(const Matrix& H, const Matrix& f, const Matrix& A, const Matrix& b, Matrix& x)
+    void
+    QPSolver::reset(void)
     {
-      // Zero-size matrix and vector
-      Matrix Aeq;
-      Matrix beq;
-      return solve(H, f, Aeq, beq, A, b, x);
+      m_factored = false;
+      m_warm_count = 0;
+      std::memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    void
+    QPSolver::prepare(size_t n, size_t p, size_t m)
+    {
+      if (n == m_n && p == m_p && m == m_m && !m_r.empty())
+        return;
+
+      if (n != m_n)
+        m_factored = false;
+
+      // Different problem structure: previous active set is meaningless.
+      m_warm_count = 0;
+      m_n = n;
+      m_p = p;
+      m_m = m;
+
+      size_t q = m + p + 1;
+      size_t nn = std::max<size_t>(n * n, 1);
+      size_t n1 = std::max<size_t>(n, 1);
+
+      m_hc.resize(nn);
+      m_h0.resize(nn);
+      m_j0.resize(nn);
+      m_r.resize(nn);
+      m_j.resize(nn);
+      m_z.resize(n1);
+      m_d.resize(n1);
+      m_np.resize(n1);
+      m_x.resize(n1);
+      m_x_old.resize(n1);
+      m_s.resize(q);
+      m_rv.resize(q);
+      m_u.resize(q);
+      m_u_old.resize(q);
+      m_aset.resize(q);
+      m_aset_old.resize(q);
+      m_iai.resize(q);
+      m_iaexcl.resize(q);
+      m_warm.resize(q);
     }
 
     double
-    QPSolver::solve(const Matrix& H, const Matrix& f, const Matrix& Aeq, const Matrix& beq, const Matrix& A, const Matrix& b, Matrix& x)
+    QPSolver::finish(double f_value, int iq, size_t p, double start, bool converged)
     {
-      // Validate parameter dimensions
-      // n: number of vars
-      // p: number of equality constraints
-      // m: number of inequality constraints
-      int n = H.columns();
-      int p = Aeq.rows();
-      int m = A.rows();
+      m_warm_count = 0;
+      if (m_warm_start)
+      {
+        for (int i = (int)p; i < iq; i++)
+          m_warm[m_warm_count++] = m_aset[i];
+      }
 
-      if (!H.isSquare())
-        throw Error("'H' is not a square matrix");
+      m_stats.active = iq - (int)p;
+      m_stats.converged = converged;
+      m_stats.solve_time = Time::Clock::get() - start;
+      m_stats.max_solve_time = std::max(m_stats.max_solve_time, m_stats.solve_time);
+      ++m_stats.solves;
+      if (!converged)
+        ++m_stats.interrupted;
 
-      if (A.columns() != n)
-        throw Error("'A' has an invalid number of rows");
+      return f_value;
+    }
 
-      if (!b.isColumnVector(m))
-        throw Error("'b' has an invalid size");
+    double
+    QPSolver::run(size_t nvars, size_t neq, size_t nineq, const double* H, const double* f,
+                  const double* Aeq, const double* beq, const double* A, const double* b,
+                  double* x)
+    {
+      double start = Time::Clock::get();
+      double deadline = start + m_time_budget;
 
-      if (p > 0)
-      {
-        if (Aeq.columns() != n)
-          throw Error("'Aeq' has an invalid number of rows");
-        if (!beq.isColumnVector(p))
-          throw Error("'beq' has an invalid size");
-      }
+      prepare(nvars, neq, nineq);
 
-      // Resize output vector
-      x.resize(n, 1);
+      // n: number of vars
+      // p: number of equality constraints
+      // m: number of inequality constraints
+      int n = (int)nvars;
+      int p = (int)neq;
+      int m = (int)nineq;
 
       // Working variables
       int i, j, k, l, ip;
-      Matrix R(n, n), J(n, n);
-      Matrix s(m + p, 1), z(n, 1), r(m + p, 1), d(n, 1), np(n, 1), u(m + p, 1), x_old(n, 1), u_old(m + p, 1);
       double f_value, psi, c1, c2, sum, ss, R_norm;
       double inf = std::numeric_limits<double>::has_infinity ?
                    std::numeric_limits<double>::infinity() : 1.0E300;
@@ -178,125 +429,136 @@ namespace DUNE
       double t, t1, t2; /* t is the step lenght, which is the minimum of the partial step length t1
       * and the full step length t2 */
 
-      tvector<int> Aset(m + p), Aset_old(m + p), iai(m + p);
       int iq;
-      int iter = 0;
-      tvector<uint8_t> iaexcl(m + p);
-
-#ifdef __QPDBG__
-      std::cout << std::endl << "Starting solve_quadprog" << std::endl;
-      print_matrix("H", H);
-      print_vector("f", f);
-      print_matrix("Aeq", Aeq);
-      print_vector("beq", beq);
-      print_matrix("A", A);
-      print_vector("b", b);
-#endif
+      unsigned iter = 0;
+      size_t warm_count = m_warm_count;
+      m_warm_count = 0;
+
+      double* R = &m_r[0];
+      double* J = &m_j[0];
+      double* H0 = &m_h0[0];
+      double* z = &m_z[0];
+      double* d = &m_d[0];
+      double* np = &m_np[0];
+      double* x_old = &m_x_old[0];
+      double* s = &m_s[0];
+      double* r = &m_rv[0];
+      double* u = &m_u[0];
+      double* u_old = &m_u_old[0];
+      int* Aset = &m_aset[0];
+      int* Aset_old = &m_aset_old[0];
+      int* iai = &m_iai[0];
+      unsigned char* iaexcl = &m_iaexcl[0];
+      const int* warm = &m_warm[0];
+
+      m_stats.iterations = 0;
+      m_stats.active = 0;
+      m_stats.converged = false;
+      m_stats.factorization_reused = m_factored && std::memcmp(&m_hc[0], H, n * n * sizeof(double)) == 0;
 
       /*
        * Preprocessing phase
        */
 
-      /* compute the trace of the original matrix G */
-      Matrix H0(H);
-      c1 = 0.0;
-      for (i = 0; i < n; i++)
-        c1 += H0(i, i);
+      if (!m_stats.factorization_reused)
+      {
+        m_factored = false;
+        std::memcpy(&m_hc[0], H, n * n * sizeof(double));
+        std::memcpy(H0, H, n * n * sizeof(double));
+
+        /* compute the trace of the original matrix G */
+        m_c1 = 0.0;
+        for (i = 0; i < n; i++)
+          m_c1 += H0[i * n + i];
+
+        /* decompose the matrix H0 in the form L^T L */
+        cholesky_decomposition(H0, n);
+
+        /* compute the inverse of the factorized matrix G^-1, this is the initial value for H */
+        std::fill(d, d + n, 0.0);
+        m_c2 = 0.0;
+        for (i = 0; i < n; i++)
+        {
+          d[i] = 1.0;
+          forward_elimination(H0, z, d, n);
+          for (j = 0; j < n; j++)
+            m_j0[i * n + j] = z[j];
+          m_c2 += z[i];
+          d[i] = 0.0;
+        }
+
+        m_factored = true;
+      }
+
+      c1 = m_c1;
+      c2 = m_c2;
 
-      /* decompose the matrix H0 in the form L^T L */
-      cholesky_decomposition(H0);
-#ifdef __QPDBG__
-      print_matrix("H0", H0);
-#endif
       /* initialize the matrix R */
-      d.fill(0);
-      R.fill(0);
+      std::fill(d, d + n, 0.0);
+      std::fill(R, R + n * n, 0.0);
+      std::copy(m_j0.begin(), m_j0.begin() + n * n, J);
       R_norm = 1.0; /* this variable will hold the norm of the matrix R */
-      /* compute the inverse of the factorized matrix G^-1, this is the initial value for H */
-      c2 = 0.0;
-      for (i = 0; i < n; i++)
-      {
-        d(i) = 1.0;
-        forward_elimination(H0, z, d);
-        for (j = 0; j < n; j++)
-          J(i, j) = z(j);
-        c2 += z(i);
-        d(i) = 0.0;
-      }
-#ifdef __QPDBG__
-      print_matrix("J", J);
-#endif
 
       /* c1 * c2 is an estimate for cond(H0) */
 
       /*
-        * Find the unconstrained minimizer of the quadratic form 0.5 * x G x + f x
+       * Find the unconstrained minimizer of the quadratic form 0.5 * x G x + f x
        * this is a feasible point in the dual space
        * x = G^-1 * f
        */
-      cholesky_solve(H0, x, f);
+      forward_elimination(H0, z, f, n);
+      backward_elimination(H0, x, z, n);
       for (i = 0; i < n; i++)
-        x(i) = -x(i);
+        x[i] = -x[i];
       /* and compute the current solution value */
-      f_value = 0.5 * Matrix::dot(f, x);
-#ifdef __QPDBG__
-      std::cout << "Unconstrained solution: " << f_value << std::endl;
-      print_vector("x", x);
-#endif
+      f_value = 0.5 * dot(f, x, n);
 
       /* Add equality constraints to the working set A */
       iq = 0;
       for (i = 0; i < p; i++)
       {
         for (j = 0; j < n; j++)
-          np(j) = Aeq(i, j);
-        compute_d(d, J, np);
-        update_z(z, J, d, iq);
-        update_r(R, r, d, iq);
-    #ifdef __QPDBG__
-        print_matrix("R", R, n, iq);
-        print_vector("z", z);
-        print_vector("r", r, iq);
-        print_vector("d", d);
-    #endif
+          np[j] = Aeq[i * n + j];
+        compute_d(d, J, np, n);
+        update_z(z, J, d, n, iq);
+        update_r(R, r, d, n, iq);
 
         /* compute full step length t2: i.e., the minimum step in primal space s.t. the contraint
           becomes feasible */
         t2 = 0.0;
-        if (std::fabs(Matrix::dot(z, z)) > std::numeric_limits<double>::epsilon()) // i.e. z != 0
-          t2 = (-Matrix::dot(np, x) - beq(i)) / Matrix::dot(z, np);
+        if (std::fabs(dot(z, z, n)) > std::numeric_limits<double>::epsilon()) // i.e. z != 0
+          t2 = (-dot(np, x, n) - beq[i]) / dot(z, np, n);
 
         /* set x = x + t2 * z */
         for (k = 0; k < n; k++)
-          x(k) += t2 * z(k);
+          x[k] += t2 * z[k];
 
         /* set u = u+ */
-        u(iq) = t2;
+        u[iq] = t2;
         for (k = 0; k < iq; k++)
-          u(k) -= t2 * r(k);
+          u[k] -= t2 * r[k];
 
         /* compute the new solution value */
-        f_value += 0.5 * (t2 * t2) * Matrix::dot(z, np);
-        Aset(i) = -i - 1;
+        f_value += 0.5 * (t2 * t2) * dot(z, np, n);
+        Aset[i] = -i - 1;
 
-        if (!add_constraint(R, J, d, iq, R_norm))
+        if (!add_constraint(R, J, d, n, iq, R_norm))
           // Equality constraints are linearly dependent
           throw Error("Constraints are linearly dependent");
       }
 
       /* set iai = K \ A */
       for (i = 0; i < m; i++)
-        iai(i) = i;
+        iai[i] = i;
 
 l1:  iter++;
-    #ifdef __QPDBG__
-      print_vector("x", x);
-    #endif
+      m_stats.iterations = iter - 1;
+
       /* step 1: choose a violated constraint */
       for (i = p; i < iq; i++)
       {
-        ip = Aset(i);
-        iai(ip) = -1;
+        ip = Aset[i];
+        iai[ip] = -1;
       }
 
       /* compute s(x) = A^T * x + b for all elements of K \ A */
@@ -305,71 +567,75 @@ l1:  iter++;
       ip = 0; /* ip will be the index of the chosen violated constraint */
       for (i = 0; i < m; i++)
       {
-        iaexcl(i) = true;
-        sum = 0.0;
-        for (j = 0; j < n; j++)
-          sum += A(i, j) * x(j);
-        sum += b(i);
-        s(i) = sum;
+        iaexcl[i] = true;
+        sum = dot(A + i * n, x, n) + b[i];
+        s[i] = sum;
         psi += std::min(0.0, sum);
       }
-    #ifdef __QPDBG__
-      print_vector("s", s, m);
-    #endif
 
       if (std::fabs(psi) <= m * std::numeric_limits<double>::epsilon() * c1 * c2 * 100.0)
       {
         /* numerically there are not infeasibilities anymore */
-        return f_value;
+        return finish(f_value, iq, p, start, true);
       }
 
+      /* stop early if the iteration or time budget is exhausted */
+      if ((m_max_iterations > 0 && iter > m_max_iterations) ||
+          (m_time_budget > 0.0 && Time::Clock::get() >= deadline))
+        return finish(f_value, iq, p, start, false);
+
       /* save old values for u and A */
       for (i = 0; i < iq; i++)
       {
-        u_old(i) = u(i);
-        Aset_old(i) = Aset(i);
+        u_old[i] = u[i];
+        Aset_old[i] = Aset[i];
       }
       /* and for x */
-      x_old = x;
+      std::copy(x, x + n, x_old);
 
 l2:     /* Step 2: check for feasibility and determine a new S-pair */
-      for (i = 0; i < m; i++)
+      /* warm start: constraints active in the previous solution take
+         precedence over the most violated one */
+      for (k = 0; k < (int)warm_count; k++)
       {
-        if (s(i) < ss && iai(i) != -1 && iaexcl(i))
+        i = warm[k];
+        if (s[i] < 0.0 && iai[i] != -1 && iaexcl[i])
         {
-          ss = s(i);
+          ss = s[i];
           ip = i;
+          break;
         }
       }
-      if (ss >= 0.0)
+
+      if (k == (int)warm_count)
       {
-        return f_value;
+        for (i = 0; i < m; i++)
+        {
+          if (s[i] < ss && iai[i] != -1 && iaexcl[i])
+          {
+            ss = s[i];
+            ip = i;
+          }
+        }
       }
 
+      if (ss >= 0.0)
+        return finish(f_value, iq, p, start, true);
+
       /* set np = n(ip) */
       for (i = 0; i < n; i++)
-        np(i) = A(ip, i);
+        np[i] = A[ip * n + i];
       /* set u = (u 0)^T */
-      u(iq) = 0.0;
+      u[iq] = 0.0;
       /* add ip to the active set A */
-      Aset(iq) = ip;
-
-    #ifdef __QPDBG__
-      std::cout << "Trying with constraint " << ip << std::endl;
-      print_vector("np", np);
-    #endif
+      Aset[iq] = ip;
 
 l2a:    /* Step 2a: determine step direction */
         /* compute z = H np: the step direction in the primal space (through J, see the paper) */
-      compute_d(d, J, np);
-      update_z(z, J, d, iq);
+      compute_d(d, J, np, n);
+      update_z(z, J, d, n, iq);
       /* compute N* np (if q > 0): the negative of the step direction in the dual space */
-      update_r(R, r, d, iq);
-    #ifdef __QPDBG__
-      std::cout << "Step direction z" << std::endl;
-      print_vector("z", z);
-      print_vector("d", d);
-    #endif
+      update_r(R, r, d, n, iq);
 
       /* Step 2b: compute step length */
       l = 0;
@@ -378,26 +644,23 @@ l2a:    /* Step 2a: determine step direction */
       /* find the index l s.t. it reaches the minimum of u+(x) / r */
       for (k = p; k < iq; k++)
       {
-        if (r(k) > 0.0)
+        if (r[k] > 0.0)
         {
-          if (u(k) / r(k) < t1)
+          if (u[k] / r[k] < t1)
           {
-            t1 = u(k) / r(k);
-            l = Aset(k);
+            t1 = u[k] / r[k];
+            l = Aset[k];
           }
         }
       }
       /* Compute t2: full step length (minimum step in primal space such that the constraint ip becomes feasible */
-      if (std::fabs(Matrix::dot(z, z)) > std::numeric_limits<double>::epsilon())  // i.e. z != 0
-        t2 = -s(ip) / Matrix::dot(z, np);
+      if (std::fabs(dot(z, z, n)) > std::numeric_limits<double>::epsilon())  // i.e. z != 0
+        t2 = -s[ip] / dot(z, np, n);
       else
         t2 = inf;  /* +inf */
 
       /* the step is chosen as the minimum of t1 and t2 */
       t = std::min(t1, t2);
-    #ifdef __QPDBG__
-      std::cout << "Step sizes: " << t << " (t1 = " << t1 << ", t2 = " << t2 << ") ";
-    #endif
 
       /* Step 2c: determine new S-pair and take step: */
 
@@ -414,17 +677,10 @@ l2a:    /* Step 2a: determine step direction */
       {
         /* set u = u +  t * (-r 1) and drop constraint l from the active set A */
         for (k = 0; k < iq; k++)
-          u(k) -= t * r(k);
-        u(iq) += t;
-        iai(l) = l;
+          u[k] -= t * r[k];
+        u[iq] += t;
+        iai[l] = l;
         delete_constraint(R, J, Aset, u, n, p, iq, l);
-    #ifdef __QPDBG__
-        std::cout << " in dual space: "
-                  << f_value << std::endl;
-        print_vector("x", x);
-        print_vector("z", z);
-        print_vector("Aset", Aset, iq + 1);
-    #endif
         goto l2a;
       }
 
@@ -432,416 +688,120 @@ l2a:    /* Step 2a: determine step direction */
 
       /* set x = x + t * z */
       for (k = 0; k < n; k++)
-        x(k) += t * z(k);
+        x[k] += t * z[k];
       /* update the solution value */
-      f_value += t * Matrix::dot(z, np) * (0.5 * t + u(iq));
+      f_value += t * dot(z, np, n) * (0.5 * t + u[iq]);
       /* u = u + t * (-r 1) */
       for (k = 0; k < iq; k++)
-        u(k) -= t * r(k);
-      u(iq) += t;
-    #ifdef __QPDBG__
-      std::cout << " in both spaces: "
-                << f_value << std::endl;
-      print_vector("x", x);
-      print_vector("u", u, iq + 1);
-      print_vector("r", r, iq + 1);
-      print_vector("Aset", Aset, iq + 1);
-    #endif
+        u[k] -= t * r[k];
+      u[iq] += t;
 
       if (std::fabs(t - t2) < std::numeric_limits<double>::epsilon())
       {
-    #ifdef __QPDBG__
-        std::cout << "Full step has taken " << t << std::endl;
-        print_vector("x", x);
-    #endif
         /* full step has taken */
         /* add constraint ip to the active set*/
-        if (!add_constraint(R, J, d, iq, R_norm))
+        if (!add_constraint(R, J, d, n, iq, R_norm))
         {
-          std::cout << "not iaexcl " << ip << std::endl;
-          iaexcl(ip) = false;
+          iaexcl[ip] = false;
           delete_constraint(R, J, Aset, u, n, p, iq, ip);
-    #ifdef __QPDBG__
-          print_matrix("R", R);
-          print_vector("Aset", Aset, iq);
-          print_vector("iai", iai);
-    #endif
           for (i = 0; i < m; i++)
-            iai(i) = i;
+            iai[i] = i;
           for (i = p; i < iq; i++)
           {
-            Aset(i) = Aset_old(i);
-            u(i) = u_old(i);
-            iai(Aset(i)) = -1;
+            Aset[i] = Aset_old[i];
+            u[i] = u_old[i];
+            iai[Aset[i]] = -1;
           }
-          x = x_old;
+          std::copy(x_old, x_old + n, x);
           goto l2; /* go to step 2 */
         }
         else
-          iai(ip) = -1;
-    #ifdef __QPDBG__
-        print_matrix("R", R);
-        print_vector("Aset", Aset, iq);
-        print_vector("iai", iai);
-    #endif
+          iai[ip] = -1;
         goto l1;
       }
 
       /* a patial step has taken */
-    #ifdef __QPDBG__
-      std::cout << "Partial step has taken " << t << std::endl;
-      print_vector("x", x);
-    #endif
       /* drop constraint l */
-      iai(l) = l;
+      iai[l] = l;
       delete_constraint(R, J, Aset, u, n, p, iq, l);
-    #ifdef __QPDBG__
-      print_matrix("R", R);
-      print_vector("Aset", Aset, iq);
-    #endif
 
       /* update s(ip) = A * x + b */
-      sum = 0.0;
-      for (k = 0; k < n; k++)
-        sum += A(ip, k) * x(k);
-      s(ip) = sum + b(ip);
+      s[ip] = dot(A + ip * n, x, n) + b[ip];
 
-    #ifdef __QPDBG__
-      print_vector("s", s, m);
-    #endif
       goto l2a;
     }
 
-    static void
-    compute_d(Matrix& d, const Matrix& J, const Matrix& np)
-    {
-      int i, j, n = d.rows();
-      double sum;
-
-      /* compute d = H^T * np */
-      for (i = 0; i < n; i++)
-      {
-        sum = 0.0;
-        for (j = 0; j < n; j++)
-          sum += J(j, i) * np(j);
-        d(i) = sum;
-      }
-    }
-
-    static void
-    update_z(Matrix& z, const Matrix& J, const Matrix& d, int iq)
-    {
-      int i, j, n = z.rows();
-
-      /* setting of z = H * d */
-      for (i = 0; i < n; i++)
-      {
-        z(i) = 0.0;
-        for (j = iq; j < n; j++)
-          z(i) += J(i, j) * d(j);
-      }
-    }
-
-    static void
-    update_r(const Matrix& R, Matrix& r, const Matrix& d, int iq)
+    double
+    QPSolver::minimizeMatrix(const Matrix& H, const Matrix& f, const Matrix* Aeq, const Matrix* beq,
+                             const Matrix& A, const Matrix& b, Matrix& x)
     {
-      int i, j; /*, n = d.size();*/
-      double sum;
+      // Validate parameter dimensions
+      int n = H.columns();
+      int p = Aeq ? Aeq->rows() : 0;
+      int m = A.rows();
 
-      /* setting of r = R^-1 d */
-      for (i = iq - 1; i >= 0; i--)
-      {
-        sum = 0.0;
-        for (j = i + 1; j < iq; j++)
-          sum += R(i, j) * r(j);
-        r(i) = (d(i) - sum) / R(i, i);
-      }
-    }
+      if (!H.isSquare())
+        throw Error("'H' is not a square matrix");
 
-    static bool
-    add_constraint(Matrix& R, Matrix& J, Matrix& d, int& iq, double& R_norm)
-    {
-      int n = d.rows();
-    #ifdef __QPDBG__
-      std::cout << "Add constraint " << iq << '/';
-    #endif
-      int i, j, k;
-      double cc, ss, h, t1, t2, xny;
+      if (!f.isColumnVector(n))
+        throw Error("'f' has an invalid size");
 
-      /* we have to find the Givens rotation which will reduce the element
-        d(j) to zero.
-        if it is already zero we don't have to do anything, except of
-        decreasing j */
-      for (j = n - 1; j >= iq + 1; j--)
-      {
-        /* The Givens rotation is done with the matrix (cc cs, cs -cc).
-        If cc is one, then element (j) of d is zero compared with element
-        (j - 1). Hence we don't have to do anything.
-        If cc is zero, then we just have to switch column (j) and column (j - 1)
-        of J. Since we only switch columns in J, we have to be careful how we
-        update d depending on the sign of gs.
-        Otherwise we have to apply the Givens rotation to these columns.
-        The i - 1 element of d has to be updated to h. */
-        cc = d(j - 1);
-        ss = d(j);
-        h = distance(cc, ss);
-        if (std::fabs(h) < std::numeric_limits<double>::epsilon()) // h == 0
-          continue;
-        d(j) = 0.0;
-        ss = ss / h;
-        cc = cc / h;
-        if (cc < 0.0)
-        {
-          cc = -cc;
-          ss = -ss;
-          d(j - 1) = -h;
-        }
-        else
-          d(j - 1) = h;
-        xny = ss / (1.0 + cc);
-        for (k = 0; k < n; k++)
-        {
-          t1 = J(k, j - 1);
-          t2 = J(k, j);
-          J(k, j - 1) = t1 * cc + t2 * ss;
-          J(k, j) = xny * (t1 + J(k, j - 1)) - t2;
-        }
-      }
-      /* update the number of constraints added*/
-      iq++;
-      /* To update R we have to put the iq components of the d vector
-        into column iq - 1 of R
-        */
-      for (i = 0; i < iq; i++)
-        R(i, iq - 1) = d(i);
-    #ifdef __QPDBG__
-      std::cout << iq << std::endl;
-      print_matrix("R", R, iq, iq);
-      print_matrix("J", J);
-      print_vector("d", d, iq);
-    #endif
-
-      if (std::fabs(d(iq - 1)) <= std::numeric_limits<double>::epsilon() * R_norm)
-      {
-        // problem degenerate
-        return false;
-      }
-      R_norm = std::max<double>(R_norm, std::fabs(d(iq - 1)));
-      return true;
-    }
-
-    static void
-    delete_constraint(Matrix& R, Matrix& J, tvector<int>& Aset, Matrix& u, int n, int p, int& iq, int l)
-    {
-    #ifdef __QPDBG__
-      std::cout << "Delete constraint " << l << ' ' << iq;
-    #endif
-      int i, j, k, qq = -1; // just to prevent warnings from smart compilers
-      double cc, ss, h, xny, t1, t2;
+      if (A.columns() != n)
+        throw Error("'A' has an invalid number of rows");
 
-      /* Find the index qq for active constraint l to be removed */
-      for (i = p; i < iq; i++)
-        if (Aset(i) == l)
-        {
-          qq = i;
-          break;
-        }
+      if (!b.isColumnVector(m))
+        throw Error("'b' has an invalid size");
 
-      /* remove the constraint from the active set and the duals */
-      for (i = qq; i < iq - 1; i++)
+      if (p > 0)
       {
-        Aset(i) = Aset(i + 1);
-        u(i) = u(i + 1);
-        for (j = 0; j < n; j++)
-          R(j, i) = R(j, i + 1);
+        if (Aeq->columns() != n)
+          throw Error("'Aeq' has an invalid number of rows");
+        if (!beq->isColumnVector(p))
+          throw Error("'beq' has an invalid size");
       }
 
-      Aset(iq - 1) = Aset(iq);
-      u(iq - 1) = u(iq);
-      Aset(iq) = 0;
-      u(iq) = 0.0;
-      for (j = 0; j < iq; j++)
-        R(j, iq - 1) = 0.0;
-      /* constraint has been fully removed */
-      iq--;
-    #ifdef __QPDBG__
-      std::cout << '/' << iq << std::endl;
-    #endif
+      prepare(n, p, m);
+      double f_value = run(n, p, m, H.begin(), f.begin(),
+                           p ? Aeq->begin() : NULL, p ? beq->begin() : NULL,
+                           A.begin(), b.begin(), &m_x[0]);
 
-      if (iq == 0)
-        return;
+      // Resize output vector
+      if (!x.isColumnVector(n))
+        x.resize(n, 1);
 
-      for (j = qq; j < iq; j++)
-      {
-        cc = R(j, j);
-        ss = R(j + 1, j);
-        h = distance(cc, ss);
-        if (std::fabs(h) < std::numeric_limits<double>::epsilon()) // h == 0
-          continue;
-        cc = cc / h;
-        ss = ss / h;
-        R(j + 1, j) = 0.0;
-        if (cc < 0.0)
-        {
-          R(j, j) = -h;
-          cc = -cc;
-          ss = -ss;
-        }
-        else
-          R(j, j) = h;
+      for (int i = 0; i < n; i++)
+        x(i) = m_x[i];
 
-        xny = ss / (1.0 + cc);
-        for (k = j + 1; k < iq; k++)
-        {
-          t1 = R(j, k);
-          t2 = R(j + 1, k);
-          R(j, k) = t1 * cc + t2 * ss;
-          R(j + 1, k) = xny * (t1 + R(j, k)) - t2;
-        }
-        for (k = 0; k < n; k++)
-        {
-          t1 = J(k, j);
-          t2 = J(k, j + 1);
-          J(k, j) = t1 * cc + t2 * ss;
-          J(k, j + 1) = xny * (J(k, j) + t1) - t2;
-        }
-      }
+      return f_value;
     }
 
     double
-    distance(double a, double b)
-    {
-      double a1, b1, t;
-      a1 = std::fabs(a);
-      b1 = std::fabs(b);
-      if (a1 > b1)
-      {
-        t = (b1 / a1);
-        return a1 * ::std::sqrt(1.0 + t * t);
-      }
-      else if (b1 > a1)
-      {
-        t = (a1 / b1);
-        return b1 * ::std::sqrt(1.0 + t * t);
-      }
-      return a1 * ::std::sqrt(2.0);
-    }
-
-    static void
-    cholesky_decomposition(Matrix& A)
+    QPSolver::minimize(const Matrix& H, const Matrix& f, const Matrix& A, const Matrix& b, Matrix& x)
     {
-      int i, j, k, n = A.rows();
-      double sum;
-
-      for (i = 0; i < n; i++)
-      {
-        for (j = i; j < n; j++)
-        {
-          sum = A(j, i);
-          for (k = i - 1; k >= 0; k--)
-            sum -= A(k, i) * A(k, j);
-          if (i == j)
-          {
-            if (sum <= 0.0)
-              throw QPSolver::Error("error in Cholesky decomposition");
-            A(i, i) = ::std::sqrt(sum);
-          }
-          else
-          {
-            A(i, j) = sum / A(i, i);
-          }
-        }
-        for (k = i + 1; k < n; k++)
-          A(k, i) = A(i, k);
-      }
+      return minimizeMatrix(H, f, NULL, NULL, A, b, x);
     }
 
-    static void
-    cholesky_solve(const Matrix& L, Matrix& x, const Matrix& b)
-    {
-      Matrix y(L.rows(), 1);
-
-      /* Solve L * y = b */
-      forward_elimination(L, y, b);
-      /* Solve L^T * x = y */
-      backward_elimination(L, x, y);
-    }
-
-    static void
-    forward_elimination(const Matrix& L, Matrix& y, const Matrix& b)
-    {
-      int i, j, n = L.rows();
-
-      y(0) = b(0) / L(0, 0);
-      for (i = 1; i < n; i++)
-      {
-        y(i) = b(i);
-        for (j = 0; j < i; j++)
-          y(i) -= L(i, j) * y(j);
-        y(i) = y(i) / L(i, i);
-      }
-    }
-
-    static void
-    backward_elimination(const Matrix& U, Matrix& x, const Matrix& y)
+    double
+    QPSolver::minimize(const Matrix& H, const Matrix& f, const Matrix& Aeq, const Matrix& beq,
+                       const Matrix& A, const Matrix& b, Matrix& x)
     {
-      int i, j, n = U.rows();
-
-      x(n - 1) = y(n - 1) / U(n - 1, n - 1);
-      for (i = n - 2; i >= 0; i--)
-      {
-        x(i) = y(i);
-        for (j = i + 1; j < n; j++)
-          x(i) -= U(i, j) * x(j);
-        x(i) = x(i) / U(i, i);
-      }
+      return minimizeMatrix(H, f, &Aeq, &beq, A, b, x);
     }
 
-    #ifdef __QPDBG__
-    static void
-    print_matrix(const char* name, const Matrix& A, int n, int m)
+    double
+    QPSolver::solve(const Matrix& H, const Matrix& f, const Matrix& A, const Matrix& b, Matrix& x)
     {
-      std::ostringstream s;
-      std::string t;
-      if (n == -1)
-        n = A.rows();
-      if (m == -1)
-        m = A.columns();
-
-      s << name << ": " << std::endl;
-      for (int i = 0; i < n; i++)
-      {
-        s << " ";
-        for (int j = 0; j < m; j++)
-          s << A(i, j) << ", ";
-        s << std::endl;
-      }
-      t = s.str();
-      t = t.substr(0, t.size() - 3); // To remove the trailing space, comma and newline
-
-      std::cout << t << std::endl;
+      QPSolver qp;
+      qp.setWarmStart(false);
+      return qp.minimize(H, f, A, b, x);
     }
 
-    template <typename T>
-    static void
-    print_vector(const char* name, const tvector<T>& v, int n)
+    double
+    QPSolver::solve(const Matrix& H, const Matrix& f, const Matrix& Aeq, const Matrix& beq, const Matrix& A, const Matrix& b, Matrix& x)
     {
-      std::ostringstream s;
-      std::string t;
-      if (n == -1)
-        n = v.size();
-
-      s << name << ": " << std::endl << " ";
-      for (int i = 0; i < n; i++)
-      {
-        s << v(i) << ", ";
-      }
-      t = s.str();
-      t = t.substr(0, t.size() - 2); // To remove the trailing space and comma
-
-      std::cout << t << std::endl;
+      QPSolver qp;
+      qp.setWarmStart(false);
+      return qp.minimize(H, f, Aeq, beq, A, b, x);
     }
-
-#endif
   }
 }
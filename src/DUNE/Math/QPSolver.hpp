@@ -30,9 +30,14 @@
 #ifndef DUNE_MATH_QP_SOLVER_HPP_INCLUDED_
 #define DUNE_MATH_QP_SOLVER_HPP_INCLUDED_
 
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <vector>
+
 // DUNE headers.
 #include <DUNE/Config.hpp>
 #include <DUNE/Math/Matrix.hpp>
+#include <DUNE/Math/FixedMatrix.hpp>
 
 namespace DUNE
 {
@@ -41,7 +46,19 @@ namespace DUNE
     // Export DLL Symbol.
     class DUNE_DLL_SYM QPSolver;
 
-    //! Quadratic programming solver.
+    //! Quadratic programming solver (Goldfarb-Idnani dual active set
+    //! method).
+    //!
+    //! Constraints follow the Quadprog++ convention: inequalities are
+    //! satisfied when A x + b >= 0 and equalities when Aeq x + beq = 0.
+    //!
+    //! The static solve() methods are one-shot. Control loops that
+    //! solve a similar problem at every step should keep a QPSolver
+    //! instance and call minimize(): the workspace is kept between
+    //! calls (no allocations once sized), the factorization of H is
+    //! reused while H does not change, the search starts from the
+    //! previous active set, and each solve can be bounded in number
+    //! of iterations and wall-clock time.
     class QPSolver
     {
     public:
@@ -54,19 +71,172 @@ namespace DUNE
         { }
       };
 
+      //! Solver statistics.
+      struct Statistics
+      {
+        //! Constraints added to the active set in the last solve.
+        unsigned iterations;
+        //! Active inequality constraints at the last solution.
+        unsigned active;
+        //! True if the last solve reached the optimum.
+        bool converged;
+        //! True if the last solve reused the factorization of H.
+        bool factorization_reused;
+        //! Duration of the last solve in seconds.
+        double solve_time;
+        //! Longest solve in seconds.
+        double max_solve_time;
+        //! Number of solves.
+        unsigned solves;
+        //! Number of solves stopped by the iteration or time budget.
+        unsigned interrupted;
+      };
+
+      //! Constructor.
+      QPSolver(void);
+
+      //! Limit the number of iterations of each solve.
+      //! @param[in] count maximum number of iterations (0 for no limit).
+      void
+      setMaximumIterations(unsigned count)
+      {
+        m_max_iterations = count;
+      }
+
+      //! Limit the duration of each solve.
+      //! @param[in] seconds time budget (0 for no limit).
+      void
+      setTimeBudget(double seconds)
+      {
+        m_time_budget = seconds;
+      }
+
+      //! Enable or disable warm starting from the previous active set.
+      //! @param[in] enabled true to enable warm starting.
+      void
+      setWarmStart(bool enabled)
+      {
+        m_warm_start = enabled;
+        m_warm_count = 0;
+      }
+
+      //! Forget the previous active set, factorization and statistics.
+      void
+      reset(void);
+
+      //! Retrieve solver statistics.
+      //! @return statistics.
+      const Statistics&
+      getStatistics(void) const
+      {
+        return m_stats;
+      }
+
       //! Minimize
       //!   0.5 x' H x + f' x
       //! subject to:
-      //!   A x <= b
+      //!   A x + b >= 0
+      //! If the iteration or time budget runs out the current iterate,
+      //! which may violate some inequalities, is returned and
+      //! Statistics::converged is false.
+      //! @return value of the objective function at x.
+      double
+      minimize(const Matrix& H, const Matrix& f, const Matrix& A, const Matrix& b, Matrix& x);
+
+      //! Minimize
+      //!   0.5 x' H x + f' x
+      //! subject to:
+      //!   A x + b >= 0  and Aeq x + beq = 0
+      //! @return value of the objective function at x.
+      double
+      minimize(const Matrix& H, const Matrix& f, const Matrix& Aeq, const Matrix& beq,
+               const Matrix& A, const Matrix& b, Matrix& x);
+
+      //! Fixed-size version of minimize() for small problems.
+      template <size_t N, size_t M>
+      double
+      minimize(const FixedMatrix<N, N>& H, const FixedMatrix<N, 1>& f,
+               const FixedMatrix<M, N>& A, const FixedMatrix<M, 1>& b,
+               FixedMatrix<N, 1>& x)
+      {
+        return run(N, 0, M, H.data(), f.data(), NULL, NULL, A.data(), b.data(), x.data());
+      }
+
+      //! Fixed-size version of minimize() with equality constraints.
+      template <size_t N, size_t P, size_t M>
+      double
+      minimize(const FixedMatrix<N, N>& H, const FixedMatrix<N, 1>& f,
+               const FixedMatrix<P, N>& Aeq, const FixedMatrix<P, 1>& beq,
+               const FixedMatrix<M, N>& A, const FixedMatrix<M, 1>& b,
+               FixedMatrix<N, 1>& x)
+      {
+        return run(N, P, M, H.data(), f.data(), Aeq.data(), beq.data(), A.data(), b.data(), x.data());
+      }
+
+      //! Minimize
+      //!   0.5 x' H x + f' x
+      //! subject to:
+      //!   A x + b >= 0
       static double
       solve(const Matrix& H, const Matrix& f, const Matrix& A, const Matrix& b, Matrix& x);
 
       //! Minimize
       //!   0.5 x' H x + f' x
       //! subject to:
-      //!   A x <= b  and Aeq x = beq
+      //!   A x + b >= 0  and Aeq x + beq = 0
       static double
       solve(const Matrix& H, const Matrix& f, const Matrix& Aeq, const Matrix& beq, const Matrix& A, const Matrix& b, Matrix& x);
+
+    private:
+      //! Maximum number of iterations per solve.
+      unsigned m_max_iterations;
+      //! Time budget per solve.
+      double m_time_budget;
+      //! True to warm start from the previous active set.
+      bool m_warm_start;
+      //! Statistics.
+      Statistics m_stats;
+      //! Dimensions of the workspace (variables, equalities, inequalities).
+      size_t m_n, m_p, m_m;
+      //! True if m_hc/m_h0/m_j0 hold a valid factorization.
+      bool m_factored;
+      //! Copy of the last H, its Cholesky factor and inverse factor.
+      std::vector<double> m_hc, m_h0, m_j0;
+      //! Trace of H and trace of its inverse factor.
+      double m_c1, m_c2;
+      //! Working matrices (n x n).
+      std::vector<double> m_r, m_j;
+      //! Working vectors of size n.
+      std::vector<double> m_z, m_d, m_np, m_x, m_x_old;
+      //! Working vectors of size m + p.
+      std::vector<double> m_s, m_rv, m_u, m_u_old;
+      //! Active set, saved active set and inactive constraint markers.
+      std::vector<int> m_aset, m_aset_old, m_iai;
+      //! Constraints excluded due to linear dependence.
+      std::vector<unsigned char> m_iaexcl;
+      //! Active inequalities of the previous solution.
+      std::vector<int> m_warm;
+      //! Number of entries in m_warm.
+      size_t m_warm_count;
+
+      //! Size the workspace.
+      void
+      prepare(size_t n, size_t p, size_t m);
+
+      //! Solve the problem given as row-major arrays.
+      double
+      run(size_t nvars, size_t neq, size_t nineq, const double* H, const double* f,
+          const double* Aeq, const double* beq, const double* A, const double* b,
+          double* x);
+
+      //! Update statistics and save the active set at the end of a solve.
+      double
+      finish(double f_value, int iq, size_t p, double start, bool converged);
+
+      //! Validate dimensions and solve.
+      double
+      minimizeMatrix(const Matrix& H, const Matrix& f, const Matrix* Aeq, const Matrix* beq,
+                     const Matrix& A, const Matrix& b, Matrix& x);
     };
   }
 }
@@ -37,5 +37,6 @@
 #include <DUNE/Math/Random/FSR256.hpp>
 #include <DUNE/Math/Random/MT19937.hpp>
 #include <DUNE/Math/Random/KernelDevice.hpp>
+#include <DUNE/Math/Random/Xoshiro256.hpp>
 
 #endif
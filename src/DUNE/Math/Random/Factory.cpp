@@ -37,6 +37,7 @@
 #include <DUNE/Math/Random/FSR256.hpp>
 #include <DUNE/Math/Random/MT19937.hpp>
 #include <DUNE/Math/Random/KernelDevice.hpp>
+#include <DUNE/Math/Random/Xoshiro256.hpp>
 
 namespace DUNE
 {
@@ -49,13 +50,15 @@ namespace DUNE
       const char* Factory::c_default = c_fsr256;
       const char* Factory::c_mt19937 = "mt19937";
       const char* Factory::c_krng = "krng";
+      const char* Factory::c_xoshiro256 = "xoshiro256";
 
       enum GType
       {
         G_DRAND48,
         G_FSR256,
         G_MT19937,
-        G_KRNG
+        G_KRNG,
+        G_XOSHIRO256
       };
 
       typedef std::pair<std::string, GType> GEntry;
@@ -67,6 +70,7 @@ namespace DUNE
         GEntry(Factory::c_fsr256, G_FSR256),
         GEntry(Factory::c_mt19937, G_MT19937),
         GEntry(Factory::c_krng, G_KRNG),
+        GEntry(Factory::c_xoshiro256, G_XOSHIRO256),
       };
 
       DUNE_DECLARE_STATIC_MAP(id2type, std::string, GType, entries);
@@ -95,10 +99,21 @@ namespace DUNE
             return new MT19937(seed_value);
           case G_KRNG:
             return new KernelDevice(); // can not seed
+          case G_XOSHIRO256:
+            return new Xoshiro256(seed_value);
           default:
             throw Generator::Error("internal factory error");
         }
       }
+
+      Generator*
+      Factory::create(const std::string& id, int32_t seed_value, const std::string& stream)
+      {
+        if (seed_value >= 0)
+          seed_value = Generator::deriveSeed(seed_value, stream);
+
+        return create(id, seed_value);
+      }
     }
   }
 }
@@ -52,12 +52,21 @@ namespace DUNE
         static const char* c_default;   //!< "fsr256"
         static const char* c_mt19937;   //!< "mt19337"
         static const char* c_krng;      //!< "krng"
+        static const char* c_xoshiro256; //!< "xoshiro256"
 
         //! Create generator with given seed. If seed is negative and
         //! the generator is not "krng" a random seed will be
         //! generated.
         static Generator*
         create(const std::string& id, int32_t seed = -1);
+
+        //! Create generator for a named stream of a master seed.
+        //! Generators created with the same master seed and
+        //! different stream names (e.g., task names) produce
+        //! different but reproducible sequences. If seed is negative
+        //! a random seed is used, as in create(id, seed).
+        static Generator*
+        create(const std::string& id, int32_t seed, const std::string& stream);
       };
     }
   }
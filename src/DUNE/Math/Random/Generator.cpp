@@ -73,6 +73,26 @@ namespace DUNE
         return seed;
       }
 
+      int32_t
+      Generator::deriveSeed(int32_t master, const std::string& stream)
+      {
+        // FNV-1a hash of the stream name.
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < stream.size(); ++i)
+        {
+          h ^= (uint8_t)stream[i];
+          h *= 0x100000001b3ULL;
+        }
+
+        // SplitMix64 finalizer of master seed and hash.
+        uint64_t z = (uint64_t)(uint32_t)master + h * 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        z ^= z >> 31;
+
+        return (int32_t)(z & (uint64_t)c_max_random);
+      }
+
       double
       Generator::uniform(void)
       {
@@ -95,6 +115,20 @@ namespace DUNE
         return y * std::sqrt(-2.0 * std::log(r2) / r2);
       }
 
+      void
+      Generator::fillUniform(double* out, size_t count)
+      {
+        for (size_t i = 0; i < count; ++i)
+          out[i] = uniform();
+      }
+
+      void
+      Generator::fillGaussian(double* out, size_t count)
+      {
+        for (size_t i = 0; i < count; ++i)
+          out[i] = gaussian();
+      }
+
       void
       Generator::ballU(double radius, double* x, double* y)
       {
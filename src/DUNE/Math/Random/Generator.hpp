@@ -31,6 +31,7 @@
 #define DUNE_MATH_RANDOM_GENERATOR_HPP_INCLUDED_
 
 // ISO C++ 98 headers.
+#include <cstddef>
 #include <stdexcept>
 #include <string>
 
@@ -75,6 +76,15 @@ namespace DUNE
         static int32_t
         arbitrarySeed(void);
 
+        //! Derive the seed of a named stream from a master seed.
+        //! Tasks sharing the same master seed get different but
+        //! reproducible sequences.
+        //! @param master master seed.
+        //! @param stream stream name (e.g., task name).
+        //! @return derived seed, in [0,c_max_random].
+        static int32_t
+        deriveSeed(int32_t master, const std::string& stream);
+
         //! Re-initialize generator with given seed.
         //! @param value value for seed.
         virtual void
@@ -103,9 +113,9 @@ namespace DUNE
         }
 
         //! Generate gaussian number with mean 0 and std. dev 1.
-        //! The number is generated using the Box-Muller method.
+        //! Default implementation uses the Box-Muller method.
         //! @return number with gaussian distribution (0,1).
-        double
+        virtual double
         gaussian(void);
 
         //! Generate number with a Gaussian distribution,
@@ -120,6 +130,35 @@ namespace DUNE
                  gaussian();
         }
 
+        //! Fill an array with numbers uniformly distributed in [0,1].
+        //! Default implementation calls uniform() for each element.
+        //! @param out output array.
+        //! @param count number of elements.
+        virtual void
+        fillUniform(double* out, size_t count);
+
+        //! Fill an array with gaussian numbers with mean 0 and
+        //! std. dev 1. Default implementation calls gaussian() for
+        //! each element.
+        //! @param out output array.
+        //! @param count number of elements.
+        virtual void
+        fillGaussian(double* out, size_t count);
+
+        //! Fill an array with gaussian numbers for a given mean and
+        //! standard deviation.
+        //! @param out output array.
+        //! @param count number of elements.
+        //! @param mu mean of distribution.
+        //! @param sigma std. dev. of distribution.
+        void
+        fillGaussian(double* out, size_t count, double mu, double sigma)
+        {
+          fillGaussian(out, count);
+          for (size_t i = 0; i < count; ++i)
+            out[i] = mu + sigma * out[i];
+        }
+
         // Generate coordinates (x,y) in relation to (0,0), such
         // that:
         // - Distance to (0,0) is uniformly distributed in [0,radius].
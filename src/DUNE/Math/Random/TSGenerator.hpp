@@ -46,6 +46,8 @@ namespace DUNE
       class TSGenerator: public Generator
       {
       public:
+        using Generator::fillGaussian;
+
         TSGenerator(void):
           m_rng()
         { }
@@ -75,6 +77,27 @@ namespace DUNE
           return m_rng.uniform();
         }
 
+        double
+        gaussian(void)
+        {
+          Concurrency::ScopedMutex lock(m_mtx);
+          return m_rng.gaussian();
+        }
+
+        void
+        fillUniform(double* out, size_t count)
+        {
+          Concurrency::ScopedMutex lock(m_mtx);
+          m_rng.fillUniform(out, count);
+        }
+
+        void
+        fillGaussian(double* out, size_t count)
+        {
+          Concurrency::ScopedMutex lock(m_mtx);
+          m_rng.fillGaussian(out, count);
+        }
+
       private:
         G m_rng;
         DUNE::Concurrency::Mutex m_mtx;
@@ -0,0 +1,278 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/Math/Random/Xoshiro256.hpp>
+
+namespace DUNE
+{
+  namespace Math
+  {
+    namespace Random
+    {
+      //! Number of ziggurat layers.
+      static const int c_zig_layers = 128;
+      //! Start of the right tail.
+      static const double c_zig_r = 3.442619855899;
+      //! Area of each layer.
+      static const double c_zig_v = 9.91256303526217e-3;
+      //! 2^-53.
+      static const double c_two_m53 = 1.0 / 9007199254740992.0;
+
+      //! Ziggurat tables (Doornik, "An Improved Ziggurat Method to
+      //! Generate Normal Random Samples", 2005).
+      struct ZigguratTables
+      {
+        double x[c_zig_layers + 1];
+        double ratio[c_zig_layers];
+
+        ZigguratTables(void)
+        {
+          double f = std::exp(-0.5 * c_zig_r * c_zig_r);
+          x[0] = c_zig_v / f;
+          x[1] = c_zig_r;
+          x[c_zig_layers] = 0.0;
+
+          for (int i = 2; i < c_zig_layers; ++i)
+          {
+            x[i] = std::sqrt(-2.0 * std::log(c_zig_v / x[i - 1] + f));
+            f = std::exp(-0.5 * x[i] * x[i]);
+          }
+
+          for (int i = 0; i < c_zig_layers; ++i)
+            ratio[i] = x[i + 1] / x[i];
+        }
+      };
+
+      static const ZigguratTables s_zig;
+
+      static inline uint64_t
+      rotl(uint64_t x, int k)
+      {
+        return (x << k) | (x >> (64 - k));
+      }
+
+      static inline uint64_t
+      splitmix64(uint64_t& x)
+      {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+      }
+
+      //! Advance a single xoshiro256 state.
+      static inline void
+      advance(uint64_t* s)
+      {
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+      }
+
+      //! Advance a single xoshiro256 state by 2^128 draws.
+      static void
+      jump(uint64_t* s)
+      {
+        static const uint64_t c_jump[] =
+        {
+          0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+          0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+        };
+
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (int i = 0; i < 4; ++i)
+        {
+          for (int b = 0; b < 64; ++b)
+          {
+            if (c_jump[i] & ((uint64_t)1 << b))
+            {
+              for (int w = 0; w < 4; ++w)
+                t[w] ^= s[w];
+            }
+            advance(s);
+          }
+        }
+
+        for (int w = 0; w < 4; ++w)
+          s[w] = t[w];
+      }
+
+      static inline double
+      toUniform(uint64_t bits)
+      {
+        return (bits >> 11) * c_two_m53;
+      }
+
+      Xoshiro256::Xoshiro256(void)
+      {
+        seed(arbitrarySeed());
+      }
+
+      Xoshiro256::Xoshiro256(int32_t value)
+      {
+        seed(value);
+      }
+
+      Xoshiro256::~Xoshiro256(void)
+      { }
+
+      void
+      Xoshiro256::seed(int32_t value)
+      {
+        uint64_t sm = (uint64_t)(uint32_t)value;
+        uint64_t s[4];
+        for (int w = 0; w < 4; ++w)
+          s[w] = splitmix64(sm);
+
+        for (unsigned l = 0; l < c_lanes; ++l)
+        {
+          if (l > 0)
+            jump(s);
+
+          for (int w = 0; w < 4; ++w)
+            m_state[w][l] = s[w];
+        }
+
+        m_index = c_lanes;
+      }
+
+      void
+      Xoshiro256::step(uint64_t* out)
+      {
+        uint64_t* s0 = m_state[0];
+        uint64_t* s1 = m_state[1];
+        uint64_t* s2 = m_state[2];
+        uint64_t* s3 = m_state[3];
+
+        for (unsigned l = 0; l < c_lanes; ++l)
+        {
+          out[l] = rotl(s0[l] + s3[l], 23) + s0[l];
+
+          uint64_t t = s1[l] << 17;
+          s2[l] ^= s0[l];
+          s3[l] ^= s1[l];
+          s1[l] ^= s2[l];
+          s0[l] ^= s3[l];
+          s2[l] ^= t;
+          s3[l] = rotl(s3[l], 45);
+        }
+      }
+
+      int32_t
+      Xoshiro256::random(void)
+      {
+        return (int32_t)(next() >> 33);
+      }
+
+      double
+      Xoshiro256::uniform(void)
+      {
+        return toUniform(next());
+      }
+
+      double
+      Xoshiro256::ziggurat(uint64_t bits)
+      {
+        while (true)
+        {
+          // Low 7 bits select the layer, high 53 bits the abscissa.
+          int i = (int)(bits & (c_zig_layers - 1));
+          double u = 2.0 * toUniform(bits) - 1.0;
+
+          if (std::fabs(u) < s_zig.ratio[i])
+            return u * s_zig.x[i];
+
+          if (i == 0)
+          {
+            // Tail beyond c_zig_r.
+            double x, y;
+            do
+            {
+              x = std::log(toUniform(next()) + 0.5 * c_two_m53) / c_zig_r;
+              y = std::log(toUniform(next()) + 0.5 * c_two_m53);
+            }
+            while (-2.0 * y < x * x);
+
+            return (u < 0) ? x - c_zig_r : c_zig_r - x;
+          }
+
+          double x = u * s_zig.x[i];
+          double f0 = std::exp(-0.5 * (s_zig.x[i] * s_zig.x[i] - x * x));
+          double f1 = std::exp(-0.5 * (s_zig.x[i + 1] * s_zig.x[i + 1] - x * x));
+          if (f1 + toUniform(next()) * (f0 - f1) < 1.0)
+            return x;
+
+          bits = next();
+        }
+      }
+
+      double
+      Xoshiro256::gaussian(void)
+      {
+        return ziggurat(next());
+      }
+
+      void
+      Xoshiro256::fillUniform(double* out, size_t count)
+      {
+        size_t i = 0;
+
+        // Drain buffered draws first to keep the sequence intact.
+        for (; i < count && m_index < c_lanes; ++i)
+          out[i] = toUniform(m_buffer[m_index++]);
+
+        uint64_t bits[c_lanes];
+        for (; i + c_lanes <= count; i += c_lanes)
+        {
+          step(bits);
+          for (unsigned l = 0; l < c_lanes; ++l)
+            out[i + l] = toUniform(bits[l]);
+        }
+
+        for (; i < count; ++i)
+          out[i] = toUniform(next());
+      }
+
+      void
+      Xoshiro256::fillGaussian(double* out, size_t count)
+      {
+        for (size_t i = 0; i < count; ++i)
+          out[i] = ziggurat(next());
+      }
+    }
+  }
+}
@@ -0,0 +1,117 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_MATH_RANDOM_XOSHIRO256_HPP_INCLUDED_
+#define DUNE_MATH_RANDOM_XOSHIRO256_HPP_INCLUDED_
+
+// DUNE headers.
+#include <DUNE/Math/Random/Generator.hpp>
+
+namespace DUNE
+{
+  namespace Math
+  {
+    namespace Random
+    {
+      // Export DLL Symbol.
+      class DUNE_DLL_SYM Xoshiro256;
+
+      //! xoshiro256++ generator by David Blackman and Sebastiano Vigna.
+      //! See http://prng.di.unimi.it/
+      //!
+      //! Four independent lanes, 2^128 draws apart, are advanced in
+      //! lockstep so that bulk generation vectorizes. The output
+      //! sequence interleaves the lanes and does not depend on how
+      //! draws are requested (one at a time or in batches).
+      //! Gaussian numbers are generated with the ziggurat method.
+      class Xoshiro256: public Generator
+      {
+      public:
+        using Generator::fillGaussian;
+
+        Xoshiro256(void);
+
+        Xoshiro256(int32_t seed);
+
+        ~Xoshiro256(void);
+
+        int32_t
+        random(void);
+
+        double
+        uniform(void);
+
+        double
+        gaussian(void);
+
+        void
+        fillUniform(double* out, size_t count);
+
+        void
+        fillGaussian(double* out, size_t count);
+
+        void
+        seed(int32_t value);
+
+      private:
+        //! Number of lanes.
+        static const unsigned c_lanes = 4;
+        //! Lane states, word-major (m_state[word][lane]).
+        uint64_t m_state[4][c_lanes];
+        //! Last output of all lanes.
+        uint64_t m_buffer[c_lanes];
+        //! Next unused entry of m_buffer.
+        unsigned m_index;
+
+        //! Advance all lanes.
+        //! @param out output of each lane.
+        void
+        step(uint64_t* out);
+
+        //! Next 64-bit output.
+        uint64_t
+        next(void)
+        {
+          if (m_index == c_lanes)
+          {
+            step(m_buffer);
+            m_index = 0;
+          }
+
+          return m_buffer[m_index++];
+        }
+
+        //! Gaussian number from a 64-bit draw.
+        double
+        ziggurat(uint64_t bits);
+      };
+    }
+  }
+}
+#endif
@@ -0,0 +1,180 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_MATH_RUNNING_STATISTICS_HPP_INCLUDED_
+#define DUNE_MATH_RUNNING_STATISTICS_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <vector>
+#include <cmath>
+
+namespace DUNE
+{
+  namespace Math
+  {
+    //! Windowed sample statistics over a fixed-size ring buffer. The
+    //! mean and the sum of squared deviations are updated on every
+    //! sample (Welford's method with removal of the oldest sample), so
+    //! all estimates are O(1) regardless of the window size.
+    template <typename T>
+    class RunningStatistics
+    {
+    public:
+      //! Constructor.
+      //! @param[in] window_size maximum number of samples in the window.
+      RunningStatistics(unsigned window_size):
+        m_window(window_size > 0 ? window_size : 1)
+      {
+        clear();
+      }
+
+      //! Clear sample.
+      void
+      clear(void)
+      {
+        m_size = 0;
+        m_oldest = 0;
+        m_mean = 0;
+        m_m2 = 0;
+      }
+
+      //! Update sample with new value, replacing the oldest value if
+      //! the window is full.
+      //! @param[in] value new value.
+      //! @return mean value.
+      T
+      update(const T& value)
+      {
+        if (m_size < windowSize())
+        {
+          m_window[m_size++] = value;
+
+          T delta = value - m_mean;
+          m_mean += delta / m_size;
+          m_m2 += delta * (value - m_mean);
+        }
+        else
+        {
+          T old = m_window[m_oldest];
+          m_window[m_oldest] = value;
+          m_oldest = (m_oldest + 1) % windowSize();
+
+          T old_mean = m_mean;
+          T delta = value - old;
+          m_mean += delta / m_size;
+          m_m2 += delta * (value - m_mean + old - old_mean);
+        }
+
+        // Guard against round-off driving the accumulator negative.
+        if (m_m2 < 0)
+          m_m2 = 0;
+
+        return m_mean;
+      }
+
+      //! Extract mean value of the sample.
+      //! @return mean value.
+      T
+      mean(void) const
+      {
+        return m_mean;
+      }
+
+      //! Extract (population) variance of the sample.
+      //! @return variance value.
+      T
+      variance(void) const
+      {
+        if (!m_size)
+          return 0;
+
+        return m_m2 / m_size;
+      }
+
+      //! Extract standard deviation of the sample.
+      //! @return standard deviation value.
+      T
+      stdev(void) const
+      {
+        return std::sqrt(variance());
+      }
+
+      //! Extract the standard error of the sample mean, using the
+      //! unbiased variance estimate.
+      //! @return standard error of the mean.
+      T
+      standardError(void) const
+      {
+        if (m_size < 2)
+          return 0;
+
+        return std::sqrt(m_m2 / (m_size - 1) / m_size);
+      }
+
+      //! Half-width of the confidence interval of the sample mean.
+      //! @param[in] z number of standard errors (1.96 for 95%).
+      //! @return half-width of the confidence interval.
+      T
+      confidence(T z = 1.96) const
+      {
+        return z * standardError();
+      }
+
+      //! Know size of sample.
+      //! @return size of the sample.
+      unsigned
+      sampleSize(void) const
+      {
+        return m_size;
+      }
+
+      //! Know size of window.
+      //! @return size of the window.
+      unsigned
+      windowSize(void) const
+      {
+        return (unsigned)m_window.size();
+      }
+
+    private:
+      //! Window.
+      std::vector<T> m_window;
+      //! Number of samples in the window.
+      unsigned m_size;
+      //! Index of oldest value.
+      unsigned m_oldest;
+      //! Sample mean.
+      T m_mean;
+      //! Sum of squared deviations from the mean.
+      T m_m2;
+    };
+  }
+}
+
+#endif
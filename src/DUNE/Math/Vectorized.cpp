@@ -0,0 +1,182 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+// == Implementation notes ==
+//
+// sin/cos: Cody-Waite reduction modulo pi/2 followed by the minimax
+// polynomials of the FreeBSD/fdlibm kernels (k_sin.c, k_cos.c).
+//
+// atan2: reduction to [0, 1] by swapping arguments, then the rational
+// approximation of the Cephes library (atan.c).
+//
+// Both sides of every select are computed unconditionally; with
+// -fno-trapping-math (see cmake/Compiler.cmake) GCC turns the loops
+// into SIMD code at -O3.
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/Math/Constants.hpp>
+#include <DUNE/Math/Vectorized.hpp>
+
+namespace DUNE
+{
+  namespace Math
+  {
+    //! 2/pi.
+    static const double c_two_over_pi = 6.36619772367581382433e-01;
+    //! First 33 bits of pi/2.
+    static const double c_pio2_1 = 1.57079632673412561417e+00;
+    //! Next 33 bits of pi/2.
+    static const double c_pio2_2 = 6.07710050630396597660e-11;
+    //! pi/2 - (c_pio2_1 + c_pio2_2).
+    static const double c_pio2_2t = 2.02226624879595063154e-21;
+    //! Adding and subtracting rounds to the nearest integer.
+    static const double c_round = 6755399441055744.0;
+    //! Largest argument reduced without loss of accuracy.
+    static const double c_max_reduce = 1e5;
+
+    // Sine polynomial.
+    static const double c_s1 = -1.66666666666666324348e-01;
+    static const double c_s2 = 8.33333333332248946124e-03;
+    static const double c_s3 = -1.98412698298579493134e-04;
+    static const double c_s4 = 2.75573137070700676789e-06;
+    static const double c_s5 = -2.50507602534068634195e-08;
+    static const double c_s6 = 1.58969099521155010221e-10;
+
+    // Cosine polynomial.
+    static const double c_c1 = 4.16666666666666019037e-02;
+    static const double c_c2 = -1.38888888888741095749e-03;
+    static const double c_c3 = 2.48015872894767294178e-05;
+    static const double c_c4 = -2.75573143513906633035e-07;
+    static const double c_c5 = 2.08757232129817482790e-09;
+    static const double c_c6 = -1.13596475577881948265e-11;
+
+    // Arc tangent rational approximation.
+    static const double c_p0 = -8.750608600031904122785e-01;
+    static const double c_p1 = -1.615753718733365076637e+01;
+    static const double c_p2 = -7.500855792314704667340e+01;
+    static const double c_p3 = -1.228866684490136173410e+02;
+    static const double c_p4 = -6.485021904942025371773e+01;
+    static const double c_q0 = 2.485846490142306297962e+01;
+    static const double c_q1 = 1.650270098316988542046e+02;
+    static const double c_q2 = 4.328810604912902668951e+02;
+    static const double c_q3 = 4.853903996359136964868e+02;
+    static const double c_q4 = 1.945506571482613964425e+02;
+    //! Low order bits of pi/4.
+    static const double c_morebits = 6.123233995736765886130e-17;
+
+    //! Round to nearest integer (|x| < 2^51).
+    static inline double
+    roundNearest(double x)
+    {
+      return (x + c_round) - c_round;
+    }
+
+    void
+    Vectorized::sincos(const double* x, double* s, double* c, size_t count)
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        double k = roundNearest(x[i] * c_two_over_pi);
+        double r = ((x[i] - k * c_pio2_1) - k * c_pio2_2) - k * c_pio2_2t;
+
+        // Quadrant (k mod 4) computed in floating point.
+        double k4 = k * 0.25;
+        double h = roundNearest(k4);
+        double h1 = h - 1.0;
+        h = (h > k4) ? h1 : h;
+        double q = k - 4.0 * h;
+
+        double z = r * r;
+        double ps = r + r * z * (c_s1 + z * (c_s2 + z * (c_s3 + z * (c_s4 + z * (c_s5 + z * c_s6)))));
+        double pc = 1.0 - 0.5 * z + z * z * (c_c1 + z * (c_c2 + z * (c_c3 + z * (c_c4 + z * (c_c5 + z * c_c6)))));
+
+        // Quadrant: 0 -> (s, c), 1 -> (c, -s), 2 -> (-s, -c), 3 -> (-c, s).
+        bool odd = (q == 1.0) | (q == 3.0);
+        double vs = odd ? pc : ps;
+        double vc = odd ? ps : pc;
+        s[i] = (q >= 2.0) ? -vs : vs;
+        c[i] = ((q == 1.0) | (q == 2.0)) ? -vc : vc;
+      }
+
+      // Arguments too large for the reduction above.
+      for (size_t i = 0; i < count; ++i)
+      {
+        if (!(std::fabs(x[i]) < c_max_reduce))
+        {
+          s[i] = std::sin(x[i]);
+          c[i] = std::cos(x[i]);
+        }
+      }
+    }
+
+    void
+    Vectorized::atan2(const double* y, const double* x, double* r, size_t count)
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        double ay = std::fabs(y[i]);
+        double ax = std::fabs(x[i]);
+        bool swap = ay > ax;
+        double num = swap ? ax : ay;
+        double den = swap ? ay : ax;
+        den = (den == 0.0) ? 1.0 : den;
+        double t = num / den;
+
+        // atan(t) for t in [0, 1].
+        bool mid = t > 0.66;
+        double tm = (t - 1.0) / (t + 1.0);
+        double v = mid ? tm : t;
+        double z = v * v;
+        double p = (((c_p0 * z + c_p1) * z + c_p2) * z + c_p3) * z + c_p4;
+        double q = ((((z + c_q0) * z + c_q1) * z + c_q2) * z + c_q3) * z + c_q4;
+        double a = v + v * z * (p / q);
+        double am = a + (c_pi / 4.0 + 0.5 * c_morebits);
+        a = mid ? am : a;
+
+        // Undo reduction (FP operations are computed unconditionally
+        // so that the selects can be vectorized).
+        double as = c_half_pi - a;
+        a = swap ? as : a;
+        double ax2 = c_pi - a;
+        a = (x[i] < 0.0) ? ax2 : a;
+        r[i] = (y[i] < 0.0) ? -a : a;
+      }
+
+      // Infinities and NaN.
+      for (size_t i = 0; i < count; ++i)
+      {
+        if (r[i] != r[i])
+          r[i] = std::atan2(y[i], x[i]);
+      }
+    }
+  }
+}
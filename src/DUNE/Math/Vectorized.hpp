@@ -24,94 +24,53 @@
 // https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
 // http://ec.europa.eu/idabc/eupl.html.                                     *
 //***************************************************************************
-// Author: Eduardo Marques                                                  *
+// Author: Ricardo Martins                                                  *
 //***************************************************************************
 
-#ifndef SIMULATORS_ENVIRONMENT_QUAD_TREE_HPP_INCLUDED_
-#define SIMULATORS_ENVIRONMENT_QUAD_TREE_HPP_INCLUDED_
+#ifndef DUNE_MATH_VECTORIZED_HPP_INCLUDED_
+#define DUNE_MATH_VECTORIZED_HPP_INCLUDED_
 
 // ISO C++ 98 headers.
-#include <iomanip>
-#include <iostream>
-#include <vector>
+#include <cstddef>
 
 // DUNE headers.
 #include <DUNE/Config.hpp>
 
-// Local headers.
-#include "Point.hpp"
-#include "Bounds.hpp"
-
-namespace Simulators
+namespace DUNE
 {
-  namespace Environment
+  namespace Math
   {
-    //! Forward declaration.
-    struct Node;
-
-    //! "Quad-tree" structure used to index spatial data in two dimensions.
-    class QuadTree
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM Vectorized;
+
+    //! Elementary functions over arrays.
+    //!
+    //! The loops are branch free so that the compiler can vectorize
+    //! them for the target instruction set (SSE2/AVX, NEON). Results
+    //! agree with the C library within a few units in the last
+    //! place: |error| < 4e-16 for sin/cos with |x| < 1e5 (larger
+    //! arguments fall back to the C library) and |error| < 5e-16 for
+    //! atan2.
+    class Vectorized
     {
     public:
-      //! Item datum.
-      struct Item
-      {
-        double x, y, value;
-      };
-
-      //! Iteration handle.
-      class Iteration
-      {
-      public:
-        virtual void
-        process(const Item& item) = 0;
-
-        virtual
-        ~Iteration(){ }
-      };
-
-      //! Constructor.
-      QuadTree(const Bounds& bounds);
-
-      ~QuadTree();
-
-      //! Insert an item.
-      //! Returns 'false' if item is out-of-bounds.
-      bool
-      insert(const Item& item);
-
-      //! Iterate tree.
-      void
-      iterate(Iteration& iteration) const;
-
-      //! Iterate tree over a given area.
-      void
-      iterate(Iteration& iteration, const Bounds& area) const;
-
-      //! Clear entire tree.
-      void
-      clear(void);
-
-      //! Remove items in a given area.
-      void
-      remove(const Bounds& area);
-
-      //! Search for items in a given area.
-      //! If any are found returns 'true' and adds results to 'item' vector.
-      bool
-      search(const Bounds& area, std::vector<Item>& items) const;
-
-      //! Get number of elements in a given area.
-      uint32_t
-      size(const Bounds& area) const;
-
-    private:
-      Bounds m_bounds;     //!< Bounds.
-      Node* m_root;     //!< Node handle providing actual implementation.
+      //! Compute sine and cosine of an array of angles.
+      //! @param[in] x angles (rad).
+      //! @param[out] s sines (must not alias x).
+      //! @param[out] c cosines (must not alias x).
+      //! @param[in] count number of elements.
+      static void
+      sincos(const double* x, double* s, double* c, size_t count);
+
+      //! Compute the four quadrant arc tangent of y/x for arrays.
+      //! @param[in] y numerators.
+      //! @param[in] x denominators.
+      //! @param[out] r results in [-pi, pi] (must not alias y or x).
+      //! Signed zeros are treated as positive.
+      //! @param[in] count number of elements.
+      static void
+      atan2(const double* y, const double* x, double* r, size_t count);
     };
-
-    std::ostream&
-    operator<<(std::ostream& os, const QuadTree& tree);
   }
 }
 
@@ -28,6 +28,10 @@
 // Author: José Braga                                                       *
 //***************************************************************************
 
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstring>
+
 // DUNE headers.
 #include <DUNE/Navigation/KalmanFilter.hpp>
 
@@ -35,12 +39,15 @@ namespace DUNE
 {
   namespace Navigation
   {
+    const double KalmanFilter::c_min_variance = 1e-12;
+
     KalmanFilter::KalmanFilter(void)
     {
       m_state_count = 1;
       Math::Matrix I(1);
       I(0) = 0;
       m_x = m_y = m_ax = m_ap = m_c = m_p = m_q = m_r = m_innov = I;
+      resizeWorkspaces();
     }
 
     KalmanFilter::KalmanFilter(Math::Matrix& A, Math::Matrix& C, Math::Matrix& P, Math::Matrix& Q)
@@ -52,6 +59,23 @@ namespace DUNE
       m_q = Q;
       m_state_count = m_ax.rows();
       m_x.resizeAndFill(m_state_count, 1, 0.0);
+      resizeWorkspaces();
+    }
+
+    void
+    KalmanFilter::resizeWorkspaces(void)
+    {
+      size_t n = m_state_count;
+      size_t m = m_c.rows();
+
+      m_w_pc.resizeAndFill(n, 1, 0.0);
+      m_w_x0.resizeAndFill(n, 1, 0.0);
+      m_w_nn.resizeAndFill(n, n, 0.0);
+      m_w_cp.resizeAndFill(m, n, 0.0);
+      m_w_kt.resizeAndFill(m, n, 0.0);
+      m_w_s.resizeAndFill(m, m, 0.0);
+      m_w_ldl.resizeAndFill(m, m, 0.0);
+      m_w_z.resizeAndFill(m, 1, 0.0);
     }
 
     void
@@ -70,6 +94,7 @@ namespace DUNE
 
       m_ax.identity();
       m_ap.identity();
+      resizeWorkspaces();
     }
 
     bool
@@ -82,6 +107,7 @@ namespace DUNE
         m_c.resizeAndKeep(num_outputs, num_states);
         m_r.resizeAndKeep(num_outputs, num_outputs);
         m_innov.resizeAndKeep(num_outputs, 1);
+        resizeWorkspaces();
         return true;
       }
       else
@@ -104,7 +130,17 @@ namespace DUNE
     void
     KalmanFilter::normalize(void)
     {
-      m_p = 0.5 * (m_p + transpose(m_p));
+      size_t n = m_state_count;
+      double* P = &m_p(0, 0);
+
+      for (size_t i = 0; i < n; ++i)
+      {
+        for (size_t j = i + 1; j < n; ++j)
+        {
+          double v = 0.5 * (P[i * n + j] + P[j * n + i]);
+          P[i * n + j] = P[j * n + i] = v;
+        }
+      }
     }
 
     void
@@ -113,15 +149,61 @@ namespace DUNE
       if (u.rows() != b.columns() || u.columns() != 1)
         throw std::runtime_error(DTR("invalid dimensions"));
 
-      m_x = m_ax * m_x + b * u;
-      m_p = m_ap * m_p * transpose(m_ap) + m_q;
+      predict();
+
+      for (size_t i = 0; i < m_state_count; ++i)
+      {
+        for (int j = 0; j < u.rows(); ++j)
+          m_x(i) += b(i, j) * u(j);
+      }
     }
 
     void
     KalmanFilter::predict(void)
     {
-      m_x = m_ax * m_x;
-      m_p = m_ap * m_p * transpose(m_ap) + m_q;
+      size_t n = m_state_count;
+      const double* A = m_ax.cbegin();
+      double* x = &m_x(0);
+      double* t = &m_w_pc(0);
+
+      // State prediction.
+      for (size_t i = 0; i < n; ++i)
+      {
+        t[i] = 0.0;
+        for (size_t j = 0; j < n; ++j)
+          t[i] += A[i * n + j] * x[j];
+      }
+
+      std::memcpy(x, t, n * sizeof(double));
+
+      // Covariance prediction: Ap * P * Ap' + Q.
+      A = m_ap.cbegin();
+      const double* Q = m_q.cbegin();
+      double* P = &m_p(0, 0);
+      double* W = &m_w_nn(0, 0);
+
+      for (size_t i = 0; i < n; ++i)
+      {
+        for (size_t j = 0; j < n; ++j)
+        {
+          double v = 0.0;
+          for (size_t k = 0; k < n; ++k)
+            v += A[i * n + k] * P[k * n + j];
+          W[i * n + j] = v;
+        }
+      }
+
+      for (size_t i = 0; i < n; ++i)
+      {
+        for (size_t j = i; j < n; ++j)
+        {
+          double v = 0.0;
+          for (size_t k = 0; k < n; ++k)
+            v += W[i * n + k] * A[j * n + k];
+          P[i * n + j] = v + 0.5 * (Q[i * n + j] + Q[j * n + i]);
+          P[j * n + i] = P[i * n + j];
+        }
+      }
     }
 
     int
@@ -139,38 +221,278 @@ namespace DUNE
       if (m_r.rows() != m_r.columns() || m_r.rows() != m_innov.rows())
         throw std::runtime_error(DTR("invalid dimensions"));
 
-      // Measurement prediction covariance.
-      Math::Matrix S = (m_c * m_p * transpose(m_c)) + m_r;
-      Math::Matrix S_1;
+      if (m_w_s.rows() != m_c.rows() || (size_t)m_w_nn.rows() != m_state_count)
+        resizeWorkspaces();
 
-      // Inverse of the measurement prediction covariance.
-      try
+      if (threshold == 0)
       {
-        S_1 = inverse(S);
+        bool diagonal = true;
+        for (int i = 0; i < m_r.rows() && diagonal; ++i)
+        {
+          for (int j = 0; j < m_r.columns(); ++j)
+          {
+            if (i != j && m_r(i, j) != 0.0)
+            {
+              diagonal = false;
+              break;
+            }
+          }
+        }
+
+        if (diagonal)
+          return updateSequential();
       }
-      catch (...)
+
+      return updateBatch(threshold);
+    }
+
+    int
+    KalmanFilter::updateSequential(void)
+    {
+      size_t n = m_state_count;
+      size_t m = m_c.rows();
+      const double* C = m_c.cbegin();
+      const double* R = m_r.cbegin();
+      const double* nu = m_innov.cbegin();
+      double* x = &m_x(0);
+      double* x0 = &m_w_x0(0);
+      double* P = &m_p(0, 0);
+      double* pc = &m_w_pc(0);
+
+      std::memcpy(x0, x, n * sizeof(double));
+
+      for (size_t i = 0; i < m; ++i)
       {
-        throw std::runtime_error(DTR("matrix inversion error"));
+        const double* c = C + i * n;
+
+        // Covariance times observation row.
+        double s = R[i * m + i];
+        bool observed = false;
+        for (size_t r = 0; r < n; ++r)
+        {
+          double v = 0.0;
+          for (size_t k = 0; k < n; ++k)
+            v += P[r * n + k] * c[k];
+          pc[r] = v;
+          s += c[r] * v;
+          observed |= (c[r] != 0.0);
+        }
+
+        if (!observed || s <= c_min_variance * (1.0 + R[i * m + i]))
+          continue;
+
+        // Innovation given by the caller is relative to the state
+        // before the update; account for the outputs already used.
+        double v = nu[i];
+        for (size_t k = 0; k < n; ++k)
+          v -= c[k] * (x[k] - x0[k]);
+
+        // Gain k = pc / s.
+        double inv = 1.0 / s;
+        for (size_t r = 0; r < n; ++r)
+          x[r] += pc[r] * inv * v;
+
+        // Joseph form: (I - k c) P (I - k c)' + k r k'
+        //            = P - k pc' - pc k' + s k k'.
+        for (size_t r = 0; r < n; ++r)
+        {
+          double kr = pc[r] * inv;
+          for (size_t q = r; q < n; ++q)
+          {
+            double kq = pc[q] * inv;
+            double val = P[r * n + q] - kr * pc[q] - pc[r] * kq + s * kr * kq;
+            P[r * n + q] = val;
+            P[q * n + r] = val;
+          }
+        }
       }
 
+      return 0;
+    }
+
+    bool
+    KalmanFilter::factor(void)
+    {
+      size_t m = m_w_s.rows();
+      const double* S = m_w_s.cbegin();
+      double* L = &m_w_ldl(0, 0);
+
+      // Lower triangle holds L (unit diagonal implied), diagonal holds D.
+      for (size_t j = 0; j < m; ++j)
+      {
+        double d = S[j * m + j];
+        for (size_t k = 0; k < j; ++k)
+          d -= L[j * m + k] * L[j * m + k] * L[k * m + k];
+
+        if (d <= c_min_variance * (1.0 + std::fabs(S[j * m + j])))
+        {
+          // Unused outputs (no observation, no noise) are ignored.
+          bool unused = true;
+          for (size_t k = 0; k < m; ++k)
+          {
+            if (S[j * m + k] != 0.0)
+            {
+              unused = false;
+              break;
+            }
+          }
+
+          if (!unused)
+            return false;
+
+          L[j * m + j] = 0.0;
+          for (size_t i = j + 1; i < m; ++i)
+            L[i * m + j] = 0.0;
+          continue;
+        }
+
+        L[j * m + j] = d;
+        for (size_t i = j + 1; i < m; ++i)
+        {
+          double v = S[i * m + j];
+          for (size_t k = 0; k < j; ++k)
+            v -= L[i * m + k] * L[j * m + k] * L[k * m + k];
+          L[i * m + j] = v / d;
+        }
+      }
+
+      return true;
+    }
+
+    void
+    KalmanFilter::solve(double* b, size_t stride) const
+    {
+      size_t m = m_w_ldl.rows();
+      const double* L = m_w_ldl.cbegin();
+
+      for (size_t i = 0; i < m; ++i)
+      {
+        for (size_t k = 0; k < i; ++k)
+          b[i * stride] -= L[i * m + k] * b[k * stride];
+      }
+
+      for (size_t i = 0; i < m; ++i)
+      {
+        double d = L[i * m + i];
+        b[i * stride] = (d == 0.0) ? 0.0 : b[i * stride] / d;
+      }
+
+      for (size_t i = m; i-- > 0;)
+      {
+        for (size_t k = i + 1; k < m; ++k)
+          b[i * stride] -= L[k * m + i] * b[k * stride];
+      }
+    }
+
+    int
+    KalmanFilter::updateBatch(float threshold)
+    {
+      size_t n = m_state_count;
+      size_t m = m_c.rows();
+      const double* C = m_c.cbegin();
+      const double* R = m_r.cbegin();
+      const double* nu = m_innov.cbegin();
+      double* CP = &m_w_cp(0, 0);
+      double* KT = &m_w_kt(0, 0);
+      double* S = &m_w_s(0, 0);
+      double* W = &m_w_nn(0, 0);
+
+      {
+        const double* P = m_p.cbegin();
+
+        // C * P.
+        for (size_t i = 0; i < m; ++i)
+        {
+          for (size_t j = 0; j < n; ++j)
+          {
+            double v = 0.0;
+            for (size_t k = 0; k < n; ++k)
+              v += C[i * n + k] * P[k * n + j];
+            CP[i * n + j] = v;
+          }
+        }
+
+        // Measurement prediction covariance: C * P * C' + R.
+        for (size_t i = 0; i < m; ++i)
+        {
+          for (size_t j = i; j < m; ++j)
+          {
+            double v = 0.5 * (R[i * m + j] + R[j * m + i]);
+            for (size_t k = 0; k < n; ++k)
+              v += CP[i * n + k] * C[j * n + k];
+            S[i * m + j] = S[j * m + i] = v;
+          }
+        }
+      }
+
+      if (!factor())
+        return -1;
+
       // Check if innovation is above a threshold value.
       // Set threshold to 0 to accept everything.
       if (threshold != 0)
       {
-        double level = (transpose(m_innov) * S_1 * m_innov)(0);
+        double* z = &m_w_z(0);
+        std::memcpy(z, nu, m * sizeof(double));
+        solve(z, 1);
+
+        double level = 0.0;
+        for (size_t i = 0; i < m; ++i)
+          level += nu[i] * z[i];
 
         if (level >= threshold)
           return -1;
       }
 
-      // Kalman Gain.
-      Math::Matrix K = m_p * transpose(m_c) * S_1;
+      // Transposed Kalman gain: S^-1 * C * P.
+      std::memcpy(KT, CP, m * n * sizeof(double));
+      for (size_t j = 0; j < n; ++j)
+        solve(KT + j, n);
 
       // State update.
-      m_x = m_x + K * m_innov;
+      double* x = &m_x(0);
+      for (size_t r = 0; r < n; ++r)
+      {
+        for (size_t i = 0; i < m; ++i)
+          x[r] += KT[i * n + r] * nu[i];
+      }
 
-      // State Covariance update.
-      m_p = m_p - K * m_c * m_p;
+      // Joseph form: P - K C P - (K C P)' + K S K'.
+      for (size_t r = 0; r < n; ++r)
+      {
+        for (size_t q = 0; q < n; ++q)
+        {
+          double v = 0.0;
+          for (size_t i = 0; i < m; ++i)
+            v += KT[i * n + r] * CP[i * n + q];
+          W[r * n + q] = v;
+        }
+      }
+
+      // S * K' (C * P is no longer needed).
+      for (size_t i = 0; i < m; ++i)
+      {
+        for (size_t q = 0; q < n; ++q)
+        {
+          double v = 0.0;
+          for (size_t k = 0; k < m; ++k)
+            v += S[i * m + k] * KT[k * n + q];
+          CP[i * n + q] = v;
+        }
+      }
+
+      double* P = &m_p(0, 0);
+      for (size_t r = 0; r < n; ++r)
+      {
+        for (size_t q = r; q < n; ++q)
+        {
+          double v = P[r * n + q] - W[r * n + q] - W[q * n + r];
+          for (size_t i = 0; i < m; ++i)
+            v += KT[i * n + r] * CP[i * n + q];
+          P[r * n + q] = v;
+          P[q * n + r] = v;
+        }
+      }
 
       return 0;
     }
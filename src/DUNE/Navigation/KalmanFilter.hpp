@@ -103,9 +103,15 @@ namespace DUNE
       void
       predict(void);
 
-      //! Kalman Filter update function.
+      //! Kalman Filter update function. With a diagonal measurement
+      //! noise matrix and no threshold, outputs are processed one at a
+      //! time as scalar updates; otherwise the innovation covariance
+      //! is factored as LDL'. Both paths use the Joseph form for the
+      //! covariance update and do not allocate memory. Outputs with no
+      //! observation and no noise are ignored.
       //! @param threshold threshold to reject large state innovations.
-      //! @return 0 if update is successful, -1 otherwise.
+      //! @return 0 if update is successful, -1 if the innovation is
+      //! above threshold or its covariance is not positive definite.
       int
       update(float threshold);
 
@@ -341,6 +347,8 @@ namespace DUNE
       setMeasurementNoise(double value);
 
     private:
+      //! Smallest innovation variance accepted (relative).
+      static const double c_min_variance;
       //! Kalman filter state count.
       size_t m_state_count;
       //! State vector.
@@ -361,6 +369,49 @@ namespace DUNE
       Math::Matrix m_r;
       //! Innovation vector.
       Math::Matrix m_innov;
+      //! Workspace: covariance times observation row (n x 1).
+      Math::Matrix m_w_pc;
+      //! Workspace: state before update (n x 1).
+      Math::Matrix m_w_x0;
+      //! Workspace: observation times covariance (m x n).
+      Math::Matrix m_w_cp;
+      //! Workspace: transposed Kalman gain (m x n).
+      Math::Matrix m_w_kt;
+      //! Workspace: innovation covariance (m x m).
+      Math::Matrix m_w_s;
+      //! Workspace: LDL' factors of innovation covariance (m x m).
+      Math::Matrix m_w_ldl;
+      //! Workspace: solution of LDL' system (m x 1).
+      Math::Matrix m_w_z;
+      //! Workspace: state sized square matrix (n x n).
+      Math::Matrix m_w_nn;
+
+      //! Size workspaces to the current number of states and outputs.
+      void
+      resizeWorkspaces(void);
+
+      //! Update using one scalar measurement at a time.
+      //! @return 0.
+      int
+      updateSequential(void);
+
+      //! Update using the LDL' factorization of the innovation covariance.
+      //! @param threshold threshold to reject large state innovations.
+      //! @return 0 if update is successful, -1 otherwise.
+      int
+      updateBatch(float threshold);
+
+      //! Factor the innovation covariance as LDL'.
+      //! @return false if it is not positive definite.
+      bool
+      factor(void);
+
+      //! Solve S z = b in place using the LDL' factors.
+      //! @param[in,out] b right hand side with stride 'stride',
+      //! overwritten by the solution.
+      //! @param[in] stride distance between consecutive elements of b.
+      void
+      solve(double* b, size_t stride) const;
     };
   }
 }
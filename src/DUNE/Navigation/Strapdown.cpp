@@ -0,0 +1,221 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+
+// DUNE headers.
+#include <DUNE/Navigation/Strapdown.hpp>
+
+namespace DUNE
+{
+  namespace Navigation
+  {
+    //! Squared rotation angle below which series expansions are used.
+    static const double c_small_angle2 = 1e-6;
+
+    //! r += 0.5 * (a x b)
+    static inline void
+    addHalfCross(const double* a, const double* b, double* r)
+    {
+      r[0] += 0.5 * (a[1] * b[2] - a[2] * b[1]);
+      r[1] += 0.5 * (a[2] * b[0] - a[0] * b[2]);
+      r[2] += 0.5 * (a[0] * b[1] - a[1] * b[0]);
+    }
+
+    Strapdown::Strapdown(unsigned decimation):
+      m_decimation(decimation ? decimation : 1)
+    {
+      reset();
+    }
+
+    void
+    Strapdown::reset(void)
+    {
+      m_samples = 0;
+      m_ready = false;
+      m_q[0] = 1.0;
+
+      for (int i = 0; i < 3; ++i)
+      {
+        m_q[i + 1] = 0.0;
+        m_alpha[i] = 0.0;
+        m_beta[i] = 0.0;
+        m_v[i] = 0.0;
+        m_scul[i] = 0.0;
+        m_dtheta_prev[i] = 0.0;
+        m_dv_prev[i] = 0.0;
+        m_phi[i] = 0.0;
+        m_dv[i] = 0.0;
+        m_dv_nav[i] = 0.0;
+      }
+    }
+
+    void
+    Strapdown::setAttitude(double phi, double theta, double psi)
+    {
+      double cr = std::cos(phi * 0.5), sr = std::sin(phi * 0.5);
+      double cp = std::cos(theta * 0.5), sp = std::sin(theta * 0.5);
+      double cy = std::cos(psi * 0.5), sy = std::sin(psi * 0.5);
+
+      m_q[0] = cr * cp * cy + sr * sp * sy;
+      m_q[1] = sr * cp * cy - cr * sp * sy;
+      m_q[2] = cr * sp * cy + sr * cp * sy;
+      m_q[3] = cr * cp * sy - sr * sp * cy;
+    }
+
+    void
+    Strapdown::getEulerAngles(double& phi, double& theta, double& psi) const
+    {
+      const double* q = m_q;
+      double s = 2.0 * (q[0] * q[2] - q[3] * q[1]);
+      if (s > 1.0)
+        s = 1.0;
+      else if (s < -1.0)
+        s = -1.0;
+
+      phi = std::atan2(2.0 * (q[0] * q[1] + q[2] * q[3]), 1.0 - 2.0 * (q[1] * q[1] + q[2] * q[2]));
+      theta = std::asin(s);
+      psi = std::atan2(2.0 * (q[0] * q[3] + q[1] * q[2]), 1.0 - 2.0 * (q[2] * q[2] + q[3] * q[3]));
+    }
+
+    bool
+    Strapdown::integrate(const double* dtheta, const double* dv)
+    {
+      // Previous samples enter the coning and sculling terms with a
+      // 1/6 weight (two-sample algorithm).
+      double a[3];
+      double v[3];
+      for (int i = 0; i < 3; ++i)
+      {
+        a[i] = m_alpha[i] + m_dtheta_prev[i] * (1.0 / 6.0);
+        v[i] = m_v[i] + m_dv_prev[i] * (1.0 / 6.0);
+      }
+
+      // Coning.
+      addHalfCross(a, dtheta, m_beta);
+      // Sculling.
+      addHalfCross(a, dv, m_scul);
+      addHalfCross(v, dtheta, m_scul);
+
+      for (int i = 0; i < 3; ++i)
+      {
+        m_alpha[i] += dtheta[i];
+        m_v[i] += dv[i];
+        m_dtheta_prev[i] = dtheta[i];
+        m_dv_prev[i] = dv[i];
+      }
+
+      m_ready = ++m_samples >= m_decimation;
+      if (m_ready)
+        update();
+
+      return m_ready;
+    }
+
+    size_t
+    Strapdown::integrate(const double* dtheta, const double* dv, size_t count)
+    {
+      m_ready = false;
+      for (size_t i = 0; i < count; ++i)
+      {
+        if (integrate(dtheta + 3 * i, dv + 3 * i))
+          return i + 1;
+      }
+
+      return count;
+    }
+
+    void
+    Strapdown::update(void)
+    {
+      // Compensated increments.
+      for (int i = 0; i < 3; ++i)
+      {
+        m_phi[i] = m_alpha[i] + m_beta[i];
+        m_dv[i] = m_v[i] + m_scul[i];
+      }
+
+      // Rotation compensation of the velocity increment.
+      addHalfCross(m_alpha, m_v, m_dv);
+
+      // Velocity increment in the navigation frame, using the
+      // attitude at the start of the interval.
+      const double* q = m_q;
+      double c[3][3] =
+      {
+        {1.0 - 2.0 * (q[2] * q[2] + q[3] * q[3]), 2.0 * (q[1] * q[2] - q[0] * q[3]), 2.0 * (q[1] * q[3] + q[0] * q[2])},
+        {2.0 * (q[1] * q[2] + q[0] * q[3]), 1.0 - 2.0 * (q[1] * q[1] + q[3] * q[3]), 2.0 * (q[2] * q[3] - q[0] * q[1])},
+        {2.0 * (q[1] * q[3] - q[0] * q[2]), 2.0 * (q[2] * q[3] + q[0] * q[1]), 1.0 - 2.0 * (q[1] * q[1] + q[2] * q[2])}
+      };
+
+      for (int i = 0; i < 3; ++i)
+        m_dv_nav[i] = c[i][0] * m_dv[0] + c[i][1] * m_dv[1] + c[i][2] * m_dv[2];
+
+      // Quaternion of the rotation vector.
+      double a2 = m_phi[0] * m_phi[0] + m_phi[1] * m_phi[1] + m_phi[2] * m_phi[2];
+      double rc, rs;
+      if (a2 < c_small_angle2)
+      {
+        rc = 1.0 - a2 / 8.0 + a2 * a2 / 384.0;
+        rs = 0.5 - a2 / 48.0 + a2 * a2 / 3840.0;
+      }
+      else
+      {
+        double a = std::sqrt(a2);
+        rc = std::cos(0.5 * a);
+        rs = std::sin(0.5 * a) / a;
+      }
+
+      double r[4] = {rc, rs * m_phi[0], rs * m_phi[1], rs * m_phi[2]};
+
+      // q = q * r
+      double n[4];
+      n[0] = q[0] * r[0] - q[1] * r[1] - q[2] * r[2] - q[3] * r[3];
+      n[1] = q[0] * r[1] + q[1] * r[0] + q[2] * r[3] - q[3] * r[2];
+      n[2] = q[0] * r[2] - q[1] * r[3] + q[2] * r[0] + q[3] * r[1];
+      n[3] = q[0] * r[3] + q[1] * r[2] - q[2] * r[1] + q[3] * r[0];
+
+      // First order normalization, enough to keep |q| at 1.
+      double k = 1.5 - 0.5 * (n[0] * n[0] + n[1] * n[1] + n[2] * n[2] + n[3] * n[3]);
+      for (int i = 0; i < 4; ++i)
+        m_q[i] = n[i] * k;
+
+      // Start a new interval.
+      m_samples = 0;
+      for (int i = 0; i < 3; ++i)
+      {
+        m_alpha[i] = 0.0;
+        m_beta[i] = 0.0;
+        m_v[i] = 0.0;
+        m_scul[i] = 0.0;
+      }
+    }
+  }
+}
@@ -0,0 +1,190 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_NAVIGATION_STRAPDOWN_HPP_INCLUDED_
+#define DUNE_NAVIGATION_STRAPDOWN_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+
+namespace DUNE
+{
+  namespace Navigation
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM Strapdown;
+
+    //! High-rate strapdown attitude integration.
+    //!
+    //! Delta angle and delta velocity samples are accumulated at
+    //! sensor rate with the incremental coning and sculling
+    //! algorithms of Savage ("Strapdown Inertial Navigation
+    //! Integration Algorithm Design", 1998). Every 'decimation'
+    //! samples the attitude quaternion is updated with the
+    //! compensated rotation vector, and the compensated increments of
+    //! the interval become available to the caller. All state is kept
+    //! in fixed-size arrays and there is no trigonometry or
+    //! allocation at sensor rate.
+    class Strapdown
+    {
+    public:
+      //! Constructor.
+      //! @param[in] decimation number of samples per output interval.
+      Strapdown(unsigned decimation = 1);
+
+      //! Reset attitude to identity and clear accumulators.
+      void
+      reset(void);
+
+      //! Set number of samples per output interval. Samples of an
+      //! incomplete interval are kept.
+      //! @param[in] decimation number of samples (at least one).
+      void
+      setDecimation(unsigned decimation)
+      {
+        m_decimation = decimation ? decimation : 1;
+      }
+
+      //! Get number of samples per output interval.
+      //! @return number of samples.
+      unsigned
+      getDecimation(void) const
+      {
+        return m_decimation;
+      }
+
+      //! Set attitude.
+      //! @param[in] phi roll angle (rad).
+      //! @param[in] theta pitch angle (rad).
+      //! @param[in] psi yaw angle (rad).
+      void
+      setAttitude(double phi, double theta, double psi);
+
+      //! Integrate one sample.
+      //! @param[in] dtheta delta angle (rad) in body frame.
+      //! @param[in] dv delta velocity (m/s) in body frame.
+      //! @return true if an output interval was completed.
+      bool
+      integrate(const double* dtheta, const double* dv);
+
+      //! Integrate a batch of samples, stopping after the first
+      //! completed output interval.
+      //! @param[in] dtheta delta angles, three per sample.
+      //! @param[in] dv delta velocities, three per sample.
+      //! @param[in] count number of samples.
+      //! @return number of samples consumed.
+      size_t
+      integrate(const double* dtheta, const double* dv, size_t count);
+
+      //! Check if the last call to integrate() completed an interval.
+      //! @return true if new output is available.
+      bool
+      ready(void) const
+      {
+        return m_ready;
+      }
+
+      //! Compensated rotation vector of the last interval.
+      //! @return pointer to three values (rad) in body frame.
+      const double*
+      getDeltaAngle(void) const
+      {
+        return m_phi;
+      }
+
+      //! Compensated velocity increment of the last interval, in the
+      //! body frame at the start of the interval.
+      //! @return pointer to three values (m/s).
+      const double*
+      getDeltaVelocity(void) const
+      {
+        return m_dv;
+      }
+
+      //! Compensated velocity increment of the last interval, in the
+      //! navigation frame (without gravity).
+      //! @return pointer to three values (m/s).
+      const double*
+      getNavigationDeltaVelocity(void) const
+      {
+        return m_dv_nav;
+      }
+
+      //! Attitude quaternion (w, x, y, z), body to navigation frame.
+      //! @return pointer to four values.
+      const double*
+      getQuaternion(void) const
+      {
+        return m_q;
+      }
+
+      //! Compute Euler angles (ZYX convention) of the attitude.
+      //! @param[out] phi roll angle (rad).
+      //! @param[out] theta pitch angle (rad).
+      //! @param[out] psi yaw angle (rad).
+      void
+      getEulerAngles(double& phi, double& theta, double& psi) const;
+
+    private:
+      //! Number of samples per interval.
+      unsigned m_decimation;
+      //! Samples in the current interval.
+      unsigned m_samples;
+      //! True if the last sample completed an interval.
+      bool m_ready;
+      //! Attitude quaternion.
+      double m_q[4];
+      //! Accumulated delta angle.
+      double m_alpha[3];
+      //! Coning correction.
+      double m_beta[3];
+      //! Accumulated delta velocity.
+      double m_v[3];
+      //! Sculling correction.
+      double m_scul[3];
+      //! Previous delta angle sample.
+      double m_dtheta_prev[3];
+      //! Previous delta velocity sample.
+      double m_dv_prev[3];
+      //! Outputs of the last interval.
+      double m_phi[3];
+      double m_dv[3];
+      double m_dv_nav[3];
+
+      //! Close the current interval.
+      void
+      update(void);
+    };
+  }
+}
+
+#endif
@@ -27,6 +27,9 @@
 // Author: Jose Pinto                                                       *
 //***************************************************************************
 
+// ISO C++ 98 headers.
+#include <cstring>
+
 // DUNE headers.
 #include <DUNE/Network/FragmentedMessage.hpp>
 
@@ -34,10 +37,15 @@ namespace DUNE
 {
   namespace Network
   {
-    FragmentedMessage::FragmentedMessage(void)
+    FragmentedMessage::FragmentedMessage(void):
+      m_received(0),
+      m_stride(0),
+      m_size(0)
     {
       m_parent = NULL;
-      m_src = m_uid = m_creation_time = m_num_frags = -1;
+      m_src = m_uid = m_num_frags = -1;
+      m_creation_time = -1;
+      std::memset(m_bitmap, 0, sizeof(m_bitmap));
     }
 
     void
@@ -46,6 +54,38 @@ namespace DUNE
       m_parent = parent;
     }
 
+    void
+    FragmentedMessage::error(const char* msg)
+    {
+      if (m_parent == NULL)
+        DUNE_ERR("FragmentedMessage", msg);
+      else
+        m_parent->err("%s", msg);
+    }
+
+    bool
+    FragmentedMessage::place(unsigned frag, const std::vector<char>& data)
+    {
+      size_t offset = frag * m_stride;
+
+      if (frag + 1 < (unsigned)m_num_frags)
+      {
+        if (data.size() != m_stride)
+          return false;
+      }
+      else
+      {
+        if (data.size() > m_stride)
+          return false;
+        m_size = offset + data.size();
+      }
+
+      if (!data.empty())
+        std::memcpy(&m_data[offset], &data[0], data.size());
+
+      return true;
+    }
+
     IMC::Message*
     FragmentedMessage::setFragment(const IMC::MessagePart* part)
     {
@@ -62,36 +102,55 @@ namespace DUNE
       if (part->uid != m_uid || part->getSource() != m_src ||
           part->frag_number >= m_num_frags)
       {
-        if (m_parent == NULL)
-          DUNE_ERR("FragmentedMessage", "Invalid fragment received and it won't be processed.");
-        else
-          m_parent->err(DTR("Invalid fragment received and it won't be processed."));
-
+        error(DTR("Invalid fragment received and it won't be processed."));
         return NULL;
       }
 
-      m_fragments[part->frag_number] = *part;
+      unsigned frag = part->frag_number;
+      if (isReceived(frag))
+        return NULL;
 
-      // Message is complete. Let's reassemble and return it.
-      if (getFragmentsMissing() == 0)
+      bool last = (frag + 1 == (unsigned)m_num_frags);
+
+      if (m_stride == 0)
       {
-        int i;
-        int total_length = 0;
-        // concatenate all parts into a single array
-        std::vector<char> data;
-        for (i = 0; i < m_num_frags; i++)
+        // The size of the last fragment tells nothing about the others.
+        if (last && m_num_frags > 1)
         {
-          total_length += m_fragments[i].data.size();
-          data.insert(data.end(), m_fragments[i].data.begin(),
-                      m_fragments[i].data.end());
+          m_tail = part->data;
+          setReceived(frag);
+          return NULL;
         }
 
-        return IMC::Packet::deserialize((uint8_t*)&data[0], total_length);
+        m_stride = part->data.size();
+        m_data.resize(m_stride * m_num_frags);
+
+        if (!m_tail.empty())
+        {
+          if (!place(m_num_frags - 1, m_tail))
+          {
+            error(DTR("Invalid fragment received and it won't be processed."));
+            m_bitmap[(m_num_frags - 1) >> 5] &= ~(1u << ((m_num_frags - 1) & 31));
+            --m_received;
+          }
+
+          std::vector<char>().swap(m_tail);
+        }
       }
-      else
+
+      if (!place(frag, part->data))
       {
-        return 0;
+        error(DTR("Invalid fragment received and it won't be processed."));
+        return NULL;
       }
+
+      setReceived(frag);
+
+      // Message is complete. Let's deserialize it from the buffer.
+      if (getFragmentsMissing() == 0)
+        return IMC::Packet::deserialize((uint8_t*)&m_data[0], m_size);
+
+      return NULL;
     }
 
     double
@@ -106,12 +165,27 @@ namespace DUNE
     int
     FragmentedMessage::getFragmentsMissing(void)
     {
-      return m_num_frags - m_fragments.size();
+      return m_num_frags - m_received;
     }
 
-    FragmentedMessage::~FragmentedMessage(void)
+    void
+    FragmentedMessage::getMissing(std::vector<unsigned>& list) const
+    {
+      list.clear();
+      for (int i = 0; i < m_num_frags; ++i)
+      {
+        if (!isReceived(i))
+          list.push_back(i);
+      }
+    }
+
+    size_t
+    FragmentedMessage::getMemoryUsage(void) const
     {
-      m_fragments.clear();
+      return sizeof(*this) + m_data.capacity() + m_tail.capacity();
     }
+
+    FragmentedMessage::~FragmentedMessage(void)
+    { }
   }
 }
@@ -30,7 +30,9 @@
 #ifndef DUNE_NETWORK_FRAGMENTED_MESSAGE_HPP_INCLUDED_
 #define DUNE_NETWORK_FRAGMENTED_MESSAGE_HPP_INCLUDED_
 
-// DUNE headers.
+// ISO C++ 98 headers.
+#include <vector>
+
 #include <DUNE/IMC.hpp>
 #include <DUNE/Tasks.hpp>
 #include <DUNE/Time.hpp>
@@ -39,17 +41,35 @@ namespace DUNE
 {
   namespace Network
   {
+    //! Reassembly of a message split in MessagePart fragments.
+    //!
+    //! The target buffer is allocated once, when the size of the
+    //! fragments becomes known, and each fragment is copied directly
+    //! to its final position. Received fragments are tracked with a
+    //! bitmap.
     class FragmentedMessage
     {
     public:
       FragmentedMessage(void);
 
+      //! Get time elapsed since the first fragment was received.
+      //! @return age in seconds.
       double
       getAge(void);
 
       int
       getFragmentsMissing(void);
 
+      //! Get the list of fragments not yet received.
+      //! @param[out] list fragment numbers.
+      void
+      getMissing(std::vector<unsigned>& list) const;
+
+      //! Get memory held by this message.
+      //! @return number of bytes.
+      size_t
+      getMemoryUsage(void) const;
+
       IMC::Message*
       setFragment(const IMC::MessagePart* part);
 
@@ -59,12 +79,44 @@ namespace DUNE
       ~FragmentedMessage(void);
 
     private:
+      //! Maximum number of fragments (frag_number is 8 bits wide).
+      static const unsigned c_max_frags = 256;
+
+      bool
+      isReceived(unsigned frag) const
+      {
+        return (m_bitmap[frag >> 5] & (1u << (frag & 31))) != 0;
+      }
+
+      void
+      setReceived(unsigned frag)
+      {
+        m_bitmap[frag >> 5] |= (1u << (frag & 31));
+        ++m_received;
+      }
+
+      bool
+      place(unsigned frag, const std::vector<char>& data);
+
+      void
+      error(const char* msg);
+
       int m_src;
       int m_uid;
       int m_num_frags;
+      int m_received;
+      //! Size of all but the last fragment.
+      size_t m_stride;
+      //! Size of reassembled message.
+      size_t m_size;
       double m_creation_time;
       DUNE::Tasks::Task* m_parent;
-      std::map<unsigned int, IMC::MessagePart> m_fragments;
+      //! Received fragments.
+      uint32_t m_bitmap[c_max_frags / 32];
+      //! Reassembly buffer.
+      std::vector<char> m_data;
+      //! Last fragment, held while the fragment size is unknown.
+      std::vector<char> m_tail;
     };
   }
 }
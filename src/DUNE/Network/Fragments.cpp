@@ -27,7 +27,6 @@
 // Author: Jose Pinto                                                       *
 //***************************************************************************
 
-// DUNE headers.
 #include <DUNE/Network/Fragments.hpp>
 
 namespace DUNE
@@ -36,41 +35,45 @@ namespace DUNE
   {
     int Fragments::s_uid = 0;
 
-    Fragments::Fragments(IMC::Message* msg, int mtu)
+    Fragments::Fragments(IMC::Message* msg, int mtu):
+      m_size(0)
     {
-      m_uid = s_uid++;
+      m_uid = s_uid++ & 0xff;
       m_num_frags = 0;
-      int frag_size = mtu - DUNE_IMC_CONST_HEADER_SIZE - 5 - DUNE_IMC_CONST_FOOTER_SIZE;
-      if (frag_size <= 0)
+      m_frag_size = mtu - DUNE_IMC_CONST_HEADER_SIZE - 5 - DUNE_IMC_CONST_FOOTER_SIZE;
+      if (m_frag_size <= 0)
       {
         DUNE_ERR("Fragments", "MTU is too small");
         return;
       }
 
-      Utils::ByteBuffer buff;
-      int size = IMC::Packet::serialize(msg, buff);
-      uint8_t* buffer = buff.getBuffer();
+      m_size = IMC::Packet::serialize(msg, m_data);
+      m_num_frags = (m_size + m_frag_size - 1) / m_frag_size;
+      m_fragments.resize(m_num_frags, NULL);
+    }
 
-      int part = 0, pos = 0;
-      m_num_frags = (int)std::ceil((float)size / (float)frag_size);
+    void
+    Fragments::getFragment(int frag_number, IMC::MessagePart& part)
+    {
+      const uint8_t* buffer = m_data.getBuffer();
+      int pos = frag_number * m_frag_size;
+      int cur_size = std::min(m_size - pos, m_frag_size);
 
-      while (pos < size)
-      {
-        int remaining = size - pos;
-        int cur_size = std::min(remaining, frag_size);
-        IMC::MessagePart* mpart = new IMC::MessagePart();
-        mpart->frag_number = part++;
-        mpart->num_frags = m_num_frags;
-        mpart->uid = m_uid;
-        mpart->data.assign(buffer + pos, buffer + pos + cur_size);
-        pos += cur_size;
-        m_fragments.push_back(mpart);
-      }
+      part.frag_number = frag_number;
+      part.num_frags = m_num_frags;
+      part.uid = m_uid;
+      part.data.assign(buffer + pos, buffer + pos + cur_size);
     }
 
     IMC::MessagePart*
     Fragments::getFragment(int frag_number)
     {
+      if (m_fragments[frag_number] == NULL)
+      {
+        m_fragments[frag_number] = new IMC::MessagePart();
+        getFragment(frag_number, *m_fragments[frag_number]);
+      }
+
       return m_fragments[frag_number];
     }
 
@@ -82,6 +85,8 @@ namespace DUNE
 
     Fragments::~Fragments(void)
     {
+      for (size_t i = 0; i < m_fragments.size(); ++i)
+        delete m_fragments[i];
       m_fragments.clear();
     }
 
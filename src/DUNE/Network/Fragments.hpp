@@ -30,7 +30,6 @@
 #ifndef DUNE_NETWORK_FRAGMENTS_HPP_INCLUDED_
 #define DUNE_NETWORK_FRAGMENTS_HPP_INCLUDED_
 
-// DUNE headers.
 #include <DUNE/IMC.hpp>
 #include <DUNE/Tasks.hpp>
 
@@ -38,14 +37,28 @@ namespace DUNE
 {
   namespace Network
   {
+    //! Split of a message in MessagePart fragments. The message is
+    //! serialized once and fragments are built from that buffer on
+    //! request.
     class Fragments
     {
     public:
       Fragments(IMC::Message* message, int mtu);
 
+      //! Get a fragment. The returned object is owned by this
+      //! instance.
+      //! @param[in] frag_number fragment number.
+      //! @return fragment.
       IMC::MessagePart*
       getFragment(int frag_number);
 
+      //! Fill a fragment, reusing the storage of a caller provided
+      //! message.
+      //! @param[in] frag_number fragment number.
+      //! @param[out] part fragment.
+      void
+      getFragment(int frag_number, IMC::MessagePart& part);
+
       int
       getNumberOfFragments(void);
 
@@ -55,6 +68,12 @@ namespace DUNE
       static int s_uid;
       int m_uid;
       int m_num_frags;
+      int m_frag_size;
+      //! Serialized message.
+      Utils::ByteBuffer m_data;
+      //! Serialized message size.
+      int m_size;
+      //! Fragments built by getFragment().
       std::vector<IMC::MessagePart*> m_fragments;
     };
 
@@ -0,0 +1,191 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_NETWORK_TOKEN_BUCKET_HPP_INCLUDED_
+#define DUNE_NETWORK_TOKEN_BUCKET_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <algorithm>
+
+// DUNE headers.
+#include <DUNE/Time/Clock.hpp>
+
+namespace DUNE
+{
+  namespace Network
+  {
+    //! Token bucket traffic shaper. Tokens (usually bytes) are added
+    //! to the bucket at a constant rate up to a maximum burst size.
+    //! Transmissions are allowed only if the bucket holds enough
+    //! tokens to pay for them. A rate of zero disables shaping.
+    class TokenBucket
+    {
+    public:
+      //! Constructor.
+      //! @param[in] rate token fill rate (tokens/s).
+      //! @param[in] burst maximum number of tokens in the bucket.
+      TokenBucket(double rate = 0, double burst = 0):
+        m_rate(0),
+        m_burst(0),
+        m_tokens(0),
+        m_last(-1)
+      {
+        setRate(rate, burst);
+      }
+
+      //! Change the fill rate and burst size. The bucket keeps its
+      //! current tokens, clamped to the new burst size.
+      //! @param[in] rate token fill rate (tokens/s).
+      //! @param[in] burst maximum number of tokens in the bucket.
+      void
+      setRate(double rate, double burst)
+      {
+        m_rate = std::max(0.0, rate);
+        m_burst = std::max(0.0, burst);
+
+        if (m_last < 0)
+          m_tokens = m_burst;
+        else
+          m_tokens = std::min(m_tokens, m_burst);
+      }
+
+      //! Check if the bucket is shaping traffic.
+      //! @return true if a rate was configured, false otherwise.
+      bool
+      isLimited(void) const
+      {
+        return m_rate > 0;
+      }
+
+      //! Get the fill rate.
+      //! @return fill rate (tokens/s).
+      double
+      getRate(void) const
+      {
+        return m_rate;
+      }
+
+      //! Get the burst size.
+      //! @return maximum number of tokens.
+      double
+      getBurst(void) const
+      {
+        return m_burst;
+      }
+
+      //! Refill the bucket up to a given instant.
+      //! @param[in] now current time (s).
+      void
+      update(double now)
+      {
+        if (m_last >= 0 && now > m_last)
+          m_tokens = std::min(m_burst, m_tokens + (now - m_last) * m_rate);
+
+        m_last = now;
+      }
+
+      //! Get the number of tokens available at a given instant.
+      //! @param[in] now current time (s).
+      //! @return number of tokens.
+      double
+      getTokens(double now)
+      {
+        update(now);
+        return m_tokens;
+      }
+
+      //! Check if a transmission of a given cost can go through now.
+      //! Requests larger than the burst size are allowed when the
+      //! bucket is full, otherwise they would never be served.
+      //! @param[in] cost transmission cost (tokens).
+      //! @param[in] now current time (s).
+      //! @return true if the transmission is allowed, false otherwise.
+      bool
+      check(double cost, double now)
+      {
+        if (!isLimited())
+          return true;
+
+        update(now);
+        return m_tokens >= std::min(cost, m_burst);
+      }
+
+      //! Pay for a transmission, if enough tokens are available.
+      //! @param[in] cost transmission cost (tokens).
+      //! @param[in] now current time (s).
+      //! @return true if the transmission is allowed, false otherwise.
+      bool
+      consume(double cost, double now)
+      {
+        if (!check(cost, now))
+          return false;
+
+        if (isLimited())
+          m_tokens -= cost;
+
+        return true;
+      }
+
+      //! Pay for a transmission using the monotonic clock.
+      //! @param[in] cost transmission cost (tokens).
+      //! @return true if the transmission is allowed, false otherwise.
+      bool
+      consume(double cost)
+      {
+        return consume(cost, Time::Clock::get());
+      }
+
+      //! Compute the time until a transmission of a given cost is
+      //! allowed.
+      //! @param[in] cost transmission cost (tokens).
+      //! @param[in] now current time (s).
+      //! @return waiting time (s).
+      double
+      getDelay(double cost, double now)
+      {
+        if (check(cost, now))
+          return 0;
+
+        return (std::min(cost, m_burst) - m_tokens) / m_rate;
+      }
+
+    private:
+      //! Fill rate (tokens/s).
+      double m_rate;
+      //! Bucket size.
+      double m_burst;
+      //! Available tokens (may become negative after oversized requests).
+      double m_tokens;
+      //! Time of last update.
+      double m_last;
+    };
+  }
+}
+
+#endif
@@ -36,6 +36,7 @@
 #include <cstring>
 #include <cstdlib>
 #include <fstream>
+#include <sstream>
 #include <algorithm>
 
 // DUNE headers.
@@ -202,8 +203,13 @@ namespace DUNE
     void
     Config::writeToFile(const char* file)
     {
+      // Serialize first, so that an invalid value does not leave a
+      // partial file behind.
+      std::ostringstream ss;
+      ss << *this;
+
       std::ofstream os(file);
-      os << *this;
+      os << ss.str();
     }
 
     std::vector<std::string>
@@ -236,6 +242,86 @@ namespace DUNE
       return opts;
     }
 
+    //! Find where a long value can be split into a continuation
+    //! line. The parser joins continuation lines with a single space,
+    //! so values are only split at a comma followed by exactly one
+    //! space, and never before text that would be parsed as a section.
+    //! @param[in] value option value.
+    //! @param[in] begin search start.
+    //! @return index of the space to split at, or the size of the
+    //! value if there is none.
+    static size_t
+    findBreak(const std::string& value, size_t begin)
+    {
+      for (size_t i = value.find(", ", begin); i != std::string::npos; i = value.find(", ", i + 1))
+      {
+        if (i + 2 < value.size() && !std::isspace((unsigned char)value[i + 2]) && value[i + 2] != '[')
+          return i + 1;
+      }
+
+      return value.size();
+    }
+
+    //! Write an option assignment. Values that do not fit in the
+    //! parser's line buffer are split after commas into continuation
+    //! lines, which parse back to the same value.
+    //! @param[in] os output stream.
+    //! @param[in] option option name.
+    //! @param[in] value option value.
+    //! @throw InvalidValue if the value cannot be parsed back.
+    static void
+    writeOption(std::ostream& os, const std::string& option, const std::string& value)
+    {
+      static const size_t c_wrap = 72;
+
+      // The parser has no escapes: these end the value.
+      if (value.find_first_of(";|#\n") != std::string::npos)
+        throw InvalidValue(option, "contains a comment or line delimiter");
+
+      // The parser trims values.
+      if (!value.empty() && (std::isspace((unsigned char)value[0])
+                             || std::isspace((unsigned char)value[value.size() - 1])))
+        throw InvalidValue(option, "starts or ends with whitespace");
+
+      std::string indent(option.size() + 3, ' ');
+      bool wrap = indent.size() + value.size() >= c_max_bfr_size / 2;
+      // A continuation line with an equal sign is parsed as an
+      // assignment, so the first line must hold all of them.
+      size_t last_equal = value.rfind('=');
+      std::string line = option + " = ";
+      size_t begin = 0;
+
+      while (begin < value.size())
+      {
+        size_t end = findBreak(value, begin);
+        std::string item = value.substr(begin, end - begin);
+
+        if (begin > 0)
+        {
+          bool fits = line.size() + 1 + item.size() <= c_wrap;
+          bool movable = last_equal == std::string::npos || begin > last_equal;
+
+          if (wrap && !fits && movable)
+          {
+            os << line << std::endl;
+            line = indent;
+          }
+          else
+          {
+            line += ' ';
+          }
+        }
+
+        line += item;
+        begin = end + 1;
+
+        if (line.size() >= c_max_bfr_size)
+          throw InvalidValue(option, "too long to be parsed");
+      }
+
+      os << line << std::endl;
+    }
+
     std::ostream&
     operator<<(std::ostream& os, const Config& cfg)
     {
@@ -256,7 +342,7 @@ namespace DUNE
         for (labels = (*sections).second.begin(); labels != (*sections).second.end(); ++labels)
         {
           if ((*labels).second != "")
-            os << (*labels).first << " = " << (*labels).second << std::endl;
+            writeOption(os, (*labels).first, (*labels).second);
         }
 
         os << std::endl;
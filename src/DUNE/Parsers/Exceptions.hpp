@@ -125,6 +125,14 @@ namespace DUNE
       { }
     };
 
+    class InvalidValue: public Error
+    {
+    public:
+      InvalidValue(const std::string& option, const std::string& reason):
+        Error(Utils::String::str("invalid value for option %s: %s", option.c_str(), reason.c_str()))
+      { }
+    };
+
     class FileOpenError: public Error
     {
     public:
@@ -27,6 +27,11 @@
 // Author: Pedro Calado                                                     *
 //***************************************************************************
 
+// ISO C++ 98 headers.
+#include <cctype>
+#include <cstdlib>
+#include <string>
+
 // DUNE headers.
 #include <DUNE/Plans/Progress.hpp>
 
@@ -39,27 +44,44 @@ namespace DUNE
     bool
     Progress::getPoint(const IMC::ManeuverControlState* mcs, unsigned& number)
     {
-      std::vector<std::vector<std::string> > lstElems;
-      Utils::String::splitMulti(mcs->info, ";", "=", lstElems);
-
-      if (!lstElems.size())
-        return false;
+      // This runs for every ManeuverControlState, so scan the
+      // "key=value;..." list in place instead of splitting it.
+      const std::string& info = mcs->info;
+      size_t begin = 0;
 
-      std::vector<std::vector<std::string> >::iterator itr = lstElems.begin();
-      for (; itr != lstElems.end(); ++itr)
+      while (begin < info.size())
       {
-        if (!itr->size() || itr->size() < 2 || itr->front() == "" || itr->back() == "")
-          continue;
+        size_t end = info.find(';', begin);
+        if (end == std::string::npos)
+          end = info.size();
 
-        std::string name = itr->front().c_str();
-        name = Utils::String::trim(name);
-        Utils::String::toLowerCase(name);
-
-        if (c_waypoint_str == name)
+        size_t eq = info.find('=', begin);
+        if (eq < end)
         {
-          number = std::atoi(itr->back().c_str());
-          return true;
+          size_t kb = begin;
+          size_t ke = eq;
+          while (kb < ke && std::isspace((unsigned char)info[kb]))
+            ++kb;
+          while (ke > kb && std::isspace((unsigned char)info[ke - 1]))
+            --ke;
+
+          size_t vb = info.rfind('=', end - 1) + 1;
+
+          if (ke - kb == c_waypoint_str.size() && vb < end)
+          {
+            bool match = true;
+            for (size_t i = 0; match && i < c_waypoint_str.size(); ++i)
+              match = std::tolower((unsigned char)info[kb + i]) == c_waypoint_str[i];
+
+            if (match)
+            {
+              number = std::atoi(info.c_str() + vb);
+              return true;
+            }
+          }
         }
+
+        begin = end + 1;
       }
 
       return false;
@@ -74,7 +96,7 @@ namespace DUNE
       if (!getPoint(mcs, curr))
         return -1.0;
 
-      if (curr > durations.size())
+      if (curr >= durations.size())
         return -1.0;
 
       return total_duration - durations[curr] + (float)mcs->eta;
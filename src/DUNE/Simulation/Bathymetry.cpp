@@ -0,0 +1,563 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/Simulation/Bathymetry.hpp>
+#include <DUNE/System/Error.hpp>
+#include <DUNE/Utils/ByteCopy.hpp>
+
+#if defined(DUNE_SYS_HAS_UNISTD_H)
+#  include <unistd.h>
+#endif
+
+#if defined(DUNE_SYS_HAS_SYS_MMAN_H)
+#  include <sys/mman.h>
+#endif
+
+#if defined(DUNE_SYS_HAS_FCNTL_H)
+#  include <fcntl.h>
+#endif
+
+// Depths are mapped in place only when the host byte order matches
+// the file.
+#if defined(DUNE_SYS_HAS_MMAP) && defined(DUNE_SYS_HAS_SYS_MMAN_H) && defined(DUNE_CPU_LITTLE_ENDIAN)
+#  define DUNE_BATHYMETRY_MMAP
+#endif
+
+namespace DUNE
+{
+  namespace Simulation
+  {
+    //! File signature.
+    static const char c_magic[] = "DUNEBATH";
+    //! File format version.
+    static const uint32_t c_version = 1;
+    //! Header size.
+    static const size_t c_header_size = 64;
+
+    //! Copy a value to a buffer in little-endian byte order.
+    template <typename T>
+    static unsigned
+    encode(const T& value, uint8_t* dst)
+    {
+      const uint8_t* src = reinterpret_cast<const uint8_t*>(&value);
+      for (unsigned i = 0; i < sizeof(T); ++i)
+      {
+#if defined(DUNE_CPU_BIG_ENDIAN)
+        dst[i] = src[sizeof(T) - 1 - i];
+#else
+        dst[i] = src[i];
+#endif
+      }
+
+      return sizeof(T);
+    }
+
+    Bathymetry::Bathymetry(void):
+      m_lat(0),
+      m_lon(0),
+      m_north0(0),
+      m_east0(0),
+      m_resolution(0),
+      m_rows(0),
+      m_cols(0),
+      m_tile(0),
+      m_tile_bits(0),
+      m_tile_cols(0),
+      m_map(NULL),
+      m_map_size(0),
+      m_data(NULL)
+    { }
+
+    Bathymetry::~Bathymetry(void)
+    {
+      close();
+    }
+
+    void
+    Bathymetry::open(const FileSystem::Path& path)
+    {
+      close();
+
+      std::FILE* fd = std::fopen(path.c_str(), "rb");
+      if (fd == NULL)
+        throw Error("unable to open " + path.str());
+
+      uint8_t hdr[c_header_size];
+      bool valid = std::fread(hdr, 1, c_header_size, fd) == c_header_size;
+      std::fseek(fd, 0, SEEK_END);
+      long file_size = std::ftell(fd);
+
+      uint32_t version = 0;
+      uint32_t tile = 0;
+      const uint8_t* ptr = hdr + 8;
+      ptr += Utils::ByteCopy::fromLE(version, ptr);
+      ptr += Utils::ByteCopy::fromLE(tile, ptr);
+      ptr += Utils::ByteCopy::fromLE(m_rows, ptr);
+      ptr += Utils::ByteCopy::fromLE(m_cols, ptr);
+      ptr += Utils::ByteCopy::fromLE(m_lat, ptr);
+      ptr += Utils::ByteCopy::fromLE(m_lon, ptr);
+      ptr += Utils::ByteCopy::fromLE(m_north0, ptr);
+      ptr += Utils::ByteCopy::fromLE(m_east0, ptr);
+      ptr += Utils::ByteCopy::fromLE(m_resolution, ptr);
+
+      valid = valid && std::memcmp(hdr, c_magic, 8) == 0 && version == c_version;
+      valid = valid && tile > 0 && (tile & (tile - 1)) == 0;
+      valid = valid && m_rows > 0 && m_cols > 0 && m_resolution > 0;
+
+      m_tile = tile;
+      m_tile_bits = 0;
+      while ((1u << m_tile_bits) < tile)
+        ++m_tile_bits;
+
+      m_tile_cols = (m_cols + tile - 1) / tile;
+      size_t tile_rows = (m_rows + tile - 1) / tile;
+      size_t count = tile_rows * m_tile_cols * tile * tile;
+      valid = valid && file_size >= (long)(c_header_size + count * sizeof(float));
+
+      if (!valid)
+      {
+        std::fclose(fd);
+        m_rows = 0;
+        m_cols = 0;
+        throw Error("invalid file " + path.str());
+      }
+
+#if defined(DUNE_BATHYMETRY_MMAP)
+      std::fclose(fd);
+
+      int mfd = ::open(path.c_str(), O_RDONLY);
+      if (mfd == -1)
+        throw System::Error(errno, "unable to open " + path.str());
+
+      m_map_size = c_header_size + count * sizeof(float);
+      m_map = mmap(0, m_map_size, PROT_READ, MAP_SHARED, mfd, 0);
+      ::close(mfd);
+
+      if (m_map == MAP_FAILED)
+      {
+        m_map = NULL;
+        throw System::Error(errno, "unable to map " + path.str());
+      }
+
+      m_data = reinterpret_cast<const float*>(static_cast<const uint8_t*>(m_map) + c_header_size);
+#else
+      std::vector<uint8_t> bfr(count * sizeof(float));
+      std::fseek(fd, c_header_size, SEEK_SET);
+      valid = std::fread(&bfr[0], 1, bfr.size(), fd) == bfr.size();
+      std::fclose(fd);
+
+      if (!valid)
+        throw Error("unable to read " + path.str());
+
+      m_copy.resize(count);
+      for (size_t i = 0; i < count; ++i)
+        Utils::ByteCopy::fromLE(m_copy[i], &bfr[i * sizeof(float)]);
+
+      m_data = &m_copy[0];
+#endif
+    }
+
+    void
+    Bathymetry::close(void)
+    {
+#if defined(DUNE_BATHYMETRY_MMAP)
+      if (m_map != NULL)
+        munmap(m_map, m_map_size);
+#endif
+
+      m_map = NULL;
+      m_map_size = 0;
+      m_copy.clear();
+      m_data = NULL;
+    }
+
+    bool
+    Bathymetry::depthAt(double north, double east, double& depth) const
+    {
+      if (m_data == NULL)
+        return false;
+
+      double fr = (north - m_north0) / m_resolution;
+      double fc = (east - m_east0) / m_resolution;
+
+      if (!(fr >= 0.0 && fc >= 0.0 && fr <= m_rows - 1 && fc <= m_cols - 1))
+        return false;
+
+      unsigned r0 = (unsigned)fr;
+      unsigned c0 = (unsigned)fc;
+      unsigned r1 = r0 + 1 < m_rows ? r0 + 1 : r0;
+      unsigned c1 = c0 + 1 < m_cols ? c0 + 1 : c0;
+      double tr = fr - r0;
+      double tc = fc - c0;
+
+      float v[4] = {node(r0, c0), node(r0, c1), node(r1, c0), node(r1, c1)};
+      double w[4] = {(1 - tr) * (1 - tc), (1 - tr) * tc, tr * (1 - tc), tr * tc};
+
+      double sum = 0.0;
+      double weight = 0.0;
+      for (unsigned i = 0; i < 4; ++i)
+      {
+        // NaN marks missing data.
+        if (v[i] == v[i])
+        {
+          sum += w[i] * v[i];
+          weight += w[i];
+        }
+      }
+
+      if (weight < 1e-6)
+        return false;
+
+      depth = sum / weight;
+      return true;
+    }
+
+    bool
+    Bathymetry::intersectCell(unsigned row, unsigned col, const Ray& ray,
+                              double t0, double t1, double& range) const
+    {
+      float z[4] = {node(row, col), node(row, col + 1), node(row + 1, col), node(row + 1, col + 1)};
+
+      // Replace missing nodes by the mean of the cell.
+      double sum = 0.0;
+      unsigned count = 0;
+      for (unsigned i = 0; i < 4; ++i)
+      {
+        if (z[i] == z[i])
+        {
+          sum += z[i];
+          ++count;
+        }
+      }
+
+      if (count == 0)
+        return false;
+
+      double zmin = std::numeric_limits<double>::max();
+      for (unsigned i = 0; i < 4; ++i)
+      {
+        if (z[i] != z[i])
+          z[i] = (float)(sum / count);
+
+        zmin = std::min(zmin, (double)z[i]);
+      }
+
+      // Ray stays above the shallowest node.
+      double length = t1 - t0;
+      double d0 = ray.depth + ray.dd * t0;
+      if (std::max(d0, d0 + ray.dd * length) < zmin)
+        return false;
+
+      // Cell coordinates along the ray: u = u0 + du * s, v = v0 + dv * s.
+      double u0 = (ray.north + ray.dn * t0 - m_north0) / m_resolution - row;
+      double v0 = (ray.east + ray.de * t0 - m_east0) / m_resolution - col;
+      double du = ray.dn / m_resolution;
+      double dv = ray.de / m_resolution;
+
+      // Bilinear surface: z = a + b * u + c * v + d * u * v.
+      double a = z[0];
+      double b = z[2] - z[0];
+      double c = z[1] - z[0];
+      double d = z[0] - z[1] - z[2] + z[3];
+
+      // Ray depth minus bottom depth: q0 + q1 * s + q2 * s^2.
+      double q0 = d0 - (a + b * u0 + c * v0 + d * u0 * v0);
+      double q1 = ray.dd - (b * du + c * dv + d * (u0 * dv + v0 * du));
+      double q2 = -d * du * dv;
+
+      if (q0 >= 0.0)
+      {
+        range = t0;
+        return true;
+      }
+
+      double s = -1.0;
+      if (std::fabs(q2) < 1e-12)
+      {
+        if (q1 > 0.0)
+          s = -q0 / q1;
+      }
+      else
+      {
+        double disc = q1 * q1 - 4.0 * q2 * q0;
+        if (disc < 0.0)
+          return false;
+
+        double root = std::sqrt(disc);
+        double s1 = (-q1 - root) / (2.0 * q2);
+        double s2 = (-q1 + root) / (2.0 * q2);
+        if (s1 > s2)
+          std::swap(s1, s2);
+
+        s = (s1 >= 0.0) ? s1 : s2;
+      }
+
+      if (s < 0.0 || s > length)
+        return false;
+
+      range = t0 + s;
+      return true;
+    }
+
+    bool
+    Bathymetry::castRay(const Ray& ray, double max_range, double& range) const
+    {
+      if (m_data == NULL || m_rows < 2 || m_cols < 2)
+        return false;
+
+      // Ray in grid coordinates.
+      double fr = (ray.north - m_north0) / m_resolution;
+      double fc = (ray.east - m_east0) / m_resolution;
+      double dr = ray.dn / m_resolution;
+      double dc = ray.de / m_resolution;
+
+      // Clip ray to the grid.
+      double t0 = 0.0;
+      double t1 = max_range;
+      double org[2] = {fr, fc};
+      double dir[2] = {dr, dc};
+      double top[2] = {(double)(m_rows - 1), (double)(m_cols - 1)};
+      for (unsigned i = 0; i < 2; ++i)
+      {
+        if (dir[i] == 0.0)
+        {
+          if (org[i] < 0.0 || org[i] > top[i])
+            return false;
+          continue;
+        }
+
+        double ta = -org[i] / dir[i];
+        double tb = (top[i] - org[i]) / dir[i];
+        if (ta > tb)
+          std::swap(ta, tb);
+
+        t0 = std::max(t0, ta);
+        t1 = std::min(t1, tb);
+      }
+
+      if (t0 > t1)
+        return false;
+
+      // First cell.
+      int row = std::min((int)(fr + dr * t0), (int)m_rows - 2);
+      int col = std::min((int)(fc + dc * t0), (int)m_cols - 2);
+      row = std::max(row, 0);
+      col = std::max(col, 0);
+
+      // Range to the next row and column boundaries and between them.
+      double inf = std::numeric_limits<double>::infinity();
+      int step_r = (dr > 0.0) ? 1 : -1;
+      int step_c = (dc > 0.0) ? 1 : -1;
+      double next_r = (dr == 0.0) ? inf : ((row + (dr > 0.0 ? 1 : 0)) - fr) / dr;
+      double next_c = (dc == 0.0) ? inf : ((col + (dc > 0.0 ? 1 : 0)) - fc) / dc;
+      double delta_r = (dr == 0.0) ? inf : 1.0 / std::fabs(dr);
+      double delta_c = (dc == 0.0) ? inf : 1.0 / std::fabs(dc);
+
+      double t = t0;
+      while (t <= t1)
+      {
+        double t_next = std::min(std::min(next_r, next_c), t1);
+
+        if (intersectCell(row, col, ray, t, t_next, range))
+          return true;
+
+        if (t_next >= t1)
+          break;
+
+        if (next_r < next_c)
+        {
+          row += step_r;
+          next_r += delta_r;
+        }
+        else
+        {
+          col += step_c;
+          next_c += delta_c;
+        }
+
+        if (row < 0 || col < 0 || row > (int)m_rows - 2 || col > (int)m_cols - 2)
+          break;
+
+        t = t_next;
+      }
+
+      return false;
+    }
+
+    size_t
+    Bathymetry::castRays(const std::vector<Ray>& rays, double max_range,
+                         std::vector<double>& ranges) const
+    {
+      size_t hits = 0;
+      ranges.resize(rays.size());
+
+      for (size_t i = 0; i < rays.size(); ++i)
+      {
+        if (castRay(rays[i], max_range, ranges[i]))
+          ++hits;
+        else
+          ranges[i] = max_range;
+      }
+
+      return hits;
+    }
+
+    void
+    Bathymetry::write(const FileSystem::Path& path, double lat, double lon,
+                      const std::vector<Sample>& samples, double resolution, unsigned fill)
+    {
+      if (samples.empty())
+        throw Error("no samples");
+
+      if (!(resolution > 0))
+        throw Error("invalid resolution");
+
+      double n_min = samples[0].north, n_max = n_min;
+      double e_min = samples[0].east, e_max = e_min;
+      for (size_t i = 1; i < samples.size(); ++i)
+      {
+        n_min = std::min(n_min, samples[i].north);
+        n_max = std::max(n_max, samples[i].north);
+        e_min = std::min(e_min, samples[i].east);
+        e_max = std::max(e_max, samples[i].east);
+      }
+
+      // One node of margin so that filled borders are kept.
+      double north0 = (std::floor(n_min / resolution) - 1) * resolution;
+      double east0 = (std::floor(e_min / resolution) - 1) * resolution;
+      unsigned rows = (unsigned)std::ceil((n_max - north0) / resolution) + 2;
+      unsigned cols = (unsigned)std::ceil((e_max - east0) / resolution) + 2;
+
+      // Mean of the samples closest to each node.
+      std::vector<double> sum(rows * cols, 0.0);
+      std::vector<unsigned> count(rows * cols, 0);
+      for (size_t i = 0; i < samples.size(); ++i)
+      {
+        unsigned r = (unsigned)((samples[i].north - north0) / resolution + 0.5);
+        unsigned c = (unsigned)((samples[i].east - east0) / resolution + 0.5);
+        sum[r * cols + c] += samples[i].depth;
+        ++count[r * cols + c];
+      }
+
+      const float nan = std::numeric_limits<float>::quiet_NaN();
+      std::vector<float> grid(rows * cols, nan);
+      for (size_t i = 0; i < grid.size(); ++i)
+      {
+        if (count[i])
+          grid[i] = (float)(sum[i] / count[i]);
+      }
+
+      // Fill holes with the mean of their neighbours.
+      std::vector<float> next;
+      for (unsigned pass = 0; pass < fill; ++pass)
+      {
+        next = grid;
+        for (unsigned r = 0; r < rows; ++r)
+        {
+          for (unsigned c = 0; c < cols; ++c)
+          {
+            if (grid[r * cols + c] == grid[r * cols + c])
+              continue;
+
+            double s = 0.0;
+            unsigned k = 0;
+            for (unsigned rr = (r ? r - 1 : 0); rr <= r + 1 && rr < rows; ++rr)
+            {
+              for (unsigned cc = (c ? c - 1 : 0); cc <= c + 1 && cc < cols; ++cc)
+              {
+                float v = grid[rr * cols + cc];
+                if (v == v)
+                {
+                  s += v;
+                  ++k;
+                }
+              }
+            }
+
+            if (k > 0)
+              next[r * cols + c] = (float)(s / k);
+          }
+        }
+        grid.swap(next);
+      }
+
+      std::FILE* fd = std::fopen(path.c_str(), "wb");
+      if (fd == NULL)
+        throw Error("unable to create " + path.str());
+
+      uint8_t hdr[c_header_size];
+      std::memset(hdr, 0, sizeof(hdr));
+      std::memcpy(hdr, c_magic, 8);
+      uint8_t* ptr = hdr + 8;
+      ptr += encode(c_version, ptr);
+      ptr += encode((uint32_t)c_tile_size, ptr);
+      ptr += encode((uint32_t)rows, ptr);
+      ptr += encode((uint32_t)cols, ptr);
+      ptr += encode(lat, ptr);
+      ptr += encode(lon, ptr);
+      ptr += encode(north0, ptr);
+      ptr += encode(east0, ptr);
+      ptr += encode(resolution, ptr);
+      bool ok = std::fwrite(hdr, 1, sizeof(hdr), fd) == sizeof(hdr);
+
+      // Tiles in row-major order, padded with NaN.
+      unsigned tile_rows = (rows + c_tile_size - 1) / c_tile_size;
+      unsigned tile_cols = (cols + c_tile_size - 1) / c_tile_size;
+      std::vector<uint8_t> tile(c_tile_size * c_tile_size * sizeof(float));
+      for (unsigned tr = 0; ok && tr < tile_rows; ++tr)
+      {
+        for (unsigned tc = 0; ok && tc < tile_cols; ++tc)
+        {
+          uint8_t* dst = &tile[0];
+          for (unsigned r = tr * c_tile_size; r < (tr + 1) * c_tile_size; ++r)
+          {
+            for (unsigned c = tc * c_tile_size; c < (tc + 1) * c_tile_size; ++c)
+              dst += encode((r < rows && c < cols) ? grid[r * cols + c] : nan, dst);
+          }
+
+          ok = std::fwrite(&tile[0], 1, tile.size(), fd) == tile.size();
+        }
+      }
+
+      ok = (std::fclose(fd) == 0) && ok;
+      if (!ok)
+        throw Error("unable to write " + path.str());
+    }
+  }
+}
@@ -0,0 +1,259 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_SIMULATION_BATHYMETRY_HPP_INCLUDED_
+#define DUNE_SIMULATION_BATHYMETRY_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/FileSystem/Path.hpp>
+
+namespace DUNE
+{
+  namespace Simulation
+  {
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM Bathymetry;
+
+    //! Gridded bathymetry.
+    //!
+    //! Depths are stored on a regular north/east grid, relative to a
+    //! WGS-84 reference, in a binary file made of square tiles of
+    //! little-endian 32-bit floats (NaN marks nodes without data).
+    //! The file is memory mapped, so only the tiles that are queried
+    //! are read from disk. Queries use bilinear interpolation and
+    //! take constant time.
+    //!
+    //! File layout (little-endian):
+    //! - magic "DUNEBATH" (8 bytes);
+    //! - version, tile size, rows, columns (uint32);
+    //! - reference latitude and longitude (rad), northing and easting
+    //!   of node (0, 0) (m), grid resolution (m) (double);
+    //! - tiles in row-major order, each with tile size * tile size
+    //!   depths in row-major order.
+    class Bathymetry
+    {
+    public:
+      //! Exception raised by Bathymetry class.
+      class Error: public std::runtime_error
+      {
+      public:
+        Error(const std::string& msg):
+          std::runtime_error("bathymetry error: " + msg)
+        { }
+      };
+
+      //! Scattered depth sample.
+      struct Sample
+      {
+        //! Northing offset to the reference (m).
+        double north;
+        //! Easting offset to the reference (m).
+        double east;
+        //! Depth (m).
+        double depth;
+      };
+
+      //! Ray for bottom intersection queries.
+      struct Ray
+      {
+        //! Origin northing and easting offsets to the reference (m).
+        double north, east;
+        //! Origin depth (m).
+        double depth;
+        //! Unit direction (north, east, down).
+        double dn, de, dd;
+      };
+
+      //! Default number of nodes per tile side.
+      static const unsigned c_tile_size = 64;
+
+      Bathymetry(void);
+
+      ~Bathymetry(void);
+
+      //! Open a gridded bathymetry file.
+      //! @param[in] path file path.
+      //! @throw Error if the file is invalid.
+      void
+      open(const FileSystem::Path& path);
+
+      //! Release the mapped file.
+      void
+      close(void);
+
+      //! Check if a file is open.
+      //! @return true if open, false otherwise.
+      bool
+      isOpen(void) const
+      {
+        return m_data != NULL;
+      }
+
+      //! Get reference latitude.
+      //! @return latitude (rad).
+      double
+      getLatitude(void) const
+      {
+        return m_lat;
+      }
+
+      //! Get reference longitude.
+      //! @return longitude (rad).
+      double
+      getLongitude(void) const
+      {
+        return m_lon;
+      }
+
+      //! Get grid resolution.
+      //! @return distance between nodes (m).
+      double
+      getResolution(void) const
+      {
+        return m_resolution;
+      }
+
+      //! Get number of rows (northing nodes).
+      //! @return number of rows.
+      unsigned
+      getRows(void) const
+      {
+        return m_rows;
+      }
+
+      //! Get number of columns (easting nodes).
+      //! @return number of columns.
+      unsigned
+      getColumns(void) const
+      {
+        return m_cols;
+      }
+
+      //! Interpolate depth at a given position. Nodes without data
+      //! are left out of the interpolation.
+      //! @param[in] north northing offset to the reference (m).
+      //! @param[in] east easting offset to the reference (m).
+      //! @param[out] depth interpolated depth (m).
+      //! @return true if there is data around the position, false
+      //! otherwise.
+      bool
+      depthAt(double north, double east, double& depth) const;
+
+      //! Find where a ray first meets the bottom. The grid cells
+      //! crossed by the ray are visited in order (DDA) and the ray is
+      //! intersected with the bilinear surface of each cell, stopping
+      //! at the first hit. Cells crossed above their shallowest node
+      //! are skipped without solving.
+      //! @param[in] ray ray.
+      //! @param[in] max_range maximum range (m).
+      //! @param[out] range distance from the origin to the bottom (m).
+      //! @return true if the bottom is hit within maximum range,
+      //! false if the ray misses it or leaves the grid.
+      bool
+      castRay(const Ray& ray, double max_range, double& range) const;
+
+      //! Cast several rays.
+      //! @param[in] rays rays.
+      //! @param[in] max_range maximum range (m).
+      //! @param[out] ranges distance to the bottom of each ray,
+      //! maximum range if the ray missed it.
+      //! @return number of rays that hit the bottom.
+      size_t
+      castRays(const std::vector<Ray>& rays, double max_range, std::vector<double>& ranges) const;
+
+      //! Grid scattered samples and write a bathymetry file. Each
+      //! node takes the mean of the samples closest to it, then
+      //! empty nodes next to nodes with data are filled with the mean
+      //! of their neighbours, 'fill' times.
+      //! @param[in] path output file.
+      //! @param[in] lat reference latitude (rad).
+      //! @param[in] lon reference longitude (rad).
+      //! @param[in] samples depth samples.
+      //! @param[in] resolution distance between nodes (m).
+      //! @param[in] fill number of hole filling passes.
+      //! @throw Error if there are no samples or the file cannot be
+      //! written.
+      static void
+      write(const FileSystem::Path& path, double lat, double lon,
+            const std::vector<Sample>& samples, double resolution, unsigned fill = 2);
+
+    private:
+      //! Reference coordinates.
+      double m_lat, m_lon;
+      //! Northing and easting of node (0, 0).
+      double m_north0, m_east0;
+      //! Grid resolution.
+      double m_resolution;
+      //! Grid dimensions.
+      unsigned m_rows, m_cols;
+      //! Tile size and its base-2 logarithm.
+      unsigned m_tile, m_tile_bits;
+      //! Number of tile columns.
+      unsigned m_tile_cols;
+      //! Mapped file.
+      void* m_map;
+      //! Mapped file size.
+      size_t m_map_size;
+      //! File contents when it cannot be mapped.
+      std::vector<float> m_copy;
+      //! First depth value.
+      const float* m_data;
+
+      //! Intersect a ray with the bilinear surface of a cell.
+      //! @param[in] row cell row.
+      //! @param[in] col cell column.
+      //! @param[in] ray ray.
+      //! @param[in] t0 range where the ray enters the cell.
+      //! @param[in] t1 range where the ray leaves the cell.
+      //! @param[out] range distance to the bottom.
+      //! @return true if the ray meets the bottom inside the cell.
+      bool
+      intersectCell(unsigned row, unsigned col, const Ray& ray,
+                    double t0, double t1, double& range) const;
+
+      //! Depth of a node.
+      float
+      node(unsigned row, unsigned col) const
+      {
+        unsigned mask = m_tile - 1;
+        size_t tile = (size_t)(row >> m_tile_bits) * m_tile_cols + (col >> m_tile_bits);
+        return m_data[(tile << (2 * m_tile_bits)) + ((row & mask) << m_tile_bits) + (col & mask)];
+      }
+    };
+  }
+}
+
+#endif
@@ -29,6 +29,11 @@
 // Author: José Braga                                                       *
 //***************************************************************************
 
+
+// ISO C++ 98 headers.
+#include <cstring>
+#include <limits>
+
 // DUNE headers.
 #include <DUNE/IMC/Factory.hpp>
 #include <DUNE/Time/Clock.hpp>
@@ -40,53 +45,189 @@ namespace DUNE
 {
   namespace Tasks
   {
-    MessageFilter::MessageFilter(void)
-    { }
+    const double MessageFilter::c_max_silence = 60.0;
+    const double MessageFilter::c_max_scale = 16.0;
+    const double MessageFilter::c_max_loss = 0.05;
+    const double MessageFilter::c_min_capacity = 0.05;
+
+    MessageFilter::Entry::Entry(void):
+      period(0),
+      entity_filter(false),
+      dedup(false),
+      max_silence(c_max_silence)
+    {
+      std::memset(entities, 0, sizeof(entities));
+      std::memset(hash, 0, sizeof(hash));
+      for (unsigned i = 0; i < c_entities; ++i)
+        stime[i] = -std::numeric_limits<double>::max();
+    }
+
+    MessageFilter::MessageFilter(void):
+      m_link_rate(0),
+      m_link_burst(0),
+      m_scale(1.0)
+    {
+      m_pending.msg = NULL;
+    }
 
     MessageFilter::~MessageFilter(void)
-    { }
+    {
+      for (size_t i = 0; i < m_table.size(); ++i)
+        delete m_table[i];
+    }
+
+    MessageFilter::Entry&
+    MessageFilter::getEntry(uint32_t id)
+    {
+      if (id >= m_table.size())
+        m_table.resize(id + 1, NULL);
+
+      if (m_table[id] == NULL)
+        m_table[id] = new Entry;
+
+      return *m_table[id];
+    }
 
-    //! Filter message
+    //! Compute FNV-1a hash of the message payload.
     //! @param[in] msg IMC Message.
-    //! @return true if message filtered, false otherwise.
+    //! @return payload hash.
+    uint64_t
+    MessageFilter::hashPayload(const IMC::Message* msg)
+    {
+      m_bfr.resize(msg->getPayloadSerializationSize());
+      if (m_bfr.empty())
+        return 0;
+
+      msg->serializeFields(&m_bfr[0]);
+
+      uint64_t hash = 0xcbf29ce484222325ULL;
+      for (size_t i = 0; i < m_bfr.size(); ++i)
+      {
+        hash ^= m_bfr[i];
+        hash *= 0x100000001b3ULL;
+      }
+
+      return hash;
+    }
+
+    MessageFilter::Link&
+    MessageFilter::getLink(uint64_t peer)
+    {
+      LinkMap::iterator itr = m_links.find(peer);
+      if (itr != m_links.end())
+        return itr->second;
+
+      Link link;
+      link.bucket.setRate(m_link_rate, m_link_burst);
+      link.capacity = m_link_rate;
+      link.scale = 1.0;
+      return m_links.insert(std::make_pair(peer, link)).first->second;
+    }
+
+    void
+    MessageFilter::setCapacity(Link& link, double capacity)
+    {
+      capacity = std::max(m_link_rate * c_min_capacity, std::min(m_link_rate, capacity));
+      if (capacity == link.capacity)
+        return;
+
+      link.capacity = capacity;
+      link.bucket.setRate(capacity, m_link_burst);
+    }
+
+    void
+    MessageFilter::setScale(Link& link, double scale)
+    {
+      scale = std::max(1.0, std::min(scale, c_max_scale));
+      if (scale == link.scale)
+        return;
+
+      link.scale = scale;
+
+      m_scale = 1.0;
+      for (LinkMap::const_iterator itr = m_links.begin(); itr != m_links.end(); ++itr)
+        m_scale = std::max(m_scale, itr->second.scale);
+    }
+
+    void
+    MessageFilter::commit(Entry& entry, unsigned entity, uint64_t hash, double now)
+    {
+      entry.stime[entity] = now;
+      entry.hash[entity] = hash;
+    }
+
+    bool
+    MessageFilter::shape(const IMC::Message* msg, size_t size, uint64_t peer, double now)
+    {
+      if (m_link_rate <= 0 || msg != m_pending.msg)
+        return false;
+
+      Link& link = getLink(peer);
+      if (!link.bucket.consume(size, now))
+      {
+        setScale(link, link.scale * 1.5);
+        return true;
+      }
+
+      // Spare capacity: slowly return to configured rates.
+      if (link.bucket.getTokens(now) > m_link_burst / 2)
+        setScale(link, link.scale * 0.99);
+
+      if (m_pending.entry != NULL)
+      {
+        commit(*m_pending.entry, m_pending.entity, m_pending.hash, m_pending.time);
+        m_pending.entry = NULL;
+      }
+
+      return false;
+    }
+
     bool
     MessageFilter::filter(const IMC::Message* msg)
     {
+      m_pending.msg = NULL;
+
       uint32_t mid = msg->getId();
+      if (mid >= m_table.size() || m_table[mid] == NULL)
+        return false;
+
+      Entry& entry = *m_table[mid];
+      unsigned ent = msg->getSourceEntity() & 0xff;
 
       // Filter message by entity.
-      if (m_filtered[mid].size() > 0)
-      {
-        bool matched = false;
-        std::vector<uint32_t>::iterator itr = m_filtered[mid].begin();
-        for (; itr != m_filtered[mid].end(); ++itr)
-        {
-          if (*itr == msg->getSourceEntity())
-          {
-            matched = true;
-            break;
-          }
-        }
+      if (!entry.isAllowed(ent))
+        return true;
 
-        // This entity is not listed to be passed.
-        if (!matched)
-          return true;
-      }
+      if (entry.period <= 0 && !entry.dedup)
+        return false;
+
+      double now = Time::Clock::get();
 
       // Filter message by rate.
-      RateMap::iterator rmitr = m_rates.find(mid);
+      if (entry.period > 0 && entry.stime[ent] + entry.period * m_scale > now)
+        return true;
 
-      if (rmitr != m_rates.end())
+      // Filter unchanged messages.
+      uint64_t hash = 0;
+      if (entry.dedup)
       {
-        double now = Time::Clock::get();
-        double& stime = m_stimes[MsgKey(mid, msg->getSourceEntity())];
-
-        if (stime + rmitr->second > now)
+        hash = hashPayload(msg);
+        if (hash == entry.hash[ent] && entry.stime[ent] + entry.max_silence > now)
           return true;
+      }
 
-        stime = now;
+      // Forwarded once the first peer accepts it.
+      if (m_link_rate > 0)
+      {
+        m_pending.msg = msg;
+        m_pending.entry = &entry;
+        m_pending.entity = ent;
+        m_pending.hash = hash;
+        m_pending.time = now;
+        return false;
       }
 
+      commit(entry, ent, hash, now);
       return false;
     }
 
@@ -95,8 +236,11 @@ namespace DUNE
     void
     MessageFilter::setupRates(const std::vector<std::string>& spec)
     {
-      m_rates.clear();
-      m_stimes.clear();
+      for (size_t i = 0; i < m_table.size(); ++i)
+      {
+        if (m_table[i] != NULL)
+          m_table[i]->period = 0;
+      }
 
       for (unsigned int i = 0; i < spec.size(); ++i)
       {
@@ -109,7 +253,7 @@ namespace DUNE
           double rate = 0;
           if (std::sscanf(parts[1].c_str(), "%lf", &rate) && rate > 0)
           {
-            m_rates[id] = 1.0 / rate;
+            getEntry(id).period = 1.0 / rate;
             continue;
           }
         }
@@ -123,8 +267,13 @@ namespace DUNE
     void
     MessageFilter::setupEntities(const std::vector<std::string>& spec, Tasks::Task* task)
     {
+      for (size_t i = 0; i < m_table.size(); ++i)
+      {
+        if (m_table[i] != NULL)
+          m_table[i]->entity_filter = false;
+      }
+
       // Process filtered entities.
-      m_filtered.clear();
       for (unsigned int i = 0; i < spec.size(); ++i)
       {
         std::vector<std::string> parts;
@@ -136,22 +285,108 @@ namespace DUNE
         uint32_t id = IMC::Factory::getIdFromAbbrev(parts[0]);
         std::vector<std::string> entities;
         Utils::String::split(parts[1], "+", entities);
-        m_filtered[id].resize(entities.size());
 
-        // Resolve entities id.
+        Entry& entry = getEntry(id);
+        entry.entity_filter = true;
+        std::memset(entry.entities, 0, sizeof(entry.entities));
+
+        // Resolve entities id. Unknown entities match nothing.
         for (unsigned j = 0; j < entities.size(); j++)
         {
-          // Resolve entities.
           try
           {
-            m_filtered[id][j] = task->resolveEntity(entities[j]);
+            unsigned eid = task->resolveEntity(entities[j]);
+            if (eid < c_entities)
+              entry.entities[eid >> 5] |= (1u << (eid & 31));
           }
           catch (...)
-          {
-            m_filtered[id][j] = UINT_MAX;
-          }
+          { }
         }
       }
     }
+
+    void
+    MessageFilter::setupDuplicates(const std::vector<std::string>& spec)
+    {
+      for (size_t i = 0; i < m_table.size(); ++i)
+      {
+        if (m_table[i] != NULL)
+          m_table[i]->dedup = false;
+      }
+
+      for (unsigned int i = 0; i < spec.size(); ++i)
+      {
+        std::vector<std::string> parts;
+        Utils::String::split(spec[i], ":", parts);
+
+        double silence = c_max_silence;
+        if (parts.size() < 1 || parts.size() > 2
+            || (parts.size() == 2 && (std::sscanf(parts[1].c_str(), "%lf", &silence) != 1 || silence <= 0)))
+          throw std::runtime_error(Utils::String::str(DTR("invalid filter: %s"), spec[i].c_str()));
+
+        Entry& entry = getEntry(IMC::Factory::getIdFromAbbrev(parts[0]));
+        entry.dedup = true;
+        entry.max_silence = silence;
+        std::memset(entry.hash, 0, sizeof(entry.hash));
+      }
+    }
+
+    void
+    MessageFilter::setupLink(double rate, double burst)
+    {
+      m_link_rate = rate;
+      m_link_burst = burst;
+      m_scale = 1.0;
+      m_links.clear();
+      m_pending.msg = NULL;
+    }
+
+    void
+    MessageFilter::onTransmission(uint64_t peer, bool success)
+    {
+      if (m_link_rate <= 0)
+        return;
+
+      Link& link = getLink(peer);
+      if (success)
+        setCapacity(link, link.capacity + m_link_rate * 0.01);
+      else
+        setCapacity(link, link.capacity * 0.5);
+    }
+
+    void
+    MessageFilter::onLinkLoss(uint64_t peer, double loss)
+    {
+      if (m_link_rate <= 0)
+        return;
+
+      Link& link = getLink(peer);
+      if (loss > c_max_loss)
+        setCapacity(link, link.capacity * (1.0 - std::min(loss, 0.5)));
+      else
+        setCapacity(link, link.capacity + m_link_rate * 0.01);
+    }
+
+    void
+    MessageFilter::removeLink(uint64_t peer)
+    {
+      LinkMap::iterator itr = m_links.find(peer);
+      if (itr == m_links.end())
+        return;
+
+      // Let the remaining links set the slowdown.
+      setScale(itr->second, 1.0);
+      m_links.erase(itr);
+    }
+
+    double
+    MessageFilter::getLinkCapacity(uint64_t peer) const
+    {
+      LinkMap::const_iterator itr = m_links.find(peer);
+      if (itr == m_links.end())
+        return m_link_rate;
+
+      return itr->second.capacity;
+    }
   }
 }
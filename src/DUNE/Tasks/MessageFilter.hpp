@@ -37,11 +37,19 @@
 // DUNE headers.
 #include <DUNE/Tasks/Task.hpp>
 #include <DUNE/IMC/Message.hpp>
+#include <DUNE/Network/TokenBucket.hpp>
 
 namespace DUNE
 {
   namespace Tasks
   {
+    //! Outgoing message filter of transports. Messages may be
+    //! filtered by source entity, rate limited per source entity,
+    //! suppressed while their payload is unchanged and shaped by
+    //! token buckets kept per transport peer, whose rates follow the
+    //! measured loss and transmission failures of each link. Per
+    //! message state lives in tables indexed by message id and source
+    //! entity, so filtering does no lookups or allocations.
     class MessageFilter
     {
     public:
@@ -55,22 +63,180 @@ namespace DUNE
       void
       setupEntities(const std::vector<std::string>& spec, Tasks::Task* task);
 
+      //! Setup suppression of unchanged messages.
+      //! @param[in] spec list of <Message>[:<Maximum Silence>].
+      void
+      setupDuplicates(const std::vector<std::string>& spec);
+
+      //! Setup the link budget shared by rate limited and deduplicated
+      //! messages. Other messages are never shaped. Each transport peer
+      //! gets its own budget.
+      //! @param[in] rate link capacity (bytes/s), zero for unlimited.
+      //! @param[in] burst bucket size (bytes).
+      void
+      setupLink(double rate, double burst);
+
+      //! Report the outcome of a transmission to a peer. Failures halve
+      //! the estimated capacity of the link, successes slowly restore
+      //! it.
+      //! @param[in] peer transport peer.
+      //! @param[in] success true if the transmission succeeded.
+      void
+      onTransmission(uint64_t peer, bool success);
+
+      //! Report the packet loss measured on the link to a peer. Loss
+      //! above a small threshold reduces the estimated capacity of the
+      //! link in proportion, lower loss lets it grow.
+      //! @param[in] peer transport peer.
+      //! @param[in] loss fraction of packets lost (0 to 1).
+      void
+      onLinkLoss(uint64_t peer, double loss);
+
+      //! Forget the link to a peer that is no longer reachable.
+      //! @param[in] peer transport peer.
+      void
+      removeLink(uint64_t peer);
+
+      //! Get current link capacity estimate of a peer.
+      //! @param[in] peer transport peer.
+      //! @return link capacity (bytes/s).
+      double
+      getLinkCapacity(uint64_t peer) const;
+
+      //! Get current slowdown of rate limiters due to link congestion.
+      //! Each link keeps its own slowdown, but rate limiters are
+      //! shared by all peers, so they follow the most congested link.
+      //! @return multiplier of rate limiter periods.
+      double
+      getScale(void) const
+      {
+        return m_scale;
+      }
+
+      //! Filter message by entity, rate and contents. When link
+      //! shaping is enabled, messages that pass and are subject to
+      //! shaping must then be checked with shape() for every peer.
+      //! @param[in] msg IMC Message.
+      //! @return true if message filtered, false otherwise.
       bool
       filter(const IMC::Message* msg);
 
+      //! Charge the last message that passed filter() to the budget of
+      //! a transport peer. The message counts as forwarded once a peer
+      //! accepts it.
+      //! @param[in] msg IMC Message.
+      //! @param[in] size number of bytes sent to the peer.
+      //! @param[in] peer transport peer.
+      //! @param[in] now current time.
+      //! @return true if message must not be sent to the peer, false
+      //! otherwise.
+      bool
+      shape(const IMC::Message* msg, size_t size, uint64_t peer, double now);
+
     private:
-      // Rate limiters.
-      typedef std::map<uint32_t, double> RateMap;
-      RateMap m_rates;
-
-      // Send times.
-      typedef std::pair<uint32_t, unsigned int> MsgKey;
-      typedef std::map<MsgKey, double> STimesMap;
-      STimesMap m_stimes;
-
-      // List of entities to be passed by given message
-      typedef std::vector<uint32_t> Entities;
-      std::map<uint32_t, Entities> m_filtered;
+      //! Number of source entities.
+      static const unsigned c_entities = 256;
+      //! Default maximum silence of deduplicated messages.
+      static const double c_max_silence;
+      //! Maximum slowdown of rate limiters.
+      static const double c_max_scale;
+      //! Packet loss tolerated before link capacity is reduced.
+      static const double c_max_loss;
+      //! Minimum link capacity (fraction of configured capacity).
+      static const double c_min_capacity;
+
+      //! Per message state.
+      struct Entry
+      {
+        //! Minimum period between messages (0 if not rate limited).
+        double period;
+        //! True if only some entities are allowed.
+        bool entity_filter;
+        //! Allowed entities.
+        uint32_t entities[c_entities / 32];
+        //! True if unchanged messages are suppressed.
+        bool dedup;
+        //! Maximum time without forwarding an unchanged message.
+        double max_silence;
+        //! Last forwarding time per entity.
+        double stime[c_entities];
+        //! Payload hash of last forwarded message per entity.
+        uint64_t hash[c_entities];
+
+        Entry(void);
+
+        bool
+        isAllowed(unsigned entity) const
+        {
+          return !entity_filter || (entities[entity >> 5] & (1u << (entity & 31)));
+        }
+      };
+
+      //! Link to a transport peer.
+      struct Link
+      {
+        //! Budget of shaped messages.
+        Network::TokenBucket bucket;
+        //! Estimated capacity.
+        double capacity;
+        //! Slowdown of rate limiters wanted by this link.
+        double scale;
+      };
+
+      //! Message waiting for its first peer.
+      struct Pending
+      {
+        //! Message that passed the filter.
+        const IMC::Message* msg;
+        //! Message state.
+        Entry* entry;
+        //! Source entity.
+        unsigned entity;
+        //! Payload hash.
+        uint64_t hash;
+        //! Time of filtering.
+        double time;
+      };
+
+      // Per message state, indexed by message id.
+      std::vector<Entry*> m_table;
+      // Per peer link budget.
+      typedef std::map<uint64_t, Link> LinkMap;
+      LinkMap m_links;
+      // Configured link capacity.
+      double m_link_rate;
+      // Link bucket size.
+      double m_link_burst;
+      // Shaped message not yet accepted by any peer.
+      Pending m_pending;
+      // Slowdown of rate limiters, the largest of all links.
+      double m_scale;
+      // Scratch buffer used to hash payloads.
+      std::vector<uint8_t> m_bfr;
+
+      Entry&
+      getEntry(uint32_t id);
+
+      uint64_t
+      hashPayload(const IMC::Message* msg);
+
+      Link&
+      getLink(uint64_t peer);
+
+      void
+      setCapacity(Link& link, double capacity);
+
+      void
+      setScale(Link& link, double scale);
+
+      void
+      commit(Entry& entry, unsigned entity, uint64_t hash, double now);
+
+      // Non-copyable.
+      MessageFilter(MessageFilter const&);
+
+      MessageFilter&
+      operator=(MessageFilter const&);
     };
   }
 }
@@ -51,6 +51,12 @@ namespace DUNE
       param("Filtered Entities", m_gargs.entities_flt)
       .description("List of <Message>:<Entity>+<Entity> that define the source entities allowed to pass message of a specific message type.");
 
+      param("Suppressed Duplicates", m_gargs.dedup)
+      .defaultValue("")
+      .description("List of <Message>[:<Maximum Silence>] that are not"
+                   " retransmitted while their contents do not change,"
+                   " except after the given number of seconds (default 60)");
+
       param("Trace - Incoming Messages", m_gargs.trace_in)
       .defaultValue("false")
       .description("Enable verbose output regarding incoming messages");
@@ -88,6 +94,7 @@ namespace DUNE
     {
       m_rl.setupRates(m_gargs.rlim);
       m_rl.setupEntities(m_gargs.entities_flt, this);
+      m_rl.setupDuplicates(m_gargs.dedup);
       bind(this, m_gargs.transports);
 
       while (!stopping())
@@ -79,6 +79,8 @@ namespace DUNE
         std::vector<std::string> rlim;
         // Filtered entities.
         std::vector<std::string> entities_flt;
+        // Messages suppressed while unchanged.
+        std::vector<std::string> dedup;
         // Trace incoming messages.
         bool trace_in;
         // Trace outgoing messages.
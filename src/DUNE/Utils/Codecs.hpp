@@ -32,5 +32,6 @@
 
 #include <DUNE/Utils/Codecs/CodedEstimatedState.hpp>
 #include <DUNE/Utils/Codecs/CodedReference.hpp>
+#include <DUNE/Utils/Codecs/DeltaCodec.hpp>
 
 #endif
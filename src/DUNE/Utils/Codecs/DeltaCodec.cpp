@@ -0,0 +1,515 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+// DUNE headers.
+#include <DUNE/Utils/Codecs/DeltaCodec.hpp>
+#include <DUNE/IMC/Definitions.hpp>
+#include <DUNE/IMC/Factory.hpp>
+#include <DUNE/IMC/Serialization.hpp>
+#include <DUNE/Time/Clock.hpp>
+#include <DUNE/Utils/String.hpp>
+
+namespace DUNE
+{
+  namespace Utils
+  {
+    namespace Codecs
+    {
+      //! Size of the common frame header.
+      static const size_t c_header_size = 10;
+      //! Flag of keyframes.
+      static const uint8_t c_keyframe = 0x80;
+      //! Largest quantized magnitude.
+      static const int64_t c_max_value = (int64_t)1 << 60;
+
+      //! Read and write a message field as a floating point value.
+      template <typename M, typename T, T M::* F>
+      struct Accessor
+      {
+        static double
+        get(const IMC::Message* msg)
+        {
+          return static_cast<double>(static_cast<const M*>(msg)->*F);
+        }
+
+        static void
+        set(IMC::Message* msg, double value)
+        {
+          static_cast<M*>(msg)->*F = static_cast<T>(value);
+        }
+      };
+
+      //! Coded field.
+      struct Field
+      {
+        //! Message identification number.
+        uint16_t (*id)(void);
+        //! Message abbreviation.
+        const char* message;
+        //! Field abbreviation.
+        const char* name;
+        //! Default resolution (power of ten).
+        int exp;
+        //! Field reader.
+        double (*get)(const IMC::Message*);
+        //! Field writer.
+        void (*set)(IMC::Message*, double);
+      };
+
+      static const Field c_fields[] =
+      {
+#define FIELD(msg, field, type, exp)                                    \
+        {&IMC::msg::getIdStatic, #msg, #field, exp,                     \
+         &Accessor<IMC::msg, type, &IMC::msg::field>::get,              \
+         &Accessor<IMC::msg, type, &IMC::msg::field>::set},
+#include <DUNE/Utils/Codecs/DeltaFields.def>
+      };
+
+      typedef std::map<uint16_t, std::vector<const Field*> > FieldMap;
+
+      //! Get the coded fields, grouped by message type.
+      static const FieldMap&
+      getFieldMap(void)
+      {
+        static FieldMap map;
+
+        if (map.empty())
+        {
+          for (size_t i = 0; i < sizeof(c_fields) / sizeof(c_fields[0]); ++i)
+            map[c_fields[i].id()].push_back(&c_fields[i]);
+        }
+
+        return map;
+      }
+
+      //! Get the coded fields of a message type.
+      static const std::vector<const Field*>&
+      getFields(uint16_t id)
+      {
+        const FieldMap& map = getFieldMap();
+        FieldMap::const_iterator itr = map.find(id);
+        if (itr == map.end())
+          throw std::runtime_error(String::str("message %u cannot be delta coded", id));
+        return itr->second;
+      }
+
+      //! Quantize a value.
+      static int64_t
+      quantize(double value, int exp)
+      {
+        if (!std::isfinite(value))
+          return 0;
+
+        double q = std::floor(value * std::pow(10.0, -exp) + 0.5);
+        if (q > c_max_value)
+          return c_max_value;
+        if (q < -c_max_value)
+          return -c_max_value;
+        return static_cast<int64_t>(q);
+      }
+
+      //! Restore a quantized value.
+      static double
+      restore(int64_t value, int exp)
+      {
+        return static_cast<double>(value) * std::pow(10.0, exp);
+      }
+
+      //! Compute the identifier of a stream.
+      static uint64_t
+      getStreamKey(uint16_t id, uint16_t src, uint8_t src_ent)
+      {
+        return ((uint64_t)id << 24) | ((uint64_t)src << 8) | src_ent;
+      }
+
+      //! Bit stream writer for zigzag Exp-Golomb codes.
+      class BitWriter
+      {
+      public:
+        BitWriter(uint8_t* bfr, size_t size):
+          m_bfr(bfr),
+          m_size(size),
+          m_bit(0),
+          m_overflow(false)
+        { }
+
+        void
+        putSigned(int64_t value)
+        {
+          uint64_t z = (value < 0) ? ((uint64_t)(-(value + 1)) << 1) | 1 : (uint64_t)value << 1;
+          uint64_t v = z + 1;
+
+          unsigned bits = 0;
+          for (uint64_t t = v; t != 0; t >>= 1)
+            ++bits;
+
+          for (unsigned i = 1; i < bits; ++i)
+            putBit(0);
+
+          for (unsigned i = bits; i-- > 0; )
+            putBit((v >> i) & 1);
+        }
+
+        bool
+        overflow(void) const
+        {
+          return m_overflow;
+        }
+
+        size_t
+        getSize(void) const
+        {
+          return (m_bit + 7) / 8;
+        }
+
+      private:
+        uint8_t* m_bfr;
+        size_t m_size;
+        size_t m_bit;
+        bool m_overflow;
+
+        void
+        putBit(unsigned bit)
+        {
+          size_t byte = m_bit / 8;
+          if (byte >= m_size)
+          {
+            m_overflow = true;
+            return;
+          }
+
+          if (m_bit % 8 == 0)
+            m_bfr[byte] = 0;
+
+          if (bit)
+            m_bfr[byte] |= 0x80 >> (m_bit % 8);
+
+          ++m_bit;
+        }
+      };
+
+      //! Bit stream reader for zigzag Exp-Golomb codes.
+      class BitReader
+      {
+      public:
+        BitReader(const uint8_t* bfr, size_t size):
+          m_bfr(bfr),
+          m_size(size),
+          m_bit(0)
+        { }
+
+        int64_t
+        getSigned(void)
+        {
+          unsigned zeros = 0;
+          while (getBit() == 0)
+          {
+            if (++zeros > 62)
+              throw std::runtime_error("invalid delta code");
+          }
+
+          uint64_t v = 1;
+          for (unsigned i = 0; i < zeros; ++i)
+            v = (v << 1) | getBit();
+
+          uint64_t z = v - 1;
+          if (z & 1)
+            return -(int64_t)(z >> 1) - 1;
+          return (int64_t)(z >> 1);
+        }
+
+      private:
+        const uint8_t* m_bfr;
+        size_t m_size;
+        size_t m_bit;
+
+        unsigned
+        getBit(void)
+        {
+          size_t byte = m_bit / 8;
+          if (byte >= m_size)
+            throw std::runtime_error("truncated delta frame");
+
+          unsigned bit = (m_bfr[byte] >> (7 - m_bit % 8)) & 1;
+          ++m_bit;
+          return bit;
+        }
+      };
+
+      DeltaCodec::DeltaCodec(void):
+        m_key_frames(20),
+        m_key_period(10.0)
+      {
+        const FieldMap& map = getFieldMap();
+        for (FieldMap::const_iterator itr = map.begin(); itr != map.end(); ++itr)
+        {
+          std::vector<int8_t>& exps = m_exps[itr->first];
+          for (size_t i = 0; i < itr->second.size(); ++i)
+            exps.push_back(static_cast<int8_t>(itr->second[i]->exp));
+        }
+      }
+
+      bool
+      DeltaCodec::isSupported(uint16_t id)
+      {
+        const FieldMap& map = getFieldMap();
+        return map.find(id) != map.end();
+      }
+
+      void
+      DeltaCodec::setMessages(const std::vector<std::string>& list)
+      {
+        m_enabled.clear();
+
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+          uint16_t id = IMC::Factory::getIdFromAbbrev(list[i]);
+          if (!isSupported(id))
+            throw std::runtime_error(String::str("message '%s' cannot be delta coded",
+                                                 list[i].c_str()));
+          m_enabled.insert(id);
+        }
+
+        reset();
+      }
+
+      void
+      DeltaCodec::setResolutions(const std::vector<std::string>& list)
+      {
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+          std::vector<std::string> parts;
+          String::split(list[i], ":", parts);
+
+          std::vector<std::string> names;
+          if (parts.size() == 2)
+            String::split(parts[0], ".", names);
+
+          if (names.size() != 2)
+            throw std::runtime_error(String::str("invalid resolution '%s'", list[i].c_str()));
+
+          double res = std::atof(parts[1].c_str());
+          if (!(res > 0))
+            throw std::runtime_error(String::str("invalid resolution '%s'", list[i].c_str()));
+
+          uint16_t id = IMC::Factory::getIdFromAbbrev(names[0]);
+          const std::vector<const Field*>& fields = getFields(id);
+
+          size_t f = 0;
+          for (; f < fields.size(); ++f)
+          {
+            if (names[1] == fields[f]->name)
+              break;
+          }
+
+          if (f == fields.size())
+            throw std::runtime_error(String::str("field '%s' cannot be delta coded",
+                                                 parts[0].c_str()));
+
+          long exp = std::lround(std::log10(res));
+          m_exps[id][f] = static_cast<int8_t>(std::max(-18L, std::min(18L, exp)));
+        }
+
+        reset();
+      }
+
+      void
+      DeltaCodec::setKeyframeInterval(unsigned frames, double period)
+      {
+        m_key_frames = frames;
+        m_key_period = period;
+      }
+
+      void
+      DeltaCodec::reset(void)
+      {
+        m_tx.clear();
+      }
+
+      size_t
+      DeltaCodec::encode(const IMC::Message* msg, uint8_t* bfr, size_t size)
+      {
+        uint16_t id = msg->getId();
+        if (!isEnabled(id))
+          return 0;
+
+        const std::vector<const Field*>& fields = getFields(id);
+        const std::vector<int8_t>& exps = m_exps[id];
+
+        if (size < c_header_size + sizeof(fp64_t) + exps.size())
+          return 0;
+
+        Stream& stream = m_tx[getStreamKey(id, msg->getSource(), msg->getSourceEntity())];
+        double now = Time::Clock::get();
+        bool key = stream.time < 0
+        || stream.count >= m_key_frames
+        || (now - stream.time) >= m_key_period;
+
+        uint8_t seq = key ? ((stream.seq + 1) & ~c_keyframe) : stream.seq;
+
+        uint8_t* ptr = bfr;
+        *ptr++ = c_magic;
+        *ptr++ = seq | (key ? c_keyframe : 0);
+        ptr += IMC::serialize(id, ptr);
+        ptr += IMC::serialize(msg->getSource(), ptr);
+        ptr += IMC::serialize(msg->getSourceEntity(), ptr);
+        ptr += IMC::serialize(msg->getDestination(), ptr);
+        ptr += IMC::serialize(msg->getDestinationEntity(), ptr);
+
+        if (key)
+        {
+          ptr += IMC::serialize(msg->getTimeStamp(), ptr);
+          for (size_t i = 0; i < exps.size(); ++i)
+            *ptr++ = static_cast<uint8_t>(exps[i]);
+        }
+
+        std::vector<int64_t> values(fields.size());
+        for (size_t i = 0; i < fields.size(); ++i)
+          values[i] = quantize(fields[i]->get(msg), exps[i]);
+
+        BitWriter writer(ptr, size - (ptr - bfr));
+        if (key)
+        {
+          for (size_t i = 0; i < values.size(); ++i)
+            writer.putSigned(values[i]);
+        }
+        else
+        {
+          writer.putSigned(quantize(msg->getTimeStamp() - stream.stamp, -3));
+          for (size_t i = 0; i < values.size(); ++i)
+            writer.putSigned(values[i] - stream.values[i]);
+        }
+
+        if (writer.overflow())
+          return 0;
+
+        if (key)
+        {
+          stream.seq = seq;
+          stream.count = 0;
+          stream.time = now;
+          stream.stamp = msg->getTimeStamp();
+          stream.exps = exps;
+          stream.values = values;
+        }
+        else
+        {
+          ++stream.count;
+        }
+
+        return (ptr - bfr) + writer.getSize();
+      }
+
+      IMC::Message*
+      DeltaCodec::decode(const uint8_t* bfr, size_t size)
+      {
+        if (!isCoded(bfr, size) || size < c_header_size)
+          throw std::runtime_error("invalid delta frame");
+
+        uint16_t length = static_cast<uint16_t>(std::min(size, (size_t)0xffff));
+        const uint8_t* ptr = bfr + 1;
+        --length;
+
+        uint8_t flags = *ptr++;
+        --length;
+        bool key = (flags & c_keyframe) != 0;
+        uint8_t seq = flags & ~c_keyframe;
+
+        uint16_t id;
+        uint16_t src;
+        uint8_t src_ent;
+        uint16_t dst;
+        uint8_t dst_ent;
+        ptr += IMC::deserialize(id, ptr, length);
+        ptr += IMC::deserialize(src, ptr, length);
+        ptr += IMC::deserialize(src_ent, ptr, length);
+        ptr += IMC::deserialize(dst, ptr, length);
+        ptr += IMC::deserialize(dst_ent, ptr, length);
+
+        const std::vector<const Field*>& fields = getFields(id);
+        Stream& stream = m_rx[getStreamKey(id, src, src_ent)];
+
+        double stamp = 0;
+        std::vector<int8_t> exps;
+        if (key)
+        {
+          ptr += IMC::deserialize(stamp, ptr, length);
+          if (length < fields.size())
+            throw std::runtime_error("truncated delta frame");
+
+          exps.assign(ptr, ptr + fields.size());
+          ptr += fields.size();
+          length -= fields.size();
+        }
+        else if (stream.time < 0 || stream.seq != seq)
+        {
+          // Keyframe was lost.
+          return NULL;
+        }
+
+        BitReader reader(ptr, length);
+        std::vector<int64_t> values(fields.size());
+
+        if (key)
+        {
+          for (size_t i = 0; i < fields.size(); ++i)
+            values[i] = reader.getSigned();
+
+          stream.seq = seq;
+          stream.time = Time::Clock::get();
+          stream.stamp = stamp;
+          stream.exps = exps;
+          stream.values = values;
+        }
+        else
+        {
+          stamp = stream.stamp + restore(reader.getSigned(), -3);
+          for (size_t i = 0; i < fields.size(); ++i)
+            values[i] = stream.values[i] + reader.getSigned();
+        }
+
+        IMC::Message* msg = IMC::Factory::produce(id);
+        for (size_t i = 0; i < fields.size(); ++i)
+          fields[i]->set(msg, restore(values[i], stream.exps[i]));
+
+        msg->setTimeStamp(stamp);
+        msg->setSource(src);
+        msg->setSourceEntity(src_ent);
+        msg->setDestination(dst);
+        msg->setDestinationEntity(dst_ent);
+        return msg;
+      }
+    }
+  }
+}
@@ -0,0 +1,183 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef DUNE_UTILS_CODECS_DELTA_CODEC_HPP_INCLUDED_
+#define DUNE_UTILS_CODECS_DELTA_CODEC_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/Config.hpp>
+#include <DUNE/IMC/Message.hpp>
+
+namespace DUNE
+{
+  namespace Utils
+  {
+    namespace Codecs
+    {
+      // Export DLL Symbol.
+      class DUNE_DLL_SYM DeltaCodec;
+
+      //! Compact codec for high rate telemetry streams. Numeric fields
+      //! of the messages listed in DeltaFields.def are quantized to a
+      //! configurable resolution and, between periodic keyframes,
+      //! coded as differences to the last keyframe. Values are packed
+      //! with zigzag Exp-Golomb codes, so fields that barely change
+      //! take only a few bits.
+      //!
+      //! Each frame starts with c_magic, which never matches the first
+      //! byte of an IMC packet, and carries its own resolutions in
+      //! keyframes, so receivers need no configuration. Delta frames
+      //! are decoded against their keyframe only, which means losing a
+      //! delta frame does not affect the following ones.
+      class DeltaCodec
+      {
+      public:
+        //! First byte of all coded frames.
+        static const uint8_t c_magic = 0xdc;
+
+        //! Constructor.
+        DeltaCodec(void);
+
+        //! Check if a message type can be coded.
+        //! @param[in] id message identification number.
+        //! @return true if the message is supported, false otherwise.
+        static bool
+        isSupported(uint16_t id);
+
+        //! Check if a buffer holds a coded frame.
+        //! @param[in] bfr buffer.
+        //! @param[in] size buffer size.
+        //! @return true if the buffer holds a coded frame.
+        static bool
+        isCoded(const uint8_t* bfr, size_t size)
+        {
+          return size > 0 && bfr[0] == c_magic;
+        }
+
+        //! Select the message types to code.
+        //! @param[in] list message abbreviations.
+        //! @throw std::runtime_error if a message is not supported.
+        void
+        setMessages(const std::vector<std::string>& list);
+
+        //! Override field resolutions.
+        //! @param[in] list list of <Message>.<Field>:<Resolution>.
+        //! Resolutions are rounded to the nearest power of ten.
+        //! @throw std::runtime_error if an entry is invalid.
+        void
+        setResolutions(const std::vector<std::string>& list);
+
+        //! Set how often keyframes are produced.
+        //! @param[in] frames maximum number of delta frames between
+        //! keyframes.
+        //! @param[in] period maximum time between keyframes (s).
+        void
+        setKeyframeInterval(unsigned frames, double period);
+
+        //! Check if a message type is selected for coding.
+        //! @param[in] id message identification number.
+        //! @return true if the message is coded, false otherwise.
+        bool
+        isEnabled(uint16_t id) const
+        {
+          return m_enabled.find(id) != m_enabled.end();
+        }
+
+        //! Encode a message.
+        //! @param[in] msg message.
+        //! @param[out] bfr output buffer.
+        //! @param[in] size size of the output buffer.
+        //! @return frame size or 0 if the message type is not enabled
+        //! or the frame does not fit the buffer.
+        size_t
+        encode(const IMC::Message* msg, uint8_t* bfr, size_t size);
+
+        //! Decode a frame.
+        //! @param[in] bfr frame.
+        //! @param[in] size frame size.
+        //! @return decoded message (caller takes ownership) or NULL if
+        //! the keyframe of a delta frame was not received.
+        //! @throw std::runtime_error if the frame is malformed.
+        IMC::Message*
+        decode(const uint8_t* bfr, size_t size);
+
+        //! Force the next frame of every stream to be a keyframe.
+        void
+        reset(void);
+
+      private:
+        //! State of a stream of messages.
+        struct Stream
+        {
+          //! Keyframe sequence number.
+          uint8_t seq;
+          //! Number of delta frames since keyframe.
+          unsigned count;
+          //! Time of keyframe (monotonic clock), negative if none.
+          double time;
+          //! Keyframe timestamp.
+          double stamp;
+          //! Resolution exponents used in keyframe.
+          std::vector<int8_t> exps;
+          //! Quantized keyframe values.
+          std::vector<int64_t> values;
+
+          Stream(void):
+            seq(0),
+            count(0),
+            time(-1),
+            stamp(0)
+          { }
+        };
+
+        //! Message types selected for coding.
+        std::set<uint16_t> m_enabled;
+        //! Resolution exponents by message type.
+        std::map<uint16_t, std::vector<int8_t> > m_exps;
+        //! Maximum number of delta frames between keyframes.
+        unsigned m_key_frames;
+        //! Maximum time between keyframes.
+        double m_key_period;
+        //! Encoder streams.
+        std::map<uint64_t, Stream> m_tx;
+        //! Decoder streams.
+        std::map<uint64_t, Stream> m_rx;
+      };
+    }
+  }
+}
+
+#endif
@@ -231,6 +231,8 @@ main(int argc, char** argv)
        "HTTP server base directory", "DIR")
   .add("-c", "--config-file",
        "Load configuration file CONFIG", "CONFIG")
+  .add("-D", "--data-dir",
+       "Store logs and databases in DIR", "DIR")
   .add("-m", "--lock-memory",
        "Lock memory")
   .add("-p", "--profiles",
@@ -271,6 +273,14 @@ main(int argc, char** argv)
     context.dir_www = options.value("--www-dir");
   }
 
+  // If requested, keep logs and databases apart from other instances.
+  if (options.value("--data-dir") != "")
+  {
+    Path data_dir(options.value("--data-dir"));
+    context.dir_log = data_dir / "log";
+    context.dir_db = data_dir / "db";
+  }
+
   DUNE::Tasks::Factory::registerDynamicTasks(context.dir_lib.c_str());
   registerStaticTasks();
 
@@ -283,7 +293,11 @@ main(int argc, char** argv)
     return 1;
   }
 
-  Path cfg_file = context.dir_cfg / options.value("--config-file") + ".ini";
+  // Generated configuration files are given by path.
+  Path cfg_file(options.value("--config-file"));
+  if (!String::endsWith(cfg_file.str(), ".ini") || !cfg_file.isFile())
+    cfg_file = context.dir_cfg / options.value("--config-file") + ".ini";
+
   try
   {
     context.config.parseFile(cfg_file.c_str());
@@ -48,6 +48,10 @@ namespace Maneuver
       bool m_moving, m_increase_row, m_arrived, m_last_on_row;
       int m_current_row, m_times, m_param_times;
       double m_lat, m_lon, m_z, m_next_lat, m_next_lon, m_param_width;
+      double m_param_turn_radius;
+      unsigned m_param_headings, m_param_threads;
+      //! Coverage planner.
+      Maneuvers::Coverage m_coverage;
 
       Task(const std::string& name, Tasks::Context& ctx):
         DUNE::Maneuvers::Maneuver(name, ctx)
@@ -63,6 +67,21 @@ namespace Maneuver
         param("Row Width", m_param_width)
         .description("Width in meters of the rows")
         .defaultValue("300.0");
+
+        param("Turn Radius", m_param_turn_radius)
+        .units(Units::Meter)
+        .defaultValue("0.0")
+        .description("Minimum turn radius used to estimate the time spent in turns");
+
+        param("Candidate Headings", m_param_headings)
+        .defaultValue("36")
+        .description("Number of evenly spaced row headings evaluated besides "
+                     "the polygon edge directions");
+
+        param("Planning Threads", m_param_threads)
+        .defaultValue("1")
+        .minimumValue("1")
+        .description("Number of threads evaluating row headings");
       }
 
       void
@@ -83,141 +102,50 @@ namespace Maneuver
         m_times = m_param_times;
       }
 
-      Math::Matrix
-      intersectSegments(const Math::Matrix& seg1, const Math::Matrix& seg2, bool* isInSegment)
-      {
-        double m1 = (seg1(1, 1) - seg1(1, 0)) / (seg1(0, 1) - seg1(0, 0));
-        double m2 = (seg2(1, 1) - seg2(1, 0)) / (seg2(0, 1) - seg2(0, 0));
-
-        double b1 = seg1(1, 0) - m1 * seg1(0, 0);
-        double b2 = seg2(1, 0) - m2 * seg2(0, 0);
-        double xi = (b2 - b1) / (m1 - m2);
-        double yi = m1 * xi + b1;
-
-        if((std::abs(b1 - b2) < 0.5) && (std::abs(m1 - m2) < 0.5))
-            *isInSegment = false;
-        else
-            *isInSegment = (std::abs(xi-seg1(0, 0)) <= std::abs(seg1(0, 0) - seg1(0, 1)))
-            && (std::abs(xi - seg1(0, 1)) <= std::abs(seg1(0, 0) - seg1(0, 1)))
-            && (std::abs(xi - seg2(0, 0)) <= std::abs(seg2(0, 0) - seg2(0, 1)))
-            && (std::abs(xi - seg2(0, 1)) <= std::abs(seg2(0, 0) - seg2(0, 1)));
-        //checking if the intersection happens inside the segments
-
-        Math::Matrix intersection;
-        double data[] = {xi, yi};
-        intersection = Matrix(data, 2, 1);
-        return intersection;
-      }
-
-      Math::Matrix
-      intersectSegmentPolygon(const Math::Matrix& poly, double height)
+      //! Plan rows covering the polygon and store their end points.
+      //! @return true if rows were found, false otherwise.
+      bool
+      planRows(void)
       {
-        Math::Matrix segment, easting_row, intersection, intersected;
-        easting_row = poly.row(0);
-        int sides = poly.columns();
-        double data[] = {min(easting_row) - 10, max(easting_row) + 10, height, height};
-        segment = Matrix(data, 2, 2);
-        bool in_poly = false;
-        int intersect_found = 0;
-
-        for(int i = 0; i < sides; i++)
+        std::vector<double> lats;
+        std::vector<double> lons;
+        IMC::MessageList<IMC::PolygonVertex>::const_iterator it = m_maneuver.polygon.begin();
+        for (; it != m_maneuver.polygon.end(); ++it)
         {
-          if(i < sides - 1)
-            intersection = intersectSegments(poly.get(0, 1, i, i + 1), segment, &in_poly);
-          else
-          {
-            double coords[] = {poly(0, sides - 1), poly(0, 0), poly(1, sides - 1), poly(1, 0)};
-            Math::Matrix wrap_side = Matrix(coords, 2, 2);
-            intersection = intersectSegments(wrap_side, segment, &in_poly);
-          }
-
-          if(in_poly)
-          {
-            if(intersect_found)
-              intersected = intersected.horzCat(intersection);
-            else
-              intersected = Matrix(intersection);
-
-            intersect_found++;
-          }
-
-          if(intersect_found == 2)
-            break;
+          lats.push_back((*it)->lat);
+          lons.push_back((*it)->lon);
         }
 
-        return intersected;
-      }
+        m_coverage.setPolygon(m_lat, m_lon, lats, lons);
 
-      Math::Matrix
-      getRows(const Math::Matrix& poly, double direction, double width, double diam)
-      {
-        int n_rows = (int)std::ceil(diam / width);
-        double row_width = diam / n_rows;
-        double offset = row_width / 2;
-        double lower_north;
-        Math::Matrix rows, rotation, rotated_poly, northing_row;
-        double data[] = {std::cos(-direction), -std::sin(-direction), std::sin(-direction), std::cos(-direction)};
-        rotation = Matrix(data, 2, 2);
-        rotated_poly = rotation.multiply(poly);
-        northing_row = rotated_poly.row(1);
-        lower_north = min(northing_row);
-
-        rows = intersectSegmentPolygon(rotated_poly, lower_north + offset);
-
-        for(int i = 1; i < n_rows; i++)
-          rows = rows.horzCat(intersectSegmentPolygon(rotated_poly, i * row_width + lower_north + offset));
-
-        double data2[] = {std::cos(direction), -std::sin(direction), std::sin(direction), std::cos(direction)};
-        rotation = Matrix(data2, 2, 2);
-        rows = rotation.multiply(rows);
-
-        return rows;
-      }
+        Maneuvers::Coverage::Parameters params;
+        params.width = m_param_width;
+        params.speed = (m_maneuver.speed_units == IMC::SUNITS_METERS_PS) ? m_maneuver.speed : 1.0;
+        params.turn_radius = m_param_turn_radius;
+        params.headings = m_param_headings;
+        params.threads = m_param_threads;
 
-      //returns the direction in which the rows can be longer (which means less rows)
-      //diameter stores the length of the polygon in the perpendicular of that direction
-      double
-      longRowsDirection(const Math::Matrix& poly, double* diameter)
-      {
-        Math::Matrix rot_mtx, rotated_poly, northing_row, diams, curr_diam;
-        double angle_min = 0.0;
-        double diam = 100000000.00;
-        double step = Math::c_pi / 1800;
-
-        for(double angle = 0.0; angle < (Math::c_pi * 1.1); angle += step)
-        {
-          double data[] = {std::cos(-angle), -std::sin(-angle), std::sin(-angle), std::cos(-angle)};
-          rot_mtx = Matrix(data, 2, 2);
-
-          rotated_poly = rot_mtx.multiply(poly);
-          northing_row = rotated_poly.row(1);
+        Maneuvers::Coverage::Plan plan;
+        if (!m_coverage.plan(params, plan))
+          return false;
 
-          double d[1] = {(max(northing_row) - min(northing_row))};
-          curr_diam = Math::Matrix(d, 1, 1);
+        trace("heading %.2f degrees, %u rows in %u cells, %.0f m, %.0f s",
+              Angles::degrees(plan.heading), plan.rows, plan.cells, plan.length, plan.duration);
 
-          if(angle == 0)
-            diams = Math::Matrix(curr_diam);
-          else
-            diams = diams.horzCat(curr_diam);
+        // Row end points as columns (easting, northing).
+        m_rows = Math::Matrix(2, 2 * plan.rows);
+        unsigned col = 0;
+        for (size_t i = 0; i < plan.waypoints.size(); ++i)
+        {
+          if (plan.waypoints[i].type == Maneuvers::Coverage::WP_TURN)
+            continue;
 
-          if((max(northing_row) - min(northing_row)) < diam)
-          {
-            diam = (max(northing_row) - min(northing_row));
-            angle_min = angle;
-          }
+          m_rows(0, col) = plan.waypoints[i].east;
+          m_rows(1, col) = plan.waypoints[i].north;
+          ++col;
         }
 
-        if(angle_min >= Math::c_pi)
-          angle_min -= Math::c_pi;
-
-        double data[] = {std::cos(-angle_min), -std::sin(-angle_min), std::sin(-angle_min), std::cos(-angle_min)};
-        rot_mtx = Matrix(data, 2, 2);
-        rotated_poly = rot_mtx.multiply(poly);
-        northing_row = rotated_poly.row(1);
-
-        *diameter = (max(northing_row) - min(northing_row));
-
-        return angle_min;
+        return true;
       }
 
       //returns distance of point to the closest point in segment defined by the 2 points in row
@@ -341,9 +269,6 @@ namespace Maneuver
       {
         m_maneuver = *maneuver;
 
-        double n, e, op_dir, diameter;
-        Math::Matrix polygon, new_vtx;
-
         // Reject if no vertices are defined. Later on, a more proper
         // check should be used that verifies if we have a 2D polygon.
         if (!maneuver->polygon.size())
@@ -352,35 +277,18 @@ namespace Maneuver
           return;
         }
 
-        IMC::MessageList<IMC::PolygonVertex>::const_iterator it = maneuver->polygon.begin();
-
         m_path.speed = m_maneuver.speed;
         m_path.speed_units = m_maneuver.speed_units;
         m_z = m_maneuver.z;
         m_lon = m_maneuver.lon;
         m_lat = m_maneuver.lat;
 
-        e = 0;
-        n = 0;
-        double coords[]= {e, n};
-        polygon = Math::Matrix(coords, 2, 1);
-
-        for (; it != maneuver->polygon.end(); it++ )
+        if (!planRows())
         {
-          WGS84::displacement(m_lat, m_lon, 0, (*it)->lat, (*it)->lon, 0, &n, &e);
-          coords[0] = e;
-          coords[1] = n;
-          new_vtx = Math::Matrix(coords, 2, 1);
-          polygon = polygon.horzCat(new_vtx);
+          signalError(DTR("unable to cover area"));
+          return;
         }
 
-        op_dir = longRowsDirection(polygon, &diameter);
-
-        trace("Direction is %.2f degrees. Diameter is %.2f", 90 - op_dir * (180 / Math::c_pi), diameter);
-
-        m_rows = getRows(polygon, op_dir, m_param_width, diameter);
-
-        trace("%d rows found", m_rows.columns() / 2);
         m_moving = true;
         enableMovement(true);
       }
@@ -32,6 +32,7 @@
 
 // ISO C++ 98 headers.
 #include <cstring>
+#include <cmath>
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
@@ -62,12 +63,12 @@ namespace Monitors
       };
 
       //! Constructor.
-      //! @param[in] window_size moving averages window sizes
+      //! @param[in] window_size moving window sizes
       BatteryData(const unsigned window_size[BM_TOTAL])
       {
         for (unsigned i = 0; i < BM_TOTAL; ++i)
         {
-          m_avg[i] = new MovingAverage<float>(window_size[i]);
+          m_avg[i] = new RunningStatistics<double>(window_size[i]);
           m_measures[i] = false;
         }
       }
@@ -148,6 +149,18 @@ namespace Monitors
         return m_avg[BM_VOLTAGE]->mean() * m_avg[BM_CURRENT]->mean() * timestep / 3600.0;
       }
 
+      //! Compute the standard deviation of the energy drop, propagated
+      //! from the standard errors of the voltage and current means
+      //! @param[in] timestep elapsed time to use in computation
+      //! @return standard deviation of the computed energy drop
+      inline float
+      getEnergyDropDeviation(float timestep) const
+      {
+        double dv = m_avg[BM_CURRENT]->mean() * m_avg[BM_VOLTAGE]->standardError();
+        double di = m_avg[BM_VOLTAGE]->mean() * m_avg[BM_CURRENT]->standardError();
+        return std::sqrt(dv * dv + di * di) * timestep / 3600.0;
+      }
+
       //! Get voltage value
       //! @return voltage estimate
       inline float
@@ -172,6 +185,15 @@ namespace Monitors
         return m_avg[BM_TEMPERATURE]->mean();
       }
 
+      //! Get statistics of a measure
+      //! @param[in] bm battery measure type
+      //! @return windowed statistics of the measure
+      inline const RunningStatistics<double>&
+      getStatistics(BatteryMeasures bm) const
+      {
+        return *m_avg[bm];
+      }
+
       //! Check if we have measurements
       //! @return false if some measurement has not been received yet
       inline bool
@@ -185,8 +207,8 @@ namespace Monitors
       bool m_measures[BM_TOTAL];
       //! Pointer to entity ids
       unsigned* m_ents;
-      //! Moving averages
-      MovingAverage<float>* m_avg[BM_TOTAL];
+      //! Windowed statistics of each measure
+      RunningStatistics<double>* m_avg[BM_TOTAL];
     };
   }
 }
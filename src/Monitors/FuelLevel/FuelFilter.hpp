@@ -139,6 +139,7 @@ namespace Monitors
         m_bdata(NULL),
         m_epower(epower),
         m_energy_consumed(0.0),
+        m_energy_deviation(0.0),
         m_has_initial_estimate(false),
         m_last_time(-1.0),
         m_total_samples(0),
@@ -147,7 +148,12 @@ namespace Monitors
         m_sane_timer(c_sane_time, real_clock, start_time),
         m_is_maneuvering(true),
         m_est_rate(0.0),
-        m_task(task)
+        m_task(task),
+        m_curve_valid(false),
+        m_curve_voltage(-1.0f),
+        m_curve_current(-1.0f),
+        m_curve_energs(c_curve_points, 0.0f),
+        m_curve_confs(c_curve_points, 0.0f)
       {
         m_bdata = new BatteryData(m_args->avg_win);
         m_bdata->setEntities(eids);
@@ -189,6 +195,10 @@ namespace Monitors
             // integrate energy consumed even if there is no estimate yet
             // take energy from estimated entities into account
             m_energy_consumed += m_bdata->getEnergyDrop(delta) + m_est_rate * delta;
+
+            // successive moving windows share all but one sample, so
+            // their errors are correlated and deviations add linearly
+            m_energy_deviation += m_bdata->getEnergyDropDeviation(delta);
           }
         }
       }
@@ -345,6 +355,7 @@ namespace Monitors
 
             // Reset energy consumed
             m_energy_consumed = 0.0;
+            m_energy_deviation = 0.0;
 
             if (m_task != NULL)
               m_task->debug("recomputed estimate");
@@ -381,7 +392,8 @@ namespace Monitors
 
         if (m_task != NULL)
         {
-          m_task->trace("Energy Left %.2f Wh", m_initial_estimate - m_energy_consumed);
+          m_task->trace("Energy Left %.2f Wh (+/- %.2f Wh)", m_initial_estimate - m_energy_consumed,
+                        getEnergyConfidence());
 
           m_task->trace("Energy value deviates %.1f from pessimistic model and %1.f"
                         " from optimistic model.", getDeviationFromModel(MDL_PES),
@@ -393,7 +405,29 @@ namespace Monitors
         }
       }
 
+      //! Get energy consumed since the last estimate
+      //! @return energy consumed in Wh
+      inline float
+      getEnergyConsumed(void) const
+      {
+        return m_energy_consumed;
+      }
+
+      //! Get half-width of the confidence interval of the energy consumed.
+      //! The standard deviations of all integration steps are added,
+      //! which bounds the error when the windows are fully correlated
+      //! @param[in] z number of standard deviations (1.96 for 95%)
+      //! @return half-width of the confidence interval in Wh
+      inline float
+      getEnergyConfidence(float z = 1.96f) const
+      {
+        return z * m_energy_deviation;
+      }
+
     private:
+      //! Number of points in the confidence curve
+      static const unsigned c_curve_points = 5;
+
       //! Compute deviation from model
       //! @param[in] model model to be used to compute deviation
       //! @return deviation from given model
@@ -609,13 +643,31 @@ namespace Monitors
         }
       }
 
-      //! Compute a rough estimate of the confidence on the measure of energy (in %)
-      //! @param[in] energy to use
-      //! @return value of confidence computed
-      float
-      computeConfidence(float energy)
+      //! Set a point of the confidence curve
+      inline void
+      setCurvePoint(unsigned index, float energy, float confidence)
       {
-        float conf;
+        m_curve_energs[index] = energy;
+        m_curve_confs[index] = confidence;
+      }
+
+      //! Refresh the confidence curve. The curve only depends on the
+      //! averaged voltage and current, so it is rebuilt when either
+      //! changes and reused otherwise.
+      //! @return true if the curve is valid, false otherwise
+      bool
+      updateConfidenceCurve(void)
+      {
+        float voltage = m_bdata->getVoltage();
+        float current = m_bdata->getCurrent();
+
+        if (voltage == m_curve_voltage && current == m_curve_current)
+          return m_curve_valid;
+
+        m_curve_voltage = voltage;
+        m_curve_current = current;
+        m_curve_valid = false;
+
         float good_est = getModelEstimate(MDL_OPT);
         float bad_est = getModelEstimate(MDL_PES);
         float merged_est = getMergedEstimate(MGD_RATED);
@@ -623,45 +675,53 @@ namespace Monitors
 
         // division by zero check (should never happen)
         if (interval == 0.0)
-          return -1.0;
+          return false;
 
         float good_conf;
         float bad_conf;
         goodBadConfidence(good_conf, bad_conf, interval,
                           good_est, bad_est, merged_est);
 
-        std::vector<float> vec_energs, vec_confs;
+        setCurvePoint(0, 0.0f, 0.0f);
+        setCurvePoint(4, m_args->full_capacity, 0.0f);
 
         if (merged_est >= bad_est && merged_est <= good_est)
         {
-          float energs[] = {0.0f, bad_est, merged_est, good_est, m_args->full_capacity};
-          float confs[] = {0.0f, bad_conf, c_top_conf, good_conf, 0.0f};
-
-          vec_energs.assign(energs, energs + sizeof(energs) / sizeof(float));
-          vec_confs.assign(confs, confs + sizeof(confs) / sizeof(float));
+          setCurvePoint(1, bad_est, bad_conf);
+          setCurvePoint(2, merged_est, c_top_conf);
+          setCurvePoint(3, good_est, good_conf);
         }
         else if (merged_est < bad_est)
         {
-          float energs[] = {0.0f, merged_est, bad_est, good_est, m_args->full_capacity};
-          float confs[] = {0.0f, c_top_conf, bad_conf, good_conf, 0.0f};
-
-          vec_energs.assign(energs, energs + sizeof(energs) / sizeof(float));
-          vec_confs.assign(confs, confs + sizeof(confs) / sizeof(float));
+          setCurvePoint(1, merged_est, c_top_conf);
+          setCurvePoint(2, bad_est, bad_conf);
+          setCurvePoint(3, good_est, good_conf);
         }
         else if (merged_est > good_est)
         {
-          float energs[] = {0.0f, bad_est, good_est, merged_est, m_args->full_capacity};
-          float confs[] = {0.0f, bad_conf, good_conf, c_top_conf, 0.0f};
-
-          vec_energs.assign(energs, energs + sizeof(energs) / sizeof(float));
-          vec_confs.assign(confs, confs + sizeof(confs) / sizeof(float));
+          setCurvePoint(1, bad_est, bad_conf);
+          setCurvePoint(2, good_est, good_conf);
+          setCurvePoint(3, merged_est, c_top_conf);
         }
         else
         {
-          return -1.0;
+          return false;
         }
 
-        conf = piecewiseLI(vec_confs, vec_energs, energy);
+        m_curve_valid = true;
+        return true;
+      }
+
+      //! Compute a rough estimate of the confidence on the measure of energy (in %)
+      //! @param[in] energy to use
+      //! @return value of confidence computed
+      float
+      computeConfidence(float energy)
+      {
+        if (!updateConfidenceCurve())
+          return -1.0;
+
+        float conf = piecewiseLI(m_curve_confs, m_curve_energs, energy);
 
         return std::max(conf, 0.0f);
       }
@@ -742,6 +802,8 @@ namespace Monitors
       const EPMap* m_epower;
       //! Estimated amount of energy consumed in Wh since the task started
       float m_energy_consumed;
+      //! Standard deviation of the energy consumed due to measurement noise
+      float m_energy_deviation;
       //! Do we have an initial estimate
       bool m_has_initial_estimate;
       //! Initial estimate of energy left in the batteries
@@ -764,6 +826,16 @@ namespace Monitors
       float m_est_rate;
       //! Pointer to typename T (which could be class Task)
       Tasks::Task* m_task;
+      //! True if the confidence curve is valid
+      bool m_curve_valid;
+      //! Averaged voltage used to build the confidence curve
+      float m_curve_voltage;
+      //! Averaged current used to build the confidence curve
+      float m_curve_current;
+      //! Energy values of the confidence curve
+      std::vector<float> m_curve_energs;
+      //! Confidence values of the confidence curve
+      std::vector<float> m_curve_confs;
     };
   }
 }
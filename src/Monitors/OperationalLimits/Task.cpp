@@ -102,6 +102,8 @@ namespace Monitors
       LErrorMap m_errs;
       //! Limits in use.
       IMC::OperationalLimits m_ol;
+      //! Local frame at the operational area reference.
+      Coordinates::LocalFrame m_ol_frame;
       //! Last EstimatedState message
       IMC::EstimatedState m_estate;
       //! Error mask.
@@ -382,7 +384,8 @@ namespace Monitors
         {
           double x, y;
 
-          WGS84::displacement(m_ol.lat, m_ol.lon, 0, m_estate.lat, m_estate.lon, 0, &x, &y);
+          m_ol_frame.setReference(m_ol.lat, m_ol.lon);
+          m_ol_frame.displacement(m_estate.lat, m_estate.lon, 0, &x, &y);
 
           x += m_estate.x;
           y += m_estate.y;
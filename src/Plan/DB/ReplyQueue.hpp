@@ -0,0 +1,130 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Eduardo Marques                                                  *
+//***************************************************************************
+
+#ifndef PLAN_DB_REPLY_QUEUE_HPP_INCLUDED_
+#define PLAN_DB_REPLY_QUEUE_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+namespace Plan
+{
+  namespace DB
+  {
+    using DUNE_NAMESPACES;
+
+    //! Replies to database requests, in request order. Successful
+    //! changes are only acknowledged once committed, and any final
+    //! reply that follows a held acknowledgement waits behind it.
+    //! Progress replies are never held.
+    class ReplyQueue
+    {
+    public:
+      //! Post a reply.
+      //! @param[in] msg reply.
+      //! @param[in] uncommitted true if the database has uncommitted
+      //! changes.
+      //! @return true if the reply can be sent now, false if it is
+      //! held until the changes are committed or discarded.
+      bool
+      post(const IMC::PlanDB& msg, bool uncommitted)
+      {
+        if (msg.type == IMC::PlanDB::DBT_IN_PROGRESS)
+          return true;
+
+        if (m_held.empty() && !(uncommitted && isChange(msg)))
+          return true;
+
+        m_held.push_back(msg);
+        return false;
+      }
+
+      //! Release held replies once changes are committed.
+      //! @param[out] out replies to send, in order.
+      void
+      commit(std::vector<IMC::PlanDB>& out)
+      {
+        out.swap(m_held);
+        m_held.clear();
+      }
+
+      //! Fail held replies once changes are discarded. Replies to
+      //! requests that read discarded changes fail as well.
+      //! @param[in] reason failure description.
+      //! @param[out] out replies to send, in order.
+      void
+      abort(const std::string& reason, std::vector<IMC::PlanDB>& out)
+      {
+        for (size_t i = 0; i < m_held.size(); ++i)
+        {
+          if (m_held[i].type != IMC::PlanDB::DBT_SUCCESS)
+            continue;
+
+          m_held[i].type = IMC::PlanDB::DBT_FAILURE;
+          m_held[i].info = reason;
+          m_held[i].arg.clear();
+        }
+
+        commit(out);
+      }
+
+      //! Check if replies are being held.
+      //! @return true if no replies are held, false otherwise.
+      bool
+      empty(void) const
+      {
+        return m_held.empty();
+      }
+
+    private:
+      //! Held replies.
+      std::vector<IMC::PlanDB> m_held;
+
+      //! Check if a reply acknowledges a change.
+      //! @param[in] msg reply.
+      //! @return true if the reply acknowledges a change.
+      static bool
+      isChange(const IMC::PlanDB& msg)
+      {
+        if (msg.type != IMC::PlanDB::DBT_SUCCESS)
+          return false;
+
+        return msg.op == IMC::PlanDB::DBOP_SET
+        || msg.op == IMC::PlanDB::DBOP_DEL
+        || msg.op == IMC::PlanDB::DBOP_CLEAR;
+      }
+    };
+  }
+}
+
+#endif
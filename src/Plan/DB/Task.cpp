@@ -29,10 +29,16 @@
 
 // ISO C++ 98 headers.
 #include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
+// Local headers.
+#include "ReplyQueue.hpp"
+
 namespace Plan
 {
   namespace DB
@@ -49,15 +55,13 @@ namespace Plan
     " data blob not null"
     " )"
     ;
-    static const char* c_insert_plan_stmt = "insert into Plan values(?,?,?,?,?,?)";
+    static const char* c_insert_plan_stmt = "insert or replace into Plan values(?,?,?,?,?,?)";
+    static const char* c_touch_plan_stmt =
+    "update Plan set change_time=?, change_sid=?, change_sname=? where plan_id=?";
     static const char* c_delete_plan_stmt = "delete from Plan where plan_id=?";
-    static const char* c_plan_iterator_stmt =
-    "select plan_id, change_time, change_sid, change_sname, md5, length(data)"
+    static const char* c_load_plans_stmt =
+    "select plan_id, change_time, change_sid, change_sname, md5, data "
     "from Plan order by plan_id";
-    static const char* c_query_plan_stmt =
-    "select change_time, change_sid, change_sname, md5, length(data)"
-    "from Plan where plan_id=?";
-    static const char* c_get_plan_stmt = "select data from Plan where plan_id=?";
     static const char* c_delete_all_plans_stmt = "delete from Plan";
 
     static const char* c_lastchange_table_stmt =
@@ -77,12 +81,29 @@ namespace Plan
                                       DTR_RT("clear database"), DTR_RT("database state"),
                                       DTR_RT("database initialization")};
 
+    static const char* c_savepoint_stmt = "savepoint request";
+    static const char* c_release_stmt = "release request";
+    static const char* c_rollback_to_stmt = "rollback to request";
+
+    static const char* c_wal_stmt = "pragma journal_mode=WAL";
+    static const char* c_sync_stmt = "pragma synchronous=FULL";
+
     struct Arguments
     {
       //! Path to DB file
       std::string db_path;
     };
 
+    //! Stored plan and its information.
+    struct CachedPlan
+    {
+      IMC::PlanSpecification spec;
+      IMC::PlanDBInformation info;
+    };
+
+    //! Plans by identifier, in database order.
+    typedef std::map<std::string, CachedPlan> PlanCache;
+
     struct Task: public DUNE::Tasks::Task
     {
       // Task arguments
@@ -95,20 +116,35 @@ namespace Plan
       IMC::PlanDBInformation m_plan_info;
       // Statements
       Database::Statement* m_insert_plan_stmt;
+      Database::Statement* m_touch_plan_stmt;
       Database::Statement* m_delete_plan_stmt;
-      Database::Statement* m_plan_iterator_stmt;
-      Database::Statement* m_query_plan_stmt;
-      Database::Statement* m_get_plan_stmt;
       Database::Statement* m_delete_all_plans_stmt;
       Database::Statement* m_lastchange_update_stmt;
       Database::Statement* m_lastchange_query_stmt;
       // Local request counter
       uint16_t m_local_reqid;
+      // Contents of the Plan table.
+      PlanCache m_plans;
+      // Contents of the LastChange table.
+      double m_change_time;
+      uint16_t m_change_sid;
+      std::string m_change_sname;
+      // Database state, valid until the next change.
+      IMC::PlanDBState m_state;
+      bool m_state_valid;
+      // True if there are uncommitted changes.
+      bool m_batch;
+      // Replies held until the batch is committed.
+      ReplyQueue m_replies;
 
       Task(const std::string& name, Tasks::Context& ctx):
         DUNE::Tasks::Task(name, ctx),
         m_db(NULL),
-        m_local_reqid(0)
+        m_local_reqid(0),
+        m_change_time(0),
+        m_change_sid(0),
+        m_state_valid(false),
+        m_batch(false)
       {
         param("DB Path", m_args.db_path)
         .defaultValue("")
@@ -142,13 +178,24 @@ namespace Plan
 
         m_db = new Database::Connection(db_file.c_str(), Database::Connection::CF_CREATE);
 
+        // Changes are appended to a write-ahead log and committed in
+        // batches. Each commit is synced before its changes are
+        // acknowledged, so acknowledged changes survive power loss.
+        try
+        {
+          m_db->execute(c_wal_stmt);
+          m_db->execute(c_sync_stmt);
+        }
+        catch (std::runtime_error& e)
+        {
+          war(DTR("unable to enable write-ahead logging: %s"), e.what());
+        }
+
         // Create Plan table and initialize associated statements
         m_db->execute(c_plan_table_stmt);
         m_insert_plan_stmt = new Database::Statement(c_insert_plan_stmt, *m_db);
+        m_touch_plan_stmt = new Database::Statement(c_touch_plan_stmt, *m_db);
         m_delete_plan_stmt = new Database::Statement(c_delete_plan_stmt, *m_db);
-        m_plan_iterator_stmt = new Database::Statement(c_plan_iterator_stmt, *m_db);
-        m_query_plan_stmt = new Database::Statement(c_query_plan_stmt, *m_db);
-        m_get_plan_stmt = new Database::Statement(c_get_plan_stmt, *m_db);
         m_delete_all_plans_stmt = new Database::Statement(c_delete_all_plans_stmt, *m_db);
 
         // Create Plan table and initialize associated statements
@@ -166,6 +213,9 @@ namespace Plan
 
         m_lastchange_query_stmt->reset();
 
+        loadCache();
+        inf(DTR("%u plans in database"), (unsigned)m_plans.size());
+
         setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
 
         onSuccess(DTR("initialization complete"));
@@ -177,17 +227,147 @@ namespace Plan
         if (m_db == NULL)
           return;
 
+        commitBatch();
+
         delete m_insert_plan_stmt;
+        delete m_touch_plan_stmt;
         delete m_delete_plan_stmt;
-        delete m_plan_iterator_stmt;
-        delete m_query_plan_stmt;
-        delete m_get_plan_stmt;
         delete m_delete_all_plans_stmt;
         delete m_lastchange_update_stmt;
         delete m_lastchange_query_stmt;
         delete m_db;
 
         m_db = NULL;
+        m_plans.clear();
+        m_state_valid = false;
+      }
+
+      //! Read all plans and the last change into memory.
+      void
+      loadCache(void)
+      {
+        m_plans.clear();
+        m_state_valid = false;
+
+        Database::Statement load(c_load_plans_stmt, *m_db);
+        while (load.execute())
+        {
+          std::string id;
+          Database::Blob data;
+          load >> id;
+
+          CachedPlan& plan = m_plans[id];
+          plan.info.plan_id = id;
+          load >> plan.info.change_time
+               >> plan.info.change_sid
+               >> plan.info.change_sname
+               >> plan.info.md5
+               >> data;
+
+          plan.info.plan_size = data.size();
+          if (!data.empty())
+            plan.spec.deserializeFields((const uint8_t*)&data[0], data.size());
+        }
+
+        m_lastchange_query_stmt->execute();
+        *m_lastchange_query_stmt >> m_change_time
+                                 >> m_change_sid
+                                 >> m_change_sname;
+        m_lastchange_query_stmt->reset();
+      }
+
+      //! Start a batch of changes, if not started yet.
+      void
+      beginBatch(void)
+      {
+        if (m_batch)
+          return;
+
+        m_db->beginTransaction();
+        m_batch = true;
+      }
+
+      //! Commit pending changes and acknowledge them.
+      void
+      commitBatch(void)
+      {
+        if (!m_batch)
+          return;
+
+        m_batch = false;
+
+        try
+        {
+          m_db->commit();
+        }
+        catch (std::runtime_error& e)
+        {
+          err(DTR("failed to commit changes: %s"), e.what());
+          abortBatch(e.what());
+          return;
+        }
+
+        std::vector<IMC::PlanDB> replies;
+        m_replies.commit(replies);
+
+        for (unsigned i = 0; i < replies.size(); ++i)
+          reply(replies[i]);
+      }
+
+      //! Discard pending changes, fail their requests and
+      //! resynchronize memory with the database.
+      //! @param[in] reason failure description.
+      void
+      abortBatch(const char* reason)
+      {
+        try
+        {
+          m_db->rollback();
+        }
+        catch (std::runtime_error&)
+        { }
+
+        m_batch = false;
+        loadCache();
+
+        std::vector<IMC::PlanDB> replies;
+        m_replies.abort(reason, replies);
+
+        for (unsigned i = 0; i < replies.size(); ++i)
+          reply(replies[i]);
+      }
+
+      //! Start the changes of a request. Each request is a savepoint
+      //! of the batch, so a failed request does not discard the
+      //! changes of the requests before it.
+      void
+      beginChange(void)
+      {
+        beginBatch();
+        m_db->execute(c_savepoint_stmt);
+      }
+
+      //! Keep the changes of a request in the batch.
+      void
+      endChange(void)
+      {
+        m_db->execute(c_release_stmt);
+      }
+
+      //! Undo the changes of a failed request.
+      //! @param[in] reason failure description.
+      void
+      undoChange(const char* reason)
+      {
+        try
+        {
+          m_db->execute(c_rollback_to_stmt);
+          m_db->execute(c_release_stmt);
+        }
+        catch (std::runtime_error&)
+        {
+          abortBatch(reason);
+        }
       }
 
       void
@@ -326,6 +506,11 @@ namespace Plan
 
         if (count != 1)
           throw std::runtime_error(DTR("database is corrupt"));
+
+        m_change_time = time;
+        m_change_sid = sid;
+        m_change_sname = sname;
+        m_state_valid = false;
       }
 
       void
@@ -359,27 +544,52 @@ namespace Plan
       void
       storeInDB(const IMC::PlanSpecification* spec)
       {
-        m_plan_info.plan_size = spec->getPayloadSerializationSize();
+        uint16_t size = spec->getPayloadSerializationSize();
+        Database::Blob plan_data(size);
+        spec->serializeFields((uint8_t*)&plan_data[0]);
+
+        std::vector<char> md5(16);
+        MD5::compute((uint8_t*)&plan_data[0], size, (uint8_t*)&md5[0]);
+
+        m_plan_info.plan_size = size;
         m_plan_info.plan_id = spec->plan_id;
         m_plan_info.change_time = Clock::getSinceEpoch();
         m_plan_info.change_sid = spec->getSource();
         m_plan_info.change_sname = resolveSystemId(m_plan_info.change_sid);
+        m_plan_info.md5 = md5;
 
-        Database::Blob plan_data(m_plan_info.plan_size);
-        spec->serializeFields((uint8_t*)&plan_data[0]);
-
-        m_plan_info.md5.resize(16);
-        MD5::compute((uint8_t*)&plan_data[0], m_plan_info.plan_size, (uint8_t*)&m_plan_info.md5[0]);
+        // Resynchronizing consoles send plans that are already stored:
+        // only record the change, without rewriting the plan.
+        PlanCache::iterator itr = m_plans.find(spec->plan_id);
+        if (itr != m_plans.end() && itr->second.info.md5 == md5)
+        {
+          try
+          {
+            beginChange();
+            *m_touch_plan_stmt << m_plan_info.change_time
+                               << m_plan_info.change_sid
+                               << m_plan_info.change_sname
+                               << m_plan_info.plan_id;
+            m_touch_plan_stmt->execute();
+            onChange(m_plan_info.change_time, m_plan_info.change_sid, m_plan_info.change_sname);
+            endChange();
+          }
+          catch (std::runtime_error& e)
+          {
+            undoChange(e.what());
+            onFailure(e.what());
+            return;
+          }
 
-        m_db->beginTransaction();
+          itr->second.info = m_plan_info;
+          m_reply.arg.set(m_plan_info);
+          onSuccess(DTR("OK (unchanged)"));
+          return;
+        }
 
-        int count = 0;
         try
         {
-          *m_delete_plan_stmt << m_plan_info.plan_id;
-          m_delete_plan_stmt->execute(&count);
-          m_delete_plan_stmt->reset();
-
+          beginChange();
           *m_insert_plan_stmt << m_plan_info.plan_id
                               << m_plan_info.change_time
                               << m_plan_info.change_sid
@@ -388,17 +598,22 @@ namespace Plan
                               << plan_data;
           m_insert_plan_stmt->execute();
           onChange(m_plan_info.change_time, m_plan_info.change_sid, m_plan_info.change_sname);
+          endChange();
         }
         catch (std::runtime_error& e)
         {
+          undoChange(e.what());
           onFailure(e.what());
-          m_db->rollback();
+          return;
         }
 
-        m_db->commit();
+        bool updated = itr != m_plans.end();
+        CachedPlan& plan = m_plans[spec->plan_id];
+        plan.spec = *spec;
+        plan.info = m_plan_info;
 
         m_reply.arg.set(m_plan_info);
-        onSuccess(count ? DTR("OK (updated)") : DTR("OK (new entry)"));
+        onSuccess(updated ? DTR("OK (updated)") : DTR("OK (new entry)"));
       }
 
       void
@@ -411,29 +626,31 @@ namespace Plan
         }
 
         inProgress();
-        m_db->beginTransaction();
 
-        int count = 0;
+        PlanCache::iterator itr = m_plans.find(req.plan_id);
+        if (itr == m_plans.end())
+        {
+          onFailure(DTR("undefined plan"));
+          return;
+        }
+
         try
         {
+          beginChange();
           *m_delete_plan_stmt << req.plan_id;
-          m_delete_plan_stmt->execute(&count);
-          if (count)
-            onChange(req);
+          m_delete_plan_stmt->execute();
+          onChange(req);
+          endChange();
         }
         catch (std::runtime_error& e)
         {
+          undoChange(e.what());
           onFailure(e.what());
-          m_db->rollback();
           return;
         }
 
-        m_db->commit();
-
-        if (!count)
-          onFailure(DTR("undefined plan"));
-        else
-          onSuccess();
+        m_plans.erase(itr);
+        onSuccess();
       }
 
       void
@@ -445,26 +662,15 @@ namespace Plan
           return;
         }
 
-        *m_get_plan_stmt << req.plan_id;
-
-        bool found = m_get_plan_stmt->execute();
-
-        if (!found)
+        PlanCache::const_iterator itr = m_plans.find(req.plan_id);
+        if (itr == m_plans.end())
         {
           onFailure(DTR("undefined plan"));
+          return;
         }
-        else
-        {
-          Database::Blob data;
-          *m_get_plan_stmt >> data;
 
-          IMC::PlanSpecification spec;
-          spec.deserializeFields((const uint8_t*)&data[0], data.size());
-          m_reply.arg.set(&spec);
-
-          onSuccess();
-        }
-        m_get_plan_stmt->reset();
+        m_reply.arg.set(itr->second.spec);
+        onSuccess();
       }
 
       void
@@ -476,26 +682,14 @@ namespace Plan
           return;
         }
 
-        *m_query_plan_stmt << req.plan_id;
-
-        bool found = m_query_plan_stmt->execute();
-
-        if (!found)
+        PlanCache::const_iterator itr = m_plans.find(req.plan_id);
+        if (itr == m_plans.end())
         {
           onFailure(DTR("undefined plan"));
           return;
         }
 
-        m_plan_info.plan_id = req.plan_id;
-        *m_query_plan_stmt >> m_plan_info.change_time
-                           >> m_plan_info.change_sid
-                           >> m_plan_info.change_sname
-                           >> m_plan_info.md5
-                           >> m_plan_info.plan_size;
-
-        m_reply.arg.set(m_plan_info);
-        m_query_plan_stmt->reset();
-
+        m_reply.arg.set(itr->second.info);
         onSuccess();
       }
 
@@ -503,21 +697,22 @@ namespace Plan
       clearDatabase(const IMC::PlanDB& req)
       {
         inProgress();
-        m_db->beginTransaction();
 
         try
         {
+          beginChange();
           m_delete_all_plans_stmt->execute();
           onChange(req);
+          endChange();
         }
         catch (std::runtime_error& e)
         {
+          undoChange(e.what());
           onFailure(e.what());
-          m_db->rollback();
           return;
         }
 
-        m_db->commit();
+        m_plans.clear();
         onSuccess();
       }
 
@@ -525,50 +720,36 @@ namespace Plan
       getDatabaseState(const IMC::PlanDB& req)
       {
         (void)req;
-        IMC::PlanDBState* state = new IMC::PlanDBState;
-
-        state->plan_size = 0;
-        state->plan_count = 0;
-
-        MD5 md5sum;
 
-        IMC::MessageList<PlanDBInformation>* plandbinfo = &state->plans_info;
-
-        while (m_plan_iterator_stmt->execute())
+        if (!m_state_valid)
         {
-          IMC::PlanDBInformation* pinfo = new IMC::PlanDBInformation;
-
-          *m_plan_iterator_stmt >> pinfo->plan_id
-                                >> pinfo->change_time
-                                >> pinfo->change_sid
-                                >> pinfo->change_sname
-                                >> pinfo->md5
-                                >> pinfo->plan_size;
+          m_state.clear();
+          m_state.plan_size = 0;
+          m_state.plan_count = 0;
 
-          md5sum.update((const uint8_t*)&pinfo->md5[0], 16); // the MD5 of all MD5s ordered by plan_id
-          state->plan_size += pinfo->plan_size;
-          state->plan_count++;
+          // The MD5 of all MD5s ordered by plan_id.
+          MD5 md5sum;
 
-          plandbinfo->push_back(*pinfo);
+          for (PlanCache::const_iterator itr = m_plans.begin(); itr != m_plans.end(); ++itr)
+          {
+            const IMC::PlanDBInformation& info = itr->second.info;
+            md5sum.update((const uint8_t*)&info.md5[0], 16);
+            m_state.plan_size += info.plan_size;
+            m_state.plan_count++;
+            m_state.plans_info.push_back(info);
+          }
 
-          delete pinfo;
+          m_state.md5.resize(16);
+          md5sum.finalize((uint8_t*)&m_state.md5[0]);
+          m_state_valid = true;
         }
-        m_plan_iterator_stmt->reset();
 
-        // Finalized MD5 digest
-        state->md5.resize(16);
-        md5sum.finalize((uint8_t*)&state->md5[0]);
+        m_state.change_time = m_change_time;
+        m_state.change_sid = m_change_sid;
+        m_state.change_sname = m_change_sname;
 
-        m_lastchange_query_stmt->execute();
-        *m_lastchange_query_stmt >> state->change_time
-                                 >> state->change_sid
-                                 >> state->change_sname;
-        m_lastchange_query_stmt->reset();
-
-        m_reply.arg.set(*state);
+        m_reply.arg.set(m_state);
         onSuccess();
-
-        delete state;
       }
 
       void
@@ -576,23 +757,33 @@ namespace Plan
       {
         m_reply.type = type;
         m_reply.info = desc;
-        dispatch(m_reply);
 
-        switch (m_reply.op)
+        // Changes are only acknowledged once committed, and later
+        // replies must not overtake them.
+        if (m_replies.post(m_reply, m_batch))
+          reply(m_reply);
+      }
+
+      void
+      reply(IMC::PlanDB& msg)
+      {
+        dispatch(msg);
+
+        switch (msg.op)
         {
           case IMC::PlanDB::DBOP_SET:
           case IMC::PlanDB::DBOP_DEL:
           case IMC::PlanDB::DBOP_CLEAR:
             {
-              if (type == IMC::PlanDB::DBT_FAILURE)
-                err("%s (%s) -- %s", DTR(c_op_desc[m_reply.op]),
-                    m_reply.plan_id.c_str(), desc);
-              else if (type == IMC::PlanDB::DBT_SUCCESS)
-                inf("%s (%s) -- %s", DTR(c_op_desc[m_reply.op]),
-                    m_reply.plan_id.c_str(), desc);
+              if (msg.type == IMC::PlanDB::DBT_FAILURE)
+                err("%s (%s) -- %s", DTR(c_op_desc[msg.op]),
+                    msg.plan_id.c_str(), msg.info.c_str());
+              else if (msg.type == IMC::PlanDB::DBT_SUCCESS)
+                inf("%s (%s) -- %s", DTR(c_op_desc[msg.op]),
+                    msg.plan_id.c_str(), msg.info.c_str());
               else
-                debug("%s (%s) -- %s", DTR(c_op_desc[m_reply.op]),
-                      m_reply.plan_id.c_str(), desc);
+                debug("%s (%s) -- %s", DTR(c_op_desc[msg.op]),
+                      msg.plan_id.c_str(), msg.info.c_str());
             }
         }
       }
@@ -621,6 +812,10 @@ namespace Plan
         while (!stopping())
         {
           waitForMessages(1.0);
+
+          // Requests received together are committed together.
+          if (m_db != NULL)
+            commitBatch();
         }
       }
     };
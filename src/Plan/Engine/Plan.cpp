@@ -112,6 +112,8 @@ namespace Plan
       if (m_profiles != NULL)
         m_profiles->clear();
 
+      m_timeline.clear();
+
       if (m_calib != NULL)
         m_calib->clear();
 
@@ -199,13 +201,8 @@ namespace Plan
 
       m_rt_stat->maneuverStopped();
 
-      const std::string& str_last = m_profiles->lastValid();
-
-      if (!str_last.empty())
-      {
-        if (m_curr_node->pman->maneuver_id == str_last)
-          m_beyond_dur = true;
-      }
+      if (m_timeline.isLastValid())
+        m_beyond_dur = true;
 
       if (m_sched == NULL)
         return;
@@ -330,24 +327,6 @@ namespace Plan
 
     // Private
 
-    float
-    Plan::getExecutionDuration(void) const
-    {
-      if (!isLinear() || !m_profiles->size())
-        return -1.0;
-
-      const std::string& str_last = m_profiles->lastValid();
-
-      if (str_last.empty())
-        return -1.0;
-
-      TimeProfile::const_iterator itr = m_profiles->find(str_last);
-      if (itr == m_profiles->end())
-        return -1.0;
-
-      return itr->second.durations.back();
-    }
-
     bool
     Plan::waitingForDevice(void)
     {
@@ -465,6 +444,7 @@ namespace Plan
         if (isLinear() && state != NULL)
         {
           m_profiles->parse(m_seq_nodes, state);
+          m_timeline.build(m_seq_nodes, *m_profiles);
 
           Timeline tline;
           fillTimeline(tline);
@@ -550,6 +530,8 @@ namespace Plan
     {
       PlanMap::iterator itr = m_graph.find(id);
 
+      m_timeline.select(id);
+
       if (itr == m_graph.end())
       {
         return NULL;
@@ -591,11 +573,10 @@ namespace Plan
           mcs->eta == 0)
         return m_progress;
 
-      TimeProfile::const_iterator itr;
-      itr = m_profiles->find(getCurrentId());
+      const ProgressTimeline::Entry* entry = m_timeline.getCurrent();
 
       // If not found
-      if (itr == m_profiles->end())
+      if (entry == NULL)
       {
         // If beyond the last maneuver with valid duration
         if (m_beyond_dur)
@@ -610,13 +591,13 @@ namespace Plan
       }
 
       // If durations vector for this maneuver is empty
-      if (!itr->second.durations.size())
+      if (entry->durations->empty())
         return m_progress;
 
-      IMC::Message* man = m_graph.find(getCurrentId())->second.pman->data.get();
+      IMC::Message* man = m_curr_node->pman->data.get();
 
       // Get execution progress
-      float exec_prog = Progress::compute(man, mcs, itr->second.durations, exec_duration);
+      float exec_prog = Progress::compute(man, mcs, *entry->durations, exec_duration);
 
       float prog = 100.0 - getExecutionPercentage() * (1.0 - exec_prog / 100.0);
 
@@ -739,22 +720,19 @@ namespace Plan
       float maneuver_end_eta = -1.0;
 
       // Iterate through plan maneuvers
-      for (; itr != m_seq_nodes.end(); ++itr)
+      for (size_t i = 0; itr != m_seq_nodes.end(); ++itr, ++i)
       {
         if (itr == m_seq_nodes.begin())
           maneuver_start_eta = execution_duration;
         else
           maneuver_start_eta = maneuver_end_eta;
 
-        TimeProfile::const_iterator dur;
-        dur = m_profiles->find((*itr)->maneuver_id);
+        const ProgressTimeline::Entry& entry = m_timeline[i];
 
-        if (dur == m_profiles->end())
+        if (entry.end < 0.0)
           maneuver_end_eta = -1.0;
-        else if (dur->second.durations.size())
-          maneuver_end_eta = execution_duration - dur->second.durations.back();
         else
-          maneuver_end_eta = -1.0;
+          maneuver_end_eta = execution_duration - entry.end;
 
         // Fill timeline
         tl.setManeuverETA((*itr)->maneuver_id, maneuver_start_eta, maneuver_end_eta);
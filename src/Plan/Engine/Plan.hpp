@@ -40,6 +40,7 @@
 #include "Calibration.hpp"
 #include "ActionSchedule.hpp"
 #include "Timeline.hpp"
+#include "ProgressTimeline.hpp"
 #include "FuelPrediction.hpp"
 #include "Statistics.hpp"
 
@@ -208,8 +209,11 @@ namespace Plan
       //! Get duration of the execution phase of the plan
       //! (total of maneuver accumulated duration)
       //! @return duration of the execution phase of the plan
-      float
-      getExecutionDuration(void) const;
+      inline float
+      getExecutionDuration(void) const
+      {
+        return m_timeline.getExecutionDuration();
+      }
 
       //! Get total duration of the plan
       //! @return total duration of the plan
@@ -336,6 +340,8 @@ namespace Plan
       std::vector<IMC::PlanManeuver*> m_seq_nodes;
       //! Pointer to maneuver durations
       Plans::TimeProfile* m_profiles;
+      //! Maneuver durations indexed by position in the plan
+      ProgressTimeline m_timeline;
       //! Flag to signal that the plan is past the last maneuver with a valid duration
       bool m_beyond_dur;
       //! Schedule for actions to take during plan
@@ -0,0 +1,202 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef PLAN_ENGINE_PROGRESS_TIMELINE_HPP_INCLUDED_
+#define PLAN_ENGINE_PROGRESS_TIMELINE_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <map>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+namespace Plan
+{
+  namespace Engine
+  {
+    using DUNE_NAMESPACES;
+
+    // Export DLL Symbol.
+    class DUNE_DLL_SYM ProgressTimeline;
+
+    //! Per-maneuver view of a plan's time profile, indexed by the
+    //! maneuver's position in the sequenced plan. It is built once
+    //! after the time profile is parsed so that progress reports only
+    //! need constant time lookups.
+    class ProgressTimeline
+    {
+    public:
+      //! Timeline entry of a single maneuver.
+      struct Entry
+      {
+        //! Accumulated durations of the maneuver, NULL if unknown.
+        const std::vector<float>* durations;
+        //! Elapsed plan time when the maneuver ends, -1 if unknown.
+        float end;
+      };
+
+      //! Constructor.
+      ProgressTimeline(void)
+      {
+        clear();
+      }
+
+      //! Remove all entries.
+      void
+      clear(void)
+      {
+        m_entries.clear();
+        m_index.clear();
+        m_exec_duration = -1.0f;
+        m_last_valid = -1;
+        m_current = -1;
+      }
+
+      //! Build the timeline from a sequenced plan and its time profile.
+      //! The time profile must outlive the timeline and must not be
+      //! parsed again without rebuilding.
+      //! @param[in] nodes sequenced plan maneuvers.
+      //! @param[in] profiles parsed time profile.
+      void
+      build(const std::vector<IMC::PlanManeuver*>& nodes,
+            const Plans::TimeProfile& profiles)
+      {
+        clear();
+
+        m_entries.resize(nodes.size());
+
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+          const std::string& id = nodes[i]->maneuver_id;
+          Entry& entry = m_entries[i];
+
+          m_index.insert(std::make_pair(id, (int)i));
+
+          Plans::TimeProfile::const_iterator itr = profiles.find(id);
+          if (itr == profiles.end())
+          {
+            entry.durations = NULL;
+            entry.end = -1.0f;
+            continue;
+          }
+
+          entry.durations = &itr->second.durations;
+          entry.end = entry.durations->empty() ? -1.0f : entry.durations->back();
+
+          if (id == profiles.lastValid())
+          {
+            m_last_valid = (int)i;
+            m_exec_duration = entry.end;
+          }
+        }
+      }
+
+      //! Select the maneuver being executed. This is the only lookup by
+      //! identifier and is meant to be done once per maneuver.
+      //! @param[in] id maneuver identifier.
+      //! @return true if the maneuver is part of the timeline.
+      bool
+      select(const std::string& id)
+      {
+        std::map<std::string, int>::const_iterator itr = m_index.find(id);
+
+        if (itr == m_index.end())
+        {
+          m_current = -1;
+          return false;
+        }
+
+        m_current = itr->second;
+        return true;
+      }
+
+      //! Get the entry of the maneuver being executed.
+      //! @return pointer to entry or NULL if the maneuver has no
+      //! computed durations.
+      inline const Entry*
+      getCurrent(void) const
+      {
+        if (m_current < 0 || m_entries[m_current].durations == NULL)
+          return NULL;
+
+        return &m_entries[m_current];
+      }
+
+      //! Check if the maneuver being executed is the last one with a
+      //! valid duration.
+      //! @return true if it is, false otherwise.
+      inline bool
+      isLastValid(void) const
+      {
+        return m_current >= 0 && m_current == m_last_valid;
+      }
+
+      //! Get duration of the execution phase of the plan.
+      //! @return duration in seconds or -1 if unknown.
+      inline float
+      getExecutionDuration(void) const
+      {
+        return m_exec_duration;
+      }
+
+      //! Get number of entries.
+      //! @return number of entries.
+      inline size_t
+      size(void) const
+      {
+        return m_entries.size();
+      }
+
+      //! Get entry by sequence position.
+      //! @param[in] index position of the maneuver in the plan.
+      //! @return timeline entry.
+      inline const Entry&
+      operator[](size_t index) const
+      {
+        return m_entries[index];
+      }
+
+    private:
+      //! Entries in plan sequence order.
+      std::vector<Entry> m_entries;
+      //! Maneuver identifier to sequence position.
+      std::map<std::string, int> m_index;
+      //! Duration of the execution phase of the plan.
+      float m_exec_duration;
+      //! Position of last maneuver with valid duration.
+      int m_last_valid;
+      //! Position of the maneuver being executed.
+      int m_current;
+    };
+  }
+}
+
+#endif
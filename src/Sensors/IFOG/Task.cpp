@@ -106,14 +106,16 @@ namespace Sensors
       std::vector<double> rotation_mx;
       //! Trigger frequency.
       unsigned trigger_frq;
+      //! Number of samples per published increment.
+      unsigned decimation;
     };
 
     struct Task: public DUNE::Tasks::Task
     {
       //! Rotation Matrix to correct IMU mounting position.
       Matrix m_rotation;
-      //! Sensor data matrix.
-      Matrix m_data;
+      //! Strapdown integrator.
+      Navigation::Strapdown m_strapdown;
       //! Euler Angles Delta.
       IMC::EulerAnglesDelta m_edelta;
       //! Velocity Delta.
@@ -173,15 +175,19 @@ namespace Sensors
         .size(9)
         .description("IMU rotation matrix which is dependent of the mounting position");
 
-        // Resize sensor data matrix.
-        m_data.resize(3, 1);
+        param("Output Decimation", m_args.decimation)
+        .defaultValue("1")
+        .minimumValue("1")
+        .description("Number of samples integrated, with coning and sculling"
+                     " compensation, in each published increment");
       }
 
       void
       onUpdateParameters(void)
       {
         m_rotation.fill(3, 3, &m_args.rotation_mx[0]);
-        m_edelta.timestep = 1.0 / m_args.trigger_frq;
+        m_strapdown.setDecimation(m_args.decimation);
+        m_edelta.timestep = (double)m_strapdown.getDecimation() / m_args.trigger_frq;
       }
 
       ~Task(void)
@@ -272,6 +278,21 @@ namespace Sensors
         return m_psu_ctl->sendFrame(frame, 2.0);
       }
 
+      //! Read three 24-bit increments and correct mounting position.
+      //! @param[in] data first increment.
+      //! @param[in] scale scale factor.
+      //! @param[out] out rotated increments.
+      void
+      readIncrements(const uint8_t* data, double scale, double* out)
+      {
+        double raw[3];
+        for (unsigned i = 0; i < 3; ++i)
+          raw[i] = read24b(data + 3 * i) * scale;
+
+        for (unsigned i = 0; i < 3; ++i)
+          out[i] = m_rotation(i, 0) * raw[0] + m_rotation(i, 1) * raw[1] + m_rotation(i, 2) * raw[2];
+      }
+
       int32_t
       read24b(const uint8_t* data)
       {
@@ -295,31 +316,30 @@ namespace Sensors
 
         double tstamp = Clock::getSinceEpoch();
 
-        // Angles Increment.
-        m_data(0) = read24b(bfr + OFF_ANG_INC0) * c_ang_scale;
-        m_data(1) = read24b(bfr + OFF_ANG_INC1) * c_ang_scale;
-        m_data(2) = read24b(bfr + OFF_ANG_INC2) * c_ang_scale;
-        m_data = m_rotation * m_data;
-
-        m_edelta.setTimeStamp(tstamp);
-        m_edelta.x = m_data(0);
-        m_edelta.y = m_data(1);
-        m_edelta.z = m_data(2);
-        m_edelta.time += m_edelta.timestep;
-        dispatch(m_edelta, DF_KEEP_TIME);
-
-        // Velocity Increment.
-        m_data(0) = read24b(bfr + OFF_VEL_INC0) * c_vel_scale;
-        m_data(1) = read24b(bfr + OFF_VEL_INC1) * c_vel_scale;
-        m_data(2) = read24b(bfr + OFF_VEL_INC2) * c_vel_scale;
-        m_data = m_rotation * m_data;
-
-        m_vdelta.setTimeStamp(tstamp);
-        m_vdelta.time += m_edelta.timestep;
-        m_vdelta.x = m_data(0);
-        m_vdelta.y = m_data(1);
-        m_vdelta.z = m_data(2);
-        dispatch(m_vdelta, DF_KEEP_TIME);
+        // Angle and velocity increments.
+        double dtheta[3];
+        double dv[3];
+        readIncrements(bfr + OFF_ANG_INC0, c_ang_scale, dtheta);
+        readIncrements(bfr + OFF_VEL_INC0, c_vel_scale, dv);
+
+        if (m_strapdown.integrate(dtheta, dv))
+        {
+          const double* phi = m_strapdown.getDeltaAngle();
+          m_edelta.setTimeStamp(tstamp);
+          m_edelta.x = phi[0];
+          m_edelta.y = phi[1];
+          m_edelta.z = phi[2];
+          m_edelta.time += m_edelta.timestep;
+          dispatch(m_edelta, DF_KEEP_TIME);
+
+          const double* vel = m_strapdown.getDeltaVelocity();
+          m_vdelta.setTimeStamp(tstamp);
+          m_vdelta.time += m_edelta.timestep;
+          m_vdelta.x = vel[0];
+          m_vdelta.y = vel[1];
+          m_vdelta.z = vel[2];
+          dispatch(m_vdelta, DF_KEEP_TIME);
+        }
 
         // Status words.
         m_sta_fail = bfr[OFF_STA_FAIL + 1] << 8 | bfr[OFF_STA_FAIL];
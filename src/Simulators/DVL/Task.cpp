@@ -112,7 +112,7 @@ namespace Simulators
       void
       onResourceAcquisition(void)
       {
-        m_prng = Random::Factory::create(m_args.prng_type, m_args.prng_seed);
+        m_prng = Random::Factory::create(m_args.prng_type, m_args.prng_seed, getName());
       }
 
       //! Release resources.
@@ -153,10 +153,14 @@ namespace Simulators
 
         if (valid)
         {
+          // Unit noise for water and ground velocities.
+          double noise[6];
+          m_prng->fillGaussian(noise, 6);
+
           // Water velocity.
-          m_wvel.x = m_sstate.u + m_prng->gaussian() * m_args.stdev_wvel;
-          m_wvel.y = m_sstate.v + m_prng->gaussian() * m_args.stdev_wvel;
-          m_wvel.z = m_sstate.w + m_prng->gaussian() * m_args.stdev_wvel;
+          m_wvel.x = m_sstate.u + noise[0] * m_args.stdev_wvel;
+          m_wvel.y = m_sstate.v + noise[1] * m_args.stdev_wvel;
+          m_wvel.z = m_sstate.w + noise[2] * m_args.stdev_wvel;
           m_wvel.validity = (IMC::WaterVelocity::VAL_VEL_X
                              | IMC::WaterVelocity::VAL_VEL_Y
                              | IMC::WaterVelocity::VAL_VEL_Z);
@@ -168,9 +172,9 @@ namespace Simulators
           BodyFixedFrame::toBodyFrame(m_sstate.phi, m_sstate.theta, m_sstate.psi,
                                       m_sstate.svx, m_sstate.svy, m_sstate.svz,
                                       &bf_wx, &bf_wy, &bf_wz);
-          m_gvel.x = m_sstate.u + m_prng->gaussian() * m_args.stdev_gvel + bf_wx;
-          m_gvel.y = m_sstate.v + m_prng->gaussian() * m_args.stdev_gvel + bf_wy;
-          m_gvel.z = m_sstate.w + m_prng->gaussian() * m_args.stdev_gvel + bf_wz;
+          m_gvel.x = m_sstate.u + noise[3] * m_args.stdev_gvel + bf_wx;
+          m_gvel.y = m_sstate.v + noise[4] * m_args.stdev_gvel + bf_wy;
+          m_gvel.z = m_sstate.w + noise[5] * m_args.stdev_gvel + bf_wz;
           m_gvel.validity = (IMC::GroundVelocity::VAL_VEL_X
                              | IMC::GroundVelocity::VAL_VEL_Y
                              | IMC::GroundVelocity::VAL_VEL_Z);
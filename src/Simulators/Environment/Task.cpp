@@ -33,9 +33,7 @@
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
-
-// Local headers.
-#include "QuadTree.hpp"
+#include <DUNE/Simulation/Bathymetry.hpp>
 
 namespace Simulators
 {
@@ -169,6 +167,8 @@ namespace Simulators
       std::vector<double> pier;
       //! Use intersection method to compute forward distance
       bool intersect_method;
+      //! Number of rays across the forward beam
+      unsigned forward_rays;
       // General arguments
       //! PRNG type.
       std::string prng_type;
@@ -195,21 +195,26 @@ namespace Simulators
       double m_a_n, m_a_e, m_b_n, m_b_e;
       //! PRNG handle.
       Random::Generator* m_prng;
-      //! The tree.
-      QuadTree* m_qtree;
+      //! Scattered bathymetry.
+      Math::KDTree m_points;
+      //! Gridded bathymetry.
+      Simulation::Bathymetry m_grid;
       //! Reference latitude and longitude for data points.
       double m_ref_lat, m_ref_lon;
       //! NE offsets in regard to navigational reference.
       double m_off_n, m_off_e;
       //! Pencil beam object
       PencilBeam* m_pb;
+      //! Forward beam rays.
+      std::vector<Simulation::Bathymetry::Ray> m_rays;
+      //! Forward beam ray ranges.
+      std::vector<double> m_ranges;
       //! Task Arguments.
       Arguments m_args;
 
       Task(const std::string& name, Tasks::Context& ctx):
         Tasks::Periodic(name, ctx),
         m_prng(NULL),
-        m_qtree(NULL),
         m_pb(NULL)
       {
         param("Simulate - Bottom Distance", m_args.simulate_bd)
@@ -330,6 +335,13 @@ namespace Simulators
         .defaultValue("false")
         .description("Use a more complex intersection method to simulate forward distance");
 
+        param("Forward Beam Rays", m_args.forward_rays)
+        .defaultValue("5")
+        .minimumValue("1")
+        .maximumValue("1000")
+        .description("Number of rays cast across the forward beam's vertical aperture "
+                     "by the intersection method, when gridded bathymetry is available");
+
         param("PRNG Type", m_args.prng_type)
         .defaultValue(Random::Factory::c_default);
 
@@ -346,7 +358,7 @@ namespace Simulators
       void
       onResourceAcquisition(void)
       {
-        m_prng = Random::Factory::create(m_args.prng_type, m_args.prng_seed);
+        m_prng = Random::Factory::create(m_args.prng_type, m_args.prng_seed, getName());
         m_pb = new PencilBeam(&m_args.pb);
       }
 
@@ -354,8 +366,9 @@ namespace Simulators
       onResourceRelease(void)
       {
         Memory::clear(m_prng);
-        Memory::clear(m_qtree);
+        m_points.clear();
         Memory::clear(m_pb);
+        m_grid.close();
       }
 
       void
@@ -401,50 +414,11 @@ namespace Simulators
       onResourceInitialization(void)
       {
         Utils::String::toLowerCase(m_args.location);
-        Path path = m_ctx.dir_cfg / "simulation" / ("bathymetry-" + m_args.location + ".ini");
-        DUNE::Parsers::Config cfg(path.c_str());
-        std::vector<std::string> lines;
-        cfg.get("Bathymetry", "Data", "", lines);
-        cfg.get("Bathymetry", "Latitude (degrees)", "", m_ref_lat);
-        cfg.get("Bathymetry", "Longitude (degrees)", "", m_ref_lon);
-
-        debug("%s | %0.6f, %0.6f", m_args.location.c_str(), m_ref_lat, m_ref_lon);
-        debug("%s | %s", m_args.location.c_str(), path.c_str());
-        debug("%s | %lu %s", m_args.location.c_str(), (long unsigned int)lines.size(), "bathymetry values");
-
-        m_ref_lat = Angles::radians(m_ref_lat);
-        m_ref_lon = Angles::radians(m_ref_lon);
-
-        std::vector<QuadTree::Item> data;
-        QuadTree::Item item;
-        Bounds* bounds = 0;
-
-        for (unsigned i = 0; i < lines.size(); ++i)
-        {
-          std::vector<double> v;
-          DUNE::Utils::String::split(lines[i], " ", v);
-          if (!bounds)
-            bounds = new Bounds(Point(v[0], v[1]));
-          else
-            bounds->cover(Point(v[0], v[1]));
-          item.x = v[0]; item.y = v[1]; item.value = v[2];
-          data.push_back(item);
-        }
-
-        std::stringstream ss;
-        ss << *bounds;
-        trace("bounds: %s", ss.str().c_str());
-
-        // Fill the tree
-        m_qtree = new QuadTree(*bounds);
-        delete bounds;
-
-        for (unsigned i = 0; i < data.size(); ++i)
-          m_qtree->insert(data[i]);
-
-        ss.clear();
-        ss << *m_qtree;
-        trace("tree elements: %s", ss.str().c_str());
+        Path grid = m_ctx.dir_cfg / "simulation" / ("bathymetry-" + m_args.location + ".bty");
+        if (grid.isFile())
+          loadGrid(grid);
+        else
+          loadPoints(m_ctx.dir_cfg / "simulation" / ("bathymetry-" + m_args.location + ".ini"));
 
         m_bd.beam_config.clear();
         m_bd.location.clear();
@@ -554,6 +528,53 @@ namespace Simulators
               m_bd.value, error);
       }
 
+      //! Load gridded bathymetry.
+      //! @param[in] path bathymetry file.
+      void
+      loadGrid(const Path& path)
+      {
+        m_grid.open(path);
+        m_ref_lat = m_grid.getLatitude();
+        m_ref_lon = m_grid.getLongitude();
+
+        debug("%s | %s", m_args.location.c_str(), path.c_str());
+        debug("%s | %ux%u nodes, %0.1f m", m_args.location.c_str(),
+              m_grid.getRows(), m_grid.getColumns(), m_grid.getResolution());
+      }
+
+      //! Load scattered bathymetry points.
+      //! @param[in] path bathymetry configuration file.
+      void
+      loadPoints(const Path& path)
+      {
+        DUNE::Parsers::Config cfg(path.c_str());
+        std::vector<std::string> lines;
+        cfg.get("Bathymetry", "Data", "", lines);
+        cfg.get("Bathymetry", "Latitude (degrees)", "", m_ref_lat);
+        cfg.get("Bathymetry", "Longitude (degrees)", "", m_ref_lon);
+
+        debug("%s | %0.6f, %0.6f", m_args.location.c_str(), m_ref_lat, m_ref_lon);
+        debug("%s | %s", m_args.location.c_str(), path.c_str());
+        debug("%s | %lu %s", m_args.location.c_str(), (long unsigned int)lines.size(), "bathymetry values");
+
+        m_ref_lat = Angles::radians(m_ref_lat);
+        m_ref_lon = Angles::radians(m_ref_lon);
+
+        std::vector<Math::KDTree::Item> data;
+        Math::KDTree::Item item;
+
+        for (unsigned i = 0; i < lines.size(); ++i)
+        {
+          std::vector<double> v;
+          DUNE::Utils::String::split(lines[i], " ", v);
+          item.x = v[0]; item.y = v[1]; item.value = v[2];
+          data.push_back(item);
+        }
+
+        m_points.build(data);
+        trace("indexed %lu points", (long unsigned int)m_points.size());
+      }
+
       //! Compute depth at a certian (x, y) position
       //! @param[in] x coordinate of position
       //! @param[in] y coordinate of position
@@ -561,34 +582,27 @@ namespace Simulators
       double
       depthAt(double x, double y)
       {
-        Point p(x, y);
-        Bounds search_area(p, m_args.interp_radius);
-
-        std::vector<QuadTree::Item> items;
+        if (m_grid.isOpen())
+        {
+          double depth;
+          if (!m_grid.depthAt(x, y, depth))
+          {
+            trace("out of bounds");
+            return m_args.oob_depth;
+          }
 
-        m_qtree->search(search_area, items);
+          return depth + m_args.tide;
+        }
 
-        if (items.size() == 0)
+        size_t index;
+        if (!m_points.nearest(x, y, index, m_args.interp_radius))
         {
           trace("out of bounds");
           return m_args.oob_depth;
         }
 
-        trace("found %lu close data values", (long unsigned int)items.size());
-
         // @todo interpolate rather than picking closest one
-        double dmin = p.distance(Point(items[0].x, items[0].y));
-        double depth = items[0].value;
-
-        for (unsigned int i = 1; i < items.size(); ++i)
-        {
-          double d = p.distance(Point(items[i].x, items[i].y));
-          if (d < dmin)
-          {
-            dmin = d;
-            depth = items[i].value;
-          }
-        }
+        double depth = m_points[index].value;
 
         return depth + m_args.tide;
       }
@@ -615,7 +629,7 @@ namespace Simulators
           psi_offset = m_pb->update();
         }
 
-        m_fd.value = forwardRange(0.0) + error;
+        m_fd.value = forwardRange(psi_offset) + error;
         m_fd.value = trimValue(m_fd.value, m_args.min_range, m_args.max_range);
         m_fd.validity = IMC::Distance::DV_VALID;
         const IMC::DeviceState* ds = *m_fd.location.begin();
@@ -651,7 +665,10 @@ namespace Simulators
 
           if (m_args.intersect_method)
           {
-            range = std::min(range, bottomIntersection());
+            if (m_grid.isOpen())
+              range = std::min(range, castForwardBeam(psi_offset));
+            else
+              range = std::min(range, bottomIntersection());
           }
           else
           {
@@ -699,6 +716,56 @@ namespace Simulators
         return range;
       }
 
+      //! Cast rays across the vertical aperture of the forward beam
+      //! against the gridded bathymetry.
+      //! @param[in] psi_offset beam heading offset.
+      //! @return range to the closest bottom hit.
+      double
+      castForwardBeam(double psi_offset)
+      {
+        unsigned count = m_args.forward_rays;
+        double psi = m_sstate.psi + psi_offset;
+        double aperture = (count > 1) ? m_args.forward_width : 0.0;
+        double step = (count > 1) ? aperture / (count - 1) : 0.0;
+
+        m_rays.resize(count);
+        for (unsigned i = 0; i < count; ++i)
+        {
+          double theta = m_sstate.theta - aperture / 2.0 + step * i;
+
+          Simulation::Bathymetry::Ray& ray = m_rays[i];
+          ray.north = m_sstate.x + m_off_n;
+          ray.east = m_sstate.y + m_off_e;
+          ray.depth = m_sstate.z - m_args.tide;
+          ray.dn = cos(theta) * cos(psi);
+          ray.de = cos(theta) * sin(psi);
+          ray.dd = - sin(theta);
+        }
+
+        m_grid.castRays(m_rays, m_args.max_range, m_ranges);
+
+        double range = m_args.max_range;
+        for (unsigned i = 0; i < count; ++i)
+        {
+          double value = m_ranges[i];
+
+          // Rays leaving the grid meet the out of bounds depth.
+          if (value >= m_args.max_range && m_rays[i].dd > 0.0)
+          {
+            const Simulation::Bathymetry::Ray& ray = m_rays[i];
+            double t = (m_args.oob_depth - m_sstate.z) / ray.dd;
+            double depth;
+            if (t < m_args.max_range &&
+                !m_grid.depthAt(ray.north + ray.dn * t, ray.east + ray.de * t, depth))
+              value = std::max(t, 0.0);
+          }
+
+          range = std::min(range, value);
+        }
+
+        return range;
+      }
+
       //! Compute the depths of c_forward_points in front of the vehicle
       //! Use connections between these points as line segments
       //! and intersect them with lower beam part of the echo sounder.
@@ -140,7 +140,7 @@ namespace Simulators
       {
         Memory::clear(m_msg);
         m_msg = IMC::Factory::produce(m_args.message_name);
-        m_prng = Random::Factory::create(m_args.prng_type, m_args.prng_seed);
+        m_prng = Random::Factory::create(m_args.prng_type, m_args.prng_seed, getName());
       }
 
       //! Release resources.
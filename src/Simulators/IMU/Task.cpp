@@ -151,7 +151,7 @@ namespace Simulators
       void
       onResourceAcquisition(void)
       {
-        m_prng = Random::Factory::create(m_args.prng_type, m_args.prng_seed);
+        m_prng = Random::Factory::create(m_args.prng_type, m_args.prng_seed, getName());
         m_heading_offset = m_prng->gaussian() * Angles::radians(m_args.stdev_heading_offset);
       }
 
@@ -201,9 +201,11 @@ namespace Simulators
         // Define Euler Angles variables and add gaussian noise component.
         if (m_args.euler)
         {
-          m_euler.phi = Angles::normalizeRadian(msg->phi + m_prng->gaussian() * Angles::radians(m_args.stdev_euler));
-          m_euler.theta = Angles::normalizeRadian(msg->theta + m_prng->gaussian() * Angles::radians(m_args.stdev_euler));
-          m_euler.psi_magnetic = Angles::normalizeRadian(msg->psi + m_prng->gaussian() * Angles::radians(m_args.stdev_euler));
+          double noise[3];
+          m_prng->fillGaussian(noise, 3, 0.0, Angles::radians(m_args.stdev_euler));
+          m_euler.phi = Angles::normalizeRadian(msg->phi + noise[0]);
+          m_euler.theta = Angles::normalizeRadian(msg->theta + noise[1]);
+          m_euler.psi_magnetic = Angles::normalizeRadian(msg->psi + noise[2]);
           m_euler.psi = Angles::normalizeRadian(m_euler.psi_magnetic + m_heading_offset);
 
           // Heading offset will increment through time according with gyro rate bias.
@@ -214,9 +216,11 @@ namespace Simulators
         }
 
         // Define Angular Velocity variables and add gaussian noise component.
-        m_agvel.x = Angles::normalizeRadian(msg->p + m_prng->gaussian() * Angles::radians(m_args.stdev_agvel));
-        m_agvel.y = Angles::normalizeRadian(msg->q + m_prng->gaussian() * Angles::radians(m_args.stdev_agvel));
-        m_agvel.z = Angles::normalizeRadian(msg->r + m_prng->gaussian() * Angles::radians(m_args.stdev_agvel));
+        double noise[3];
+        m_prng->fillGaussian(noise, 3, 0.0, Angles::radians(m_args.stdev_agvel));
+        m_agvel.x = Angles::normalizeRadian(msg->p + noise[0]);
+        m_agvel.y = Angles::normalizeRadian(msg->q + noise[1]);
+        m_agvel.z = Angles::normalizeRadian(msg->r + noise[2]);
 
         // Compute acceleration values using simulated state velocity fields.
         m_accel.x = (msg->u - m_vel[0]) / tstep;
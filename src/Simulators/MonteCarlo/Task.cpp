@@ -0,0 +1,457 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+namespace Simulators
+{
+  //! Runs one plan in a simulated vehicle on behalf of the Monte Carlo
+  //! mission runner (dune-montecarlo).
+  //!
+  //! Once navigation is available and the vehicle is in service mode,
+  //! the plan read from 'Plan File' is started. While it executes, the
+  //! task accumulates distance travelled, cross-track error, energy
+  //! from the vehicle's power model and abort requests. When the plan
+  //! ends, or the timeout expires, the metrics are written to 'Report
+  //! File' and the task becomes idle until the daemon is terminated.
+  //!
+  //! @author Ricardo Martins
+  namespace MonteCarlo
+  {
+    using DUNE_NAMESPACES;
+
+    //! Request identifier of the plan start.
+    static const uint16_t c_request_id = 0x4d43;
+
+    //! Run states.
+    enum RunState
+    {
+      //! Waiting for the vehicle to be ready.
+      RS_WAITING,
+      //! Plan start requested.
+      RS_STARTING,
+      //! Plan executing.
+      RS_EXECUTING,
+      //! Report written.
+      RS_DONE
+    };
+
+    struct Arguments
+    {
+      //! File with the plan to execute.
+      std::string plan_file;
+      //! Plan identifier.
+      std::string plan_id;
+      //! Report file.
+      std::string report_file;
+      //! Run timeout.
+      double timeout;
+    };
+
+    struct Task: public DUNE::Tasks::Task
+    {
+      //! Task arguments.
+      Arguments m_args;
+      //! Plan to execute.
+      IMC::PlanSpecification m_spec;
+      //! Power model.
+      Power::Model* m_power;
+      //! Run state.
+      RunState m_state;
+      //! Navigation is available.
+      bool m_nav;
+      //! Vehicle is in service mode.
+      bool m_service;
+      //! Time of task start.
+      double m_boot_time;
+      //! Time of plan execution start.
+      double m_exec_time;
+      //! Last position.
+      double m_lat;
+      double m_lon;
+      //! True if m_lat and m_lon are valid.
+      bool m_have_pos;
+      //! Distance travelled while executing.
+      double m_distance;
+      //! Sum of absolute cross-track errors.
+      double m_xtrack_sum;
+      //! Maximum absolute cross-track error.
+      double m_xtrack_max;
+      //! Number of cross-track error samples.
+      unsigned m_xtrack_count;
+      //! Last propeller speed and its timestamp.
+      double m_rpm;
+      double m_rpm_time;
+      //! Energy spent by motion while executing.
+      double m_motion_energy;
+      //! Number of abort requests.
+      unsigned m_aborts;
+
+      //! Constructor.
+      //! @param[in] name task name.
+      //! @param[in] ctx context.
+      Task(const std::string& name, Tasks::Context& ctx):
+        DUNE::Tasks::Task(name, ctx),
+        m_power(NULL),
+        m_state(RS_WAITING),
+        m_nav(false),
+        m_service(false),
+        m_boot_time(0),
+        m_exec_time(0)
+      {
+        param("Plan File", m_args.plan_file)
+        .description("LSF file with the plan specification to execute");
+
+        param("Plan Identifier", m_args.plan_id)
+        .defaultValue("")
+        .description("Plan to execute, empty for the first plan in the file");
+
+        param("Report File", m_args.report_file)
+        .description("File where run metrics are written");
+
+        param("Timeout", m_args.timeout)
+        .defaultValue("3600")
+        .units(Units::Second)
+        .description("Maximum amount of simulated time for the run");
+
+        reset();
+
+        bind<IMC::Abort>(this);
+        bind<IMC::EstimatedState>(this);
+        bind<IMC::PathControlState>(this);
+        bind<IMC::PlanControl>(this);
+        bind<IMC::PlanControlState>(this);
+        bind<IMC::Rpm>(this);
+        bind<IMC::VehicleState>(this);
+      }
+
+      //! Acquire resources.
+      void
+      onResourceAcquisition(void)
+      {
+        loadPlan();
+
+        try
+        {
+          m_power = new Power::Model(&m_ctx.config);
+          m_power->validate();
+        }
+        catch (std::exception& e)
+        {
+          Memory::clear(m_power);
+          war(DTR("energy will not be reported: %s"), e.what());
+        }
+      }
+
+      //! Initialize resources.
+      void
+      onResourceInitialization(void)
+      {
+        m_boot_time = Clock::get();
+        setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
+      }
+
+      //! Release resources.
+      void
+      onResourceRelease(void)
+      {
+        Memory::clear(m_power);
+      }
+
+      //! Clear run metrics.
+      void
+      reset(void)
+      {
+        m_have_pos = false;
+        m_distance = 0;
+        m_xtrack_sum = 0;
+        m_xtrack_max = 0;
+        m_xtrack_count = 0;
+        m_rpm = 0;
+        m_rpm_time = -1;
+        m_motion_energy = 0;
+        m_aborts = 0;
+      }
+
+      //! Read the plan specification from the plan file.
+      void
+      loadPlan(void)
+      {
+        Path file(m_args.plan_file);
+        if (!file.isFile())
+          throw RestartNeeded(DTR("plan file not found"), 0, false);
+
+        std::istream* is = NULL;
+        Compression::Methods method = Compression::Factory::detect(file.c_str());
+        if (method == METHOD_UNKNOWN)
+          is = new std::ifstream(file.c_str(), std::ios::binary);
+        else
+          is = new Compression::FileInput(file.c_str(), method);
+
+        bool found = false;
+        IMC::Message* msg = NULL;
+
+        while (!found && (msg = IMC::Packet::deserialize(*is)) != NULL)
+        {
+          const IMC::PlanSpecification* spec = NULL;
+
+          if (msg->getId() == IMC::PlanSpecification::getIdStatic())
+            spec = static_cast<IMC::PlanSpecification*>(msg);
+          else if (msg->getId() == IMC::PlanDB::getIdStatic())
+            spec = static_cast<const IMC::PlanSpecification*>(static_cast<IMC::PlanDB*>(msg)->arg.get());
+          else if (msg->getId() == IMC::PlanControl::getIdStatic())
+            spec = static_cast<const IMC::PlanSpecification*>(static_cast<IMC::PlanControl*>(msg)->arg.get());
+
+          if (spec != NULL && spec->getId() == IMC::PlanSpecification::getIdStatic())
+          {
+            if (m_args.plan_id.empty() || spec->plan_id == m_args.plan_id)
+            {
+              m_spec = *spec;
+              found = true;
+            }
+          }
+
+          delete msg;
+        }
+
+        delete is;
+
+        if (!found)
+          throw RestartNeeded(DTR("plan not found in plan file"), 0, false);
+
+        inf(DTR("loaded plan '%s'"), m_spec.plan_id.c_str());
+      }
+
+      void
+      consume(const IMC::Abort* msg)
+      {
+        (void)msg;
+
+        if (m_state == RS_STARTING || m_state == RS_EXECUTING)
+          ++m_aborts;
+      }
+
+      void
+      consume(const IMC::EstimatedState* msg)
+      {
+        if (msg->getSource() != getSystemId())
+          return;
+
+        m_nav = true;
+
+        if (m_state != RS_EXECUTING)
+          return;
+
+        double lat = 0;
+        double lon = 0;
+        Coordinates::toWGS84(*msg, lat, lon);
+
+        if (m_have_pos)
+          m_distance += WGS84::distance(m_lat, m_lon, 0, lat, lon, 0);
+
+        m_lat = lat;
+        m_lon = lon;
+        m_have_pos = true;
+      }
+
+      void
+      consume(const IMC::PathControlState* msg)
+      {
+        if (m_state != RS_EXECUTING)
+          return;
+
+        double error = std::fabs(msg->y);
+        m_xtrack_sum += error;
+        m_xtrack_max = std::max(m_xtrack_max, error);
+        ++m_xtrack_count;
+      }
+
+      void
+      consume(const IMC::PlanControl* msg)
+      {
+        if (m_state != RS_STARTING || msg->request_id != c_request_id)
+          return;
+
+        if (msg->type == IMC::PlanControl::PC_FAILURE)
+        {
+          err(DTR("plan was rejected: %s"), msg->info.c_str());
+          finish("rejected");
+        }
+      }
+
+      void
+      consume(const IMC::PlanControlState* msg)
+      {
+        if (msg->getSource() != getSystemId() || msg->plan_id != m_spec.plan_id)
+          return;
+
+        bool executing = msg->state == IMC::PlanControlState::PCS_EXECUTING;
+
+        if (m_state == RS_STARTING && executing)
+        {
+          m_state = RS_EXECUTING;
+          m_exec_time = Clock::get();
+          m_rpm_time = -1;
+          inf(DTR("plan is executing"));
+        }
+        else if (m_state == RS_EXECUTING && !executing)
+        {
+          if (msg->last_outcome == IMC::PlanControlState::LPO_SUCCESS)
+            finish("success");
+          else
+            finish("failure");
+        }
+      }
+
+      void
+      consume(const IMC::Rpm* msg)
+      {
+        if (m_state != RS_EXECUTING || m_power == NULL)
+          return;
+
+        double now = msg->getTimeStamp();
+
+        if (m_rpm_time >= 0)
+          m_motion_energy += m_power->computeMotionEnergy(std::fabs(m_rpm), now - m_rpm_time);
+
+        m_rpm = msg->value;
+        m_rpm_time = now;
+      }
+
+      void
+      consume(const IMC::VehicleState* msg)
+      {
+        if (msg->getSource() != getSystemId())
+          return;
+
+        m_service = msg->op_mode == IMC::VehicleState::VS_SERVICE;
+      }
+
+      //! Request the plan to start.
+      void
+      startPlan(void)
+      {
+        IMC::PlanControl pc;
+        pc.setDestination(getSystemId());
+        pc.type = IMC::PlanControl::PC_REQUEST;
+        pc.op = IMC::PlanControl::PC_START;
+        pc.request_id = c_request_id;
+        pc.plan_id = m_spec.plan_id;
+        pc.arg.set(m_spec);
+        dispatch(pc);
+
+        m_state = RS_STARTING;
+        inf(DTR("starting plan '%s'"), m_spec.plan_id.c_str());
+      }
+
+      //! Write run metrics to the report file.
+      //! @param[in] outcome run outcome.
+      void
+      finish(const std::string& outcome)
+      {
+        double duration = -1;
+        double energy = -1;
+
+        if (m_state == RS_EXECUTING)
+        {
+          duration = Clock::get() - m_exec_time;
+
+          if (m_power != NULL)
+            energy = m_motion_energy
+            + m_power->computeHotelEnergy(duration)
+            + m_power->computeIMUEnergy(duration);
+        }
+
+        double xtrack_mean = -1;
+        double xtrack_max = -1;
+        if (m_xtrack_count > 0)
+        {
+          xtrack_mean = m_xtrack_sum / m_xtrack_count;
+          xtrack_max = m_xtrack_max;
+        }
+
+        // Write to a temporary file first so that the runner never
+        // reads a partial report.
+        std::string tmp = m_args.report_file + ".tmp";
+        std::ofstream ofs(tmp.c_str());
+        ofs << "[Run]" << std::endl
+            << "Outcome = " << outcome << std::endl
+            << "Plan = " << m_spec.plan_id << std::endl
+            << "Duration = " << duration << std::endl
+            << "Distance = " << m_distance << std::endl
+            << "Path Error Mean = " << xtrack_mean << std::endl
+            << "Path Error Max = " << xtrack_max << std::endl
+            << "Energy = " << energy << std::endl
+            << "Aborts = " << m_aborts << std::endl;
+        ofs.close();
+
+        if (std::rename(tmp.c_str(), m_args.report_file.c_str()) != 0)
+          err(DTR("failed to write report: %s"), System::Error::getLastMessage().c_str());
+
+        m_state = RS_DONE;
+        inf(DTR("run finished: %s"), outcome.c_str());
+        setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_IDLE);
+      }
+
+      //! Main loop.
+      void
+      onMain(void)
+      {
+        while (!stopping())
+        {
+          waitForMessages(1.0);
+
+          double now = Clock::get();
+
+          if (m_state == RS_DONE)
+            continue;
+
+          if (now - m_boot_time > m_args.timeout)
+          {
+            war(DTR("run timed out"));
+            finish("timeout");
+            continue;
+          }
+
+          if (m_state == RS_WAITING && m_nav && m_service)
+            startPlan();
+        }
+      }
+    };
+  }
+}
+
+DUNE_TASK
@@ -65,6 +65,10 @@ namespace Simulators
       std::string svlabel;
       //! Simulation time multiplier
       double time_multiplier;
+      //! Integration scheme.
+      std::string integrator;
+      //! Number of integration sub-steps per task period.
+      unsigned substeps;
     };
 
     //! Simulator task.
@@ -90,6 +94,18 @@ namespace Simulators
         .defaultValue("1.0")
         .description("Simulation time multiplier");
 
+        param("Integrator", m_args.integrator)
+        .defaultValue("Euler")
+        .values("Euler, Semi-Implicit Euler, Runge-Kutta 4")
+        .description("Numerical integration scheme of the vehicle dynamics");
+
+        param("Integration Sub-Steps", m_args.substeps)
+        .defaultValue("1")
+        .minimumValue("1")
+        .maximumValue("1000")
+        .description("Number of integration steps per task period. Use it to "
+                     "simulate fast dynamics without raising the task frequency");
+
         param("Entity Label - Stream Velocity Source", m_args.svlabel)
             .defaultValue("Stream Velocity Simulator")
             .description("Entity label of the stream velocity source.");
@@ -109,6 +125,23 @@ namespace Simulators
           Time::Clock::setTimeMultiplier(m_args.time_multiplier);
           war("Using time multiplier: x%.2f", Time::Clock::getTimeMultiplier());
         }
+
+        if (m_world)
+          setupIntegrator();
+      }
+
+      //! Configure world integration scheme.
+      void
+      setupIntegrator(void)
+      {
+        World::Integrator integrator = World::EULER;
+        if (m_args.integrator == "Semi-Implicit Euler")
+          integrator = World::SEMI_IMPLICIT_EULER;
+        else if (m_args.integrator == "Runge-Kutta 4")
+          integrator = World::RUNGE_KUTTA_4;
+
+        m_world->setIntegrator(integrator, m_args.substeps);
+        debug("integrator: %s, sub-steps: %u", m_args.integrator.c_str(), m_args.substeps);
       }
 
       //! Release allocated resources.
@@ -134,6 +167,7 @@ namespace Simulators
 
         m_world->addVehicle(m_vehicle);
         m_world->setTimeStep(1.0 / getFrequency());
+        setupIntegrator();
 
         m_svel[0] = 0.0;
         m_svel[1] = 0.0;
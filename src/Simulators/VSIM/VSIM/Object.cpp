@@ -61,6 +61,7 @@ namespace Simulators
 
       m_body_id = 0;
       m_mass = 0;
+      m_integration_method = true;
     }
 
     void
@@ -165,52 +166,101 @@ namespace Simulators
     }
 
     void
-    Object::update(double ts)
+    Object::getState(double* state) const
     {
-      // Initialize variables.
-      double c1 = std::cos(m_orientation[0]);
-      double c2 = std::cos(m_orientation[1]);
-      double c3 = std::cos(m_orientation[2]);
-
-      double s1 = std::sin(m_orientation[0]);
-      double s2 = std::sin(m_orientation[1]);
-      double s3 = std::sin(m_orientation[2]);
+      for (unsigned i = 0; i < 3; ++i)
+      {
+        state[i] = m_position[i];
+        state[i + 3] = m_orientation[i];
+        state[i + 6] = m_linear_velocity[i];
+        state[i + 9] = m_angular_velocity[i];
+      }
+    }
 
-      double t2 = std::tan(m_orientation[1]);
+    void
+    Object::setState(const double* state)
+    {
+      for (unsigned i = 0; i < 3; ++i)
+      {
+        m_position[i] = state[i];
+        m_orientation[i] = state[i + 3];
+        m_linear_velocity[i] = state[i + 6];
+        m_angular_velocity[i] = state[i + 9];
+      }
+    }
 
-      double u = m_linear_velocity[0];
-      double v = m_linear_velocity[1];
-      double w = m_linear_velocity[2];
-      double p = m_angular_velocity[0];
-      double q = m_angular_velocity[1];
-      double r = m_angular_velocity[2];
+    void
+    Object::computeKinematics(const double* state, double* deriv)
+    {
+      // Initialize variables.
+      double c1 = std::cos(state[3]);
+      double c2 = std::cos(state[4]);
+      double c3 = std::cos(state[5]);
 
-      double d_pos[6];
-      double d_vel[6];
+      double s1 = std::sin(state[3]);
+      double s2 = std::sin(state[4]);
+      double s3 = std::sin(state[5]);
 
-      // Accelerations.
-      for (unsigned i = 0; i < 6; ++i)
-        d_vel[i] = m_forces[i] / m_inertia[i];
+      double t2 = std::tan(state[4]);
 
-      // Reset forces to zero.
-      resetForces();
+      double u = state[6];
+      double v = state[7];
+      double w = state[8];
+      double p = state[9];
+      double q = state[10];
+      double r = state[11];
 
       // Compute Velocities
       // Transformation Matrix: eta1dot = J1(eta2)*nu1
       //    J1=[ c3*c2   c3*s2*s1-s3*c1  s3*s1+c3*c1*s2
       //         s3*c2   c1*c3+s1*s2*s3  c1*s2*s3-c3*s1
       //          -s2        c2*s1           c1*c2     ];
-      d_pos[0] = (c3 * c2) * u + (c3 * s2 * s1 - s3 * c1) * v + (s3 * s1 + c3 * c1 * s2) * w;
-      d_pos[1] = (s3 * c2) * u + (c1 * c3 + s1 * s2 * s3) * v + (c1 * s2 * s3 - c3 * s1) * w;
-      d_pos[2] = (-s2) * u + (c2 * s1) * v + (c1 * c2) * w;
+      deriv[0] = (c3 * c2) * u + (c3 * s2 * s1 - s3 * c1) * v + (s3 * s1 + c3 * c1 * s2) * w;
+      deriv[1] = (s3 * c2) * u + (c1 * c3 + s1 * s2 * s3) * v + (c1 * s2 * s3 - c3 * s1) * w;
+      deriv[2] = (-s2) * u + (c2 * s1) * v + (c1 * c2) * w;
 
       // Transformation Matrix: eta2dot = J1(eta2)*nu2
       //   J2=[ 1   s1*t2   c1*t2
       //        0    c1      -s1
       //        0   s1/c2   c1/c2 ];
-      d_pos[3] = p + (s1 * t2) * q + (c1 * t2) * r;
-      d_pos[4] = c1 * q + (-s1) * r;
-      d_pos[5] = (s1 / c2) * q + (c1 / c2) * r;
+      deriv[3] = p + (s1 * t2) * q + (c1 * t2) * r;
+      deriv[4] = c1 * q + (-s1) * r;
+      deriv[5] = (s1 / c2) * q + (c1 / c2) * r;
+    }
+
+    void
+    Object::computeDerivatives(const double* state, double* deriv)
+    {
+      setState(state);
+
+      resetForces();
+      applyForces();
+
+      computeKinematics(state, deriv);
+
+      // Accelerations.
+      for (unsigned i = 0; i < 6; ++i)
+        deriv[i + 6] = m_forces[i] / m_inertia[i];
+
+      resetForces();
+    }
+
+    void
+    Object::update(double ts)
+    {
+      double state[c_state_size];
+      double d_pos[c_state_size];
+      double d_vel[6];
+
+      getState(state);
+      computeKinematics(state, d_pos);
+
+      // Accelerations.
+      for (unsigned i = 0; i < 6; ++i)
+        d_vel[i] = m_forces[i] / m_inertia[i];
+
+      // Reset forces to zero.
+      resetForces();
 
       // Integrate using Euler's method.
       for (unsigned i = 0; i < 3; i++)
@@ -232,8 +282,7 @@ namespace Simulators
         }
       }
 
-      if (m_position[2] <= 0.0)
-        m_position[2] = 0.0;
+      clampToSurface();
     }
   }
 }
@@ -38,6 +38,10 @@ namespace Simulators
 {
   namespace VSIM
   {
+    //! Number of state variables: position, orientation, linear
+    //! velocity and angular velocity.
+    static const unsigned c_state_size = 12;
+
     //! %Object properties.
     class Object
     {
@@ -85,6 +89,15 @@ namespace Simulators
         m_integration_method = method;
       }
 
+      //! Retrieve integration method.
+      //! @return true if velocities are integrated from accelerations,
+      //! false if they are computed directly from forces.
+      bool
+      getIntegrationMethod(void) const
+      {
+        return m_integration_method;
+      }
+
       //! Insert object in virtual World.
       virtual void
       insertInWorld(void);
@@ -164,6 +177,39 @@ namespace Simulators
       void
       update(double timestep);
 
+      //! Copy object state to a contiguous vector laid out as
+      //! [position, orientation, linear velocity, angular velocity].
+      //! @param[out] state object state.
+      void
+      getState(double* state) const;
+
+      //! Replace object state.
+      //! @param[in] state object state (see getState()).
+      void
+      setState(const double* state);
+
+      //! Evaluate the state derivative at a given state. Forces are
+      //! recomputed for that state and the object is left in it.
+      //! @param[in] state object state.
+      //! @param[out] deriv state derivative.
+      void
+      computeDerivatives(const double* state, double* deriv);
+
+      //! Compute position and orientation rates from the velocities
+      //! of a given state (first six entries of the derivative).
+      //! @param[in] state object state.
+      //! @param[out] deriv state derivative.
+      static void
+      computeKinematics(const double* state, double* deriv);
+
+      //! Keep the object at or below the sea surface.
+      void
+      clampToSurface(void)
+      {
+        if (m_position[2] <= 0.0)
+          m_position[2] = 0.0;
+      }
+
     protected:
       //! Object's mass.
       double m_mass;
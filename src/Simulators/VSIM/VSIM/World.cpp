@@ -28,6 +28,9 @@
 // Author: José Braga                                                       *
 //***************************************************************************
 
+// ISO C++ 98 headers.
+#include <algorithm>
+
 // VSIM headers.
 #include <VSIM/World.hpp>
 
@@ -36,7 +39,9 @@ namespace Simulators
   namespace VSIM
   {
     World::World(int ident, double grv[3], double tstep):
-      m_timestep(tstep)
+      m_timestep(tstep),
+      m_integrator(EULER),
+      m_substeps(1)
     {
       m_world_id = ident;
       setGravity(grv[0], grv[1], grv[2]);
@@ -56,49 +61,147 @@ namespace Simulators
     void
     World::addObject(Object* obj)
     {
-      m_objects.push_back(obj);
+      m_bodies.push_back(obj);
       obj->insertInWorld();
     }
 
     void
     World::addVehicle(Vehicle* veh)
     {
-      m_vehicles.push_back(veh);
+      m_bodies.push_back(veh);
       veh->insertInWorld();
     }
 
     void
-    World::applyForces(void)
+    World::stepEuler(bool integrated, double ts)
+    {
+      for (size_t i = 0; i < m_bodies.size(); ++i)
+      {
+        if (m_bodies[i]->getIntegrationMethod() != integrated)
+          continue;
+
+        m_bodies[i]->applyForces();
+        m_bodies[i]->update(ts);
+      }
+    }
+
+    void
+    World::computeDerivatives(const std::vector<double>& state, std::vector<double>& deriv)
     {
-      std::list<Object*>::iterator oitr = m_objects.begin();
-      for (; oitr != m_objects.end(); ++oitr)
-        (*oitr)->applyForces();
+      for (size_t i = 0; i < m_bodies.size(); ++i)
+      {
+        if (!m_bodies[i]->getIntegrationMethod())
+          continue;
 
-      std::list<Vehicle*>::iterator vitr = m_vehicles.begin();
-      for (; vitr != m_vehicles.end(); ++vitr)
-        (*vitr)->applyForces();
+        m_bodies[i]->computeDerivatives(&state[i * c_state_size],
+                                        &deriv[i * c_state_size]);
+      }
     }
 
     void
-    World::update(void)
+    World::commitState(const std::vector<double>& state)
     {
-      std::list<Object*>::iterator oitr = m_objects.begin();
-      for (; oitr != m_objects.end(); ++oitr)
-        (*oitr)->update(m_timestep);
+      for (size_t i = 0; i < m_bodies.size(); ++i)
+      {
+        if (!m_bodies[i]->getIntegrationMethod())
+          continue;
+
+        m_bodies[i]->setState(&state[i * c_state_size]);
+        m_bodies[i]->clampToSurface();
+      }
+    }
+
+    void
+    World::stepSemiImplicitEuler(double ts)
+    {
+      computeDerivatives(m_state, m_deriv);
+
+      // Velocities first, then pose from the updated velocities.
+      for (size_t i = 0; i < m_bodies.size(); ++i)
+      {
+        double* x = &m_state[i * c_state_size];
+        double* dx = &m_deriv[i * c_state_size];
+
+        for (unsigned j = 6; j < c_state_size; ++j)
+          x[j] += dx[j] * ts;
+
+        Object::computeKinematics(x, dx);
+
+        for (unsigned j = 0; j < 6; ++j)
+          x[j] += dx[j] * ts;
+      }
 
-      std::list<Vehicle*>::iterator vitr = m_vehicles.begin();
-      for (; vitr != m_vehicles.end(); ++vitr)
-        (*vitr)->update(m_timestep);
+      commitState(m_state);
+    }
+
+    void
+    World::stepRungeKutta4(double ts)
+    {
+      static const double c_stage[] = {0.5, 0.5, 1.0, 0.0};
+      static const double c_weight[] = {1.0, 2.0, 2.0, 1.0};
+      const size_t size = m_state.size();
+
+      std::fill(m_accum.begin(), m_accum.end(), 0.0);
+      m_stage = m_state;
+
+      for (unsigned k = 0; k < 4; ++k)
+      {
+        computeDerivatives(m_stage, m_deriv);
+
+        for (size_t j = 0; j < size; ++j)
+        {
+          m_accum[j] += c_weight[k] * m_deriv[j];
+          m_stage[j] = m_state[j] + c_stage[k] * ts * m_deriv[j];
+        }
+      }
+
+      for (size_t j = 0; j < size; ++j)
+        m_state[j] += ts / 6.0 * m_accum[j];
+
+      commitState(m_state);
     }
 
     void
     World::takeStep(void)
     {
-      // Apply forces to vehicle.
-      applyForces();
+      // Bodies with directly computed velocities keep a single update
+      // per tick: their actuation model advances on every evaluation.
+      stepEuler(false, m_timestep);
+
+      if (m_integrator == EULER && m_substeps == 1)
+      {
+        stepEuler(true, m_timestep);
+        return;
+      }
+
+      const size_t size = m_bodies.size() * c_state_size;
+      m_state.resize(size, 0.0);
+      m_stage.resize(size, 0.0);
+      m_deriv.resize(size, 0.0);
+      m_accum.resize(size, 0.0);
+
+      double ts = m_timestep / m_substeps;
+
+      for (unsigned s = 0; s < m_substeps; ++s)
+      {
+        switch (m_integrator)
+        {
+          case EULER:
+            stepEuler(true, ts);
+            break;
+
+          case SEMI_IMPLICIT_EULER:
+          case RUNGE_KUTTA_4:
+            for (size_t i = 0; i < m_bodies.size(); ++i)
+              m_bodies[i]->getState(&m_state[i * c_state_size]);
 
-      // Update vehicle state.
-      update();
+            if (m_integrator == RUNGE_KUTTA_4)
+              stepRungeKutta4(ts);
+            else
+              stepSemiImplicitEuler(ts);
+            break;
+        }
+      }
     }
   }
 }
@@ -32,7 +32,7 @@
 #define SIMULATORS_VSIM_VSIM_WORLD_HPP_INCLUDED_
 
 // ISO C++ 98 headers.
-#include <list>
+#include <vector>
 
 // VSIM headers.
 #include <VSIM/Object.hpp>
@@ -46,6 +46,17 @@ namespace Simulators
     class World
     {
     public:
+      //! Numerical integration schemes.
+      enum Integrator
+      {
+        //! Explicit Euler.
+        EULER,
+        //! Semi-implicit (symplectic) Euler.
+        SEMI_IMPLICIT_EULER,
+        //! Classical fourth-order Runge-Kutta.
+        RUNGE_KUTTA_4
+      };
+
       //! Constructor.
       World(int ident, double grv[3], double tstep);
 
@@ -68,6 +79,17 @@ namespace Simulators
         return m_timestep;
       }
 
+      //! Define integration scheme and number of internal sub-steps
+      //! per world timestep.
+      //! @param[in] integrator integration scheme.
+      //! @param[in] substeps number of sub-steps (at least one).
+      void
+      setIntegrator(Integrator integrator, unsigned substeps)
+      {
+        m_integrator = integrator;
+        m_substeps = (substeps == 0) ? 1 : substeps;
+      }
+
       //! Add object to world.
       //! @param[in] obj new object.
       void
@@ -83,13 +105,33 @@ namespace Simulators
       takeStep(void);
 
     private:
-      //! Applies forces to all objects/vehicles.
+      //! Advance bodies with the legacy explicit Euler update.
+      //! @param[in] integrated true for bodies with integrated velocities,
+      //! false for bodies with directly computed velocities.
+      //! @param[in] ts integration timestep.
+      void
+      stepEuler(bool integrated, double ts);
+
+      //! Advance bodies with semi-implicit Euler.
+      //! @param[in] ts integration timestep.
+      void
+      stepSemiImplicitEuler(double ts);
+
+      //! Advance bodies with fourth-order Runge-Kutta.
+      //! @param[in] ts integration timestep.
+      void
+      stepRungeKutta4(double ts);
+
+      //! Evaluate state derivatives of all integrated bodies.
+      //! @param[in] state contiguous state of all bodies.
+      //! @param[out] deriv contiguous state derivatives of all bodies.
       void
-      applyForces(void);
+      computeDerivatives(const std::vector<double>& state, std::vector<double>& deriv);
 
-      //! Fetches all objects and vehicles data from simulator.
+      //! Write integrated states back to bodies.
+      //! @param[in] state contiguous state of all bodies.
       void
-      update(void);
+      commitState(const std::vector<double>& state);
 
       //! Set world's gravity.
       //! @param[in] x set world gravity in the x-axis.
@@ -102,12 +144,22 @@ namespace Simulators
       int m_world_id;
       //! World's gravity.
       double m_gravity[3];
-      //! World's vehicles.
-      std::list<Object*> m_objects;
-      //! World's objects.
-      std::list<Vehicle*> m_vehicles;
+      //! World's objects and vehicles.
+      std::vector<Object*> m_bodies;
       //! Integration timestep.
       double m_timestep;
+      //! Integration scheme.
+      Integrator m_integrator;
+      //! Number of sub-steps per timestep.
+      unsigned m_substeps;
+      //! State of all bodies at the start of a sub-step.
+      std::vector<double> m_state;
+      //! Intermediate state of all bodies.
+      std::vector<double> m_stage;
+      //! State derivatives of all bodies.
+      std::vector<double> m_deriv;
+      //! Weighted sum of Runge-Kutta derivatives.
+      std::vector<double> m_accum;
     };
   }
 }
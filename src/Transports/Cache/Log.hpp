@@ -0,0 +1,513 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef TRANSPORTS_CACHE_LOG_HPP_INCLUDED_
+#define TRANSPORTS_CACHE_LOG_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+#if defined(DUNE_SYS_HAS_UNISTD_H)
+#  include <unistd.h>
+#endif
+
+namespace Transports
+{
+  namespace Cache
+  {
+    using DUNE_NAMESPACES;
+
+    //! Record synchronization marker.
+    static const uint16_t c_sync = 0x4C43;
+    //! Superseded bytes tolerated before compacting, besides the
+    //! size of live records.
+    static const int64_t c_compact_slack = 64 * 1024;
+
+    //! Append-only store of the latest message of each (message
+    //! identifier, sub identifier) pair.
+    //!
+    //! Every store appends one record to a single file: a 10 byte
+    //! header (sync, message id, sub id, payload size and a CRC-16 of
+    //! the previous fields and payload) followed by the serialized
+    //! packet. An in-memory index keeps the offset of the latest
+    //! record for each key. Records that fail the checksum, such as
+    //! a write interrupted by a power loss, end the log when it is
+    //! opened and are dropped by compaction, which rewrites the live
+    //! records to a new file and renames it over the log once
+    //! superseded records outweigh live ones.
+    class Log
+    {
+    public:
+      //! Record header size.
+      static const size_t c_header_size = 10;
+
+      //! Constructor.
+      //! @param[in] path log file.
+      Log(const Path& path):
+        m_path(path),
+        m_fd(NULL),
+        m_file_size(0),
+        m_live_size(0),
+        m_dirty(false)
+      { }
+
+      ~Log(void)
+      {
+        close();
+      }
+
+      //! Open the log, creating it if needed, and rebuild the index.
+      //! @return number of bytes dropped from a damaged tail.
+      int64_t
+      open(void)
+      {
+        close();
+
+        m_fd = std::fopen(m_path.c_str(), "a+b");
+        if (m_fd == NULL)
+          throw System::Error(errno, "unable to open " + m_path.str());
+
+        std::vector<uint8_t> data;
+        readFile(data);
+
+        m_index.clear();
+        m_live_size = 0;
+
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+          Key key = 0;
+          int size = decode(&data[pos], data.size() - pos, key);
+          if (size < 0)
+            break;
+
+          std::map<Key, Entry>::iterator itr = m_index.find(key);
+          if (itr != m_index.end())
+            m_live_size -= c_header_size + itr->second.size;
+
+          Entry& entry = m_index[key];
+          entry.offset = pos + c_header_size;
+          entry.size = (uint16_t)size;
+          m_live_size += c_header_size + size;
+
+          pos += c_header_size + size;
+        }
+
+        m_file_size = data.size();
+        int64_t dropped = data.size() - pos;
+
+        // Damaged records would be followed by new ones.
+        if (dropped > 0)
+          compact();
+
+        return dropped;
+      }
+
+      //! Close the log.
+      void
+      close(void)
+      {
+        if (m_fd == NULL)
+          return;
+
+        sync();
+        std::fclose(m_fd);
+        m_fd = NULL;
+      }
+
+      //! Store a message, superseding any previous message with the
+      //! same identifier and sub identifier.
+      //! @param[in] msg message.
+      void
+      append(const IMC::Message* msg)
+      {
+        uint16_t size = msg->getSerializationSize();
+        m_bfr.resize(c_header_size + size);
+        IMC::Packet::serialize(msg, &m_bfr[c_header_size], size);
+        encode(msg->getId(), msg->getSubId(), &m_bfr[c_header_size], size, &m_bfr[0]);
+
+        if (std::fwrite(&m_bfr[0], 1, m_bfr.size(), m_fd) != m_bfr.size()
+            || std::fflush(m_fd) != 0)
+          throw System::Error(errno, "unable to write " + m_path.str());
+
+        Key key = ((Key)msg->getId() << 16) | msg->getSubId();
+        std::map<Key, Entry>::iterator itr = m_index.find(key);
+        if (itr != m_index.end())
+          m_live_size -= c_header_size + itr->second.size;
+
+        Entry& entry = m_index[key];
+        entry.offset = m_file_size + c_header_size;
+        entry.size = size;
+        m_live_size += m_bfr.size();
+        m_file_size += m_bfr.size();
+        m_dirty = true;
+
+        if (m_file_size - m_live_size > std::max(m_live_size, c_compact_slack))
+          compact();
+      }
+
+      //! Flush stored messages to the storage device.
+      void
+      sync(void)
+      {
+        if (m_fd == NULL || !m_dirty)
+          return;
+
+        flush(m_fd);
+        m_dirty = false;
+      }
+
+      //! Remove all messages.
+      void
+      clear(void)
+      {
+        close();
+
+        std::FILE* fd = std::fopen(m_path.c_str(), "wb");
+        if (fd == NULL)
+          throw System::Error(errno, "unable to truncate " + m_path.str());
+
+        write(fd, NULL, 0);
+        std::fclose(fd);
+
+        open();
+      }
+
+      //! Rewrite the log keeping only live records.
+      void
+      compact(void)
+      {
+        std::vector<uint8_t> data;
+        readFile(data);
+
+        // Keep records in log order.
+        std::vector<std::pair<int64_t, Key> > live;
+        for (std::map<Key, Entry>::iterator itr = m_index.begin(); itr != m_index.end(); ++itr)
+          live.push_back(std::make_pair(itr->second.offset, itr->first));
+        std::sort(live.begin(), live.end());
+
+        std::vector<uint8_t> out;
+        out.reserve(m_live_size);
+        for (size_t i = 0; i < live.size(); ++i)
+        {
+          Entry& entry = m_index[live[i].second];
+          const uint8_t* record = &data[entry.offset - c_header_size];
+          out.insert(out.end(), record, record + c_header_size + entry.size);
+          entry.offset = out.size() - entry.size;
+        }
+
+        Path tmp(m_path.str() + ".tmp");
+        std::FILE* fd = std::fopen(tmp.c_str(), "wb");
+        if (fd == NULL)
+          throw System::Error(errno, "unable to create " + tmp.str());
+
+        write(fd, out.empty() ? NULL : &out[0], out.size());
+        std::fclose(fd);
+
+        std::fclose(m_fd);
+        m_fd = NULL;
+
+        if (std::rename(tmp.c_str(), m_path.c_str()) != 0)
+        {
+          // Some systems do not replace existing files.
+          m_path.remove();
+          if (std::rename(tmp.c_str(), m_path.c_str()) != 0)
+            throw System::Error(errno, "unable to replace " + m_path.str());
+        }
+
+        m_fd = std::fopen(m_path.c_str(), "a+b");
+        if (m_fd == NULL)
+          throw System::Error(errno, "unable to open " + m_path.str());
+
+        m_file_size = out.size();
+        m_live_size = out.size();
+        m_dirty = false;
+      }
+
+      //! Get number of live messages.
+      //! @return number of messages.
+      size_t
+      size(void) const
+      {
+        return m_index.size();
+      }
+
+      //! Get log file path.
+      //! @return path.
+      const Path&
+      getPath(void) const
+      {
+        return m_path;
+      }
+
+      //! Get log file size.
+      //! @return size in bytes.
+      int64_t
+      getFileSize(void) const
+      {
+        return m_file_size;
+      }
+
+      //! Retrieve the serialized live messages, one after the other
+      //! like in an LSF file, reading the log sequentially. Messages
+      //! named in 'order' come first, in that order, followed by the
+      //! others sorted by name; messages of the same type are sorted
+      //! by sub identifier.
+      //! @param[in] order message names in loading order.
+      //! @param[out] data serialized messages.
+      void
+      snapshot(const std::vector<std::string>& order, std::vector<uint8_t>& data)
+      {
+        std::vector<uint16_t> sizes;
+        snapshot(order, data, sizes);
+      }
+
+      //! Retrieve the serialized live messages, as above, and the
+      //! stored size of each one.
+      //! @param[in] order message names in loading order.
+      //! @param[out] data serialized messages.
+      //! @param[out] sizes size of each message in data.
+      void
+      snapshot(const std::vector<std::string>& order, std::vector<uint8_t>& data,
+               std::vector<uint16_t>& sizes)
+      {
+        std::vector<Slot> slots;
+        slots.reserve(m_index.size());
+
+        for (std::map<Key, Entry>::iterator itr = m_index.begin(); itr != m_index.end(); ++itr)
+        {
+          Slot slot;
+          slot.name = IMC::Factory::getAbbrevFromId(itr->first >> 16);
+          slot.rank = std::find(order.begin(), order.end(), slot.name) - order.begin();
+          slot.subid = itr->first & 0xffff;
+          slot.offset = itr->second.offset;
+          slot.size = itr->second.size;
+          slots.push_back(slot);
+        }
+
+        std::sort(slots.begin(), slots.end());
+
+        std::vector<uint8_t> contents;
+        readFile(contents);
+
+        data.clear();
+        data.reserve(m_live_size);
+        sizes.clear();
+        sizes.reserve(slots.size());
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+          const uint8_t* payload = &contents[slots[i].offset];
+          data.insert(data.end(), payload, payload + slots[i].size);
+          sizes.push_back(slots[i].size);
+        }
+      }
+
+      //! Read messages stored one file per message, in a directory per
+      //! message type, by previous versions of the cache.
+      //! @param[in] dir cache directory.
+      //! @param[out] msgs messages read (caller owns them).
+      static void
+      readLegacy(const Path& dir, std::vector<IMC::Message*>& msgs)
+      {
+        std::vector<std::string> names;
+        const char* fname = 0;
+
+        try
+        {
+          Directory directory(dir);
+          while ((fname = directory.readEntry(Directory::RD_FILE_NAME)))
+          {
+            if ((dir / fname).type() == Path::PT_DIRECTORY)
+              names.push_back(fname);
+          }
+        }
+        catch (...)
+        { }
+
+        for (unsigned int i = 0; i < names.size(); ++i)
+        {
+          try
+          {
+            Directory md(dir / names[i]);
+            while ((fname = md.readEntry(Directory::RD_FULL_NAME)))
+            {
+              std::ifstream ifs(fname, std::ios::binary);
+              IMC::Message* msg = IMC::Packet::deserialize(ifs);
+              if (msg)
+                msgs.push_back(msg);
+            }
+          }
+          catch (...)
+          { }
+        }
+      }
+
+    private:
+      //! Location of a live record.
+      struct Entry
+      {
+        //! Payload offset.
+        int64_t offset;
+        //! Payload size.
+        uint16_t size;
+      };
+
+      //! Loading order of a live record.
+      struct Slot
+      {
+        size_t rank;
+        std::string name;
+        uint16_t subid;
+        int64_t offset;
+        uint16_t size;
+
+        bool
+        operator<(const Slot& other) const
+        {
+          if (rank != other.rank)
+            return rank < other.rank;
+          if (name != other.name)
+            return name < other.name;
+          return subid < other.subid;
+        }
+      };
+
+      //! Index key: message identifier and sub identifier.
+      typedef uint32_t Key;
+
+      //! Log file path.
+      Path m_path;
+      //! Log file handle.
+      std::FILE* m_fd;
+      //! Latest record of each key.
+      std::map<Key, Entry> m_index;
+      //! Log file size.
+      int64_t m_file_size;
+      //! Size of live records.
+      int64_t m_live_size;
+      //! True if there are writes not yet flushed to the device.
+      bool m_dirty;
+      //! Serialization buffer.
+      std::vector<uint8_t> m_bfr;
+
+      //! Read the whole log file.
+      void
+      readFile(std::vector<uint8_t>& data)
+      {
+        std::fflush(m_fd);
+        std::fseek(m_fd, 0, SEEK_END);
+        long size = std::ftell(m_fd);
+        std::fseek(m_fd, 0, SEEK_SET);
+
+        data.resize(size > 0 ? size : 0);
+        if (!data.empty() && std::fread(&data[0], 1, data.size(), m_fd) != data.size())
+          throw System::Error(errno, "unable to read " + m_path.str());
+      }
+
+      //! Build a record.
+      static size_t
+      encode(uint16_t id, uint16_t subid, const uint8_t* payload, uint16_t size, uint8_t* dst)
+      {
+        ByteCopy::toLE(c_sync, dst);
+        ByteCopy::toLE(id, dst + 2);
+        ByteCopy::toLE(subid, dst + 4);
+        ByteCopy::toLE(size, dst + 6);
+
+        uint16_t crc = Algorithms::CRC16::compute(dst + 2, 6);
+        crc = Algorithms::CRC16::compute(payload, size, crc);
+        ByteCopy::toLE(crc, dst + 8);
+
+        return c_header_size + size;
+      }
+
+      //! Parse a record header.
+      //! @return payload size or -1 if the record is invalid.
+      static int
+      decode(const uint8_t* bfr, size_t size, Key& key)
+      {
+        if (size < c_header_size)
+          return -1;
+
+        uint16_t sync = 0;
+        uint16_t id = 0;
+        uint16_t subid = 0;
+        uint16_t length = 0;
+        uint16_t crc = 0;
+        ByteCopy::fromLE(sync, bfr);
+        ByteCopy::fromLE(id, bfr + 2);
+        ByteCopy::fromLE(subid, bfr + 4);
+        ByteCopy::fromLE(length, bfr + 6);
+        ByteCopy::fromLE(crc, bfr + 8);
+
+        if (sync != c_sync || size < c_header_size + length)
+          return -1;
+
+        uint16_t computed = Algorithms::CRC16::compute(bfr + 2, 6);
+        computed = Algorithms::CRC16::compute(bfr + c_header_size, length, computed);
+        if (computed != crc)
+          return -1;
+
+        key = ((Key)id << 16) | subid;
+        return length;
+      }
+
+      //! Write a buffer to a file and flush it to the device.
+      static void
+      write(std::FILE* fd, const uint8_t* data, size_t size)
+      {
+        if (size > 0 && std::fwrite(data, 1, size, fd) != size)
+          throw System::Error(errno, "unable to write cache log");
+
+        flush(fd);
+      }
+
+      //! Flush a file to the device.
+      static void
+      flush(std::FILE* fd)
+      {
+        std::fflush(fd);
+
+#if defined(DUNE_SYS_HAS_UNISTD_H)
+        fsync(fileno(fd));
+#endif
+      }
+    };
+  }
+}
+
+#endif
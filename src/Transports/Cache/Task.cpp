@@ -36,6 +36,9 @@
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
+// Local headers.
+#include "Log.hpp"
+
 namespace Transports
 {
   namespace Cache
@@ -52,210 +55,124 @@ namespace Transports
     {
       // Cache directory path.
       Path m_path;
-      // Path to snapshot file.
+      // Path to snapshot file of the previous cache layout.
       Path m_snapshot;
-      // Internal buffer.
-      uint8_t* m_buffer;
-      // Internal buffer size.
-      uint16_t m_buffer_size;
+      // Message log.
+      Log m_log;
       // Task arguments.
       Arguments m_args;
 
       Task(const std::string& name, Tasks::Context& ctx):
-        DUNE::Tasks::Task(name, ctx)
+        DUNE::Tasks::Task(name, ctx),
+        m_path(ctx.dir_db / "Cache"),
+        m_snapshot(m_path / (std::string(DUNE_IMC_CONST_MD5) + ".lsf")),
+        m_log(m_path / (std::string(DUNE_IMC_CONST_MD5) + ".log"))
       {
         // Define configuration parameters.
         param("Loading Order", m_args.order)
         .defaultValue("")
         .description("List of messages ordered by loading order");
 
-        // Initialize internal buffer.
-        m_buffer_size = 128;
-        m_buffer = new uint8_t[m_buffer_size];
-
         // Create cache directory.
-        m_path = m_ctx.dir_db / "Cache";
         m_path.create();
 
-        // Set snapshot file path.
-        m_snapshot = m_path / (std::string(DUNE_IMC_CONST_MD5) + ".lsf");
-
         // Bind messages.
         bind<IMC::CacheControl>(this);
       }
 
-      ~Task(void)
-      {
-        delete [] m_buffer;
-      }
-
-      void
-      onResourceInitialization(void)
-      {
-        setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
-      }
-
       void
-      consume(const IMC::CacheControl* msg)
+      onResourceAcquisition(void)
       {
-        switch (msg->op)
+        // Cached messages of other IMC versions are discarded.
+        if (!m_log.getPath().isFile())
         {
-          case IMC::CacheControl::COP_STORE:
-            if (!msg->message.isNull())
-              store(msg->message.get());
-            break;
-          case IMC::CacheControl::COP_LOAD:
-            load();
-            break;
-          case IMC::CacheControl::COP_CLEAR:
-            clear();
-            break;
-          case IMC::CacheControl::COP_COPY:
-            copySnapshot(msg->snapshot);
-            break;
-          default:
-            break;
-        }
-      }
-
-      void
-      getMessageFiles(std::vector<std::string>& files)
-      {
-        std::vector<std::string> msgs = m_args.order;
-        const char* fname = 0;
+          std::vector<IMC::Message*> msgs;
+          if (m_snapshot.isFile())
+            Log::readLegacy(m_path, msgs);
 
-        // Retrieve the name of all cached messages that are not in the
-        // loading order list.
-        try
-        {
-          Directory dir(m_path);
+          m_path.remove(Path::MODE_RECURSIVE);
+          m_path.create();
+          m_log.open();
 
-          while ((fname = dir.readEntry(Directory::RD_FILE_NAME)))
+          for (unsigned int i = 0; i < msgs.size(); ++i)
           {
-            if (std::find(msgs.begin(), msgs.end(), fname) == msgs.end()
-                && ((m_path / fname).type() == Path::PT_DIRECTORY))
-            {
-              msgs.push_back(fname);
-            }
+            m_log.append(msgs[i]);
+            delete msgs[i];
           }
-        }
-        catch (...)
-        { }
 
-        // Load cached messages.
-        for (unsigned int i = 0; i < msgs.size(); ++i)
-        {
-          try
-          {
-            Directory md(m_path / msgs[i]);
-            while ((fname = md.readEntry(Directory::RD_FULL_NAME)))
-              files.push_back(fname);
-          }
-          catch (...)
-          { }
+          if (!msgs.empty())
+            inf(DTR("imported %u cached messages"), (unsigned)msgs.size());
         }
+
+        int64_t dropped = m_log.open();
+        if (dropped > 0)
+          war(DTR("dropped %lld bytes of damaged cache records"), (long long)dropped);
       }
 
       void
-      growBuffer(int size)
+      onResourceRelease(void)
       {
-        if (size > m_buffer_size)
-        {
-          delete [] m_buffer;
-          m_buffer_size = size;
-          m_buffer = new uint8_t[m_buffer_size];
-        }
+        m_log.close();
       }
 
       void
-      store(const IMC::Message* msg)
+      onResourceInitialization(void)
       {
-        std::string id = String::str(msg->getSubId());
-        uint16_t size = msg->getSerializationSize();
-
-        // Create destination directory.
-        Path path = m_path / msg->getName();
-        path.create();
-
-        // Open file for writing.
-        path = path / id;
-        std::ofstream ofs(path.c_str(), std::ios::binary);
-
-        growBuffer(size);
-
-        // Write message to file.
-        IMC::Packet::serialize(msg, m_buffer, size);
-        ofs.write((char*)m_buffer, size);
-        ofs.close();
-
-        storeSnapshot();
+        setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
       }
 
       void
-      loadSnapshot(void)
+      consume(const IMC::CacheControl* msg)
       {
-        if (m_snapshot.type() != Path::PT_FILE)
-        {
-          clear();
-          return;
-        }
-
-        std::ifstream ifs(m_snapshot.c_str(), std::ios::binary);
-
-        if (!ifs.is_open())
-          return;
-
-        while (!ifs.eof())
+        try
         {
-          IMC::Message* msg = IMC::Packet::deserialize(ifs);
-          if (msg)
+          switch (msg->op)
           {
-            dispatch(msg, DF_KEEP_TIME);
-            delete msg;
+            case IMC::CacheControl::COP_STORE:
+              if (!msg->message.isNull())
+                m_log.append(msg->message.get());
+              break;
+            case IMC::CacheControl::COP_LOAD:
+              load();
+              break;
+            case IMC::CacheControl::COP_CLEAR:
+              m_log.clear();
+              break;
+            case IMC::CacheControl::COP_COPY:
+              copySnapshot(msg->snapshot);
+              break;
+            default:
+              break;
           }
         }
-      }
-
-      void
-      storeSnapshot(void)
-      {
-        // Retrieve file list.
-        std::vector<std::string> files;
-        getMessageFiles(files);
-
-        std::ofstream ofs(m_snapshot.c_str(), std::ios::binary);
-
-        // Copy all cached messages to a single file.
-        for (unsigned int i = 0; i < files.size(); ++i)
+        catch (std::exception& e)
         {
-          int64_t size = Path(files[i]).size();
-
-          if (size < 0)
-            continue;
-
-          growBuffer(size);
-
-          std::ifstream ifs(files[i].c_str(), std::ios::binary);
-          ifs.read((char*)m_buffer, size);
-          ofs.write((char*)m_buffer, size);
+          err(DTR("cache operation failed: %s"), e.what());
         }
       }
 
       void
       copySnapshot(Path destination)
       {
-        if (!Path(m_snapshot).exists())
-          return;
-
         try
         {
-          Path(m_snapshot).copy(destination);
+          std::vector<uint8_t> data;
+          m_log.snapshot(m_args.order, data);
+
+          std::ofstream ofs(destination.c_str(), std::ios::binary);
+          if (!data.empty())
+            ofs.write((const char*)&data[0], data.size());
+          ofs.close();
+
+          if (ofs.fail())
+            throw std::runtime_error("unable to write " + destination.str());
+
           IMC::CacheControl cc;
           cc.op = IMC::CacheControl::COP_COPY_COMPLETE;
           cc.snapshot = destination.str();
           dispatch(cc);
         }
-        catch (System::Error& e)
+        catch (std::exception& e)
         {
           err(DTR("failed to copy cache snapshot: %s"), e.what());
         }
@@ -264,37 +181,45 @@ namespace Transports
       void
       load(void)
       {
-        std::vector<std::string> files;
-        getMessageFiles(files);
+        std::vector<uint8_t> data;
+        std::vector<uint16_t> sizes;
+        m_log.snapshot(m_args.order, data, sizes);
 
-        for (unsigned int i = 0; i < files.size(); ++i)
+        size_t pos = 0;
+        for (size_t i = 0; i < sizes.size(); ++i)
         {
-          std::ifstream ifs(files[i].c_str(), std::ios::binary);
-          IMC::Message* msg = IMC::Packet::deserialize(ifs);
-          if (msg)
+          const uint8_t* record = &data[pos];
+          pos += sizes[i];
+
+          try
           {
+            IMC::Message* msg = IMC::Packet::deserialize(record, sizes[i]);
             dispatch(msg, DF_KEEP_TIME);
             delete msg;
           }
+          catch (std::exception& e)
+          {
+            err(DTR("failed to load cached message: %s"), e.what());
+          }
         }
       }
 
-      void
-      clear(void)
-      {
-        // Remove cache directory and create a new one.
-        m_path.remove(Path::MODE_RECURSIVE);
-        m_path.create();
-      }
-
       void
       onMain(void)
       {
-        loadSnapshot();
+        try
+        {
+          load();
+        }
+        catch (std::exception& e)
+        {
+          err(DTR("failed to load cache: %s"), e.what());
+        }
 
         while (!stopping())
         {
           waitForMessages(1.0);
+          m_log.sync();
         }
       }
     };
@@ -29,11 +29,17 @@
 #define SRC_TRANSPORTS_COMMMANAGER_ROUTER_HPP_
 
 // ISO C++ 98 headers.
+#include <algorithm>
+#include <set>
 #include <string>
+#include <vector>
 
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
+// Local headers.
+#include "Scheduler.hpp"
+
 namespace Transports
 {
   namespace CommManager
@@ -263,7 +269,7 @@ namespace Transports
         uint16_t newId = createInternalId();
         tx.req_id = newId;
         m_transmission_requests[newId] = msg->clone();
-        m_parent->dispatch(tx);
+        schedule(LINK_ACOUSTIC, msg, newId, tx);
 
       }
 
@@ -334,7 +340,7 @@ namespace Transports
         uint16_t newId = createInternalId();
         tx.req_id = newId;
         m_transmission_requests[newId] = msg->clone();
-        m_parent->dispatch(tx);
+        schedule(LINK_SATELLITE, msg, newId, tx);
       }
 
       void
@@ -549,7 +555,7 @@ namespace Transports
         uint16_t newId = createInternalId();
         sms.req_id = newId;
         m_transmission_requests[newId] = msg->clone();
-        m_parent->dispatch(sms);
+        schedule(LINK_GSM, msg, newId, sms);
       }
 
       void
@@ -609,7 +615,7 @@ namespace Transports
         uint16_t newId = createInternalId();
         send.req_id = newId;
         m_transmission_requests[newId] = msg->clone();
-        m_parent->dispatch(send);
+        schedule(LINK_WIFI, msg, newId, send);
 
       }
 
@@ -752,6 +758,107 @@ namespace Transports
         return &m_transmission_requests;
       }
 
+      //! Configure the transmission scheduler of a link.
+      //! @param[in] link link.
+      //! @param[in] rate transmission rate (bytes/s), 0 for unlimited.
+      //! @param[in] burst maximum burst size (bytes).
+      //! @param[in] queue_max maximum number of queued requests.
+      void
+      configureLink(LinkType link, double rate, double burst, unsigned queue_max)
+      {
+        m_scheduler.configure(link, rate, burst, queue_max);
+      }
+
+      //! Set which inline messages are sent ahead of or behind
+      //! regular traffic.
+      //! @param[in] high abbreviations of high priority messages.
+      //! @param[in] low abbreviations of low priority messages.
+      void
+      setPriorityMessages(const std::vector<std::string>& high,
+                          const std::vector<std::string>& low)
+      {
+        m_prio_high.clear();
+        m_prio_low.clear();
+
+        for (unsigned i = 0; i < high.size(); ++i)
+          m_prio_high.insert(IMC::Factory::getIdFromAbbrev(high[i]));
+
+        for (unsigned i = 0; i < low.size(); ++i)
+          m_prio_low.insert(IMC::Factory::getIdFromAbbrev(low[i]));
+      }
+
+      //! Set the share of link capacity of requests originated by a
+      //! given system.
+      //! @param[in] system system id.
+      //! @param[in] weight relative weight.
+      void
+      setSourceWeight(uint16_t system, unsigned weight)
+      {
+        m_scheduler.setWeight(system, weight);
+      }
+
+      //! Check if there are requests waiting for link capacity.
+      //! @return true if requests are queued, false otherwise.
+      bool
+      hasQueued(void) const
+      {
+        return !m_scheduler.empty();
+      }
+
+      //! Discard expired requests and hand queued requests to the
+      //! modems, as long as links have capacity.
+      void
+      serviceQueues(void)
+      {
+        double now = Time::Clock::getSinceEpoch();
+
+        std::vector<uint16_t> expired;
+        m_scheduler.expire(now, expired);
+        discard(expired, "Transmission expired while queued.");
+
+        for (unsigned i = 0; i < LINK_TOTAL; ++i)
+        {
+          Scheduler::Entry entry;
+          while (m_scheduler.dequeue(static_cast<LinkType>(i), now, entry))
+          {
+            MessagesQueued::iterator itr = m_transmission_requests.find(entry.id);
+            if (itr != m_transmission_requests.end())
+            {
+              refreshTimeout(entry.msg, itr->second->deadline, now);
+              m_parent->dispatch(entry.msg);
+            }
+
+            delete entry.msg;
+          }
+        }
+      }
+
+      //! Report queue statistics of all links that carried traffic.
+      void
+      reportStatistics(void)
+      {
+        static const char* c_link_names[] = {"Wi-Fi", "Acoustic", "Satellite", "GSM"};
+        double now = Time::Clock::getSinceEpoch();
+
+        for (unsigned i = 0; i < LINK_TOTAL; ++i)
+        {
+          LinkType link = static_cast<LinkType>(i);
+          const LinkStatistics& stats = m_scheduler.getStatistics(link);
+          if (stats.accepted == 0 && stats.dropped == 0)
+            continue;
+
+          m_parent->inf("%s link: %u queued | %u accepted | %u sent (%llu bytes)"
+                        " | %u expired | %u dropped | wait avg %.1f s, max %.1f s"
+                        " | %.0f tokens",
+                        c_link_names[i], m_scheduler.getSize(link),
+                        stats.accepted, stats.sent,
+                        (unsigned long long)stats.bytes, stats.expired,
+                        stats.dropped,
+                        stats.sent ? stats.wait / stats.sent : 0.0,
+                        stats.max_wait, m_scheduler.getTokens(link, now));
+        }
+      }
+
       ~Router()
       {
       }
@@ -782,6 +889,13 @@ namespace Transports
 
       uint16_t c_wifi_timeout;
 
+      //! Per link transmission scheduler.
+      Scheduler m_scheduler;
+      //! Identifiers of high priority messages.
+      std::set<uint16_t> m_prio_high;
+      //! Identifiers of low priority messages.
+      std::set<uint16_t> m_prio_low;
+
       enum RSSIType
       {
         GSM, IRIDIUM
@@ -886,6 +1000,105 @@ namespace Transports
         }
       }
 
+      //! Queue a request on a link and service the queues.
+      //! @param[in] link link.
+      //! @param[in] req original transmission request.
+      //! @param[in] id internal request identifier.
+      //! @param[in] tx message to hand to the modem.
+      void
+      schedule(LinkType link, const IMC::TransmissionRequest* req,
+               uint16_t id, const IMC::Message& tx)
+      {
+        std::vector<uint16_t> dropped;
+        m_scheduler.enqueue(link, getPriority(req), req->getSource(), id,
+                            tx.clone(), req->deadline,
+                            Time::Clock::getSinceEpoch(), dropped);
+        discard(dropped, "Transmission queue is full.");
+        serviceQueues();
+      }
+
+      //! Recompute the time a modem has left to transmit a request,
+      //! since it may have waited for link capacity after being queued.
+      //! @param[in] msg message to hand to the modem.
+      //! @param[in] deadline absolute deadline (s since epoch).
+      //! @param[in] now current time (s since epoch).
+      void
+      refreshTimeout(IMC::Message* msg, double deadline, double now)
+      {
+        double left = std::max(0.0, deadline - now);
+
+        switch (msg->getId())
+        {
+          case DUNE_IMC_ACOUSTICREQUEST:
+            static_cast<IMC::AcousticRequest*>(msg)->timeout = left;
+            break;
+
+          case DUNE_IMC_IRIDIUMMSGTX:
+            static_cast<IMC::IridiumMsgTx*>(msg)->ttl = (uint16_t)std::min(left, 65535.0);
+            break;
+
+          case DUNE_IMC_SMSREQUEST:
+            static_cast<IMC::SmsRequest*>(msg)->timeout = left;
+            break;
+
+          default:
+            // TCPRequest carries the absolute deadline.
+            break;
+        }
+      }
+
+      //! Fail a list of pending requests.
+      //! @param[in] ids internal request identifiers.
+      //! @param[in] info reason.
+      void
+      discard(const std::vector<uint16_t>& ids, const std::string& info)
+      {
+        for (unsigned i = 0; i < ids.size(); ++i)
+        {
+          MessagesQueued::iterator itr = m_transmission_requests.find(ids[i]);
+          if (itr == m_transmission_requests.end())
+            continue;
+
+          answer(itr->second, info,
+                 IMC::TransmissionStatus::TSTAT_TEMPORARY_FAILURE);
+          Memory::clear(itr->second);
+          m_transmission_requests.erase(itr);
+        }
+      }
+
+      //! Classify a transmission request.
+      //! @param[in] msg transmission request.
+      //! @return priority class.
+      PriorityClass
+      getPriority(const IMC::TransmissionRequest* msg)
+      {
+        switch (msg->data_mode)
+        {
+          case IMC::TransmissionRequest::DMODE_ABORT:
+            return PRIO_CONTROL;
+
+          case IMC::TransmissionRequest::DMODE_RANGE:
+          case IMC::TransmissionRequest::DMODE_REVERSE_RANGE:
+            return PRIO_COMMAND;
+
+          case IMC::TransmissionRequest::DMODE_INLINEMSG:
+            {
+              if (msg->msg_data.isNull())
+                return PRIO_NORMAL;
+
+              uint16_t id = msg->msg_data.get()->getId();
+              if (m_prio_high.find(id) != m_prio_high.end())
+                return PRIO_COMMAND;
+              if (m_prio_low.find(id) != m_prio_low.end())
+                return PRIO_BULK;
+              return PRIO_NORMAL;
+            }
+
+          default:
+            return PRIO_NORMAL;
+        }
+      }
+
       bool
       checkGSMMessageSize(const IMC::TransmissionRequest* msg)
       {
@@ -0,0 +1,468 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef TRANSPORTS_COMMMANAGER_SCHEDULER_HPP_INCLUDED_
+#define TRANSPORTS_COMMMANAGER_SCHEDULER_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <deque>
+#include <map>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+namespace Transports
+{
+  namespace CommManager
+  {
+    using DUNE_NAMESPACES;
+
+    //! Communication links handled by the scheduler.
+    enum LinkType
+    {
+      //! Wi-Fi (TCP).
+      LINK_WIFI,
+      //! Acoustic modem.
+      LINK_ACOUSTIC,
+      //! Satellite modem.
+      LINK_SATELLITE,
+      //! GSM modem.
+      LINK_GSM,
+      //! Number of links.
+      LINK_TOTAL
+    };
+
+    //! Priority classes. Lower values are always served first.
+    enum PriorityClass
+    {
+      //! Aborts.
+      PRIO_CONTROL,
+      //! Commands and ranging requests.
+      PRIO_COMMAND,
+      //! Regular traffic.
+      PRIO_NORMAL,
+      //! Bulk data.
+      PRIO_BULK,
+      //! Number of priority classes.
+      PRIO_TOTAL
+    };
+
+    //! Per link queue statistics.
+    struct LinkStatistics
+    {
+      //! Number of accepted requests.
+      unsigned accepted;
+      //! Number of dispatched requests.
+      unsigned sent;
+      //! Number of requests that expired while queued.
+      unsigned expired;
+      //! Number of requests dropped due to queue overflow.
+      unsigned dropped;
+      //! Number of dispatched bytes.
+      uint64_t bytes;
+      //! Accumulated queueing delay of dispatched requests (s).
+      double wait;
+      //! Maximum queueing delay of dispatched requests (s).
+      double max_wait;
+
+      LinkStatistics(void):
+        accepted(0),
+        sent(0),
+        expired(0),
+        dropped(0),
+        bytes(0),
+        wait(0),
+        max_wait(0)
+      { }
+    };
+
+    //! Per link transmission scheduler. Each link is shaped by a
+    //! token bucket, queued requests are served by strict priority
+    //! class and, inside a class, by weighted fair queueing among
+    //! the systems that originated them. Requests that are past their
+    //! deadline are discarded before being handed to the modem.
+    class Scheduler
+    {
+    public:
+      //! Request waiting for transmission.
+      struct Entry
+      {
+        //! Internal request identifier.
+        uint16_t id;
+        //! Message to dispatch when the request is served.
+        IMC::Message* msg;
+        //! Transmission cost (bytes).
+        unsigned cost;
+        //! Absolute deadline (s since epoch), 0 if none.
+        double deadline;
+        //! Arrival time (s since epoch).
+        double arrival;
+        //! Virtual finish time used for fair queueing.
+        double tag;
+      };
+
+      Scheduler(void):
+        m_weight_default(1)
+      {
+        m_queue_max.assign(LINK_TOTAL, 0);
+        m_buckets.resize(LINK_TOTAL);
+        m_links.resize(LINK_TOTAL);
+        m_stats.resize(LINK_TOTAL);
+      }
+
+      ~Scheduler(void)
+      {
+        for (unsigned i = 0; i < LINK_TOTAL; ++i)
+          clear(static_cast<LinkType>(i));
+      }
+
+      //! Configure a link.
+      //! @param[in] link link.
+      //! @param[in] rate transmission rate (bytes/s), 0 for unlimited.
+      //! @param[in] burst maximum burst size (bytes).
+      //! @param[in] queue_max maximum number of queued requests, 0
+      //! for unlimited.
+      void
+      configure(LinkType link, double rate, double burst, unsigned queue_max)
+      {
+        m_buckets[link].setRate(rate, burst);
+        m_queue_max[link] = queue_max;
+      }
+
+      //! Set the weight of the requests originated by a given system.
+      //! @param[in] flow originating system.
+      //! @param[in] weight relative share of the link.
+      void
+      setWeight(unsigned flow, unsigned weight)
+      {
+        m_weights[flow] = std::max(1u, weight);
+      }
+
+      //! Queue a message for transmission. If the link queue is full
+      //! the newest request of the lowest priority class is dropped to
+      //! make room, or the new request is rejected if nothing of lower
+      //! priority is waiting.
+      //! @param[in] link link.
+      //! @param[in] prio priority class.
+      //! @param[in] flow originating system.
+      //! @param[in] id internal request identifier.
+      //! @param[in] msg message to dispatch, ownership is transferred.
+      //! @param[in] deadline absolute deadline (s since epoch).
+      //! @param[in] now current time (s since epoch).
+      //! @param[out] dropped identifiers of discarded requests.
+      //! @return true if the request was queued, false otherwise.
+      bool
+      enqueue(LinkType link, PriorityClass prio, unsigned flow, uint16_t id,
+              IMC::Message* msg, double deadline, double now,
+              std::vector<uint16_t>& dropped)
+      {
+        LinkStatistics& stats = m_stats[link];
+
+        if (m_queue_max[link] > 0 && getSize(link) >= m_queue_max[link])
+        {
+          if (!dropTail(link, prio, dropped))
+          {
+            ++stats.dropped;
+            dropped.push_back(id);
+            delete msg;
+            return false;
+          }
+        }
+
+        Class& cls = m_links[link].classes[prio];
+        Flow& f = cls.flows[flow];
+
+        Entry e;
+        e.id = id;
+        e.msg = msg;
+        e.cost = msg->getSerializationSize();
+        e.deadline = deadline;
+        e.arrival = now;
+        e.tag = std::max(cls.vtime, f.finish) + e.cost / (double)getWeight(flow);
+        f.finish = e.tag;
+        f.entries.push_back(e);
+        ++cls.size;
+        ++stats.accepted;
+        return true;
+      }
+
+      //! Remove the next request that can be transmitted on a link.
+      //! @param[in] link link.
+      //! @param[in] now current time (s since epoch).
+      //! @param[out] entry served request, the caller takes ownership
+      //! of the message.
+      //! @return true if a request was served, false if the queue is
+      //! empty or the link is out of tokens.
+      bool
+      dequeue(LinkType link, double now, Entry& entry)
+      {
+        for (unsigned p = 0; p < PRIO_TOTAL; ++p)
+        {
+          Class& cls = m_links[link].classes[p];
+          if (cls.size == 0)
+            continue;
+
+          FlowMap::iterator best = cls.flows.end();
+          for (FlowMap::iterator itr = cls.flows.begin(); itr != cls.flows.end(); ++itr)
+          {
+            if (itr->second.entries.empty())
+              continue;
+
+            if (best == cls.flows.end()
+                || itr->second.entries.front().tag < best->second.entries.front().tag)
+              best = itr;
+          }
+
+          // Strict priority: lower classes wait until this one drains.
+          if (!m_buckets[link].consume(best->second.entries.front().cost, now))
+            return false;
+
+          entry = best->second.entries.front();
+          best->second.entries.pop_front();
+          --cls.size;
+          cls.vtime = entry.tag;
+
+          if (cls.size == 0)
+            cls.flows.clear();
+
+          LinkStatistics& stats = m_stats[link];
+          double wait = std::max(0.0, now - entry.arrival);
+          ++stats.sent;
+          stats.bytes += entry.cost;
+          stats.wait += wait;
+          stats.max_wait = std::max(stats.max_wait, wait);
+          return true;
+        }
+
+        return false;
+      }
+
+      //! Discard all requests whose deadline has passed.
+      //! @param[in] now current time (s since epoch).
+      //! @param[out] expired identifiers of discarded requests.
+      void
+      expire(double now, std::vector<uint16_t>& expired)
+      {
+        for (unsigned l = 0; l < LINK_TOTAL; ++l)
+        {
+          for (unsigned p = 0; p < PRIO_TOTAL; ++p)
+          {
+            Class& cls = m_links[l].classes[p];
+            if (cls.size == 0)
+              continue;
+
+            for (FlowMap::iterator itr = cls.flows.begin(); itr != cls.flows.end(); ++itr)
+            {
+              std::deque<Entry>& q = itr->second.entries;
+              std::deque<Entry>::iterator e = q.begin();
+              while (e != q.end())
+              {
+                if (e->deadline > 0 && e->deadline <= now)
+                {
+                  expired.push_back(e->id);
+                  delete e->msg;
+                  e = q.erase(e);
+                  --cls.size;
+                  ++m_stats[l].expired;
+                }
+                else
+                {
+                  ++e;
+                }
+              }
+            }
+          }
+        }
+      }
+
+      //! Discard all requests queued on a link.
+      //! @param[in] link link.
+      void
+      clear(LinkType link)
+      {
+        for (unsigned p = 0; p < PRIO_TOTAL; ++p)
+        {
+          Class& cls = m_links[link].classes[p];
+          for (FlowMap::iterator itr = cls.flows.begin(); itr != cls.flows.end(); ++itr)
+          {
+            for (unsigned i = 0; i < itr->second.entries.size(); ++i)
+              delete itr->second.entries[i].msg;
+          }
+
+          cls.flows.clear();
+          cls.size = 0;
+        }
+      }
+
+      //! Get the number of requests queued on a link.
+      //! @param[in] link link.
+      //! @return number of requests.
+      unsigned
+      getSize(LinkType link) const
+      {
+        unsigned size = 0;
+        for (unsigned p = 0; p < PRIO_TOTAL; ++p)
+          size += m_links[link].classes[p].size;
+        return size;
+      }
+
+      //! Check if there are requests waiting on any link.
+      //! @return true if all queues are empty, false otherwise.
+      bool
+      empty(void) const
+      {
+        for (unsigned l = 0; l < LINK_TOTAL; ++l)
+        {
+          if (getSize(static_cast<LinkType>(l)) > 0)
+            return false;
+        }
+
+        return true;
+      }
+
+      //! Get the statistics of a link.
+      //! @param[in] link link.
+      //! @return link statistics.
+      const LinkStatistics&
+      getStatistics(LinkType link) const
+      {
+        return m_stats[link];
+      }
+
+      //! Get the number of tokens available on a link.
+      //! @param[in] link link.
+      //! @param[in] now current time (s since epoch).
+      //! @return number of tokens (bytes).
+      double
+      getTokens(LinkType link, double now)
+      {
+        return m_buckets[link].getTokens(now);
+      }
+
+    private:
+      //! Requests of one originating system.
+      struct Flow
+      {
+        //! Queued requests, in arrival order.
+        std::deque<Entry> entries;
+        //! Virtual finish time of the last queued request.
+        double finish;
+
+        Flow(void):
+          finish(0)
+        { }
+      };
+
+      typedef std::map<unsigned, Flow> FlowMap;
+
+      //! Requests of one priority class.
+      struct Class
+      {
+        //! Flows with queued requests.
+        FlowMap flows;
+        //! Number of queued requests.
+        unsigned size;
+        //! Virtual time (tag of the last served request).
+        double vtime;
+
+        Class(void):
+          size(0),
+          vtime(0)
+        { }
+      };
+
+      //! Queues of one link.
+      struct Link
+      {
+        Class classes[PRIO_TOTAL];
+      };
+
+      //! Default flow weight.
+      unsigned m_weight_default;
+      //! Flow weights.
+      std::map<unsigned, unsigned> m_weights;
+      //! Maximum queue length per link.
+      std::vector<unsigned> m_queue_max;
+      //! Token bucket per link.
+      std::vector<Network::TokenBucket> m_buckets;
+      //! Queues per link.
+      std::vector<Link> m_links;
+      //! Statistics per link.
+      std::vector<LinkStatistics> m_stats;
+
+      unsigned
+      getWeight(unsigned flow) const
+      {
+        std::map<unsigned, unsigned>::const_iterator itr = m_weights.find(flow);
+        if (itr == m_weights.end())
+          return m_weight_default;
+        return itr->second;
+      }
+
+      //! Drop the newest request of the lowest priority class below
+      //! a given priority, taking it from the flow with the largest
+      //! backlog.
+      //! @param[in] link link.
+      //! @param[in] prio priority of the incoming request.
+      //! @param[out] dropped identifiers of discarded requests.
+      //! @return true if a request was dropped, false otherwise.
+      bool
+      dropTail(LinkType link, PriorityClass prio, std::vector<uint16_t>& dropped)
+      {
+        for (int p = PRIO_TOTAL - 1; p > (int)prio; --p)
+        {
+          Class& cls = m_links[link].classes[p];
+          if (cls.size == 0)
+            continue;
+
+          FlowMap::iterator worst = cls.flows.end();
+          for (FlowMap::iterator itr = cls.flows.begin(); itr != cls.flows.end(); ++itr)
+          {
+            if (worst == cls.flows.end()
+                || itr->second.entries.size() > worst->second.entries.size())
+              worst = itr;
+          }
+
+          Entry& e = worst->second.entries.back();
+          dropped.push_back(e.id);
+          delete e.msg;
+          worst->second.entries.pop_back();
+          --cls.size;
+          ++m_stats[link].dropped;
+          return true;
+        }
+
+        return false;
+      }
+    };
+  }
+}
+
+#endif
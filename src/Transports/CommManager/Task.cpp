@@ -60,6 +60,20 @@ namespace Transports
       std::string acoustic_addr_section;
       //! Send Iridium text messages as plain text
       bool iridium_plain_texts;
+      //! Transmission rate of each link (bit/s).
+      double link_rate[LINK_TOTAL];
+      //! Maximum burst size of each link (bytes).
+      double link_burst[LINK_TOTAL];
+      //! Maximum number of queued requests per link.
+      unsigned queue_max;
+      //! Inline messages sent ahead of regular traffic.
+      std::vector<std::string> prio_high;
+      //! Inline messages sent behind regular traffic.
+      std::vector<std::string> prio_low;
+      //! Name of the configuration section with source weights.
+      std::string weights_section;
+      //! Period between queue statistics reports.
+      float stats_period;
     };
 
     //! Config section from where to fetch emergency sms number
@@ -80,6 +94,7 @@ namespace Transports
       Time::Counter<float> m_iridium_timer;
       Time::Counter<float> m_clean_timer;
       Time::Counter<float> m_retransmission_timer;
+      Time::Counter<float> m_stats_timer;
       std::list<IMC::TransmissionRequest*> m_retransmission_list;
       int m_plan_chksum;
       Router m_router;
@@ -124,6 +139,52 @@ namespace Transports
             .description("Send Iridium text messages as plain text (and not IMC)")
             .defaultValue("1");
 
+        const char* link_names[] = {"Wi-Fi", "Acoustic", "Satellite", "GSM"};
+        for (unsigned i = 0; i < LINK_TOTAL; ++i)
+        {
+          std::string link = link_names[i];
+
+          param(link + " - Link Rate", m_args.link_rate[i])
+              .units(Units::BitPerSecond)
+              .defaultValue("0")
+              .minimumValue("0")
+              .description("Sustained transmission rate of the link."
+                           " Value of 0 disables rate limiting.");
+
+          param(link + " - Link Burst", m_args.link_burst[i])
+              .units(Units::Byte)
+              .defaultValue("512")
+              .minimumValue("0")
+              .description("Maximum number of bytes that can be sent in a single"
+                           " burst over the link");
+        }
+
+        param("Maximum Queue Length", m_args.queue_max)
+            .defaultValue("32")
+            .description("Maximum number of requests waiting for each link."
+                         " Value of 0 disables the limit.");
+
+        param("High Priority Messages", m_args.prio_high)
+            .defaultValue("Abort, PlanControl, VehicleCommand")
+            .description("Inline messages that are transmitted ahead of regular traffic");
+
+        param("Low Priority Messages", m_args.prio_low)
+            .defaultValue("")
+            .description("Inline messages that are transmitted only when no"
+                         " other traffic is waiting");
+
+        param("Source Weights Section", m_args.weights_section)
+            .defaultValue("CommManager Weights")
+            .description("Name of the configuration section with the relative link"
+                         " share of each requesting system");
+
+        param("Statistics Period", m_args.stats_period)
+            .units(Units::Second)
+            .defaultValue("0")
+            .minimumValue("0")
+            .description("Period between link queue statistics reports."
+                         " Value of 0 disables reports.");
+
         bind<IMC::AcousticOperation>(this);
         bind<IMC::AcousticStatus>(this);
         bind<IMC::Announce>(this);
@@ -186,6 +247,23 @@ namespace Transports
           }
         }
         m_router.setAcousticMap(acousticMap);
+
+        // Relative link share of each requesting system.
+        addrs = m_ctx.config.options(m_args.weights_section);
+        for (unsigned i = 0; i < addrs.size(); ++i)
+        {
+          unsigned weight = 1;
+          m_ctx.config.get(m_args.weights_section, addrs[i], "1", weight);
+
+          unsigned sys = resolveSystemName(addrs[i]);
+          if (sys == IMC::AddressResolver::invalid())
+          {
+            war(DTR("unknown system in weights section: %s"), addrs[i].c_str());
+            continue;
+          }
+
+          m_router.setSourceWeight(sys, weight);
+        }
       }
 
       void
@@ -217,6 +295,13 @@ namespace Transports
       onUpdateParameters(void)
       {
         m_iridium_timer.setTop(m_args.iridium_period);
+        m_stats_timer.setTop(m_args.stats_period);
+
+        for (unsigned i = 0; i < LINK_TOTAL; ++i)
+          m_router.configureLink(static_cast<LinkType>(i), m_args.link_rate[i] / 8.0,
+                                 m_args.link_burst[i], m_args.queue_max);
+
+        m_router.setPriorityMessages(m_args.prio_high, m_args.prio_low);
       }
 
       void
@@ -871,7 +956,9 @@ namespace Transports
       {
         while (!stopping())
         {
-          waitForMessages(1.0);
+          waitForMessages(m_router.hasQueued() ? 0.1 : 1.0);
+
+          m_router.serviceQueues();
 
           if (m_retransmission_timer.overflow())
           {
@@ -889,6 +976,12 @@ namespace Transports
             m_clean_timer.reset();
           }
 
+          if (m_args.stats_period > 0 && m_stats_timer.overflow())
+          {
+            m_router.reportStatistics();
+            m_stats_timer.reset();
+          }
+
           if (m_args.iridium_period > 0 && m_iridium_timer.overflow())
           {
             if (m_vmedium != NULL && m_vmedium->medium == IMC::VehicleMedium::VM_WATER)
@@ -24,58 +24,57 @@
 // https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
 // http://ec.europa.eu/idabc/eupl.html.                                     *
 //***************************************************************************
-// Author: Eduardo Marques                                                  *
+// Author: Ricardo Martins                                                  *
 //***************************************************************************
 
-#ifndef SIMULATORS_ENVIRONMENT_POINT_HPP_INCLUDED_
-#define SIMULATORS_ENVIRONMENT_POINT_HPP_INCLUDED_
+#ifndef SRC_TRANSPORTS_DATASTORE_DATASAMPLE_HPP_
+#define SRC_TRANSPORTS_DATASTORE_DATASAMPLE_HPP_
 
-// ISO C++ 98 headers.
-#include <iomanip>
-#include <cmath>
+#define MINIMUM_SAMPLE_SIZE 15
 
 // DUNE headers.
-#include <DUNE/Config.hpp>
+#include <DUNE/DUNE.hpp>
 
-namespace Simulators
+namespace Transports
 {
-  namespace Environment
+  namespace DataStore
   {
-    //! Directions for search/insertion
-    enum
-    {
-      DIR_NW, DIR_NE, DIR_SW, DIR_SE
-    };
+    using DUNE_NAMESPACES;
 
-    //! Point structure.
-    struct Point
+    //! Class used to store a single sample.
+    //! All samples have a location, timestamp, priority and a message (IMC).
+    class DataSample
     {
-      double x, y;
+    public:
+      //! Sample global coordinates
+      double latDegs, lonDegs, zMeters, timestamp;
+
+      //! Priority of the sample (higher priority samples are transmitted first)
+      int priority;
 
-      Point(double x_, double y_):
-        x(x_), y(y_) { }
+      //! The system that generated this sample
+      int source;
 
-      double
-      distance(const Point& other) const
+      //! Actual data gathered at these coords
+      IMC::Message* sample;
+
+      DataSample(void)
       {
-        double dx = x - other.x;
-        double dy = y - other.y;
-        return std::sqrt(dx * dx + dy * dy);
+        latDegs = lonDegs = zMeters = timestamp = 0;
+        priority = source = -1;
+        sample = NULL;
       }
 
-      template <typename T>
-      int
-      direction(const T& other) const
+      ~DataSample(void)
       {
-        double dx = other.x - x;
-        double dy = other.y - y;
-
-        int dir = dx >= 0 ? DIR_NW : DIR_SW;
-
-        if (dy > 0)
-          dir++;      // other is East of this
+        if (sample != NULL)
+          delete sample;
+      }
 
-        return dir;
+      int
+      serializationSize(void)
+      {
+        return sample->getPayloadSerializationSize() + MINIMUM_SAMPLE_SIZE;
       }
     };
   }
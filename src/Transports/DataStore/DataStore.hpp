@@ -29,7 +29,6 @@
 #define SRC_TRANSPORTS_DATASTORE_DATASTORE_HPP_
 
 #define BASE_HISTORY_SIZE 36
-#define MINIMUM_SAMPLE_SIZE 15
 
 // ISO C++ 98 headers.
 #include <string>
@@ -37,58 +36,16 @@
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
+// Local headers.
+#include "DataSample.hpp"
+#include "SampleQueue.hpp"
+
 namespace Transports
 {
   namespace DataStore
   {
     using DUNE_NAMESPACES;
 
-    //! Class used to store a single sample.
-    //! All samples have a location, timestamp, priority and a message (IMC).
-    class DataSample
-    {
-    public:
-      //! Sample global coordinates
-      double latDegs, lonDegs, zMeters, timestamp;
-
-      //! Priority of the sample (higher priority samples are transmitted first)
-      int priority;
-
-      //! The system that generated this sample
-      int source;
-
-      //! Actual data gathered at these coords
-      IMC::Message* sample;
-
-      DataSample(void)
-      {
-        latDegs = lonDegs = zMeters = timestamp = 0;
-        priority = source = -1;
-        sample = NULL;
-      }
-
-      ~DataSample(void)
-      {
-        if (sample != NULL)
-          delete sample;
-      }
-
-      int
-      serializationSize(void)
-      {
-        return sample->getPayloadSerializationSize() + MINIMUM_SAMPLE_SIZE;
-      }
-    };
-
-    class CompareSamples
-    {
-    public:
-      bool operator()(const DataSample* p1, const DataSample* p2) const
-      {
-        return p1->priority <= p2->priority && p1->timestamp < p2->timestamp;
-      }
-    };
-
     //! Translate a (global coordinates) Data Sample into an IMC HistoricSample message
     HistoricSample*
     parse(DataSample* sample, double base_lat, double base_lon, long base_time)
@@ -156,21 +113,49 @@ namespace Transports
 
       ~DataStore(void)
       {
-        Concurrency::ScopedRWLock(m_lock, true);
-        while (!m_samples.empty())
-        {
-          delete m_samples.top();
-          m_samples.pop();
-        }
+        close();
+      }
+
+      //! Open on-disk sample storage, restoring samples left by a
+      //! previous run.
+      //! @param[in] dir storage directory.
+      //! @param[in] segment_size size of each segment file in bytes.
+      //! @param[in] budget maximum size of all segment files in bytes.
+      //! @param[in] policy what to do when the budget is exceeded.
+      //! @return number of restored samples.
+      size_t
+      open(const Path& dir, size_t segment_size, uint64_t budget,
+           SampleQueue::EvictionPolicy policy)
+      {
+        Concurrency::ScopedRWLock l(m_lock, true);
+        return m_samples.open(dir, segment_size, budget, policy);
+      }
+
+      //! Release on-disk sample storage.
+      void
+      close(void)
+      {
+        Concurrency::ScopedRWLock l(m_lock, true);
+        m_samples.close();
       }
 
       //! Add sample to this store
       void
       addSample(DataSample* sample)
       {
-        Concurrency::ScopedRWLock(m_lock, true);
+        Concurrency::ScopedRWLock l(m_lock, true);
         m_task->debug("Adding sample %d/%f", sample->sample->getId(), sample->timestamp);
-        m_samples.push(sample);
+        if (!m_samples.push(*sample))
+          m_task->debug("Sample %d/%f rejected", sample->sample->getId(), sample->timestamp);
+        delete sample;
+      }
+
+      //! Get number of stored samples.
+      size_t
+      getSampleCount(void)
+      {
+        Concurrency::ScopedRWLock l(m_lock, false);
+        return m_samples.size();
       }
 
       //! Add a series of historic samples packed as an HistoricData message
@@ -253,45 +238,23 @@ namespace Transports
       {
 
         size -= BASE_HISTORY_SIZE; // base fields from HistoricData
-        IMC::HistoricData* ret = new IMC::HistoricData();
 
-        std::vector<DataSample*> added, rejected;
-
-        Concurrency::ScopedRWLock(m_lock, true);
-        while (!m_samples.empty() && size > MINIMUM_SAMPLE_SIZE)
-        {
-          // pop next sample
-          DataSample* sample = m_samples.top();
-          m_samples.pop();
-
-          // check if there is space left for this sample
-          int sample_size = sample->serializationSize();
-          if (sample_size > size)
-          {
-            rejected.push_back(sample);
-          }
-          else
-          {
-            size -= sample_size;
-            added.push_back(sample);
-          }
-        }
-
-        // add back samples that didn't fit on the message
-        std::vector<DataSample *>::iterator it;
-        for (it = rejected.begin(); it != rejected.end(); it++)
+        std::vector<DataSample*> added;
         {
-          m_samples.push(*it);
+          Concurrency::ScopedRWLock l(m_lock, true);
+          m_samples.pop(size, MINIMUM_SAMPLE_SIZE, added);
         }
 
         // no data can be added
         if (added.empty())
           return NULL;
 
+        IMC::HistoricData* ret = new IMC::HistoricData();
         ret->base_lat = added.at(0)->latDegs;
         ret->base_lon = added.at(0)->lonDegs;
         ret->base_time = added.at(0)->timestamp;
 
+        std::vector<DataSample*>::iterator it;
         for (it = added.begin(); it != added.end(); it++)
         {
           DataSample * sample = *it;
@@ -304,7 +267,7 @@ namespace Transports
       }
 
     private:
-      std::priority_queue<DataSample *, std::vector<DataSample *> , CompareSamples> m_samples;
+      SampleQueue m_samples;
       std::vector<RemoteCommand* > m_commands;
       Concurrency::RWLock m_lock;
       Task* m_task;
@@ -0,0 +1,734 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef SRC_TRANSPORTS_DATASTORE_SAMPLEQUEUE_HPP_
+#define SRC_TRANSPORTS_DATASTORE_SAMPLEQUEUE_HPP_
+
+// ISO C++ 98 headers.
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+#if defined(DUNE_SYS_HAS_UNISTD_H)
+#  include <unistd.h>
+#endif
+
+#if defined(DUNE_SYS_HAS_SYS_MMAN_H)
+#  include <sys/mman.h>
+#endif
+
+#if defined(DUNE_SYS_HAS_FCNTL_H)
+#  include <fcntl.h>
+#endif
+
+#if defined(DUNE_SYS_HAS_MMAP) && defined(DUNE_SYS_HAS_SYS_MMAN_H)
+#  define DATASTORE_SAMPLE_QUEUE_MMAP
+#endif
+
+// Local headers.
+#include "DataSample.hpp"
+
+namespace Transports
+{
+  namespace DataStore
+  {
+    using DUNE_NAMESPACES;
+
+    //! Disk-backed priority queue of samples.
+    //!
+    //! Samples are appended to fixed-size segment files that are
+    //! memory mapped. Each record holds the sample metadata, a CRC-16
+    //! and the serialized message; extracted or evicted records are
+    //! flagged in place and a segment file is removed once it holds no
+    //! live records. Only a small index (priority, timestamp and
+    //! location of each record) is kept in memory, and samples are
+    //! rebuilt from the segments that remain after a restart. Where
+    //! memory mapping is not available segments live on the heap and
+    //! samples do not survive a restart.
+    //!
+    //! The budget bounds the size of all segment files. When a new
+    //! segment would exceed it, the live records of the sparsest
+    //! segment are first moved to the new one so that the sparse file
+    //! can be removed; samples are only evicted (or rejected) when no
+    //! segment is sparse enough. Disk usage exceeds the budget by at
+    //! most one segment while records are being moved.
+    class SampleQueue
+    {
+    public:
+      //! What to do when the byte budget is exceeded.
+      enum EvictionPolicy
+      {
+        //! Drop the lowest priority, oldest samples.
+        EP_LOWEST_PRIORITY,
+        //! Drop the samples stored first.
+        EP_OLDEST,
+        //! Refuse new samples.
+        EP_REJECT
+      };
+
+      SampleQueue(void):
+        m_segment_size(0),
+        m_budget(0),
+        m_policy(EP_LOWEST_PRIORITY),
+        m_bytes(0),
+        m_disk(0),
+        m_seq(0),
+        m_active(0),
+        m_evicted(0)
+      { }
+
+      ~SampleQueue(void)
+      {
+        close();
+      }
+
+      //! Parse an eviction policy name.
+      //! @param[in] name policy name.
+      //! @return eviction policy.
+      static EvictionPolicy
+      parsePolicy(const std::string& name)
+      {
+        if (name == "Oldest")
+          return EP_OLDEST;
+        if (name == "Reject")
+          return EP_REJECT;
+        return EP_LOWEST_PRIORITY;
+      }
+
+      //! Open the queue, restoring samples stored in a previous run.
+      //! @param[in] dir segments directory.
+      //! @param[in] segment_size size of each segment file in bytes.
+      //! @param[in] budget maximum size of all segment files in bytes,
+      //! raised to two segments if smaller.
+      //! @param[in] policy what to do when the budget is exceeded.
+      //! @return number of restored samples.
+      size_t
+      open(const Path& dir, size_t segment_size, uint64_t budget, EvictionPolicy policy)
+      {
+        close();
+
+        m_dir = dir;
+        m_segment_size = std::max(segment_size, (size_t)(c_header_size + 65536)) & ~(size_t)7;
+        m_budget = std::max(budget, (uint64_t)m_segment_size * 2);
+        m_policy = policy;
+        m_dir.create();
+
+        // Restore segments in creation order.
+        std::set<uint32_t> ids;
+        const char* fname = 0;
+        Directory directory(m_dir);
+        while ((fname = directory.readEntry(Directory::RD_FILE_NAME)))
+        {
+          unsigned id = 0;
+          if (std::sscanf(fname, "%08x.seg", &id) == 1)
+            ids.insert(id);
+        }
+
+        for (std::set<uint32_t>::iterator itr = ids.begin(); itr != ids.end(); ++itr)
+          restore(*itr);
+
+        m_active = ids.empty() ? 0 : *ids.rbegin();
+        if (ids.empty() || !m_segments.count(m_active))
+          createSegment(++m_active);
+
+        // The budget may have been lowered since the last run.
+        while (m_disk > m_budget && !m_records.empty())
+          evict();
+
+        return m_records.size();
+      }
+
+      //! Release all segments, keeping their contents on disk.
+      void
+      close(void)
+      {
+        for (std::map<uint32_t, Segment>::iterator itr = m_segments.begin();
+             itr != m_segments.end(); ++itr)
+          unmap(itr->second);
+
+        m_segments.clear();
+        m_records.clear();
+        m_order.clear();
+        m_bytes = 0;
+        m_disk = 0;
+        m_segment_size = 0;
+      }
+
+      //! Store a sample.
+      //! @param[in] sample sample.
+      //! @return true if stored, false if rejected.
+      bool
+      push(DataSample& sample)
+      {
+        if (m_segment_size == 0)
+          return false;
+
+        uint16_t size = sample.sample->getSerializationSize();
+        size_t length = align(c_header_size + size);
+
+        if (length > m_segment_size)
+          return false;
+
+        if (!reserve(length))
+        {
+          ++m_evicted;
+          return false;
+        }
+
+        Segment* seg = &m_segments[m_active];
+
+        uint8_t* ptr = seg->data + seg->used;
+        IMC::Packet::serialize(sample.sample, ptr + c_header_size, size);
+
+        Header hdr;
+        hdr.magic = 0;
+        hdr.size = size;
+        hdr.crc = Algorithms::CRC16::compute(ptr + c_header_size, size);
+        hdr.priority = sample.priority;
+        hdr.source = sample.source;
+        hdr.timestamp = sample.timestamp;
+        hdr.lat = sample.latDegs;
+        hdr.lon = sample.lonDegs;
+        hdr.z = sample.zMeters;
+        std::memcpy(ptr, &hdr, c_header_size);
+
+        // The record becomes valid once the magic is written.
+        uint32_t magic = c_live;
+        std::memcpy(ptr, &magic, sizeof(magic));
+
+        index(m_active, seg->used, hdr, sample.serializationSize());
+        seg->used += length;
+        return true;
+      }
+
+      //! Extract the highest priority samples that fit in a size
+      //! budget. Samples of equal priority are taken newest first.
+      //! @param[in] size size budget, using the same units as
+      //! DataSample::serializationSize().
+      //! @param[in] minimum stop when the budget left is this small.
+      //! @param[out] samples extracted samples (caller owns them).
+      void
+      pop(int size, int minimum, std::vector<DataSample*>& samples)
+      {
+        std::set<Key>::iterator itr = m_order.begin();
+        while (itr != m_order.end() && size > minimum)
+        {
+          Record& rec = m_records[itr->seq];
+          if (rec.wire > size)
+          {
+            ++itr;
+            continue;
+          }
+
+          DataSample* sample = load(rec);
+          if (sample != NULL)
+          {
+            samples.push_back(sample);
+            size -= rec.wire;
+          }
+
+          uint64_t seq = itr->seq;
+          ++itr;
+          remove(seq);
+        }
+      }
+
+      //! Get number of stored samples.
+      //! @return number of samples.
+      size_t
+      size(void) const
+      {
+        return m_records.size();
+      }
+
+      //! Get size of stored samples.
+      //! @return size in bytes.
+      uint64_t
+      getBytes(void) const
+      {
+        return m_bytes;
+      }
+
+      //! Get size of all segment files.
+      //! @return size in bytes.
+      uint64_t
+      getStorage(void) const
+      {
+        return m_disk;
+      }
+
+      //! Get number of samples evicted or rejected since opened.
+      //! @return number of samples.
+      uint64_t
+      getEvicted(void) const
+      {
+        return m_evicted;
+      }
+
+    private:
+      //! Marker of a live record.
+      static const uint32_t c_live = 0x4C535344;
+      //! Marker of an extracted or evicted record.
+      static const uint32_t c_dead = 0x44454144;
+      //! Record header size.
+      static const size_t c_header_size = 48;
+
+      //! Record header, in host byte order.
+      struct Header
+      {
+        uint32_t magic;
+        uint16_t size;
+        uint16_t crc;
+        int32_t priority;
+        int32_t source;
+        double timestamp;
+        double lat;
+        double lon;
+        double z;
+      };
+
+      //! Mapped segment file.
+      struct Segment
+      {
+        //! Mapped contents.
+        uint8_t* data;
+        //! Size of the file.
+        size_t size;
+        //! Bytes written.
+        size_t used;
+        //! Number of live records.
+        size_t live;
+        //! Size of live records.
+        size_t bytes;
+      };
+
+      //! Location of a stored record.
+      struct Record
+      {
+        uint32_t segment;
+        size_t offset;
+        size_t length;
+        int wire;
+        int priority;
+        double timestamp;
+      };
+
+      //! Extraction order: priority, then newest first.
+      struct Key
+      {
+        int priority;
+        double timestamp;
+        uint64_t seq;
+
+        bool
+        operator<(const Key& other) const
+        {
+          if (priority != other.priority)
+            return priority > other.priority;
+          if (timestamp != other.timestamp)
+            return timestamp > other.timestamp;
+          return seq < other.seq;
+        }
+      };
+
+      //! Segments directory.
+      Path m_dir;
+      //! Segment size.
+      size_t m_segment_size;
+      //! Maximum size of all segment files.
+      uint64_t m_budget;
+      //! Eviction policy.
+      EvictionPolicy m_policy;
+      //! Size of live records.
+      uint64_t m_bytes;
+      //! Size of all segment files.
+      uint64_t m_disk;
+      //! Next record sequence number.
+      uint64_t m_seq;
+      //! Segment being written.
+      uint32_t m_active;
+      //! Number of evicted samples.
+      uint64_t m_evicted;
+      //! Segments by identifier.
+      std::map<uint32_t, Segment> m_segments;
+      //! Records in storage order.
+      std::map<uint64_t, Record> m_records;
+      //! Records in extraction order.
+      std::set<Key> m_order;
+
+      static size_t
+      align(size_t size)
+      {
+        return (size + 7) & ~(size_t)7;
+      }
+
+      Path
+      segmentPath(uint32_t id) const
+      {
+        return m_dir / String::str("%08x.seg", id);
+      }
+
+      void
+      index(uint32_t segment, size_t offset, const Header& hdr, int wire)
+      {
+        Record rec;
+        rec.segment = segment;
+        rec.offset = offset;
+        rec.length = align(c_header_size + hdr.size);
+        rec.wire = wire;
+        rec.priority = hdr.priority;
+        rec.timestamp = hdr.timestamp;
+
+        Key key = {rec.priority, rec.timestamp, m_seq};
+        m_records[m_seq++] = rec;
+        m_order.insert(key);
+        Segment& seg = m_segments[segment];
+        seg.live++;
+        seg.bytes += rec.length;
+        m_bytes += rec.length;
+      }
+
+      void
+      remove(uint64_t seq)
+      {
+        std::map<uint64_t, Record>::iterator itr = m_records.find(seq);
+        Record rec = itr->second;
+        m_records.erase(itr);
+
+        Key key = {rec.priority, rec.timestamp, seq};
+        m_order.erase(key);
+        m_bytes -= rec.length;
+
+        Segment& seg = m_segments[rec.segment];
+        uint32_t magic = c_dead;
+        std::memcpy(seg.data + rec.offset, &magic, sizeof(magic));
+        seg.bytes -= rec.length;
+
+        if (--seg.live == 0 && rec.segment != m_active)
+          dropSegment(rec.segment);
+      }
+
+      //! Drop one sample according to the eviction policy.
+      void
+      evict(void)
+      {
+        if (m_policy == EP_OLDEST)
+          remove(m_records.begin()->first);
+        else
+          remove(m_order.rbegin()->seq);
+
+        ++m_evicted;
+      }
+
+      //! Make room in the active segment for a record, rolling over to
+      //! a new segment within the budget.
+      //! @param[in] length record length.
+      //! @return true if the record fits, false if rejected.
+      bool
+      reserve(size_t length)
+      {
+        while (true)
+        {
+          std::map<uint32_t, Segment>::iterator act = m_segments.find(m_active);
+          if (act != m_segments.end())
+          {
+            if (act->second.used + length <= act->second.size)
+              return true;
+
+            // Full segment whose records were all extracted.
+            if (act->second.live == 0)
+            {
+              dropSegment(m_active);
+              continue;
+            }
+          }
+
+          if (m_disk + m_segment_size <= m_budget)
+          {
+            createSegment(++m_active);
+            continue;
+          }
+
+          uint32_t sparse = 0;
+          if (findSparse(length, sparse))
+          {
+            createSegment(++m_active);
+            compact(sparse);
+            continue;
+          }
+
+          if (m_policy == EP_REJECT || m_records.empty())
+            return false;
+
+          evict();
+        }
+      }
+
+      //! Find the segment with the fewest live bytes whose records can
+      //! be moved to a new segment leaving room for another record,
+      //! without exceeding the budget once it is removed.
+      //! @param[in] length length of the record to be stored.
+      //! @param[out] id segment identifier.
+      //! @return true if a segment was found, false otherwise.
+      bool
+      findSparse(size_t length, uint32_t& id) const
+      {
+        bool found = false;
+        size_t best = 0;
+
+        for (std::map<uint32_t, Segment>::const_iterator itr = m_segments.begin();
+             itr != m_segments.end(); ++itr)
+        {
+          const Segment& seg = itr->second;
+          if (seg.bytes + length > m_segment_size)
+            continue;
+
+          if (m_disk - seg.size + m_segment_size > m_budget)
+            continue;
+
+          if (!found || seg.bytes < best)
+          {
+            found = true;
+            best = seg.bytes;
+            id = itr->first;
+          }
+        }
+
+        return found;
+      }
+
+      //! Move the live records of a segment to the active segment and
+      //! remove it.
+      //! @param[in] id segment identifier.
+      void
+      compact(uint32_t id)
+      {
+        Segment& src = m_segments[id];
+        Segment& dst = m_segments[m_active];
+
+        for (std::map<uint64_t, Record>::iterator itr = m_records.begin();
+             itr != m_records.end(); ++itr)
+        {
+          Record& rec = itr->second;
+          if (rec.segment != id)
+            continue;
+
+          // Copy before flagging the original, so a crash in between
+          // can only duplicate the record.
+          std::memcpy(dst.data + dst.used, src.data + rec.offset, rec.length);
+          uint32_t magic = c_dead;
+          std::memcpy(src.data + rec.offset, &magic, sizeof(magic));
+
+          rec.segment = m_active;
+          rec.offset = dst.used;
+          dst.used += rec.length;
+          dst.live++;
+          dst.bytes += rec.length;
+        }
+
+        dropSegment(id);
+      }
+
+      //! Unmap a segment and remove its file.
+      //! @param[in] id segment identifier.
+      void
+      dropSegment(uint32_t id)
+      {
+        std::map<uint32_t, Segment>::iterator itr = m_segments.find(id);
+        m_disk -= itr->second.size;
+        unmap(itr->second);
+        m_segments.erase(itr);
+        removeFile(id);
+      }
+
+      DataSample*
+      load(const Record& rec)
+      {
+        const uint8_t* ptr = m_segments[rec.segment].data + rec.offset;
+        Header hdr;
+        std::memcpy(&hdr, ptr, c_header_size);
+
+        DataSample* sample = new DataSample();
+        try
+        {
+          sample->sample = IMC::Packet::deserialize(ptr + c_header_size, hdr.size);
+        }
+        catch (std::exception&)
+        {
+          delete sample;
+          return NULL;
+        }
+
+        sample->priority = hdr.priority;
+        sample->source = hdr.source;
+        sample->timestamp = hdr.timestamp;
+        sample->latDegs = hdr.lat;
+        sample->lonDegs = hdr.lon;
+        sample->zMeters = hdr.z;
+        return sample;
+      }
+
+      //! Index the live records of a segment file.
+      void
+      restore(uint32_t id)
+      {
+        Segment seg;
+        if (!map(id, false, seg))
+          return;
+
+        m_segments[id] = seg;
+        m_disk += seg.size;
+        Segment& s = m_segments[id];
+
+        // Records end at the first invalid header.
+        while (s.used + c_header_size <= s.size)
+        {
+          Header hdr;
+          std::memcpy(&hdr, s.data + s.used, c_header_size);
+          if (hdr.magic != c_live && hdr.magic != c_dead)
+            break;
+
+          size_t length = align(c_header_size + hdr.size);
+          if (s.used + length > s.size)
+            break;
+
+          const uint8_t* payload = s.data + s.used + c_header_size;
+          if (Algorithms::CRC16::compute(payload, hdr.size) != hdr.crc)
+            break;
+
+          if (hdr.magic == c_live)
+          {
+            int wire = hdr.size - DUNE_IMC_CONST_HEADER_SIZE - DUNE_IMC_CONST_FOOTER_SIZE
+            + MINIMUM_SAMPLE_SIZE;
+            index(id, s.used, hdr, wire);
+          }
+
+          s.used += length;
+        }
+
+        // Segments written to the end are not reused.
+        if (s.live == 0)
+          dropSegment(id);
+      }
+
+      void
+      createSegment(uint32_t id)
+      {
+        Segment seg;
+        if (!map(id, true, seg))
+          throw std::runtime_error(String::str("unable to create segment %s",
+                                               segmentPath(id).c_str()));
+
+        m_segments[id] = seg;
+        m_disk += seg.size;
+      }
+
+      //! Map a segment file. New segments have the configured size;
+      //! existing ones keep the size they were created with.
+      bool
+      map(uint32_t id, bool create, Segment& seg)
+      {
+        seg.size = m_segment_size;
+        seg.used = 0;
+        seg.live = 0;
+        seg.bytes = 0;
+
+#if defined(DATASTORE_SAMPLE_QUEUE_MMAP)
+        Path path = segmentPath(id);
+        int fd = ::open(path.c_str(), O_RDWR | (create ? O_CREAT | O_TRUNC : 0), 0644);
+        if (fd < 0)
+          return false;
+
+        if (create && ftruncate(fd, m_segment_size) != 0)
+        {
+          ::close(fd);
+          return false;
+        }
+
+        if (!create)
+        {
+          int64_t size = path.size();
+          if (size < (int64_t)c_header_size)
+          {
+            ::close(fd);
+            return false;
+          }
+
+          seg.size = (size_t)size;
+        }
+
+        void* data = mmap(0, seg.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+          return false;
+
+        seg.data = static_cast<uint8_t*>(data);
+#else
+        if (!create)
+          return false;
+
+        seg.data = new uint8_t[m_segment_size];
+        std::memset(seg.data, 0, m_segment_size);
+#endif
+
+        return true;
+      }
+
+      void
+      unmap(Segment& seg)
+      {
+#if defined(DATASTORE_SAMPLE_QUEUE_MMAP)
+        munmap(seg.data, seg.size);
+#else
+        delete [] seg.data;
+#endif
+        seg.data = NULL;
+      }
+
+      void
+      removeFile(uint32_t id)
+      {
+#if defined(DATASTORE_SAMPLE_QUEUE_MMAP)
+        std::remove(segmentPath(id).c_str());
+#else
+        (void)id;
+#endif
+      }
+    };
+  }
+}
+
+#endif
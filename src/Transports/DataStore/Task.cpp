@@ -71,6 +71,15 @@ namespace Transports
       //! Variable priorities will result in older
       //! data being sent through low bandwidth connections
       bool variable_priorities;
+
+      //! Maximum size of all storage segment files, in KiB
+      unsigned storage_budget;
+
+      //! Size of each storage segment file, in KiB
+      unsigned segment_size;
+
+      //! What to do when the storage budget is exceeded
+      std::string eviction_policy;
     };
 
     struct Task: public DUNE::Tasks::Task
@@ -156,6 +165,19 @@ namespace Transports
         .description("Apply variable priorities to local samples")
         .defaultValue("true");
 
+        param("Storage Budget", m_args.storage_budget)
+        .description("Maximum size of all storage segment files, in KiB")
+        .defaultValue("16384");
+
+        param("Segment Size", m_args.segment_size)
+        .description("Size of each storage segment file, in KiB")
+        .defaultValue("256");
+
+        param("Eviction Policy", m_args.eviction_policy)
+        .values("Lowest Priority, Oldest, Reject")
+        .description("Samples dropped when the storage budget is exceeded")
+        .defaultValue("Lowest Priority");
+
         m_wifi_forward_timer.setTop(m_args.wifi_forward_period);
         m_acoustic_forward_timer.setTop(m_args.acoustic_forward_period);
         m_any_forward_timer.setTop(m_args.any_forward_period);
@@ -208,6 +230,23 @@ namespace Transports
         m_iridium_upload_timer.setTop(m_args.iridium_upload_period);
       }
 
+      void
+      onResourceAcquisition(void)
+      {
+        size_t count = m_store.open(m_ctx.dir_db / "DataStore",
+                                    m_args.segment_size * 1024,
+                                    (uint64_t)m_args.storage_budget * 1024,
+                                    SampleQueue::parsePolicy(m_args.eviction_policy));
+        if (count > 0)
+          inf(DTR("restored %u samples from storage"), (unsigned)count);
+      }
+
+      void
+      onResourceRelease(void)
+      {
+        m_store.close();
+      }
+
       void
       onResourceInitialization(void)
       {
@@ -41,6 +41,8 @@ namespace Transports
     {
       // Reception timeout.
       float max_age_secs;
+      // Memory budget for incomplete messages.
+      unsigned max_memory;
     };
 
     struct Task: public DUNE::Tasks::Task
@@ -56,6 +58,12 @@ namespace Transports
         .defaultValue("1800")
         .description("Maximum amount of seconds to wait for missing fragments in incoming messages");
 
+        param("Memory Budget", m_args.max_memory)
+        .defaultValue("1048576")
+        .units(Units::Byte)
+        .description("Maximum amount of memory used by incomplete messages."
+                     " When exceeded, the oldest messages are discarded");
+
         bind<IMC::MessagePart>(this);
         m_gc_counter.setTop(120);
         setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
@@ -70,23 +78,64 @@ namespace Transports
       void
       consume(const IMC::MessagePart* msg)
       {
-        int hash = (msg->uid << 16) | msg->getSource();
+        uint32_t hash = (msg->uid << 16) | msg->getSource();
 
-        if (m_incoming.find(hash) == m_incoming.end())
+        std::map<uint32_t, FragmentedMessage>::iterator itr = m_incoming.find(hash);
+        if (itr == m_incoming.end())
         {
-          FragmentedMessage incMsg;
-          incMsg.setParentTask(this);
-          m_incoming[hash] = incMsg;
+          itr = m_incoming.insert(std::make_pair(hash, FragmentedMessage())).first;
+          itr->second.setParentTask(this);
         }
 
         debug("Incoming message fragment (%d still missing)",
-              m_incoming[hash].getFragmentsMissing());
+              itr->second.getFragmentsMissing());
+
+        IMC::Message* res = NULL;
+        try
+        {
+          res = itr->second.setFragment(msg);
+        }
+        catch (std::exception& e)
+        {
+          err(DTR("Failed to reassemble message: %s"), e.what());
+          m_incoming.erase(itr);
+          return;
+        }
 
-        IMC::Message * res = m_incoming[hash].setFragment(msg);
         if (res != NULL)
         {
           dispatch(res);
-          m_incoming.erase(hash);
+          delete res;
+          m_incoming.erase(itr);
+          return;
+        }
+
+        enforceBudget();
+      }
+
+      //! Discard the oldest incomplete messages while the memory
+      //! budget is exceeded.
+      void
+      enforceBudget(void)
+      {
+        while (!m_incoming.empty())
+        {
+          size_t usage = 0;
+          std::map<uint32_t, FragmentedMessage>::iterator oldest = m_incoming.begin();
+          std::map<uint32_t, FragmentedMessage>::iterator it = m_incoming.begin();
+          for ( ; it != m_incoming.end(); ++it)
+          {
+            usage += it->second.getMemoryUsage();
+            if (it->second.getAge() > oldest->second.getAge())
+              oldest = it;
+          }
+
+          if (usage <= m_args.max_memory)
+            break;
+
+          war(DTR("Memory budget exceeded, removed incoming message (%d fragments were still missing)."),
+              oldest->second.getFragmentsMissing());
+          m_incoming.erase(oldest);
         }
       }
 
@@ -0,0 +1,188 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef TRANSPORTS_LOG_TRANSFER_CATALOG_HPP_INCLUDED_
+#define TRANSPORTS_LOG_TRANSFER_CATALOG_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+namespace Transports
+{
+  namespace LogTransfer
+  {
+    //! File in the catalog.
+    struct Entry
+    {
+      //! Path relative to the root folder.
+      std::string path;
+      //! Size in bytes.
+      int64_t size;
+      //! Modification time.
+      std::time_t mtime;
+
+      //! Newest files first.
+      bool
+      operator<(const Entry& other) const
+      {
+        if (mtime != other.mtime)
+          return mtime > other.mtime;
+        return path < other.path;
+      }
+    };
+
+    //! Chunk index of a file, shared by all sessions.
+    struct SharedIndex
+    {
+      //! Chunk index.
+      DUNE::FileSystem::ChunkIndex index;
+      //! Lock of the chunk index.
+      DUNE::Concurrency::Mutex mutex;
+    };
+
+    //! Files available for transfer and their chunk indexes, shared
+    //! by all sessions.
+    class Catalog
+    {
+    public:
+      Catalog(const DUNE::FileSystem::Path& root):
+        m_root(root.canonical())
+      { }
+
+      ~Catalog(void)
+      {
+        std::map<std::string, SharedIndex*>::iterator itr = m_indexes.begin();
+        for (; itr != m_indexes.end(); ++itr)
+          delete itr->second;
+      }
+
+      //! Resolve a path relative to the root folder. Paths that lead
+      //! outside the root folder, through '..' or symbolic links, are
+      //! refused.
+      //! @param[in] path relative path.
+      //! @param[out] abs canonical absolute path.
+      //! @return true if path names a file inside the root folder.
+      bool
+      resolve(const std::string& path, DUNE::FileSystem::Path& abs) const
+      {
+        if (path.empty())
+          return false;
+
+        try
+        {
+          abs = (m_root / path).canonical();
+        }
+        catch (std::exception&)
+        {
+          return false;
+        }
+
+        std::string prefix = m_root.str() + DUNE::FileSystem::Path::separator();
+        if (abs.str().compare(0, prefix.size(), prefix) != 0)
+          return false;
+
+        return abs.isFile();
+      }
+
+      //! List all files, newest first.
+      //! @param[out] entries files.
+      void
+      list(std::vector<Entry>& entries) const
+      {
+        entries.clear();
+        walk(m_root, "", entries);
+        std::sort(entries.begin(), entries.end());
+      }
+
+      //! Get the chunk index of a file. Sessions hash the index in
+      //! place, a few chunks at a time while holding its lock, so any
+      //! session asking for the same file continues where the last one
+      //! stopped.
+      //! @param[in] path relative path.
+      //! @param[out] abs canonical absolute path.
+      //! @return chunk index, owned by the catalog, or NULL if path is
+      //! not a valid file.
+      SharedIndex*
+      getIndex(const std::string& path, DUNE::FileSystem::Path& abs)
+      {
+        if (!resolve(path, abs))
+          return NULL;
+
+        DUNE::Concurrency::ScopedMutex l(m_mutex);
+        SharedIndex*& index = m_indexes[abs.str()];
+        if (index == NULL)
+          index = new SharedIndex;
+
+        return index;
+      }
+
+    private:
+      //! Canonical root folder.
+      DUNE::FileSystem::Path m_root;
+      //! Chunk indexes by canonical path.
+      std::map<std::string, SharedIndex*> m_indexes;
+      //! Lock of the map of chunk indexes.
+      DUNE::Concurrency::Mutex m_mutex;
+
+      void
+      walk(const DUNE::FileSystem::Path& dir, const std::string& prefix,
+           std::vector<Entry>& entries) const
+      {
+        DUNE::FileSystem::Directory d(dir);
+        const char* name = NULL;
+        while ((name = d.readEntry(DUNE::FileSystem::Directory::RD_FILE_NAME)))
+        {
+          std::string rel = prefix.empty() ? name : prefix + "/" + name;
+          DUNE::FileSystem::Path abs = dir / name;
+
+          if (abs.isDirectory())
+          {
+            walk(abs, rel, entries);
+          }
+          else if (abs.isFile())
+          {
+            Entry e;
+            e.path = rel;
+            e.size = abs.size();
+            e.mtime = abs.getLastModifiedTime();
+            entries.push_back(e);
+          }
+        }
+      }
+    };
+  }
+}
+
+#endif
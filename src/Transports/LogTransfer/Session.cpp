@@ -0,0 +1,248 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstdlib>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "Session.hpp"
+
+namespace Transports
+{
+  namespace LogTransfer
+  {
+    using DUNE_NAMESPACES;
+
+    Session::Session(Tasks::Task* task, Catalog& catalog, TCPSocket* sock, double timeout):
+      m_task(task),
+      m_catalog(catalog),
+      m_sock(sock),
+      m_timer(timeout),
+      m_bytes_sent(0),
+      m_quit(false)
+    {
+      m_sock->setNoDelay(true);
+      m_sock->setSendTimeout(timeout);
+      m_sock->setKeepAlive(true);
+    }
+
+    Session::~Session(void)
+    {
+      delete m_sock;
+    }
+
+    void
+    Session::send(const char* data, size_t size)
+    {
+      while (size > 0)
+      {
+        size_t rv = m_sock->write(data, size);
+        data += rv;
+        size -= rv;
+      }
+    }
+
+    std::istream&
+    Session::openFile(const Path& path)
+    {
+      // Clients fetch a file chunk after chunk, keep it open.
+      if (m_file.is_open() && m_file_path == path)
+        return m_file;
+
+      m_file.close();
+      m_file.clear();
+      m_file.open(path.c_str(), std::ios::binary);
+      if (!m_file)
+        throw std::runtime_error(String::str("cannot read file '%s'", path.c_str()));
+
+      m_file_path = path;
+      return m_file;
+    }
+
+    void
+    Session::handleLIST(void)
+    {
+      std::vector<Entry> entries;
+      m_catalog.list(entries);
+
+      std::string reply;
+      for (size_t i = 0; i < entries.size(); ++i)
+      {
+        reply += String::str("F %lld %lld %s\n", (long long)entries[i].size,
+                             (long long)entries[i].mtime, entries[i].path.c_str());
+      }
+
+      reply += ".\n";
+      send(reply);
+    }
+
+    void
+    Session::handleHASH(const std::string& path)
+    {
+      Path abs;
+      SharedIndex* shared = m_catalog.getIndex(path, abs);
+      if (shared == NULL)
+      {
+        send("E no such file\n");
+        return;
+      }
+
+      std::istream& is = openFile(abs);
+
+      // Large files are hashed a few chunks at a time, reporting
+      // progress so that the client does not time out.
+      std::string reply;
+      while (true)
+      {
+        {
+          ScopedMutex l(shared->mutex);
+          ChunkIndex& index = shared->index;
+
+          if (index.resume(abs, is, c_hash_chunks))
+          {
+            reply = String::str("H %lld %u\n", (long long)index.getSize(),
+                                (unsigned)index.getCount());
+            for (size_t i = 0; i < index.getCount(); ++i)
+            {
+              reply += index.getDigest(i);
+              reply += '\n';
+            }
+            break;
+          }
+
+          reply = String::str("P %u %u\n", (unsigned)index.getHashed(),
+                              (unsigned)index.getCount());
+        }
+
+        if (isStopping())
+          return;
+
+        send(reply);
+      }
+
+      send(reply);
+    }
+
+    void
+    Session::handleGET(const std::string& arg)
+    {
+      size_t sep = arg.find(' ');
+      if (sep == std::string::npos)
+      {
+        send("E invalid request\n");
+        return;
+      }
+
+      size_t index = std::strtoul(arg.c_str(), NULL, 10);
+      Path path;
+      if (!m_catalog.resolve(arg.substr(sep + 1), path))
+      {
+        send("E no such file\n");
+        return;
+      }
+
+      // Digest of what is actually sent, so that clients can verify
+      // chunks of files that changed after being indexed.
+      unsigned size = ChunkIndex::read(openFile(path), index, m_chunk);
+      std::string hdr = String::str("D %u %u %s\n", (unsigned)index, size,
+                                    ChunkIndex::digest(&m_chunk[0], size).c_str());
+      send(hdr);
+      send(&m_chunk[0], size);
+      m_bytes_sent += size;
+    }
+
+    void
+    Session::handleRequest(const std::string& line)
+    {
+      m_task->spew("request: %s", line.c_str());
+
+      size_t sep = line.find(' ');
+      std::string cmd = line.substr(0, sep);
+      std::string arg = (sep == std::string::npos) ? "" : line.substr(sep + 1);
+
+      if (cmd == "LIST")
+        handleLIST();
+      else if (cmd == "HASH")
+        handleHASH(arg);
+      else if (cmd == "GET")
+        handleGET(arg);
+      else if (cmd == "QUIT")
+        m_quit = true;
+      else
+        send("E unknown request\n");
+    }
+
+    void
+    Session::run(void)
+    {
+      char bfr[1024];
+
+      while (!isStopping() && !m_quit)
+      {
+        if (m_timer.overflow())
+          break;
+
+        try
+        {
+          if (!Poll::poll(*m_sock, 1.0))
+            continue;
+
+          size_t rv = m_sock->read(bfr, sizeof(bfr));
+          for (size_t i = 0; i < rv && !m_quit; ++i)
+          {
+            if (bfr[i] == '\r')
+              continue;
+
+            if (bfr[i] != '\n')
+            {
+              m_line.push_back(bfr[i]);
+              if (m_line.size() > c_max_line)
+                throw std::runtime_error("request too long");
+              continue;
+            }
+
+            handleRequest(m_line);
+            m_line.clear();
+            m_timer.reset();
+          }
+        }
+        catch (std::exception& e)
+        {
+          m_task->debug("session closed: %s", e.what());
+          break;
+        }
+      }
+
+      m_task->debug("session finished, sent %lld bytes", (long long)m_bytes_sent);
+    }
+  }
+}
@@ -0,0 +1,133 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+#ifndef TRANSPORTS_LOG_TRANSFER_SESSION_HPP_INCLUDED_
+#define TRANSPORTS_LOG_TRANSFER_SESSION_HPP_INCLUDED_
+
+// ISO C++ 98 headers.
+#include <fstream>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "Catalog.hpp"
+
+namespace Transports
+{
+  namespace LogTransfer
+  {
+    //! Client session. Requests are text lines and are answered in
+    //! order, so clients may pipeline as many as they like:
+    //!
+    //! - LIST: one "F <size> <mtime> <path>" line per file, newest
+    //!   first, terminated by a "." line.
+    //! - HASH <path>: "P <hashed> <count>" progress lines while the
+    //!   file is being hashed, then a "H <size> <count>" line followed
+    //!   by one MD5 digest line per chunk.
+    //! - GET <index> <path>: a "D <index> <size> <digest>" line
+    //!   followed by the chunk contents.
+    //! - QUIT: closes the session.
+    //!
+    //! Failed requests are answered with an "E <reason>" line.
+    class Session: public DUNE::Concurrency::Thread
+    {
+    public:
+      Session(DUNE::Tasks::Task* task, Catalog& catalog,
+              DUNE::Network::TCPSocket* sock, double timeout);
+
+      ~Session(void);
+
+      //! Get number of bytes of chunk data sent.
+      //! @return number of bytes.
+      int64_t
+      getBytesSent(void) const
+      {
+        return m_bytes_sent;
+      }
+
+    private:
+      //! Maximum length of a request line.
+      static const size_t c_max_line = 4096;
+      //! Number of chunks hashed between progress reports.
+      static const size_t c_hash_chunks = 16;
+      //! Parent task.
+      DUNE::Tasks::Task* m_task;
+      //! File catalog.
+      Catalog& m_catalog;
+      //! Client socket.
+      DUNE::Network::TCPSocket* m_sock;
+      //! Idle timer.
+      DUNE::Time::Counter<double> m_timer;
+      //! Partial request line.
+      std::string m_line;
+      //! Chunk buffer.
+      std::vector<char> m_chunk;
+      //! File being read.
+      std::ifstream m_file;
+      //! Path of the file being read.
+      DUNE::FileSystem::Path m_file_path;
+      //! Bytes of chunk data sent.
+      int64_t m_bytes_sent;
+      //! True if the client asked to quit.
+      bool m_quit;
+
+      void
+      send(const char* data, size_t size);
+
+      void
+      send(const std::string& str)
+      {
+        send(str.c_str(), str.size());
+      }
+
+      std::istream&
+      openFile(const DUNE::FileSystem::Path& path);
+
+      void
+      handleLIST(void);
+
+      void
+      handleHASH(const std::string& path);
+
+      void
+      handleGET(const std::string& arg);
+
+      void
+      handleRequest(const std::string& line);
+
+      void
+      run(void);
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,294 @@
+//***************************************************************************
+// Copyright 2007-2020 Universidade do Porto - Faculdade de Engenharia      *
+// Laboratório de Sistemas e Tecnologia Subaquática (LSTS)                  *
+//***************************************************************************
+// This file is part of DUNE: Unified Navigation Environment.               *
+//                                                                          *
+// Commercial Licence Usage                                                 *
+// Licencees holding valid commercial DUNE licences may use this file in    *
+// accordance with the commercial licence agreement provided with the       *
+// Software or, alternatively, in accordance with the terms contained in a  *
+// written agreement between you and Faculdade de Engenharia da             *
+// Universidade do Porto. For licensing terms, conditions, and further      *
+// information contact lsts@fe.up.pt.                                       *
+//                                                                          *
+// Modified European Union Public Licence - EUPL v.1.1 Usage                *
+// Alternatively, this file may be used under the terms of the Modified     *
+// EUPL, Version 1.1 only (the "Licence"), appearing in the file LICENCE.md *
+// included in the packaging of this file. You may not use this work        *
+// except in compliance with the Licence. Unless required by applicable     *
+// law or agreed to in writing, software distributed under the Licence is   *
+// distributed on an "AS IS" basis, WITHOUT WARRANTIES OR CONDITIONS OF     *
+// ANY KIND, either express or implied. See the Licence for the specific    *
+// language governing permissions and limitations at                        *
+// https://github.com/LSTS/dune/blob/master/LICENCE.md and                  *
+// http://ec.europa.eu/idabc/eupl.html.                                     *
+//***************************************************************************
+// Author: Ricardo Martins                                                  *
+//***************************************************************************
+
+// ISO C++ 98 headers.
+#include <cstdio>
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+// DUNE headers.
+#include <DUNE/DUNE.hpp>
+
+// Local headers.
+#include "Catalog.hpp"
+#include "Session.hpp"
+
+namespace Transports
+{
+  //! Resumable transfer of log files over TCP.
+  //!
+  //! Files in the log folder are exposed as sequences of 256 KiB
+  //! content addressed chunks. Clients list the files (newest
+  //! first), fetch the chunk digests of a file and then request only
+  //! the chunks they lack or that changed, pipelining as many
+  //! requests as their window allows. Transfers interrupted by link
+  //! loss resume from the chunks already stored by the client (see
+  //! dune-logfetch).
+  //!
+  //! The service has no authentication: only clients from the
+  //! allowed networks may connect.
+  //!
+  //! @author Ricardo Martins
+  namespace LogTransfer
+  {
+    using DUNE_NAMESPACES;
+
+    //! Task arguments
+    struct Arguments
+    {
+      //! Listening port.
+      uint16_t port;
+      //! Session timeout.
+      double session_tout;
+      //! Maximum number of concurrent sessions.
+      unsigned max_sessions;
+      //! Networks allowed to connect.
+      std::vector<std::string> allowed;
+    };
+
+    //! Network of allowed clients.
+    struct AllowedNetwork
+    {
+      //! Network address (host order).
+      uint32_t address;
+      //! Network mask (host order).
+      uint32_t mask;
+    };
+
+    struct Task: public Tasks::Task
+    {
+      //! Arguments
+      Arguments m_args;
+      //! Listening socket.
+      TCPSocket* m_sock;
+      //! File catalog.
+      Catalog* m_catalog;
+      //! Active sessions.
+      std::list<Session*> m_sessions;
+      //! Networks allowed to connect.
+      std::vector<AllowedNetwork> m_allowed;
+
+      Task(const std::string& name, Tasks::Context& ctx):
+        Tasks::Task(name, ctx),
+        m_sock(NULL),
+        m_catalog(NULL)
+      {
+        param("Port", m_args.port)
+        .defaultValue("30022")
+        .description("TCP port used to listen for clients");
+
+        param("Session Timeout", m_args.session_tout)
+        .units(Units::Second)
+        .defaultValue("60")
+        .minimumValue("5")
+        .description("Time without requests after which a session is closed");
+
+        param("Maximum Sessions", m_args.max_sessions)
+        .defaultValue("4")
+        .minimumValue("1")
+        .description("Maximum number of concurrent client sessions");
+
+        param("Allowed Addresses", m_args.allowed)
+        .defaultValue("127.0.0.1")
+        .description("List of <Address>[/<Prefix Length>] of the clients"
+                     " allowed to fetch logs. Connections from other"
+                     " addresses are refused");
+      }
+
+      void
+      onUpdateParameters(void)
+      {
+        m_allowed.clear();
+        for (size_t i = 0; i < m_args.allowed.size(); ++i)
+        {
+          char addr[128] = {0};
+          unsigned prefix = 32;
+          int rv = std::sscanf(m_args.allowed[i].c_str(), "%127[^/]/%u", addr, &prefix);
+          if (rv < 1 || prefix > 32)
+            throw std::runtime_error(String::str(DTR("invalid address: %s"),
+                                                 m_args.allowed[i].c_str()));
+
+          AllowedNetwork net;
+          net.mask = (prefix == 0) ? 0 : (0xffffffffu << (32 - prefix));
+          net.address = Address(addr).toIntegerNative() & net.mask;
+          m_allowed.push_back(net);
+        }
+      }
+
+      //! Check if a client may connect.
+      //! @param[in] addr client address.
+      //! @return true if the client belongs to an allowed network.
+      bool
+      isAllowed(const Address& addr) const
+      {
+        uint32_t value = addr.toIntegerNative();
+        for (size_t i = 0; i < m_allowed.size(); ++i)
+        {
+          if ((value & m_allowed[i].mask) == m_allowed[i].address)
+            return true;
+        }
+
+        return false;
+      }
+
+      ~Task(void)
+      {
+        onResourceRelease();
+      }
+
+      void
+      onResourceAcquisition(void)
+      {
+        m_catalog = new Catalog(m_ctx.dir_log);
+
+        m_sock = new TCPSocket;
+        try
+        {
+          m_sock->bind(m_args.port);
+          m_sock->listen(5);
+        }
+        catch (std::runtime_error& e)
+        {
+          throw RestartNeeded(e.what(), 5);
+        }
+
+        inf(DTR("listening on port %u"), m_args.port);
+
+        std::set<Address> addrs;
+        std::vector<Interface> itfs = Interface::get();
+        for (unsigned i = 0; i < itfs.size(); ++i)
+        {
+          Address addr = itfs[i].address();
+          if (addrs.find(addr) != addrs.end())
+            continue;
+
+          addrs.insert(addr);
+
+          IMC::AnnounceService announce;
+          announce.service = String::str("dune-logtransfer://%s:%u/",
+                                         addr.c_str(), m_args.port);
+
+          if (addr.isLoopback())
+            announce.service_type = IMC::AnnounceService::SRV_TYPE_LOCAL;
+          else
+            announce.service_type = IMC::AnnounceService::SRV_TYPE_EXTERNAL;
+
+          dispatch(announce);
+        }
+
+        setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
+      }
+
+      void
+      onResourceRelease(void)
+      {
+        while (!m_sessions.empty())
+        {
+          Session* session = m_sessions.front();
+          m_sessions.pop_front();
+          session->stopAndJoin();
+          delete session;
+        }
+
+        Memory::clear(m_sock);
+        Memory::clear(m_catalog);
+      }
+
+      void
+      acceptNewClient(void)
+      {
+        try
+        {
+          Address addr;
+          TCPSocket* client = m_sock->accept(&addr);
+
+          if (!isAllowed(addr))
+          {
+            war(DTR("rejected client '%s': address not allowed"), addr.c_str());
+            delete client;
+            return;
+          }
+
+          if (m_sessions.size() >= m_args.max_sessions)
+          {
+            war(DTR("rejected client '%s': too many sessions"), addr.c_str());
+            delete client;
+            return;
+          }
+
+          debug("accepted connection from '%s'", addr.c_str());
+          Session* session = new Session(this, *m_catalog, client, m_args.session_tout);
+          session->start();
+          m_sessions.push_back(session);
+        }
+        catch (std::runtime_error& e)
+        {
+          err(DTR("error accepting new client connection: %s"), e.what());
+        }
+      }
+
+      void
+      cleanSessions(void)
+      {
+        std::list<Session*>::iterator itr = m_sessions.begin();
+        while (itr != m_sessions.end())
+        {
+          if ((*itr)->isDead())
+          {
+            (*itr)->stopAndJoin();
+            delete *itr;
+            itr = m_sessions.erase(itr);
+          }
+          else
+          {
+            ++itr;
+          }
+        }
+      }
+
+      void
+      onMain(void)
+      {
+        while (!stopping())
+        {
+          consumeMessages();
+
+          cleanSessions();
+
+          if (Poll::poll(*m_sock, 1.0))
+            acceptNewClient();
+        }
+      }
+    };
+  }
+}
+
+DUNE_TASK
@@ -98,6 +98,10 @@ namespace Transports
       std::string elabel_voltage;
       //! Radio reports periodicity.
       double radio_period;
+      //! Send high speed reports delta coded.
+      bool delta_report;
+      //! Maximum number of delta frames between keyframes.
+      unsigned delta_key_frames;
 
     };
 
@@ -240,6 +244,16 @@ namespace Transports
         .maximumValue("600")
         .description("Reports periodicity");
 
+        param("UAV high speed Reports Delta Coded", m_args.delta_report)
+        .defaultValue("false")
+        .description("Send high speed reports as delta coded estimated state"
+                     " frames instead of full reports");
+
+        param("UAV high speed Reports Keyframe Interval", m_args.delta_key_frames)
+        .defaultValue("10")
+        .minimumValue("1")
+        .description("Maximum number of delta coded frames between keyframes");
+
         param("Entity Label - Voltage", m_args.elabel_voltage)
         .defaultValue("Autopilot")
           .description("Entity label for battery Voltage");
@@ -608,6 +622,9 @@ namespace Transports
             debug("configuration completed");
             m_radio->clearNewRxData();
             m_telemetry = new Telemetry(this, (uint8_t) m_systemID, m_radio_names, m_radio_addrs, m_radio->maxDataPacket());
+            if (m_args.delta_report)
+              m_telemetry->setDeltaCoding(m_args.delta_key_frames,
+                                          m_args.delta_key_frames * m_args.radio_period);
              m_fast_treport_counter.setTop(m_args.radio_period);
             m_sm_state = SM_ACT_DONE;
             /* no break */
@@ -712,7 +729,10 @@ namespace Transports
             m_fast_treport_counter.setTop(m_args.radio_period);
            if(m_telemetry->isIdle())
            {
-             m_telemetry->createReport();
+             if (m_args.delta_report)
+               m_telemetry->createDeltaReport();
+             else
+               m_telemetry->createReport();
            }
           }
         }
@@ -38,6 +38,7 @@
 // DUNE headers.
 #include <DUNE/Coordinates.hpp>
 #include <DUNE/IMC/Definitions.hpp>
+#include <DUNE/Utils/Codecs/DeltaCodec.hpp>
 
 // Local headers
 #include "TelemetryTypes.hpp"
@@ -299,6 +300,70 @@ namespace Transports
 
        }
 
+       //! Enable delta coding of estimated state reports.
+       //! @param[in] frames maximum number of delta frames between
+       //! keyframes.
+       //! @param[in] period maximum time between keyframes.
+       void
+       setDeltaCoding(unsigned frames, double period)
+       {
+         std::vector<std::string> msgs(1, "EstimatedState");
+         m_codec.setMessages(msgs);
+         m_codec.setKeyframeInterval(frames, period);
+       }
+
+       //! Queue the last estimated state as a delta coded frame.
+       void
+       createDeltaReport(void)
+       {
+         uint8_t bfr[c_delta_bfr_size];
+         size_t size = m_codec.encode(&m_repotdata.estate, bfr, sizeof(bfr));
+         if (size == 0)
+           return;
+
+         XxMesg frame;
+         frame.setMsgData(std::string((const char*)bfr, size));
+         updateTxSync();
+         frame.encodeHeader(CODE_DELTA, systemID, 0, local_tx_sync, false,
+                            m_max_packet_size, MAX_MESSAGE_PERIOD * 4);
+         frame.state = MSG_QUEUE;
+         frame.telemetry_imc_status.type = IMC::TelemetryMsg::TM_TXSTATUS;
+         frame.telemetry_imc_status.code = CODE_DELTA;
+         frame.telemetry_imc_status.req_id = local_tx_sync;
+
+         m_tx_msg_queue.push(frame);
+         m_task->debug("Delta report to queue (%u bytes)", (unsigned)size);
+       }
+
+       bool
+       deltaDecode(XxMesg& rxmsg)
+       {
+         try
+         {
+           IMC::Message* m = m_codec.decode((const uint8_t*)rxmsg.msg.data(),
+                                            rxmsg.msg.size());
+           rxmsg.state = MSG_PROCESSED;
+           if (m == NULL)
+           {
+             m_task->debug("RX: delta frame ignored, keyframe was lost");
+             return true;
+           }
+
+           std::string src_system = safeLookup(rxmsg.src_id);
+           m->setSource(m_task->resolveSystemName(src_system));
+           m_task->dispatch(m, DF_KEEP_TIME);
+           delete m;
+           return true;
+         }
+         catch (std::exception& e)
+         {
+           m_task->err("Error decoding delta frame: %s.", e.what());
+         }
+
+         rxmsg.state = MSG_ERROR;
+         return false;
+       }
+
        bool
        reportDecode(XxMesg & rxmsg)
        {
@@ -470,6 +535,9 @@ namespace Transports
             case CODE_IMC:
                 recvImcMessage(m_rx_msg);
               break;
+            case CODE_DELTA:
+                deltaDecode(m_rx_msg);
+              break;
             case CODE_AK:
               // data transmition reciver side
               m_task->debug("AK to message trasmition");
@@ -728,9 +796,12 @@ namespace Transports
          return "unknown";
        }
     private:
-
+      //! Size of delta coded frame buffer.
+      static const size_t c_delta_bfr_size = 256;
       //! Pointer to task.
       Tasks::Task* m_task;
+      //! Delta codec of estimated state reports.
+      Utils::Codecs::DeltaCodec m_codec;
       RepotImcData m_repotdata;
       XxMesg acquisition_Rx_Frame;
       XxMesg m_tx_mesg;
@@ -79,7 +79,8 @@ namespace Transports
       CODE_REPORT = 0x01,
       CODE_IMC = 0x02,
       CODE_AK = 0x03,
-      CODE_RAW = 0x04
+      CODE_RAW = 0x04,
+      CODE_DELTA = 0x05
     };
 
     struct RepotImcData
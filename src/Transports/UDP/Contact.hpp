@@ -30,6 +30,9 @@
 #ifndef TRANSPORTS_UDP_CONTACT_HPP_INCLUDED_
 #define TRANSPORTS_UDP_CONTACT_HPP_INCLUDED_
 
+// ISO C++ 98 headers.
+#include <algorithm>
+
 // DUNE headers.
 #include <DUNE/DUNE.hpp>
 
@@ -39,12 +42,18 @@ namespace Transports
   {
     using DUNE_NAMESPACES;
 
+    //! Gain of packet loss averages.
+    static const double c_loss_gain = 0.05;
+
     class Contact
     {
     public:
       Contact(unsigned id, const Address& addr):
         m_id(id),
-        m_addr(addr)
+        m_addr(addr),
+        m_hb_time(-1),
+        m_hb_lost(0),
+        m_hb_expected(0)
       { }
 
       void
@@ -59,6 +68,35 @@ namespace Transports
         m_counter.reset();
       }
 
+      //! Update packet loss estimate with a heartbeat of this node.
+      //! Heartbeats are periodic, so gaps between them count lost
+      //! packets.
+      //! @param[in] time heartbeat time stamp.
+      //! @param[in] period nominal period of heartbeats.
+      void
+      onHeartbeat(double time, double period)
+      {
+        if (m_hb_time >= 0 && time > m_hb_time && period > 0)
+        {
+          double expected = std::max(1.0, Math::round((time - m_hb_time) / period));
+          m_hb_lost += c_loss_gain * (expected - 1.0 - m_hb_lost);
+          m_hb_expected += c_loss_gain * (expected - m_hb_expected);
+        }
+
+        m_hb_time = time;
+      }
+
+      //! Get estimated packet loss of link to this node.
+      //! @return fraction of packets lost.
+      double
+      getLoss(void) const
+      {
+        if (m_hb_expected <= 0)
+          return 0;
+
+        return m_hb_lost / m_hb_expected;
+      }
+
       unsigned
       getId(void) const
       {
@@ -90,6 +128,12 @@ namespace Transports
       Address m_addr;
       // Counter to check if node is no longer reachable.
       Time::Counter<float> m_counter;
+      // Time stamp of last heartbeat.
+      double m_hb_time;
+      // Average number of heartbeats lost per heartbeat received.
+      double m_hb_lost;
+      // Average number of heartbeats expected per heartbeat received.
+      double m_hb_expected;
     };
   }
 }
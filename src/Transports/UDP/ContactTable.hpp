@@ -49,8 +49,9 @@ namespace Transports
     class ContactTable
     {
     public:
-      ContactTable(float tout):
-        m_tout(tout)
+      ContactTable(float tout, double hb_period):
+        m_tout(tout),
+        m_hb_period(hb_period)
       { }
 
       void
@@ -83,6 +84,17 @@ namespace Transports
         itr->second.update();
       }
 
+      //! Account a heartbeat received from a contact.
+      //! @param[in] id node id.
+      //! @param[in] time heartbeat time stamp.
+      void
+      onHeartbeat(unsigned id, double time)
+      {
+        Table::iterator itr = m_table.find(id);
+        if (itr != m_table.end())
+          itr->second.onHeartbeat(time, m_hb_period);
+      }
+
     private:
       // Table type.
       typedef std::map<unsigned, Contact> Table;
@@ -92,6 +104,8 @@ namespace Transports
       Table m_table;
       // Timeout value to deactivate a contact.
       float m_tout;
+      // Nominal period of heartbeats.
+      double m_hb_period;
     };
   }
 }
@@ -51,11 +51,11 @@ namespace Transports
     {
     public:
       Listener(Tasks::Task& task, UDPSocket& sock, LimitedComms* lcomms,
-               float contact_timeout, bool trace = false):
+               float contact_timeout, double heartbeat_period, bool trace = false):
         m_task(task),
         m_sock(sock),
         m_trace(trace),
-        m_contacts(contact_timeout),
+        m_contacts(contact_timeout, heartbeat_period),
         m_lcomms(lcomms)
       {  }
 
@@ -94,6 +94,8 @@ namespace Transports
       RWLock m_contacts_lock;
       // LimitedComms object
       LimitedComms* m_lcomms;
+      // Decoder of delta coded telemetry.
+      Utils::Codecs::DeltaCodec m_codec;
 
       void
       run(void)
@@ -110,7 +112,18 @@ namespace Transports
               continue;
 
             uint16_t rv = m_sock.read(bfr, c_bfr_size, &addr);
-            IMC::Message* msg = IMC::Packet::deserialize(bfr, rv);
+
+            IMC::Message* msg = NULL;
+            if (Utils::Codecs::DeltaCodec::isCoded(bfr, rv))
+            {
+              msg = m_codec.decode(bfr, rv);
+              if (msg == NULL)
+                continue;
+            }
+            else
+            {
+              msg = IMC::Packet::deserialize(bfr, rv);
+            }
 
             if (m_lcomms->isActive())
             {
@@ -128,6 +141,8 @@ namespace Transports
 
             m_contacts_lock.lockWrite();
             m_contacts.update(msg->getSource(), addr);
+            if (msg->getId() == DUNE_IMC_HEARTBEAT)
+              m_contacts.onHeartbeat(msg->getSource(), msg->getTimeStamp());
             m_contacts_lock.unlock();
 
             m_task.dispatch(msg, DF_KEEP_TIME | DF_KEEP_SRC_EID);
@@ -137,22 +137,43 @@ namespace Transports
         return true;
       }
 
+      //! Check if the node has an active address.
+      //! @return true if node is reachable, false otherwise.
+      bool
+      isActive(void) const
+      {
+        return m_active != m_addrs.end();
+      }
+
+      //! Get active address of node.
+      //! @return active address.
+      const Address&
+      getAddress(void) const
+      {
+        return m_active->first;
+      }
+
       //! Send data to node.
       //! @param[in] sock UDP destination socket.
       //! @param[in] data data to be transmitted.
       //! @param[in] data_len length of data to be transmitted.
-      void
+      //! @return false if transmission failed, true otherwise.
+      bool
       send(UDPSocket& sock, const uint8_t* data, unsigned data_len)
       {
         if (m_active == m_addrs.end())
-          return;
+          return true;
 
         try
         {
           sock.write(data, data_len, m_active->first, m_active->second);
         }
         catch (...)
-        { }
+        {
+          return false;
+        }
+
+        return true;
       }
 
     private:
@@ -96,25 +96,34 @@ namespace Transports
         return m_active_count;
       }
 
+      //! Send data to all active nodes. Each node is a separate link
+      //! for message shaping.
+      //! @param[in] sock UDP destination socket.
+      //! @param[in] data data to be transmitted.
+      //! @param[in] data_len length of data to be transmitted.
+      //! @param[in] msg message being transmitted.
+      //! @param[in] filter message filter.
+      //! @param[in] now current time.
       void
-      send(UDPSocket& sock, const uint8_t* data, unsigned data_len, unsigned msgid)
+      send(UDPSocket& sock, const uint8_t* data, unsigned data_len,
+           const IMC::Message* msg, Tasks::MessageFilter& filter, double now)
       {
-        if (m_lcomms != NULL)
-        {
-          if (m_lcomms->isActive())
-          {
-            for (Table::iterator itr = m_table.begin(); itr != m_table.end(); ++itr)
-            {
-              if (m_lcomms->isNodeWithinRange(itr->first, msgid))
-                itr->second.send(sock, data, data_len);
-            }
-
-            return;
-          }
-        }
+        bool limited = m_lcomms != NULL && m_lcomms->isActive();
 
         for (Table::iterator itr = m_table.begin(); itr != m_table.end(); ++itr)
-          itr->second.send(sock, data, data_len);
+        {
+          if (!itr->second.isActive())
+            continue;
+
+          if (limited && !m_lcomms->isNodeWithinRange(itr->first, msg->getId()))
+            continue;
+
+          uint64_t peer = itr->second.getAddress().toInteger();
+          if (filter.shape(msg, data_len, peer, now))
+            continue;
+
+          filter.onTransmission(peer, itr->second.send(sock, data, data_len));
+        }
       }
 
       void
@@ -56,6 +56,8 @@ namespace Transports
       float contact_timeout;
       // Contact refresh periodicity.
       float contact_refresh_per;
+      // Nominal period of heartbeats sent by nodes.
+      double heartbeat_period;
       // Local UDP port.
       unsigned port;
       // Static destinations.
@@ -68,6 +70,12 @@ namespace Transports
       std::vector<std::string> rate_lims;
       // Filtered entities.
       std::vector<std::string> entities_flt;
+      // Messages suppressed while unchanged.
+      std::vector<std::string> dedup_msgs;
+      // Link capacity.
+      double link_rate;
+      // Link burst size.
+      double link_burst;
       // List of messages to publish.
       std::vector<std::string> messages;
       // Announce this transport to services or not
@@ -84,6 +92,14 @@ namespace Transports
       bool only_local;
       // Optional custom service type
       std::string custom_service;
+      // Messages sent with the delta codec.
+      std::vector<std::string> delta_msgs;
+      // Delta codec field resolutions.
+      std::vector<std::string> delta_res;
+      // Maximum number of delta frames between keyframes.
+      unsigned delta_key_frames;
+      // Maximum time between keyframes.
+      double delta_key_period;
     };
 
     // Internal buffer size.
@@ -115,6 +131,8 @@ namespace Transports
       LimitedComms* m_lcomms;
       //! Message Filter
       MessageFilter m_filter;
+      //! Delta codec for outgoing telemetry.
+      Utils::Codecs::DeltaCodec m_codec;
 
       Task(const std::string& name, Tasks::Context& ctx):
         DUNE::Tasks::Task(name, ctx),
@@ -134,6 +152,13 @@ namespace Transports
         .units(Units::Second)
         .defaultValue("5.0");
 
+        param("Heartbeat Period", m_args.heartbeat_period)
+        .units(Units::Second)
+        .defaultValue("1.0")
+        .minimumValue("0.1")
+        .description("Nominal period of heartbeats sent by other nodes,"
+                     " used to estimate the packet loss of their links");
+
         param("Print Outgoing Messages", m_args.trace_out)
         .defaultValue("false")
         .description("Print outgoing messages (Debug)");
@@ -151,6 +176,25 @@ namespace Transports
         param("Filtered Entities", m_args.entities_flt)
         .description("List of <Message>:<Entity>+<Entity> that define the source entities allowed to pass message of a specific message type.");
 
+        param("Suppressed Duplicates", m_args.dedup_msgs)
+        .description("List of <Message>[:<Maximum Silence>] that are not"
+                     " retransmitted while their contents do not change,"
+                     " except after the given number of seconds (default 60)");
+
+        param("Link Capacity", m_args.link_rate)
+        .defaultValue("0")
+        .units(Units::BitPerSecond)
+        .description("Capacity shared by rate limited and deduplicated"
+                     " messages, per destination address. The capacity of"
+                     " each link is reduced when its heartbeats are lost or"
+                     " transmissions fail, and rate limiters slow down when"
+                     " the budget is exhausted. Zero disables link shaping");
+
+        param("Link Burst", m_args.link_burst)
+        .defaultValue("4096")
+        .units(Units::Byte)
+        .description("Maximum burst of shaped messages, per destination address");
+
         param("Announce Service", m_args.announce_service)
         .defaultValue("true")
         .description("Announce this transport to services or not");
@@ -184,6 +228,27 @@ namespace Transports
         .defaultValue("")
         .description("Optional custom service type (imc+udp+<Custom Service Type>), empty entry gives default service (imc+udp)");
 
+        param("Delta Coded Messages", m_args.delta_msgs)
+        .defaultValue("")
+        .description("List of messages sent quantized and delta coded. Receivers"
+                     " must run a DUNE version able to decode them");
+
+        param("Delta Coding Resolutions", m_args.delta_res)
+        .defaultValue("")
+        .description("List of <Message>.<Field>:<Resolution> overriding the"
+                     " default quantization of delta coded fields");
+
+        param("Delta Keyframe Interval", m_args.delta_key_frames)
+        .defaultValue("20")
+        .minimumValue("0")
+        .description("Maximum number of delta frames between keyframes");
+
+        param("Delta Keyframe Period", m_args.delta_key_period)
+        .units(Units::Second)
+        .defaultValue("5.0")
+        .minimumValue("0")
+        .description("Maximum time between keyframes");
+
         // Allocate space for internal buffer.
         m_bfr = new uint8_t[c_bfr_size];
 
@@ -212,9 +277,24 @@ namespace Transports
         m_filter.setupRates(m_args.rate_lims);
         // Process filtered entities.
         m_filter.setupEntities(m_args.entities_flt, this);
+        // Process duplicate suppression and link shaping.
+        m_filter.setupDuplicates(m_args.dedup_msgs);
+        m_filter.setupLink(m_args.link_rate / 8.0, m_args.link_burst);
 
         m_underwater_comms = m_args.underwater_comms;
 
+        // Setup delta codec.
+        try
+        {
+          m_codec.setMessages(m_args.delta_msgs);
+          m_codec.setResolutions(m_args.delta_res);
+          m_codec.setKeyframeInterval(m_args.delta_key_frames, m_args.delta_key_period);
+        }
+        catch (std::runtime_error& e)
+        {
+          throw std::runtime_error(String::str(DTR("invalid delta coding parameters: %s"), e.what()));
+        }
+
         // Initialize communication limitations parameters.
         if (m_ctx.profiles.isSelected("Simulation") && m_args.comm_range > 0)
         {
@@ -299,7 +379,8 @@ namespace Transports
 
         // Start listener thread.
         m_listener = new Listener(*this, m_sock, m_lcomms,
-                                  m_args.contact_timeout, m_args.trace_in);
+                                  m_args.contact_timeout, m_args.heartbeat_period,
+                                  m_args.trace_in);
         m_listener->start();
 
         setEntityState(IMC::EntityState::ESTA_NORMAL, Status::CODE_ACTIVE);
@@ -339,24 +420,40 @@ namespace Transports
         if (m_args.trace_out)
           msg->toText(std::cerr);
 
-        uint16_t rv = IMC::Packet::serialize(msg, m_bfr, c_bfr_size);
+        uint16_t rv = 0;
+        if (m_codec.isEnabled(msg->getId()))
+          rv = m_codec.encode(msg, m_bfr, c_bfr_size);
+
+        if (rv == 0)
+          rv = IMC::Packet::serialize(msg, m_bfr, c_bfr_size);
+
+        double now = Clock::get();
 
         // Send to static nodes.
         std::set<NodeAddress>::iterator itr = m_static_dsts.begin();
         for (; itr != m_static_dsts.end(); ++itr)
         {
+          uint64_t peer = itr->getAddress().toInteger();
+          if (m_filter.shape(msg, rv, peer, now))
+            continue;
+
+          bool ok = true;
           try
           {
             m_sock.write(m_bfr, rv, itr->getAddress(), itr->getPort());
           }
           catch (...)
-          { }
+          {
+            ok = false;
+          }
+
+          m_filter.onTransmission(peer, ok);
         }
 
         if (m_args.dynamic_nodes)
         {
           // Send to dynamic nodes.
-          m_node_table.send(m_sock, m_bfr, rv, msg->getId());
+          m_node_table.send(m_sock, m_bfr, rv, msg, m_filter, now);
         }
       }
 
@@ -391,13 +488,18 @@ namespace Transports
 
           if (itr->isActive())
           {
+            m_filter.onLinkLoss(itr->getAddress().toInteger(), itr->getLoss());
+
             if (m_node_table.activate(itr->getId(), itr->getAddress()))
               inf(DTR("activating transmission to node '%s'"), name.c_str());
           }
           else
           {
             if (m_node_table.deactivate(itr->getId(), itr->getAddress()))
+            {
               inf(DTR("deactivating transmission to node '%s'"), name.c_str());
+              m_filter.removeLink(itr->getAddress().toInteger());
+            }
           }
         }
 